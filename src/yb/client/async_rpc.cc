@@ -131,6 +131,10 @@ const YBTable* AsyncRpc::table() const {
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
+    if (tablet_invoker_.tablet_split() && RouteAgainAfterSplit(new_status)) {
+      retained_self_.reset();
+      return;
+    }
     ProcessResponseFromTserver(new_status);
     batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
     batcher_->CheckForFinishedFlush();
@@ -138,6 +142,17 @@ void AsyncRpc::Finished(const Status& status) {
   }
 }
 
+bool AsyncRpc::RouteAgainAfterSplit(const Status& status) {
+  // Transaction keeps track of the tablets it has written to, so it is restarted instead.
+  if (batcher_->transaction() || MonoTime::Now() >= batcher_->deadline()) {
+    return false;
+  }
+  VLOG(1) << ToString() << ": routing operations again: " << status;
+  RestoreRequests();
+  batcher_->RouteAgainAfterSplit(ops_);
+  return true;
+}
+
 void AsyncRpc::Failed(const Status& status) {
   std::string error_message = status.message().ToBuffer();
   auto redis_error_code = status.IsInvalidCommand() || status.IsInvalidArgument() ?
@@ -347,6 +362,26 @@ WriteRpc::~WriteRpc() {
   }
 }
 
+void WriteRpc::Finished(const Status& status) {
+  // Finished could be invoked before the rpc was ever sent, e.g. when tablet lookup failed.
+  SkipMultiWrite();
+  AsyncRpc::Finished(status);
+}
+
+void WriteRpc::SkipMultiWrite() {
+  if (multi_write_) {
+    auto multi_write = std::move(multi_write_);
+    multi_write->Skip();
+  }
+}
+
+Status WriteRpc::GetSidecar(int idx, Slice* sidecar) const {
+  if (multi_write_response_) {
+    return multi_write_response_->GetSidecar(idx, sidecar);
+  }
+  return retrier().controller().GetSidecar(idx, sidecar);
+}
+
 void WriteRpc::CallRemoteMethod() {
   auto trace = trace_; // It is possible that we receive reply before returning from WriteAsync.
                        // Since send happens before we return from WriteAsync.
@@ -355,6 +390,17 @@ void WriteRpc::CallRemoteMethod() {
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
 
+  multi_write_response_.reset();
+  if (multi_write_) {
+    auto multi_write = std::move(multi_write_);
+    if (&tablet_invoker_.current_ts() == multi_write->tserver()) {
+      TRACE_TO(trace, "Added to MultiWrite");
+      multi_write->Add(std::static_pointer_cast<WriteRpc>(shared_from_this()));
+      return;
+    }
+    multi_write->Skip();
+  }
+
   tablet_invoker_.proxy()->WriteAsync(
       req_, &resp_, PrepareController(MonoDelta::kMax),
       std::bind(&WriteRpc::Finished, this, Status::OK()));
@@ -402,8 +448,7 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
-              ql_response.rows_data_sidecar(), &rows_data));
+          CHECK_OK(GetSidecar(ql_response.rows_data_sidecar(), &rows_data));
           ql_op->mutable_rows_data()->assign(util::to_char_ptr(rows_data.data()), rows_data.size());
         }
         ql_idx++;
@@ -421,8 +466,7 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
         const auto& pgsql_response = pgsql_op->response();
         if (pgsql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
-              pgsql_response.rows_data_sidecar(), &rows_data));
+          CHECK_OK(GetSidecar(pgsql_response.rows_data_sidecar(), &rows_data));
           down_cast<YBPgsqlWriteOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
         }
@@ -452,12 +496,133 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
   }
 }
 
+void WriteRpc::RestoreRequests() {
+  size_t redis_idx = 0;
+  size_t ql_idx = 0;
+  size_t pgsql_idx = 0;
+  for (auto& op : ops_) {
+    YBOperation* yb_op = op->yb_op.get();
+    switch (yb_op->type()) {
+      case YBOperation::Type::REDIS_WRITE:
+        down_cast<YBRedisWriteOp*>(yb_op)->mutable_request()->Swap(
+            req_.mutable_redis_write_batch(redis_idx++));
+        break;
+      case YBOperation::Type::QL_WRITE:
+        down_cast<YBqlWriteOp*>(yb_op)->mutable_request()->Swap(
+            req_.mutable_ql_write_batch(ql_idx++));
+        break;
+      case YBOperation::Type::PGSQL_WRITE:
+        down_cast<YBPgsqlWriteOp*>(yb_op)->mutable_request()->Swap(
+            req_.mutable_pgsql_write_batch(pgsql_idx++));
+        break;
+      case YBOperation::Type::PGSQL_READ: FALLTHROUGH_INTENDED;
+      case YBOperation::Type::REDIS_READ: FALLTHROUGH_INTENDED;
+      case YBOperation::Type::QL_READ:
+        LOG(FATAL) << "Not a write operation " << op->yb_op->type();
+        break;
+    }
+  }
+}
+
+MultiTabletWriteRpc::MultiTabletWriteRpc(
+    RemoteTabletServer* tserver, size_t num_rpcs, MonoTime deadline)
+    : tserver_(tserver), num_rpcs_(num_rpcs), deadline_(deadline) {
+  rpcs_.reserve(num_rpcs);
+}
+
+void MultiTabletWriteRpc::Add(std::shared_ptr<WriteRpc> rpc) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  rpcs_.push_back(std::move(rpc));
+  Reported(&lock);
+}
+
+void MultiTabletWriteRpc::Skip() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Reported(&lock);
+}
+
+void MultiTabletWriteRpc::Reported(std::unique_lock<std::mutex>* lock) {
+  if (++num_reported_ != num_rpcs_) {
+    return;
+  }
+  if (rpcs_.size() < 2) {
+    // Nothing to group, send the only added rpc, if any, as usual.
+    auto rpcs = std::move(rpcs_);
+    lock->unlock();
+    for (const auto& rpc : rpcs) {
+      rpc->CallRemoteMethod();
+    }
+    return;
+  }
+
+  for (const auto& rpc : rpcs_) {
+    req_.add_requests()->Swap(&rpc->req_);
+  }
+  auto proxy = rpcs_.front()->tablet_invoker_.proxy();
+  lock->unlock();
+
+  VLOG(3) << "Sending MultiWrite of " << req_.requests_size() << " tablets to "
+          << tserver_->permanent_uuid();
+  controller_.set_deadline(deadline_);
+  proxy->MultiWriteAsync(
+      req_, &resp_, &controller_,
+      std::bind(&MultiTabletWriteRpc::Done, shared_from_this()));
+}
+
+void MultiTabletWriteRpc::Done() {
+  std::vector<std::shared_ptr<WriteRpc>> rpcs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rpcs.swap(rpcs_);
+  }
+
+  auto status = controller_.status();
+  if (status.ok() && resp_.has_error()) {
+    status = StatusFromPB(resp_.error().status());
+  }
+  if (status.ok() && static_cast<size_t>(resp_.responses_size()) != rpcs.size()) {
+    status = STATUS_FORMAT(IllegalState, "MultiWrite response count mismatch: $0 vs $1",
+                           resp_.responses_size(), rpcs.size());
+  }
+  for (size_t i = 0; i != rpcs.size(); ++i) {
+    rpcs[i]->req_.Swap(req_.mutable_requests(i));
+  }
+
+  if (!status.ok()) {
+    // The call as a whole has failed, e.g. the tablet server does not support it, so fall back to
+    // sending the writes one by one and let each of them handle the failure on its own.
+    LOG(WARNING) << "MultiWrite to " << tserver_->permanent_uuid() << " failed: " << status
+                 << ", sending " << rpcs.size() << " writes separately";
+    for (const auto& rpc : rpcs) {
+      rpc->CallRemoteMethod();
+    }
+    return;
+  }
+
+  auto self = shared_from_this();
+  for (size_t i = 0; i != rpcs.size(); ++i) {
+    rpcs[i]->resp_.Swap(resp_.mutable_responses(i));
+    rpcs[i]->multi_write_response_ = self;
+    rpcs[i]->Finished(Status::OK());
+  }
+}
+
 ReadRpc::ReadRpc(
     const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
     bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level)
     : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level) {
   TRACE_TO(trace_, "ReadRpc initiated to $0", tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    auto max_staleness = batcher->follower_read_max_staleness();
+    if (max_staleness.Initialized()) {
+      req_.set_max_staleness_ms(max_staleness.ToMilliseconds());
+      auto min_safe_ht = batcher->follower_read_min_safe_ht();
+      if (min_safe_ht.is_valid() && min_safe_ht != HybridTime::kMin) {
+        req_.set_min_safe_ht(min_safe_ht.ToUint64());
+      }
+    }
+  }
 
   int ctr = 0;
   for (auto& op : ops_) {
@@ -623,6 +788,33 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   }
 }
 
+void ReadRpc::RestoreRequests() {
+  size_t redis_idx = 0;
+  size_t ql_idx = 0;
+  size_t pgsql_idx = 0;
+  for (auto& op : ops_) {
+    YBOperation* yb_op = op->yb_op.get();
+    switch (yb_op->type()) {
+      case YBOperation::Type::REDIS_READ:
+        down_cast<YBRedisReadOp*>(yb_op)->mutable_request()->Swap(
+            req_.mutable_redis_batch(redis_idx++));
+        break;
+      case YBOperation::Type::QL_READ:
+        down_cast<YBqlReadOp*>(yb_op)->mutable_request()->Swap(req_.mutable_ql_batch(ql_idx++));
+        break;
+      case YBOperation::Type::PGSQL_READ:
+        down_cast<YBPgsqlReadOp*>(yb_op)->mutable_request()->Swap(
+            req_.mutable_pgsql_batch(pgsql_idx++));
+        break;
+      case YBOperation::Type::PGSQL_WRITE: FALLTHROUGH_INTENDED;
+      case YBOperation::Type::REDIS_WRITE: FALLTHROUGH_INTENDED;
+      case YBOperation::Type::QL_WRITE:
+        LOG(FATAL) << "Not a read operation " << op->yb_op->type();
+        break;
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace client
 }  // namespace yb
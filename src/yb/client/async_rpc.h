@@ -14,6 +14,10 @@
 #ifndef YB_CLIENT_ASYNC_RPC_H_
 #define YB_CLIENT_ASYNC_RPC_H_
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 
@@ -84,6 +88,14 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // Return latest hybrid time that was present on tserver during processing of this request.
   virtual HybridTime PropagatedHybridTime() = 0;
 
+  // Moves requests of the operations from the tserver request back to the operations, so they
+  // could be sent again with another rpc.
+  virtual void RestoreRequests() = 0;
+
+  // Hands the operations back to the batcher to be routed again after the tablet was split.
+  // Returns false if the operations could not be routed again, so the rpc should fail as usual.
+  bool RouteAgainAfterSplit(const Status& status);
+
   void Failed(const Status& status) override;
 
   // Is this a local call?
@@ -134,6 +146,8 @@ class AsyncRpcBase : public AsyncRpc {
   Resp resp_;
 };
 
+class MultiTabletWriteRpc;
+
 class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResponsePB> {
  public:
   WriteRpc(
@@ -142,9 +156,72 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
 
   virtual ~WriteRpc();
 
+  // Lets the first attempt of this rpc be sent as a part of the MultiWrite call of 'multi_write'.
+  // Should be called before SendRpc.
+  void SetMultiWrite(std::shared_ptr<MultiTabletWriteRpc> multi_write) {
+    multi_write_ = std::move(multi_write);
+  }
+
+ protected:
+  void Finished(const Status& status) override;
+
  private:
+  friend class MultiTabletWriteRpc;
+
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+  void RestoreRequests() override;
+
+  // Tells the MultiWrite call that this rpc does not take part in it, if not done yet.
+  void SkipMultiWrite();
+
+  CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
+
+  // The MultiWrite call that this rpc is going to be sent with.
+  std::shared_ptr<MultiTabletWriteRpc> multi_write_;
+
+  // The MultiWrite call that the current response was received with, its controller holds the
+  // sidecars of the response.
+  std::shared_ptr<MultiTabletWriteRpc> multi_write_response_;
+};
+
+// Sends the first attempts of the write rpcs of a single flush that go to the same remote tablet
+// server as one MultiWrite call, instead of one call per tablet.
+//
+// Every rpc attached to this object reports exactly once: it is either added, when it is about to
+// be sent to the expected tablet server, or skipped otherwise. Once all of them have reported, the
+// added rpcs are sent together. Responses are handed back to the rpcs, so retries and error
+// handling are done by each rpc on its own, as usual.
+class MultiTabletWriteRpc : public std::enable_shared_from_this<MultiTabletWriteRpc> {
+ public:
+  MultiTabletWriteRpc(RemoteTabletServer* tserver, size_t num_rpcs, MonoTime deadline);
+
+  RemoteTabletServer* tserver() const { return tserver_; }
+
+  void Add(std::shared_ptr<WriteRpc> rpc);
+  void Skip();
+
+  CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const {
+    return controller_.GetSidecar(idx, sidecar);
+  }
+
+ private:
+  // Invoked when one more rpc has reported, sends the call if it was the last one.
+  void Reported(std::unique_lock<std::mutex>* lock);
+
+  void Done();
+
+  RemoteTabletServer* const tserver_;
+  const size_t num_rpcs_;
+  const MonoTime deadline_;
+
+  std::mutex mutex_;
+  size_t num_reported_ = 0;
+  std::vector<std::shared_ptr<WriteRpc>> rpcs_;
+
+  tserver::MultiWriteRequestPB req_;
+  tserver::MultiWriteResponsePB resp_;
+  rpc::RpcController controller_;
 };
 
 class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadResponsePB> {
@@ -159,6 +236,7 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
  private:
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+  void RestoreRequests() override;
 };
 
 }  // namespace internal
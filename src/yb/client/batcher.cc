@@ -68,6 +68,13 @@ DEFINE_bool(redis_allow_reads_from_followers, false,
 TAG_FLAG(redis_allow_reads_from_followers, evolving);
 TAG_FLAG(redis_allow_reads_from_followers, runtime);
 
+DEFINE_bool(enable_multi_tablet_write_rpc, false,
+            "If true, writes of a single flush to different tablets whose leaders are on the same "
+            "remote tablet server are sent to it in one MultiWrite call. Requires all tablet "
+            "servers to support MultiWrite.");
+TAG_FLAG(enable_multi_tablet_write_rpc, advanced);
+TAG_FLAG(enable_multi_tablet_write_rpc, runtime);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -412,8 +419,31 @@ OpGroup GetOpGroup(const InFlightOpPtr& op) {
   return OpGroup::kLeaderRead;
 }
 
+Status Batcher::CheckSingleTabletAutoCommitUnlocked() const {
+  if (transaction_) {
+    return STATUS(IllegalState, "Single tablet auto-commit flush in context of transaction");
+  }
+  if (had_errors_) {
+    return STATUS(IllegalState, "Single tablet auto-commit flush has failed operations");
+  }
+  const RemoteTablet* tablet = nullptr;
+  for (const auto& op : ops_queue_) {
+    if (op->yb_op->read_only()) {
+      return STATUS(IllegalState, "Single tablet auto-commit flush does not support reads");
+    }
+    if (tablet != nullptr && op->tablet.get() != tablet) {
+      return STATUS_FORMAT(
+          IllegalState, "Single tablet auto-commit flush writes to multiple tablets: $0 and $1",
+          tablet->tablet_id(), op->tablet->tablet_id());
+    }
+    tablet = op->tablet.get();
+  }
+  return Status::OK();
+}
+
 void Batcher::FlushBuffersIfReady() {
   InFlightOps ops;
+  Status single_tablet_status;
 
   // We're only ready to flush if:
   // 1. The batcher is in the flushing state (i.e. FlushAsync was called).
@@ -431,8 +461,12 @@ void Batcher::FlushBuffersIfReady() {
       return;
     }
 
+    if (single_tablet_auto_commit_ && !ops_queue_.empty()) {
+      single_tablet_status = CheckSingleTabletAutoCommitUnlocked();
+    }
+
     auto transaction = this->transaction();
-    if (transaction) {
+    if (transaction && single_tablet_status.ok()) {
       // If this Batcher is executed in context of transaction,
       // then this transaction should initialize metadata used by RPC calls.
       //
@@ -451,6 +485,15 @@ void Batcher::FlushBuffersIfReady() {
     ops.swap(ops_queue_);
   }
 
+  if (!single_tablet_status.ok()) {
+    // Writes are applied atomically only if all of them are sent together, so none is sent.
+    for (const auto& op : ops) {
+      MarkInFlightOpFailed(op, single_tablet_status);
+    }
+    CheckForFinishedFlush();
+    return;
+  }
+
   if (ops.empty()) {
     return;
   }
@@ -470,19 +513,56 @@ void Batcher::FlushBuffersIfReady() {
   });
 
   // Now flush the ops for each tablet.
+  std::vector<std::shared_ptr<AsyncRpc>> rpcs;
   auto start = ops.begin();
   auto start_group = GetOpGroup(*start);
   for (auto it = start; it != ops.end(); ++it) {
     auto it_group = GetOpGroup(*it);
     if ((**it).tablet.get() != (**start).tablet.get() || start_group != it_group) {
-      FlushBuffer(
-          start->get()->tablet.get(), start, it, /* allow_local_calls_in_curr_thread */ false);
+      rpcs.push_back(CreateRpc(
+          start->get()->tablet.get(), start, it, /* allow_local_calls_in_curr_thread */ false));
       start = it;
       start_group = it_group;
     }
   }
 
-  FlushBuffer(start->get()->tablet.get(), start, ops.end(), allow_local_calls_in_curr_thread_);
+  rpcs.push_back(CreateRpc(
+      start->get()->tablet.get(), start, ops.end(), allow_local_calls_in_curr_thread_));
+
+  if (FLAGS_enable_multi_tablet_write_rpc) {
+    GroupWriteRpcs(rpcs);
+  }
+
+  for (const auto& rpc : rpcs) {
+    rpc->SendRpc();
+  }
+}
+
+void Batcher::GroupWriteRpcs(const std::vector<std::shared_ptr<AsyncRpc>>& rpcs) {
+  // Local writes are not grouped, they do not pay for network round trips.
+  std::unordered_map<RemoteTabletServer*, std::vector<std::shared_ptr<WriteRpc>>> groups;
+  for (const auto& rpc : rpcs) {
+    if (rpc->ops().front()->yb_op->read_only()) {
+      continue;
+    }
+    auto* leader = rpc->tablet().LeaderTServer();
+    if (leader && !leader->IsLocal()) {
+      groups[leader].push_back(std::static_pointer_cast<WriteRpc>(rpc));
+    }
+  }
+
+  for (const auto& group : groups) {
+    if (group.second.size() < 2) {
+      continue;
+    }
+    VLOG(3) << "Grouping writes to " << group.second.size() << " tablets on "
+            << group.first->permanent_uuid();
+    auto multi_write = std::make_shared<MultiTabletWriteRpc>(
+        group.first, group.second.size(), deadline_);
+    for (const auto& rpc : group.second) {
+      rpc->SetMultiWrite(multi_write);
+    }
+  }
 }
 
 const std::shared_ptr<rpc::Messenger>& Batcher::messenger() const {
@@ -493,7 +573,7 @@ YBTransactionPtr Batcher::transaction() const {
   return transaction_;
 }
 
-void Batcher::FlushBuffer(
+std::shared_ptr<AsyncRpc> Batcher::CreateRpc(
     RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
     const bool allow_local_calls_in_curr_thread) {
   VLOG(3) << "FlushBuffersIfReady: already in flushing state, immediately flushing to "
@@ -501,7 +581,7 @@ void Batcher::FlushBuffer(
 
   CHECK(begin != end);
 
-  // Create and send an RPC that aggregates the ops. The RPC is freed when
+  // Create an RPC that aggregates the ops. The RPC is freed when
   // its callback completes.
   //
   // The RPC object takes ownership of the in flight ops.
@@ -530,7 +610,7 @@ void Batcher::FlushBuffer(
   if (!rpc) {
     FATAL_INVALID_ENUM_VALUE(OpGroup, op_group);
   }
-  rpc->SendRpc();
+  return rpc;
 }
 
 using tserver::ReadResponsePB;
@@ -557,6 +637,35 @@ void Batcher::RemoveInFlightOpsAfterFlushing(
   }
 }
 
+void Batcher::RouteAgainAfterSplit(const InFlightOps& ops) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    outstanding_lookups_ += ops.size();
+    for (const auto& op : ops) {
+      std::lock_guard<simple_spinlock> l2(op->lock_);
+      op->state = InFlightOpState::kLookingUpTablet;
+      op->tablet = nullptr;
+    }
+  }
+
+  // All ops of the rpc belong to the same table.
+  client_->data_->meta_cache_->RefreshTablePartitions(
+      ops.front()->yb_op->table(), deadline_, Bind(&Batcher::PartitionsRefreshed, this, ops));
+}
+
+void Batcher::PartitionsRefreshed(InFlightOps ops, const Status& s) {
+  for (auto& op : ops) {
+    if (!s.ok()) {
+      TabletLookupFinished(std::move(op), s);
+      continue;
+    }
+    VLOG(3) << "Looking up tablet again for " << op->yb_op->ToString();
+    client_->data_->meta_cache_->LookupTabletByKey(
+        op->yb_op->table(), op->partition_key, deadline_, &op->tablet,
+        Bind(&Batcher::TabletLookupFinished, this, op));
+  }
+}
+
 void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   // TODO: there is a potential race here -- if the Batcher gets destructed while
   // RPCs are in-flight, then accessing state_ will crash. We probably need to keep
@@ -583,6 +692,12 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
   if (s.ok() && rpc.resp().has_propagated_hybrid_time()) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
   }
+  if (s.ok() && rpc.resp().has_safe_time()) {
+    auto session_data = weak_session_data_.lock();
+    if (session_data) {
+      session_data->UpdateLastWriteHybridTime(HybridTime(rpc.resp().safe_time()));
+    }
+  }
 
   // Check individual row errors.
   for (const WriteResponsePB_PerRowErrorPB& err_pb : rpc.resp().per_row_errors()) {
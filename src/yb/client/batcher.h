@@ -144,6 +144,20 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
+  // Staleness bound of CONSISTENT_PREFIX reads, and the hybrid time of the last write of the
+  // session, that such reads must observe. Set by the session before flush.
+  void SetFollowerReadOptions(MonoDelta max_staleness, HybridTime min_safe_ht) {
+    follower_read_max_staleness_ = max_staleness;
+    follower_read_min_safe_ht_ = min_safe_ht;
+  }
+
+  MonoDelta follower_read_max_staleness() const { return follower_read_max_staleness_; }
+
+  HybridTime follower_read_min_safe_ht() const { return follower_read_min_safe_ht_; }
+
+  // See YBSession::SetSingleTabletAutoCommit. Set by the session before flush.
+  void set_single_tablet_auto_commit(bool flag) { single_tablet_auto_commit_ = flag; }
+
  private:
   friend class RefCountedThreadSafe<Batcher>;
   friend class AsyncRpc;
@@ -158,6 +172,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
+  // Refreshes partitions of the table of the specified ops, that were sent to a tablet that was
+  // split, and looks up their tablets again. The ops are sent again after that as usual.
+  void RouteAgainAfterSplit(const InFlightOps& ops);
+
     // Return true if the batch has been aborted, and any in-flight ops should stop
   // processing wherever they are.
   bool IsAbortedUnlocked() const;
@@ -174,10 +192,18 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   void CheckForFinishedFlush();
   void FlushBuffersIfReady();
-  void FlushBuffer(
+
+  // Checks that the queued operations could be sent as a single tablet auto-commit write.
+  CHECKED_STATUS CheckSingleTabletAutoCommitUnlocked() const;
+
+  std::shared_ptr<AsyncRpc> CreateRpc(
       RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
       const bool allow_local_calls_in_curr_thread);
 
+  // Attaches write rpcs whose tablet leaders are on the same remote tablet server to a shared
+  // MultiWrite call, see FLAGS_enable_multi_tablet_write_rpc.
+  void GroupWriteRpcs(const std::vector<std::shared_ptr<AsyncRpc>>& rpcs);
+
   // Calls/Schedules flush_callback_ and resets it to free resources.
   void RunCallback(const Status& s);
 
@@ -194,6 +220,7 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   // Async Callbacks.
   void TabletLookupFinished(InFlightOpPtr op, const Status& s);
+  void PartitionsRefreshed(InFlightOps ops, const Status& s);
 
   // Compute a new deadline based on timeout_. If no timeout_ has been set,
   // uses a hard-coded default and issues periodic warnings.
@@ -257,6 +284,11 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // If true, we might allow the local calls to be run in the same IPC thread.
   bool allow_local_calls_in_curr_thread_ = true;
 
+  MonoDelta follower_read_max_staleness_;
+  HybridTime follower_read_min_safe_ht_;
+
+  bool single_tablet_auto_commit_ = false;
+
   // The number of bytes used in the buffer for pending operations.
   AtomicInt<int64_t> buffer_bytes_used_;
 
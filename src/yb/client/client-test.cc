@@ -96,8 +96,11 @@ DECLARE_int32(replication_factor);
 DEFINE_int32(test_scan_num_rows, 1000, "Number of rows to insert and scan");
 DECLARE_int32(min_backoff_ms_exponent);
 DECLARE_int32(max_backoff_ms_exponent);
+DECLARE_bool(enable_multi_tablet_write_rpc);
 
 METRIC_DECLARE_counter(rpcs_queue_overflow);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Write);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_MultiWrite);
 
 using namespace std::literals; // NOLINT
 using namespace std::placeholders;
@@ -1394,6 +1397,43 @@ TEST_F(ClientTest, TestReplicatedMultiTabletTable) {
   // and ensure that the client handles refreshing the leader.
 }
 
+// Checks that writes of a single flush to many tablets are grouped into one call per tablet server.
+TEST_F(ClientTest, MultiTabletWrite) {
+  const YBTableName kTable("multi_tablet_write");
+  constexpr int kTablets = 12;
+  constexpr int kNumRowsToWrite = 500;
+  FLAGS_enable_multi_tablet_write_rpc = true;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(kTable, kTablets, &table));
+
+  auto sum_handled = [this](const HistogramPrototype& prototype) {
+    uint64_t result = 0;
+    for (int i = 0; i < cluster_->num_tablet_servers(); i++) {
+      result += prototype.Instantiate(
+          cluster_->mini_tablet_server(i)->server()->metric_entity())->TotalCount();
+    }
+    return result;
+  };
+  auto writes_before = sum_handled(METRIC_handler_latency_yb_tserver_TabletServerService_Write);
+
+  ASSERT_NO_FATALS(InsertTestRows(table, kNumRowsToWrite));
+  ASSERT_EQ(kNumRowsToWrite, CountRowsFromClient(table));
+
+  ASSERT_NO_FATALS(UpdateTestRows(table, 0, kNumRowsToWrite));
+  ASSERT_EQ(kNumRowsToWrite, CountRowsFromClient(table));
+
+  auto multi_writes = sum_handled(
+      METRIC_handler_latency_yb_tserver_TabletServerService_MultiWrite);
+  // Local calls made by MultiWrite are also handled as plain writes.
+  auto writes = sum_handled(METRIC_handler_latency_yb_tserver_TabletServerService_Write) -
+                writes_before;
+  LOG(INFO) << "MultiWrite calls: " << multi_writes << ", per tablet writes: " << writes;
+  ASSERT_GT(multi_writes, 0);
+  ASSERT_LE(multi_writes, 2 * cluster_->num_tablet_servers());
+  ASSERT_GE(writes, kTablets);
+}
+
 TEST_F(ClientTest, TestReplicatedMultiTabletTableFailover) {
   const YBTableName kReplicatedTable("replicated_failover_on_reads");
   const int kNumRowsToWrite = 100;
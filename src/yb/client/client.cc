@@ -1287,18 +1287,33 @@ YBqlReadOp* YBTable::NewQLRead() {
   return new YBqlReadOp(shared_from_this());
 }
 
-const std::string& YBTable::FindPartitionStart(
+std::string YBTable::FindPartitionStart(
     const std::string& partition_key, size_t group_by) const {
-  auto it = std::lower_bound(data_->partitions_.begin(), data_->partitions_.end(), partition_key);
-  if (it == data_->partitions_.end() || *it > partition_key) {
-    DCHECK(it != data_->partitions_.begin());
+  boost::shared_lock<rw_spinlock> lock(data_->partitions_mutex_);
+  const auto& partitions = data_->partitions_;
+  auto it = std::lower_bound(partitions.begin(), partitions.end(), partition_key);
+  if (it == partitions.end() || *it > partition_key) {
+    DCHECK(it != partitions.begin());
     --it;
   }
   if (group_by <= 1) {
     return *it;
   }
-  size_t idx = (it - data_->partitions_.begin()) / group_by * group_by;
-  return data_->partitions_[idx];
+  size_t idx = (it - partitions.begin()) / group_by * group_by;
+  return partitions[idx];
+}
+
+std::string YBTable::FindNextPartitionStart(const std::string& partition_key) const {
+  boost::shared_lock<rw_spinlock> lock(data_->partitions_mutex_);
+  const auto& partitions = data_->partitions_;
+  auto it = std::upper_bound(partitions.begin(), partitions.end(), partition_key);
+  return it == partitions.end() ? std::string() : *it;
+}
+
+void YBTable::UpdatePartitions(std::vector<std::string> partitions) {
+  std::sort(partitions.begin(), partitions.end());
+  std::lock_guard<rw_spinlock> lock(data_->partitions_mutex_);
+  data_->partitions_.swap(partitions);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1382,6 +1397,14 @@ void YBSession::SetTimeout(MonoDelta timeout) {
   data_->SetTimeout(timeout);
 }
 
+void YBSession::SetFollowerReadMaxStaleness(MonoDelta max_staleness) {
+  data_->SetFollowerReadMaxStaleness(max_staleness);
+}
+
+void YBSession::SetSingleTabletAutoCommit(bool enabled) {
+  data_->SetSingleTabletAutoCommit(enabled);
+}
+
 Status YBSession::Flush() {
   return data_->Flush();
 }
@@ -724,9 +724,13 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
 
   // Finds partition start for specified partition_key.
   // Partitions could be groupped by group_by bunches, in this case start of such bunch is returned.
-  const std::string& FindPartitionStart(
+  std::string FindPartitionStart(
       const std::string& partition_key, size_t group_by = 1) const;
 
+  // Finds start of the partition following the one that contains specified partition_key.
+  // Returns empty string if that partition is the last one.
+  std::string FindNextPartitionStart(const std::string& partition_key) const;
+
   //------------------------------------------------------------------------------------------------
   // Postgres support
   // Create a new QL operation for this table.
@@ -744,9 +748,14 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
 
   friend class YBClient;
   friend class internal::GetTableSchemaRpc;
+  friend class internal::MetaCache;
 
   YBTable(const std::shared_ptr<YBClient>& client, const Info& info);
 
+  // Replaces partitions of this table with the ones received from the master, e.g. after a tablet
+  // of this table was split.
+  void UpdatePartitions(std::vector<std::string> partitions);
+
   // Owned.
   Data* data_;
 
@@ -965,6 +974,20 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   // Set the timeout for writes made in this session.
   void SetTimeout(MonoDelta timeout);
 
+  // Bounds the staleness of CONSISTENT_PREFIX reads made in this session. Such reads are sent to
+  // the closest replica, and a replica whose safe time lags more than max_staleness behind, or
+  // does not include the last write done through this session, rejects the read so that it is
+  // retried on another replica, falling back to the leader. Uninitialized means no bound.
+  void SetFollowerReadMaxStaleness(MonoDelta max_staleness);
+
+  // Makes each flush of this session a single tablet auto-commit write. All operations of such
+  // flush should be writes to the same tablet. The tablet applies them as one regular write batch
+  // at a single hybrid time, in one Raft round, without a distributed transaction, so there are
+  // neither intents nor apply step. Flush that has reads, writes to several tablets, failed tablet
+  // lookups, or is done in context of a transaction, fails all its operations with IllegalState
+  // and nothing is sent.
+  void SetSingleTabletAutoCommit(bool enabled);
+
   CHECKED_STATUS ReadSync(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
   void ReadAsync(std::shared_ptr<YBOperation> yb_op, boost::function<void(const Status&)> callback);
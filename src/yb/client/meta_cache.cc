@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <limits>
 #include <mutex>
 
 #include <boost/bind.hpp>
@@ -650,7 +651,8 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         remote = new RemoteTablet(tablet_id, partition);
 
         CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-        CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+        // A tablet created by a split replaces the split tablet with the same partition start.
+        tablets_by_key[partition.partition_key_start()] = remote;
       }
       remote->Refresh(ts_cache_, loc.replicas());
 
@@ -874,6 +876,65 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
+class LookupFullTableRpc : public LookupRpc {
+ public:
+  LookupFullTableRpc(const scoped_refptr<MetaCache>& meta_cache,
+                     const YBTable* table,
+                     StatusCallback user_cb,
+                     const MonoTime& deadline,
+                     const shared_ptr<Messenger>& messenger)
+      : LookupRpc(meta_cache, deadline, messenger),
+        table_(table->shared_from_this()),
+        user_cb_(std::move(user_cb)) {
+  }
+
+  std::string ToString() const override {
+    return Format("GetTableLocations($0, all, $1)", table_->name(), num_attempts());
+  }
+
+  void DoSendRpc() override {
+    // Fill out the request.
+    req_.mutable_table()->set_table_id(table_->id());
+    req_.set_max_returned_locations(std::numeric_limits<int32_t>::max());
+    req_.set_require_tablets_running(true);
+
+    master_proxy()->GetTableLocationsAsync(
+        req_, &resp_, mutable_retrier()->mutable_controller(),
+        std::bind(&LookupFullTableRpc::Finished, this, Status::OK()));
+  }
+
+ private:
+  void Finished(const Status& status) override {
+    DoFinished(status, resp_, nullptr /* partition_group_start */);
+  }
+
+  void Notify(const Status& status, const RemoteTabletPtr& result) override {
+    if (status.ok()) {
+      std::vector<std::string> partitions;
+      partitions.reserve(resp_.tablet_locations().size());
+      for (const auto& tablet_location : resp_.tablet_locations()) {
+        partitions.push_back(tablet_location.partition().partition_key_start());
+      }
+      std::const_pointer_cast<YBTable>(table_)->UpdatePartitions(std::move(partitions));
+    }
+    user_cb_.Run(status);
+  }
+
+  // Table to lookup.
+  std::shared_ptr<const YBTable> table_;
+
+  // User-specified callback to invoke when the lookup finishes.
+  //
+  // Always invoked, regardless of success or failure.
+  StatusCallback user_cb_;
+
+  // Request body.
+  GetTableLocationsRequestPB req_;
+
+  // Response body.
+  GetTableLocationsResponsePB resp_;
+};
+
 RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* table,
                                                              const std::string& partition_key) {
   auto it = tables_.find(table->id());
@@ -932,7 +993,7 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const MonoTime& deadline,
                                   RemoteTabletPtr* remote_tablet,
                                   const StatusCallback& callback) {
-  const auto& partition_start = table->FindPartitionStart(partition_key);
+  auto partition_start = table->FindPartitionStart(partition_key);
 
   rpc::Rpcs::Handle rpc;
   {
@@ -942,8 +1003,7 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
     }
   }
 
-  const std::string& partition_group_start =
-      table->FindPartitionStart(partition_start, kPartitionGroupSize);
+  auto partition_group_start = table->FindPartitionStart(partition_start, kPartitionGroupSize);
   {
     std::unique_lock<boost::shared_mutex> lock(mutex_);
     if (FastLookupTabletByKeyUnlocked(table, partition_start, remote_tablet, callback, &lock)) {
@@ -991,6 +1051,13 @@ void MetaCache::LookupTabletById(const TabletId& tablet_id,
       this, callback, tablet_id, remote_tablet, deadline, client_->data_->messenger_);
 }
 
+void MetaCache::RefreshTablePartitions(const YBTable* table,
+                                       const MonoTime& deadline,
+                                       const StatusCallback& callback) {
+  rpc::StartRpc<LookupFullTableRpc>(
+      this, table, callback, deadline, client_->data_->messenger_);
+}
+
 void MetaCache::MarkTSFailed(RemoteTabletServer* ts,
                              const Status& status) {
   LOG(INFO) << "Marking tablet server " << ts->ToString() << " as failed.";
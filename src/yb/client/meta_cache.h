@@ -282,6 +282,15 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                         RemoteTabletPtr* remote_tablet,
                         const StatusCallback& callback);
 
+  // Fetches locations of all tablets of the table from the master, caches them and replaces
+  // partitions of the table with the received ones. Used to route operations again after a tablet
+  // of the table was split.
+  //
+  // NOTE: the memory referenced by 'table' must remain valid until 'callback' is invoked.
+  void RefreshTablePartitions(const YBTable* table,
+                              const MonoTime& deadline,
+                              const StatusCallback& callback);
+
   // Mark any replicas of any tablets hosted by 'ts' as failed. They will
   // not be returned in future cache lookups.
   void MarkTSFailed(RemoteTabletServer* ts, const Status& status);
@@ -297,6 +306,7 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   friend class LookupRpc;
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
+  friend class LookupFullTableRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
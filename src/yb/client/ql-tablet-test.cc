@@ -31,6 +31,7 @@
 #include "yb/master/master.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 
 #include "yb/server/skewed_clock.h"
 
@@ -654,5 +655,108 @@ TEST_F(QLTabletTest, SkewedClocks) {
   cluster_.reset();
 }
 
+TEST_F(QLTabletTest, FollowerReadsWithBoundedStaleness) {
+  TableHandle table;
+  CreateTable(kTable1Name, &table);
+
+  auto session = CreateSession();
+  session->SetFollowerReadMaxStaleness(MonoDelta::FromSeconds(1));
+
+  for (int i = 0; i != kTotalKeys; ++i) {
+    SetValue(session, i, ValueForKey(i), &table);
+
+    // Read should observe the write just done by this session, even if it is sent to a follower.
+    auto op = CreateReadOp(i, &table);
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    ASSERT_OK(session->Apply(op));
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+    auto rowblock = RowsResult(op.get()).GetRowBlock();
+    ASSERT_EQ(1, rowblock->row_count()) << "i: " << i;
+    ASSERT_EQ(ValueForKey(i), rowblock->row(0).column(0).int32_value()) << "i: " << i;
+  }
+
+  // Reads are sent to the closest replica, so some of them should be served by followers.
+  uint64_t follower_reads = 0;
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      if (peer->tablet_metadata()->table_id() != table->id() ||
+          peer->LeaderStatus() != consensus::Consensus::LeaderStatus::NOT_LEADER) {
+        continue;
+      }
+      follower_reads += peer->tablet()->metrics()->ql_read_latency->TotalCount();
+    }
+  }
+  LOG(INFO) << "Follower reads: " << follower_reads;
+  ASSERT_GT(follower_reads, 0U);
+}
+
+TEST_F(QLTabletTest, SplitTablet) {
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  FillTable(0, kTotalKeys, &table);
+  auto session = CreateSession();
+  ASSERT_TRUE(GetValue(session, 0, &table).is_initialized());
+
+  auto* catalog_manager = cluster_->mini_master()->master()->catalog_manager();
+  auto get_tablets = [catalog_manager, &table]() -> Result<std::vector<TabletId>> {
+    master::GetTableLocationsRequestPB req;
+    master::GetTableLocationsResponsePB resp;
+    req.set_max_returned_locations(std::numeric_limits<uint32_t>::max());
+    table.name().SetIntoTableIdentifierPB(req.mutable_table());
+    RETURN_NOT_OK(catalog_manager->GetTableLocations(&req, &resp));
+    std::vector<TabletId> result;
+    for (const auto& tablet : resp.tablet_locations()) {
+      result.push_back(tablet.tablet_id());
+    }
+    return result;
+  };
+
+  auto tablets = ASSERT_RESULT(get_tablets());
+  ASSERT_EQ(1, tablets.size());
+
+  master::SplitTabletRequestPB req;
+  master::SplitTabletResponsePB resp;
+  req.set_tablet_id(tablets.front());
+  ASSERT_OK(catalog_manager->SplitTablet(&req, &resp));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+
+  ASSERT_OK(WaitFor([&get_tablets]() -> Result<bool> {
+    return VERIFY_RESULT(get_tablets()).size() == 2;
+  }, 30s, "Wait for split"));
+
+  // Each replica of the split tablet creates the new tablets, and is deleted only after the new
+  // tablets are running on all their voters.
+  const auto new_tablets = ASSERT_RESULT(get_tablets());
+  ASSERT_OK(WaitFor([this, &tablets, &new_tablets]() {
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+      tablet::TabletPeerPtr peer;
+      if (tablet_manager->LookupTablet(tablets.front(), &peer)) {
+        return false;
+      }
+      for (const auto& tablet_id : new_tablets) {
+        if (!tablet_manager->LookupTablet(tablet_id, &peer) ||
+            peer->state() != tablet::RUNNING) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }, 30s, "Wait for split tablet replicas to be deleted"));
+
+  // The table and the session opened before the split are used, so operations routed to the split
+  // tablet with the cached partitions have to be routed again to the new tablets.
+  VerifyTable(0, kTotalKeys, &table);
+
+  for (int i = 0; i != kTotalKeys; ++i) {
+    SetValue(session, i, ValueForKey(i) + 1, &table);
+    auto value = GetValue(session, i, &table);
+    ASSERT_TRUE(value.is_initialized()) << "i: " << i;
+    ASSERT_EQ(ValueForKey(i) + 1, *value) << "i: " << i;
+  }
+}
+
 } // namespace client
 } // namespace yb
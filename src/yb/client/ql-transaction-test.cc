@@ -13,6 +13,7 @@
 //
 //
 
+#include <map>
 #include <thread>
 
 #include <boost/optional/optional.hpp>
@@ -27,17 +28,23 @@
 #include "yb/yql/cql/ql/util/errcodes.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
 
+#include "yb/gutil/strings/util.h"
+
+#include "yb/rocksdb/db.h"
+
 #include "yb/rpc/rpc.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/skewed_clock.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include "yb/util/path_util.h"
 #include "yb/util/random_util.h"
 
 using namespace std::literals; // NOLINT
@@ -56,6 +63,9 @@ DECLARE_uint64(max_clock_skew_usec);
 DECLARE_bool(transaction_allow_rerequest_status_in_tests);
 DECLARE_uint64(transaction_delay_status_reply_usec_in_tests);
 DECLARE_string(time_source);
+DECLARE_bool(enable_transaction_wait_queues);
+DECLARE_int32(transaction_conflict_max_wait_ms);
+DECLARE_bool(enable_transaction_status_batching);
 
 namespace yb {
 namespace client {
@@ -279,6 +289,46 @@ class QLTransactionTest : public QLDmlTestBase {
         transaction_manager_.get_ptr(), IsolationLevel::SNAPSHOT_ISOLATION);
   }
 
+  YBSessionPtr CreateSingleTabletSession(const YBTransactionPtr& transaction = nullptr) {
+    auto session = CreateSession(transaction);
+    session->SetSingleTabletAutoCommit(true);
+    return session;
+  }
+
+  // Returns 'count' keys, starting search from 'start', that belong to the same tablet.
+  std::vector<int32_t> SameTabletKeys(int32_t start, size_t count) {
+    std::vector<int32_t> result;
+    std::string tablet_start;
+    for (int32_t key = start; result.size() != count; ++key) {
+      const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+      QLAddInt32HashValue(op->mutable_request(), key);
+      std::string partition_key;
+      CHECK_OK(op->GetPartitionKey(&partition_key));
+      const auto& partition_start = table_->FindPartitionStart(partition_key);
+      if (result.empty()) {
+        tablet_start = partition_start;
+      } else if (partition_start != tablet_start) {
+        continue;
+      }
+      result.push_back(key);
+    }
+    return result;
+  }
+
+  // Writes rows with specified keys using single flush.
+  CHECKED_STATUS WriteRowsBatch(
+      const YBSessionPtr& session, const std::vector<int32_t>& keys, int32_t value) {
+    RETURN_NOT_OK(session->SetFlushMode(YBSession::MANUAL_FLUSH));
+    for (auto key : keys) {
+      const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+      auto* const req = op->mutable_request();
+      QLAddInt32HashValue(req, key);
+      table_.AddInt32ColumnValue(req, kValueColumn, value);
+      RETURN_NOT_OK(session->Apply(op));
+    }
+    return session->Flush();
+  }
+
   YBTransactionPtr CreateTransaction2() {
     return std::make_shared<YBTransaction>(
         transaction_manager2_.get_ptr(), IsolationLevel::SNAPSHOT_ISOLATION);
@@ -341,11 +391,30 @@ class QLTransactionTest : public QLDmlTestBase {
     return result;
   }
 
+  // Returns peers of tablets that store intents in a separate RocksDB, i.e. tablets of the
+  // transactional user table.
+  tserver::TSTabletManager::TabletPeers IntentsTabletPeers() {
+    tserver::TSTabletManager::TabletPeers result;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* tablet_manager = cluster_->mini_tablet_server(i)->server()->tablet_manager();
+      for (const auto& peer : tablet_manager->GetTabletPeers()) {
+        if (peer->tablet() && peer->tablet()->TEST_intents_db()) {
+          result.push_back(peer);
+        }
+      }
+    }
+    return result;
+  }
+
   // We write data with first transaction then try to read it another one.
   // If commit is true, then first transaction is committed and second should be restarted.
   // Otherwise second transaction would see pending intents from first one and should not restart.
   void TestReadRestart(bool commit = true);
 
+  // Checks that concurrent reads of a key that is being updated by transactions never see a value
+  // older than the one committed before the read started, while status replies are delayed.
+  void TestCorrectStatusRequestBatching();
+
   TableHandle table_;
   std::shared_ptr<server::SkewedClock> skewed_clock_{
       std::make_shared<server::SkewedClock>(WallClock())};
@@ -756,6 +825,67 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+// With wait queues non transactional write waits for the conflicting transaction, instead of
+// aborting it.
+TEST_F(QLTransactionTest, WaitForConflictingTransaction) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_transaction_wait_queues = true;
+  FLAGS_transaction_conflict_max_wait_ms = 60000;
+
+  auto transaction = CreateTransaction();
+  ASSERT_OK(WriteRow(CreateSession(transaction), 1, 1));
+
+  std::atomic<bool> written(false);
+  std::thread writer([this, &written] {
+    ASSERT_OK(WriteRow(CreateSession(), 1, 2));
+    written.store(true, std::memory_order_release);
+  });
+  BOOST_SCOPE_EXIT(&writer) {
+    writer.join();
+  } BOOST_SCOPE_EXIT_END;
+
+  std::this_thread::sleep_for(1s);
+  ASSERT_FALSE(written.load(std::memory_order_acquire));
+  ASSERT_OK(transaction->CommitFuture().get());
+  ASSERT_OK(WaitFor([&written] { return written.load(std::memory_order_acquire); },
+                    10s, "Write after commit"));
+
+  VERIFY_ROW(CreateSession(), 1, 2);
+}
+
+TEST_F(QLTransactionTest, WaitQueueDeadlock) {
+  google::FlagSaver flag_saver;
+  FLAGS_enable_transaction_wait_queues = true;
+  FLAGS_transaction_conflict_max_wait_ms = 3000;
+
+  // Deadlocks are detected only when all waits happen on the same tablet server, so both keys are
+  // taken from the same tablet.
+  const auto keys = SameTabletKeys(1, 2);
+  auto txn1 = CreateTransaction();
+  auto txn2 = CreateTransaction();
+  auto session1 = CreateSession(txn1);
+  auto session2 = CreateSession(txn2);
+  ASSERT_OK(WriteRow(session1, keys[0], 1));
+  ASSERT_OK(WriteRow(session2, keys[1], 2));
+
+  // Transaction 1 waits for transaction 2, until the wait deadline, then conflict is resolved
+  // as usual.
+  std::thread waiter([this, session1, &keys] {
+    auto result = WriteRow(session1, keys[1], 1);
+    LOG(INFO) << "Waiting write done: " << result.status();
+  });
+  BOOST_SCOPE_EXIT(&waiter) {
+    waiter.join();
+  } BOOST_SCOPE_EXIT_END;
+
+  std::this_thread::sleep_for(1s);
+  // Transaction 2 would wait for transaction 1, so it fails right away.
+  auto start = MonoTime::Now();
+  ASSERT_NOK(WriteRow(session2, keys[0], 2));
+  ASSERT_LT(MonoTime::Now() - start, MonoDelta::FromMilliseconds(
+      FLAGS_transaction_conflict_max_wait_ms));
+}
+
 TEST_F(QLTransactionTest, ResolveIntentsWriteReadUpdateRead) {
   google::FlagSaver flag_saver;
   DisableApplyingIntents();
@@ -915,7 +1045,7 @@ TEST_F(QLTransactionTest, ResolveIntentsCheckConsistency) {
 //
 // It is don't for multiple keys sequentially. So those keys are located on different tablets
 // and tablet servers, and we test different cases of clock skew.
-TEST_F(QLTransactionTest, CorrectStatusRequestBatching) {
+void QLTransactionTest::TestCorrectStatusRequestBatching() {
   const auto kClockSkew = 100ms;
   constexpr auto kMinWrites = RegularBuildVsSanitizers(25, 1);
   constexpr auto kMinReads = 10;
@@ -1009,6 +1139,16 @@ TEST_F(QLTransactionTest, CorrectStatusRequestBatching) {
   cluster_.reset();
 }
 
+TEST_F(QLTransactionTest, CorrectStatusRequestBatching) {
+  TestCorrectStatusRequestBatching();
+}
+
+// Same as above, but status requests of transactions with the same status tablet are batched.
+TEST_F(QLTransactionTest, CorrectStatusRequestBatchingWithMultiTransactionRequests) {
+  FLAGS_enable_transaction_status_batching = true;
+  TestCorrectStatusRequestBatching();
+}
+
 struct TransactionState {
   YBTransactionPtr transaction;
   std::shared_future<TransactionMetadata> metadata_future;
@@ -1023,29 +1163,31 @@ struct TransactionState {
     ASSERT_EQ(status_future.wait_for(NonTsanVsTsan(1s, 5s)), std::future_status::ready);
     auto resp = status_future.get();
     ASSERT_OK(resp);
+    ASSERT_EQ(1, resp->status().size());
+    ASSERT_EQ(1, resp->status_hybrid_time().size());
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    if (resp->status(0) == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (resp->status(0) == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status(0));
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(resp->status(0), TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(resp->status(0));
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = resp->status(0);
   }
 };
 
@@ -1107,7 +1249,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
@@ -1129,6 +1271,170 @@ TEST_F(QLTransactionTest, StatusEvolution) {
   }
 }
 
+// Requests status of several transactions with the same status tablet in a single RPC.
+TEST_F(QLTransactionTest, MultiTransactionStatusRequest) {
+  constexpr int kTransactions = 10;
+  std::vector<YBTransactionPtr> transactions;
+  std::map<TabletId, std::vector<TransactionId>> status_tablets;
+  for (int i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    {
+      auto session = CreateSession(txn);
+      ASSERT_OK(WriteRow(session, i, i));
+    }
+    auto metadata = txn->TEST_GetMetadata().get();
+    status_tablets[metadata.status_tablet].push_back(metadata.transaction_id);
+    transactions.push_back(txn);
+  }
+
+  rpc::Rpcs rpcs;
+  for (auto& entry : status_tablets) {
+    // Unknown transactions are reported as aborted.
+    entry.second.push_back(GenerateTransactionId());
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(entry.first);
+    for (const auto& id : entry.second) {
+      req.add_transaction_id(id.data, id.size());
+    }
+    auto resp = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
+        GetTransactionStatus, &rpcs)(
+            TransactionRpcDeadline(), nullptr /* tablet */, client_.get(), &req).get();
+    ASSERT_OK(resp);
+    ASSERT_EQ(entry.second.size(), resp->status().size());
+    ASSERT_EQ(entry.second.size(), resp->status_hybrid_time().size());
+    for (size_t i = 0; i + 1 < entry.second.size(); ++i) {
+      ASSERT_EQ(TransactionStatus::PENDING, resp->status(i));
+      ASSERT_TRUE(HybridTime(resp->status_hybrid_time(i)).is_valid());
+    }
+    ASSERT_EQ(TransactionStatus::ABORTED, resp->status(entry.second.size() - 1));
+  }
+
+  for (const auto& txn : transactions) {
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+}
+
+TEST_F(QLTransactionTest, SingleTablet) {
+  const auto keys = SameTabletKeys(0, kNumRows);
+
+  auto single_tablet_session = CreateSingleTabletSession();
+  ASSERT_OK(WriteRowsBatch(single_tablet_session, keys, 1));
+
+  auto session = CreateSession();
+  for (auto key : keys) {
+    VERIFY_ROW(session, key, 1);
+  }
+
+  // Single tablet write rewrites rows of a transaction.
+  auto txn = CreateTransaction();
+  ASSERT_OK(WriteRowsBatch(CreateSession(txn), keys, 2));
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_OK(WriteRowsBatch(single_tablet_session, keys, 3));
+  for (auto key : keys) {
+    VERIFY_ROW(session, key, 3);
+  }
+
+  // Writes to several tablets are rejected, so nothing is written.
+  int32_t other_key = keys.back() + 1;
+  std::string partition_key, other_partition_key;
+  {
+    const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+    QLAddInt32HashValue(op->mutable_request(), keys[0]);
+    ASSERT_OK(op->GetPartitionKey(&partition_key));
+  }
+  for (;; ++other_key) {
+    const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+    QLAddInt32HashValue(op->mutable_request(), other_key);
+    ASSERT_OK(op->GetPartitionKey(&other_partition_key));
+    if (table_->FindPartitionStart(partition_key) !=
+        table_->FindPartitionStart(other_partition_key)) {
+      break;
+    }
+  }
+  ASSERT_NOK(WriteRowsBatch(single_tablet_session, {keys[2], other_key}, 5));
+  VERIFY_ROW(session, keys[2], 3);
+  ASSERT_NOK(SelectRow(session, other_key));
+
+  // Reads are rejected.
+  {
+    ASSERT_OK(single_tablet_session->SetFlushMode(YBSession::MANUAL_FLUSH));
+    const auto op = ReadRow(single_tablet_session, keys[0]);
+    ASSERT_NOK(single_tablet_session->Flush());
+    ASSERT_FALSE(op->succeeded());
+  }
+
+  // Single tablet auto-commit is not a part of a transaction, so such session is rejected.
+  txn = CreateTransaction();
+  ASSERT_NOK(WriteRowsBatch(CreateSingleTabletSession(txn), {keys[3]}, 6));
+  txn->Abort();
+  VERIFY_ROW(session, keys[3], 3);
+}
+
+// Compares latency and throughput of small multi row writes confined to a single tablet,
+// executed as regular transactions and as single tablet auto-commit writes.
+TEST_F(QLTransactionTest, SingleTabletPerformance) {
+  constexpr size_t kRowsPerTransaction = 3;
+  constexpr size_t kThreads = 4;
+  const auto kDuration = NonTsanVsTsan(5s, 15s);
+
+  const auto keys = SameTabletKeys(0, kRowsPerTransaction * kThreads);
+
+  for (bool single_tablet : {false, true}) {
+    std::atomic<size_t> transactions(0);
+    std::atomic<int64_t> total_latency_us(0);
+    std::atomic<size_t> failures(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != kThreads; ++t) {
+      threads.emplace_back([this, t, single_tablet, &keys, &transactions, &total_latency_us,
+                            &failures, &stop] {
+        std::vector<int32_t> thread_keys(keys.begin() + t * kRowsPerTransaction,
+                                         keys.begin() + (t + 1) * kRowsPerTransaction);
+        int32_t value = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+          auto start = MonoTime::Now();
+          Status status;
+          if (single_tablet) {
+            status = WriteRowsBatch(CreateSingleTabletSession(), thread_keys, ++value);
+          } else {
+            auto txn = CreateTransaction();
+            status = WriteRowsBatch(CreateSession(txn), thread_keys, ++value);
+            if (status.ok()) {
+              status = txn->CommitFuture().get();
+            }
+          }
+          if (!status.ok()) {
+            LOG(WARNING) << "Write failed: " << status;
+            failures.fetch_add(1, std::memory_order_acq_rel);
+            continue;
+          }
+          total_latency_us.fetch_add(
+              (MonoTime::Now() - start).ToMicroseconds(), std::memory_order_acq_rel);
+          transactions.fetch_add(1, std::memory_order_acq_rel);
+        }
+      });
+    }
+
+    std::this_thread::sleep_for(kDuration);
+    stop.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ASSERT_GT(transactions.load(), 0);
+    LOG(INFO) << "Single tablet: " << single_tablet << ", transactions: " << transactions.load()
+              << ", failures: " << failures.load()
+              << ", throughput: " << transactions.load() * 1000 /
+                     std::chrono::duration_cast<std::chrono::milliseconds>(kDuration).count()
+              << " txn/s, average latency: " << total_latency_us.load() / transactions.load()
+              << " us";
+    if (single_tablet) {
+      ASSERT_EQ(failures.load(), 0);
+    }
+  }
+}
+
 // Writing multiple keys concurrently, each key is increasing by 1 at each step.
 // At the same time concurrently execute several transactions that read all those keys.
 // Suppose two transactions have read values t1_i and t2_i respectively.
@@ -1272,5 +1578,104 @@ TEST_F(QLTransactionTest, InsertDeleteWithClusterRestart) {
   }
 }
 
+// Intents RocksDB should not be flushed ahead of regular records written before its intents,
+// otherwise removed intents could be persisted while the applied records are lost after restart.
+TEST_F(QLTransactionTest, IntentsFlushedAfterRegularRecords) {
+  WriteData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  std::this_thread::sleep_for(1s); // Wait some time for intents to apply on followers.
+
+  size_t num_checked_peers = 0;
+  for (const auto& peer : IntentsTabletPeers()) {
+    auto* tablet = peer->tablet();
+    auto* regular_db = tablet->TEST_db();
+    uint64_t regular_entries = 0;
+    ASSERT_TRUE(regular_db->GetIntProperty(
+        rocksdb::DB::Properties::kNumEntriesActiveMemTable, &regular_entries));
+    if (regular_entries == 0) {
+      continue;
+    }
+
+    // Flush only intents, regular RocksDB should be flushed before the intents memtable is.
+    ASSERT_OK(tablet->TEST_intents_db()->Flush(rocksdb::FlushOptions()));
+
+    uint64_t active_entries = 0, immutable_entries = 0;
+    ASSERT_TRUE(regular_db->GetIntProperty(
+        rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries));
+    ASSERT_TRUE(regular_db->GetIntProperty(
+        rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries));
+    ASSERT_EQ(0U, active_entries + immutable_entries) << "Tablet: " << tablet->tablet_id();
+    auto op_ids = ASSERT_RESULT(tablet->MaxPersistentOpIds());
+    ASSERT_LE(op_ids.intents, op_ids.regular) << "Tablet: " << tablet->tablet_id();
+    ++num_checked_peers;
+  }
+  ASSERT_GT(num_checked_peers, 0U);
+
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData();
+}
+
+// Regular RocksDB is flushed while intents of a committed but not applied transaction stay only in
+// the intents memtable, so bootstrap should replay them from the intents flushed op id.
+TEST_F(QLTransactionTest, BootstrapWithLaggingIntents) {
+  WriteData();
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  std::this_thread::sleep_for(1s); // Wait some time for intents to apply on followers.
+
+  DisableApplyingIntents();
+  auto txn = CreateTransaction();
+  WriteRows(CreateSession(txn), 1);
+  ASSERT_OK(txn->CommitFuture().get());
+
+  size_t num_lagging_peers = 0;
+  for (const auto& peer : IntentsTabletPeers()) {
+    auto* tablet = peer->tablet();
+    ASSERT_OK(tablet->TEST_db()->Flush(rocksdb::FlushOptions()));
+    auto op_ids = ASSERT_RESULT(tablet->MaxPersistentOpIds());
+    LOG(INFO) << "Tablet: " << tablet->tablet_id() << ", persistent op ids: " << op_ids.ToString();
+    if (op_ids.intents < op_ids.regular) {
+      ++num_lagging_peers;
+    }
+  }
+  ASSERT_GT(num_lagging_peers, 0U);
+
+  ASSERT_OK(cluster_->RestartSync());
+
+  SetIgnoreApplyingProbability(0.0);
+  ASSERT_OK(WaitFor(
+      [this] { return CountTransactions() == 0; }, kTransactionApplyTime, "Transactions cleaned"));
+  VerifyData(2);
+}
+
+// Checkpoint, that is used by remote bootstrap, should contain files of the intents RocksDB.
+TEST_F(QLTransactionTest, CheckpointWithIntents) {
+  DisableApplyingIntents();
+  WriteData();
+
+  size_t num_intents_files = 0;
+  int checkpoint_idx = 0;
+  for (const auto& peer : IntentsTabletPeers()) {
+    auto* tablet = peer->tablet();
+    ASSERT_OK(tablet->Flush(tablet::FlushMode::kSync));
+
+    const auto dir = GetTestPath(Format("checkpoint-$0", checkpoint_idx++));
+    google::protobuf::RepeatedPtrField<tablet::FilePB> rocksdb_files;
+    ASSERT_OK(tablet->CreateCheckpoint(dir, &rocksdb_files));
+    ASSERT_TRUE(env_->FileExists(JoinPathSegments(dir, tablet::Tablet::kIntentsSubdir)));
+
+    const std::string intents_prefix = std::string(tablet::Tablet::kIntentsSubdir) + "/";
+    for (const auto& file : rocksdb_files) {
+      ASSERT_NE(tablet::Tablet::kIntentsSubdir, file.name());
+      ASSERT_TRUE(env_->FileExists(JoinPathSegments(dir, file.name()))) << file.name();
+      if (HasPrefixString(file.name(), intents_prefix) && HasSuffixString(file.name(), ".sst")) {
+        ++num_intents_files;
+      }
+    }
+  }
+  ASSERT_GT(num_intents_files, 0U);
+}
+
 } // namespace client
 } // namespace yb
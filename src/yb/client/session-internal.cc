@@ -120,6 +120,9 @@ void YBSessionData::FlushAsync(boost::function<void(const Status&)> callback) {
       flushed_batchers_.insert(old_batcher);
     }
     old_batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
+    old_batcher->SetFollowerReadOptions(follower_read_max_staleness_,
+                                        HybridTime(last_write_ht_.load(std::memory_order_acquire)));
+    old_batcher->set_single_tablet_auto_commit(single_tablet_auto_commit_);
     old_batcher->FlushAsync(std::move(callback));
   } else {
     callback(Status::OK());
@@ -219,6 +222,22 @@ void YBSessionData::SetTimeout(MonoDelta timeout) {
   }
 }
 
+void YBSessionData::SetFollowerReadMaxStaleness(MonoDelta max_staleness) {
+  follower_read_max_staleness_ = max_staleness;
+}
+
+void YBSessionData::SetSingleTabletAutoCommit(bool enabled) {
+  single_tablet_auto_commit_ = enabled;
+}
+
+void YBSessionData::UpdateLastWriteHybridTime(HybridTime ht) {
+  auto value = ht.ToUint64();
+  auto current = last_write_ht_.load(std::memory_order_acquire);
+  while (current < value &&
+         !last_write_ht_.compare_exchange_weak(current, value, std::memory_order_acq_rel)) {
+  }
+}
+
 int YBSessionData::CountBufferedOperations() const {
   CHECK_EQ(flush_mode_, YBSession::MANUAL_FLUSH);
   return batcher_ ? batcher_->CountBufferedOperations() : 0;
@@ -32,6 +32,7 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <atomic>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
@@ -82,6 +83,13 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   CHECKED_STATUS SetFlushMode(YBSession::FlushMode mode);
   void SetTimeout(MonoDelta timeout);
+  void SetFollowerReadMaxStaleness(MonoDelta max_staleness);
+  void SetSingleTabletAutoCommit(bool enabled);
+
+  // Called by Batcher when a write of this session succeeded, so that following bounded staleness
+  // reads are served only by replicas that already have it.
+  void UpdateLastWriteHybridTime(HybridTime ht);
+
   bool HasPendingOperations() const;
   int CountBufferedOperations() const;
 
@@ -132,6 +140,15 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   // Timeout for the next batch.
   MonoDelta timeout_;
 
+  // Max staleness of CONSISTENT_PREFIX reads, uninitialized if not bounded.
+  MonoDelta follower_read_max_staleness_;
+
+  // Whether each flush is a single tablet auto-commit write, see YBSession.
+  bool single_tablet_auto_commit_ = false;
+
+  // The highest tablet safe time returned by writes of this session. Updated from rpc threads.
+  std::atomic<uint64_t> last_write_ht_{HybridTime::kMin.ToUint64()};
+
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
 };
 
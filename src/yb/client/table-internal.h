@@ -37,6 +37,7 @@
 #include "yb/common/index.h"
 #include "yb/common/partition.h"
 #include "yb/client/client.h"
+#include "yb/util/locks.h"
 
 namespace yb {
 
@@ -61,6 +62,9 @@ class YBTable::Data {
   std::shared_ptr<YBClient> client_;
   YBTableType table_type_;
   const Info info_;
+
+  // Sorted partition starts of the table. Refreshed when a tablet of the table is split.
+  mutable rw_spinlock partitions_mutex_;
   std::vector<std::string> partitions_;
 
  private:
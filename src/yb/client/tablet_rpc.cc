@@ -45,10 +45,19 @@ TabletInvoker::TabletInvoker(bool consistent_prefix,
 TabletInvoker::~TabletInvoker() {}
 
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
+  // Replicas that failed this rpc, or rejected it because they were too stale, are skipped.
+  std::set<std::string> blacklist;
+  for (auto* ts : followers_) {
+    blacklist.insert(ts->permanent_uuid());
+  }
   std::vector<RemoteTabletServer*> candidates;
   current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
-                                              &candidates);
+                                              YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                              blacklist, &candidates);
+  if (!current_ts_ && !followers_.empty()) {
+    // The leader is never too stale, so fall back to it once all other replicas were rejected.
+    current_ts_ = tablet_->LeaderTServer();
+  }
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
@@ -210,6 +219,18 @@ bool TabletInvoker::Done(Status* status) {
     *status = resp_error_status;
   }
 
+  // The tablet was split, or the operation was routed with outdated table partitions. The tablet
+  // location has to be refreshed and the operation routed again with the current partitions.
+  // This rpc is finished, the owner of the rpc could route its operations again, see
+  // tablet_split().
+  if (ErrorCode(rpc_->response_error()) == tserver::TabletServerErrorPB::TABLET_SPLIT) {
+    tablet_split_ = true;
+    if (tablet_ != nullptr) {
+      tablet_->MarkStale();
+    }
+    *status = STATUS_FORMAT(NotFound, "Tablet $0 was split: $1", tablet_id_, *status);
+  }
+
   // Oops, we failed over to a replica that wasn't a LEADER. Unlikely as
   // we're using consensus configuration information from the master, but still possible
   // (e.g. leader restarted and became a FOLLOWER). Try again.
@@ -298,6 +319,11 @@ void TabletInvoker::LookupTabletCb(const Status& status) {
   // Unless we know that this status is persistent.
   // For instance if tablet was deleted, we would always receive "Not found".
   if (status.IsNotFound()) {
+    // The tablet is deleted after it was split, so operations could be routed to the new tablets.
+    tablet_split_ = true;
+    if (tablet_ != nullptr) {
+      tablet_->MarkStale();
+    }
     command_->Finished(status);
     return;
   }
@@ -67,6 +67,10 @@ class TabletInvoker {
   bool IsLocalCall() const;
 
   const RemoteTabletPtr& tablet() const { return tablet_; }
+
+  // Whether the tablet was split or deleted, so the operations of this rpc should be routed again
+  // using the current table partitions.
+  bool tablet_split() const { return tablet_split_; }
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy() const;
   YBClient& client() const { return *client_; }
   const RemoteTabletServer& current_ts() { return *current_ts_; }
@@ -120,6 +124,7 @@ class TabletInvoker {
 
   // Used to retry some failed RPCs.
   // Tablet servers that refused the write because they were followers at the time.
+  // For consistent prefix reads, tablet servers that were too stale to serve the read.
   // Cleared when new consensus configuration information arrives from the master.
   std::unordered_set<RemoteTabletServer*> followers_;
 
@@ -129,6 +134,8 @@ class TabletInvoker {
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
+
+  bool tablet_split_ = false;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
@@ -139,6 +139,14 @@ const std::string& YBRedisReadOp::GetKey() const {
 }
 
 Status YBRedisReadOp::GetPartitionKey(std::string *partition_key) const {
+  if (redis_read_request_->has_scan_request() &&
+      redis_read_request_->scan_request().request_type() ==
+          RedisScanRequestPB_ScanRequestType_SCAN) {
+    // SCAN is not bound to a key, it is routed to the tablet that holds the hash code it resumes at.
+    *partition_key = PartitionSchema::EncodeMultiColumnHashValue(
+        redis_read_request_->key_value().hash_code());
+    return Status::OK();
+  }
   const Slice& slice(redis_read_request_->key_value().key());
   return table_->partition_schema().EncodeRedisKey(slice, partition_key);
 }
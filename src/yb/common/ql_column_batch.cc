@@ -0,0 +1,252 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_column_batch.h"
+
+namespace yb {
+
+QLColumnVector::QLColumnVector(ColumnIdRep column_id, DataType data_type)
+    : column_id_(column_id), data_type_(data_type), layout_(LayoutFor(data_type)) {
+  if (layout_ == QLColumnVectorLayout::kBytes) {
+    offsets_.push_back(0);
+  }
+}
+
+QLColumnVectorLayout QLColumnVector::LayoutFor(DataType data_type) {
+  switch (data_type) {
+    case INT8: FALLTHROUGH_INTENDED;
+    case INT16: FALLTHROUGH_INTENDED;
+    case INT32: FALLTHROUGH_INTENDED;
+    case INT64: FALLTHROUGH_INTENDED;
+    case BOOL: FALLTHROUGH_INTENDED;
+    case TIMESTAMP:
+      return QLColumnVectorLayout::kInt;
+    case FLOAT: FALLTHROUGH_INTENDED;
+    case DOUBLE:
+      return QLColumnVectorLayout::kDouble;
+    case STRING: FALLTHROUGH_INTENDED;
+    case BINARY:
+      return QLColumnVectorLayout::kBytes;
+    default:
+      return QLColumnVectorLayout::kValue;
+  }
+}
+
+QLValuePB::ValueCase QLColumnVector::ValueCaseFor(DataType data_type) {
+  switch (data_type) {
+    case INT8: return QLValuePB::kInt8Value;
+    case INT16: return QLValuePB::kInt16Value;
+    case INT32: return QLValuePB::kInt32Value;
+    case INT64: return QLValuePB::kInt64Value;
+    case BOOL: return QLValuePB::kBoolValue;
+    case TIMESTAMP: return QLValuePB::kTimestampValue;
+    case FLOAT: return QLValuePB::kFloatValue;
+    case DOUBLE: return QLValuePB::kDoubleValue;
+    case STRING: return QLValuePB::kStringValue;
+    case BINARY: return QLValuePB::kBinaryValue;
+    default: return QLValuePB::VALUE_NOT_SET;
+  }
+}
+
+void QLColumnVector::AppendNull() {
+  is_null_.push_back(1);
+  switch (layout_) {
+    case QLColumnVectorLayout::kInt:
+      ints_.push_back(0);
+      return;
+    case QLColumnVectorLayout::kDouble:
+      doubles_.push_back(0);
+      return;
+    case QLColumnVectorLayout::kBytes:
+      offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+      return;
+    case QLColumnVectorLayout::kValue:
+      values_.emplace_back();
+      return;
+  }
+  FATAL_INVALID_ENUM_VALUE(QLColumnVectorLayout, layout_);
+}
+
+void QLColumnVector::AppendInt(int64_t value) {
+  DCHECK_EQ(layout_, QLColumnVectorLayout::kInt);
+  is_null_.push_back(0);
+  ints_.push_back(value);
+}
+
+void QLColumnVector::AppendDouble(double value) {
+  DCHECK_EQ(layout_, QLColumnVectorLayout::kDouble);
+  is_null_.push_back(0);
+  doubles_.push_back(value);
+}
+
+void QLColumnVector::AppendBytes(const Slice& value) {
+  DCHECK_EQ(layout_, QLColumnVectorLayout::kBytes);
+  is_null_.push_back(0);
+  bytes_.append(value.cdata(), value.size());
+  offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+}
+
+void QLColumnVector::AppendValue(const QLValuePB& value) {
+  if (IsNull(value)) {
+    AppendNull();
+    return;
+  }
+
+  if (layout_ == QLColumnVectorLayout::kValue) {
+    is_null_.push_back(0);
+    values_.push_back(value);
+    return;
+  }
+
+  if (value.value_case() != ValueCaseFor(data_type_)) {
+    LOG(DFATAL) << "Unexpected value " << value.ShortDebugString() << " for column "
+                << column_id_ << " of type " << DataType_Name(data_type_);
+    AppendNull();
+    return;
+  }
+
+  switch (value.value_case()) {
+    case QLValuePB::kInt8Value:
+      AppendInt(value.int8_value());
+      return;
+    case QLValuePB::kInt16Value:
+      AppendInt(value.int16_value());
+      return;
+    case QLValuePB::kInt32Value:
+      AppendInt(value.int32_value());
+      return;
+    case QLValuePB::kInt64Value:
+      AppendInt(value.int64_value());
+      return;
+    case QLValuePB::kBoolValue:
+      AppendInt(value.bool_value() ? 1 : 0);
+      return;
+    case QLValuePB::kTimestampValue:
+      AppendInt(value.timestamp_value());
+      return;
+    case QLValuePB::kFloatValue:
+      AppendDouble(value.float_value());
+      return;
+    case QLValuePB::kDoubleValue:
+      AppendDouble(value.double_value());
+      return;
+    case QLValuePB::kStringValue:
+      AppendBytes(value.string_value());
+      return;
+    case QLValuePB::kBinaryValue:
+      AppendBytes(value.binary_value());
+      return;
+    default:
+      break;
+  }
+  LOG(DFATAL) << "Unexpected value case: " << value.value_case();
+  AppendNull();
+}
+
+void QLColumnVector::GetValue(size_t row, QLValuePB* value) const {
+  if (IsNull(row)) {
+    SetNull(value);
+    return;
+  }
+
+  switch (data_type_) {
+    case INT8:
+      value->set_int8_value(static_cast<int8_t>(ints_[row]));
+      return;
+    case INT16:
+      value->set_int16_value(static_cast<int16_t>(ints_[row]));
+      return;
+    case INT32:
+      value->set_int32_value(static_cast<int32_t>(ints_[row]));
+      return;
+    case INT64:
+      value->set_int64_value(ints_[row]);
+      return;
+    case BOOL:
+      value->set_bool_value(ints_[row] != 0);
+      return;
+    case TIMESTAMP:
+      value->set_timestamp_value(ints_[row]);
+      return;
+    case FLOAT:
+      value->set_float_value(static_cast<float>(doubles_[row]));
+      return;
+    case DOUBLE:
+      value->set_double_value(doubles_[row]);
+      return;
+    case STRING:
+      value->set_string_value(bytes_value(row).ToBuffer());
+      return;
+    case BINARY:
+      value->set_binary_value(bytes_value(row).ToBuffer());
+      return;
+    default:
+      *value = values_[row];
+      return;
+  }
+}
+
+void QLColumnVector::Clear() {
+  is_null_.clear();
+  ints_.clear();
+  doubles_.clear();
+  bytes_.clear();
+  values_.clear();
+  offsets_.clear();
+  if (layout_ == QLColumnVectorLayout::kBytes) {
+    offsets_.push_back(0);
+  }
+}
+
+void QLColumnBatch::AddColumn(ColumnIdRep column_id, DataType data_type) {
+  DCHECK_EQ(num_rows_, 0);
+  columns_.emplace_back(column_id, data_type);
+}
+
+void QLColumnBatch::Clear() {
+  for (auto& column : columns_) {
+    column.Clear();
+  }
+  num_rows_ = 0;
+}
+
+const QLColumnVector* QLColumnBatch::FindColumn(ColumnIdRep column_id) const {
+  for (const auto& column : columns_) {
+    if (column.column_id() == column_id) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+void QLColumnBatch::AppendRow(const QLTableRow& row) {
+  for (auto& column : columns_) {
+    auto value = row.GetValue(column.column_id());
+    if (value) {
+      column.AppendValue(*value);
+    } else {
+      column.AppendNull();
+    }
+  }
+  FinishRow();
+}
+
+void QLColumnBatch::GetRow(size_t row, QLTableRow* table_row) const {
+  for (const auto& column : columns_) {
+    if (!column.IsNull(row)) {
+      column.GetValue(row, &table_row->AllocColumn(column.column_id()).value);
+    }
+  }
+}
+
+} // namespace yb
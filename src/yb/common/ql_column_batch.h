@@ -0,0 +1,121 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_COMMON_QL_COLUMN_BATCH_H
+#define YB_COMMON_QL_COLUMN_BATCH_H
+
+#include <string>
+#include <vector>
+
+#include "yb/common/ql_expr.h"
+#include "yb/util/enums.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Physical representation of the values of a column in QLColumnVector. Fixed-width types are
+// stored unboxed so that scans that only filter and aggregate do not have to build a QLValuePB per
+// cell. Other types are kept as QLValuePB.
+YB_DEFINE_ENUM(QLColumnVectorLayout, (kInt)(kDouble)(kBytes)(kValue));
+
+// Values of a single column for a batch of rows. Every row has a slot in the vector, null values
+// included.
+class QLColumnVector {
+ public:
+  QLColumnVector(ColumnIdRep column_id, DataType data_type);
+
+  static QLColumnVectorLayout LayoutFor(DataType data_type);
+
+  // Value case that a non-null QLValuePB of the given type has.
+  static QLValuePB::ValueCase ValueCaseFor(DataType data_type);
+
+  ColumnIdRep column_id() const { return column_id_; }
+  DataType data_type() const { return data_type_; }
+  QLColumnVectorLayout layout() const { return layout_; }
+  size_t size() const { return is_null_.size(); }
+
+  void AppendNull();
+  void AppendInt(int64_t value);
+  void AppendDouble(double value);
+  void AppendBytes(const Slice& value);
+  // Appends a value of any type, converting it to the layout of this vector.
+  void AppendValue(const QLValuePB& value);
+
+  bool IsNull(size_t row) const { return is_null_[row] != 0; }
+
+  int64_t int_value(size_t row) const { return ints_[row]; }
+  double double_value(size_t row) const { return doubles_[row]; }
+  Slice bytes_value(size_t row) const {
+    return Slice(bytes_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]);
+  }
+  const QLValuePB& value(size_t row) const { return values_[row]; }
+
+  // Converts the value at the given row back to its QLValuePB representation.
+  void GetValue(size_t row, QLValuePB* value) const;
+
+  void Clear();
+
+ private:
+  const ColumnIdRep column_id_;
+  const DataType data_type_;
+  const QLColumnVectorLayout layout_;
+
+  std::vector<uint8_t> is_null_;
+  std::vector<int64_t> ints_;
+  std::vector<double> doubles_;
+  // For kBytes, value of row i is stored in bytes_[offsets_[i], offsets_[i + 1]).
+  std::vector<uint32_t> offsets_;
+  std::string bytes_;
+  std::vector<QLValuePB> values_;
+};
+
+// A batch of rows stored column by column. The set of columns is fixed by the caller, which lets
+// an iterator fill the vectors directly without going through QLTableRow.
+class QLColumnBatch {
+ public:
+  QLColumnBatch() {}
+
+  void AddColumn(ColumnIdRep column_id, DataType data_type);
+
+  // Removes all rows, keeping the columns.
+  void Clear();
+
+  size_t num_rows() const { return num_rows_; }
+  size_t num_columns() const { return columns_.size(); }
+
+  QLColumnVector& column(size_t index) { return columns_[index]; }
+  const QLColumnVector& column(size_t index) const { return columns_[index]; }
+
+  // Returns the column with the given id, or nullptr if the batch does not have it.
+  const QLColumnVector* FindColumn(ColumnIdRep column_id) const;
+
+  // Must be called after a value was appended to every column.
+  void FinishRow() {
+    ++num_rows_;
+  }
+
+  // Appends a row from its QLTableRow representation. Absent columns are appended as nulls.
+  void AppendRow(const QLTableRow& row);
+
+  // Materializes the given row into a QLTableRow. Null columns are not allocated, same as
+  // DocRowwiseIterator does for absent columns.
+  void GetRow(size_t row, QLTableRow* table_row) const;
+
+ private:
+  std::vector<QLColumnVector> columns_;
+  size_t num_rows_ = 0;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COLUMN_BATCH_H
@@ -2,8 +2,11 @@
 // Copyright (c) YugaByte, Inc.
 //--------------------------------------------------------------------------------------------------
 
+#include <cmath>
+
 #include <yb/util/jsonb.h>
 #include "yb/common/ql_expr.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/ql_bfunc.h"
 
 namespace yb {
@@ -375,6 +378,175 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 #undef QL_EVALUATE_BETWEEN
 }
 
+namespace {
+
+// Three-way comparison with the same semantics as Compare(QLValuePB, QLValuePB): NaN is equal to
+// NaN and greater than any other value.
+int CompareDoubles(double lhs, double rhs) {
+  const bool lhs_is_nan = std::isnan(lhs);
+  const bool rhs_is_nan = std::isnan(rhs);
+  if (lhs_is_nan || rhs_is_nan) {
+    return lhs_is_nan == rhs_is_nan ? 0 : (lhs_is_nan ? 1 : -1);
+  }
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+bool RelationHolds(QLOperator op, int cmp) {
+  switch (op) {
+    case QL_OP_EQUAL: return cmp == 0;
+    case QL_OP_NOT_EQUAL: return cmp != 0;
+    case QL_OP_LESS_THAN: return cmp < 0;
+    case QL_OP_LESS_THAN_EQUAL: return cmp <= 0;
+    case QL_OP_GREATER_THAN: return cmp > 0;
+    case QL_OP_GREATER_THAN_EQUAL: return cmp >= 0;
+    default: break;
+  }
+  LOG(DFATAL) << "Unexpected relational operator " << op;
+  return false;
+}
+
+int64_t ConstantToInt(const QLValuePB& value) {
+  switch (value.value_case()) {
+    case QLValuePB::kInt8Value: return value.int8_value();
+    case QLValuePB::kInt16Value: return value.int16_value();
+    case QLValuePB::kInt32Value: return value.int32_value();
+    case QLValuePB::kInt64Value: return value.int64_value();
+    case QLValuePB::kBoolValue: return value.bool_value() ? 1 : 0;
+    case QLValuePB::kTimestampValue: return value.timestamp_value();
+    default: break;
+  }
+  LOG(DFATAL) << "Unexpected value case " << value.value_case();
+  return 0;
+}
+
+// Evaluates "<column> <op> <constant>" on the column vector. Null values never satisfy the
+// relation because the constant is not null.
+template <class Compare>
+void RestrictSelection(
+    QLOperator op, const QLColumnVector& column, const Compare& compare,
+    std::vector<uint8_t>* selection) {
+  for (size_t row = 0; row != selection->size(); ++row) {
+    auto& selected = (*selection)[row];
+    if (selected) {
+      selected = !column.IsNull(row) && RelationHolds(op, compare(row));
+    }
+  }
+}
+
+// Returns the column vector when the condition is a comparison of a column with a non-null
+// constant of the same type that can be evaluated on the unboxed values.
+const QLColumnVector* VectorizableComparison(const QLConditionPB& condition,
+                                             const QLColumnBatch& batch) {
+  switch (condition.op()) {
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL:
+      break;
+    default:
+      return nullptr;
+  }
+  const auto& operands = condition.operands();
+  if (operands.size() != 2 || !operands.Get(0).has_column_id() || !operands.Get(1).has_value()) {
+    return nullptr;
+  }
+  const QLColumnVector* column = batch.FindColumn(operands.Get(0).column_id());
+  if (column == nullptr || column->layout() == QLColumnVectorLayout::kValue ||
+      operands.Get(1).value().value_case() != QLColumnVector::ValueCaseFor(column->data_type())) {
+    return nullptr;
+  }
+  return column;
+}
+
+} // namespace
+
+CHECKED_STATUS QLExprExecutor::EvalBatchCondition(const QLConditionPB& condition,
+                                                  const QLColumnBatch& batch,
+                                                  std::vector<uint8_t>* selection) {
+  DCHECK_EQ(selection->size(), batch.num_rows());
+  const auto& operands = condition.operands();
+
+  switch (condition.op()) {
+    case QL_OP_AND:
+      CHECK_GT(operands.size(), 0);
+      for (const auto &operand : operands) {
+        CHECK_EQ(operand.expr_case(), QLExpressionPB::ExprCase::kCondition);
+        RETURN_NOT_OK(EvalBatchCondition(operand.condition(), batch, selection));
+      }
+      return Status::OK();
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL: {
+      CHECK_EQ(operands.size(), 1);
+      const QLColumnVector* column = operands.Get(0).has_column_id()
+          ? batch.FindColumn(operands.Get(0).column_id()) : nullptr;
+      if (column == nullptr) {
+        break;
+      }
+      const bool expect_null = condition.op() == QL_OP_IS_NULL;
+      for (size_t row = 0; row != selection->size(); ++row) {
+        auto& selected = (*selection)[row];
+        selected = selected && column->IsNull(row) == expect_null;
+      }
+      return Status::OK();
+    }
+
+    default: {
+      const QLColumnVector* column = VectorizableComparison(condition, batch);
+      if (column == nullptr) {
+        break;
+      }
+      const QLValuePB& constant = operands.Get(1).value();
+      switch (column->layout()) {
+        case QLColumnVectorLayout::kInt: {
+          const int64_t rhs = ConstantToInt(constant);
+          RestrictSelection(condition.op(), *column, [column, rhs](size_t row) {
+            const int64_t lhs = column->int_value(row);
+            return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+          }, selection);
+          return Status::OK();
+        }
+        case QLColumnVectorLayout::kDouble: {
+          const double rhs = constant.value_case() == QLValuePB::kFloatValue
+              ? constant.float_value() : constant.double_value();
+          RestrictSelection(condition.op(), *column, [column, rhs](size_t row) {
+            return CompareDoubles(column->double_value(row), rhs);
+          }, selection);
+          return Status::OK();
+        }
+        case QLColumnVectorLayout::kBytes: {
+          const Slice rhs = constant.value_case() == QLValuePB::kStringValue
+              ? Slice(constant.string_value()) : Slice(constant.binary_value());
+          RestrictSelection(condition.op(), *column, [column, &rhs](size_t row) {
+            return column->bytes_value(row).compare(rhs);
+          }, selection);
+          return Status::OK();
+        }
+        case QLColumnVectorLayout::kValue:
+          break;
+      }
+      break;
+    }
+  }
+
+  // Evaluate the condition for each selected row separately.
+  QLTableRow row;
+  for (size_t i = 0; i != selection->size(); ++i) {
+    auto& selected = (*selection)[i];
+    if (!selected) {
+      continue;
+    }
+    row.Clear();
+    batch.GetRow(i, &row);
+    bool match = false;
+    RETURN_NOT_OK(EvalCondition(condition, row, &match));
+    selected = match;
+  }
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 
 bfpg::TSOpcode QLExprExecutor::GetTSWriteInstruction(const PgsqlExpressionPB& ql_expr) const {
@@ -13,6 +13,8 @@
 
 namespace yb {
 
+class QLColumnBatch;
+
 // TODO(neil)
 // - This should be maping directly from "int32_t" to QLValue.
 //   using ValueMap = std::unordered_map<int32_t, const QLValuePB>;
@@ -182,6 +184,14 @@ class QLExprExecutor {
                                        const QLTableRow& table_row,
                                        QLValue *result);
 
+  // Evaluate a boolean condition for all rows of the batch. Clears the selection entries of the
+  // rows that do not satisfy the condition, rows that are already unselected are not evaluated.
+  // Comparisons of a column with a constant are evaluated on the column vectors, other conditions
+  // are evaluated row by row.
+  CHECKED_STATUS EvalBatchCondition(const QLConditionPB& condition,
+                                    const QLColumnBatch& batch,
+                                    std::vector<uint8_t>* selection);
+
   //------------------------------------------------------------------------------------------------
   // PGSQL Support.
 
@@ -23,6 +23,7 @@ namespace yb {
 class HybridTime;
 class PgsqlReadRequestPB;
 class PgsqlResponsePB;
+class QLColumnBatch;
 class QLReadRequestPB;
 class QLResponsePB;
 class QLTableRow;
@@ -74,6 +75,12 @@ class YQLRowwiseIteratorIf {
     return Status::OK();
   }
 
+  // Appends up to max_rows next rows to the batch, filling the columns the batch was set up with.
+  // Columns that are absent from a row are appended as nulls. The default implementation reads the
+  // rows one by one using the iterator's schema, iterators that can produce column values without
+  // building a QLTableRow should override it.
+  virtual CHECKED_STATUS NextBatch(size_t max_rows, QLColumnBatch* batch);
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
@@ -15,6 +15,8 @@
 
 #include "yb/common/ql_scanspec.h"
 
+#include "yb/common/ql_column_batch.h"
+
 namespace yb {
 namespace common {
 
@@ -137,13 +139,25 @@ QLScanRange::QLScanRange(const Schema& schema, const QLConditionPB& condition)
     case QL_OP_IN: {
       if (has_range_column) {
         QL_GET_COLUMN_VALUE_EXPR_ELSE_RETURN(col_expr, val_expr);
-        // - <column> IN (<value>) --> min/max values = <value>
-        // TODO(Mihnea) handle the other cases here too
-        if (val_expr->value().list_value().elems_size() == 1) {
-          QLValuePB value = val_expr->value().list_value().elems(0);
-          const ColumnId column_id(col_expr->column_id());
-          ranges_.at(column_id).min_value = value;
-          ranges_.at(column_id).max_value = value;
+        // - <column> IN (<value_1>, ..., <value_n>) --> min/max values = min/max of <value_i>
+        // The individual values are seeked to by DocRowwiseIterator using the scan spec's range
+        // options, the bounds just narrow the initial seek and the file filter.
+        bool has_value = false;
+        QLRange values_range;
+        for (const auto& value : val_expr->value().list_value().elems()) {
+          if (IsNull(value)) {
+            continue;
+          }
+          if (!has_value || value < values_range.min_value) {
+            values_range.min_value = value;
+          }
+          if (!has_value || value > values_range.max_value) {
+            values_range.max_value = value;
+          }
+          has_value = true;
+        }
+        if (has_value) {
+          ranges_.at(ColumnId(col_expr->column_id())) = values_range;
         }
       }
       return;
@@ -313,5 +327,14 @@ CHECKED_STATUS QLScanSpec::Match(const QLTableRow& table_row, bool* match) const
   return Status::OK();
 }
 
+CHECKED_STATUS QLScanSpec::MatchBatch(const QLColumnBatch& batch,
+                                      std::vector<uint8_t>* selection) const {
+  selection->assign(batch.num_rows(), 1);
+  if (condition_ != nullptr) {
+    return executor_->EvalBatchCondition(*condition_, batch, selection);
+  }
+  return Status::OK();
+}
+
 } // namespace common
 } // namespace yb
@@ -99,6 +99,10 @@ class QLScanSpec : public YQLScanSpec {
   // virtual to make the class polymorphic.
   virtual CHECKED_STATUS Match(const QLTableRow& table_row, bool* match) const;
 
+  // Evaluate the WHERE condition for all rows of the batch. Sets selection entries of the rows
+  // that are selected to 1 and others to 0.
+  CHECKED_STATUS MatchBatch(const QLColumnBatch& batch, std::vector<uint8_t>* selection) const;
+
   bool is_forward_scan() const {
     return is_forward_scan_;
   }
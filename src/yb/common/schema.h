@@ -360,13 +360,15 @@ class TableProperties {
       : default_time_to_live_(kNoDefaultTtl),
         contain_counters_(false),
         is_transactional_(false),
-        copartition_table_id_(kNoCopartitionTableId) {}
+        copartition_table_id_(kNoCopartitionTableId),
+        num_range_components_in_bloom_filter_(0) {}
 
   TableProperties(const TableProperties& other) {
     default_time_to_live_ = other.default_time_to_live_;
     contain_counters_ = other.contain_counters_;
     is_transactional_ = other.is_transactional_;
     copartition_table_id_ = other.copartition_table_id_;
+    num_range_components_in_bloom_filter_ = other.num_range_components_in_bloom_filter_;
   }
 
   // Containing counters is a internal property instead of a user-defined property, so we don't use
@@ -419,6 +421,14 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  size_t num_range_components_in_bloom_filter() const {
+    return num_range_components_in_bloom_filter_;
+  }
+
+  void SetNumRangeComponentsInBloomFilter(size_t num_range_components_in_bloom_filter) {
+    num_range_components_in_bloom_filter_ = num_range_components_in_bloom_filter;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const {
     if (HasDefaultTimeToLive()) {
       pb->set_default_time_to_live(default_time_to_live_);
@@ -428,6 +438,9 @@ class TableProperties {
     if (HasCopartitionTableId()) {
       pb->set_copartition_table_id(copartition_table_id_);
     }
+    if (num_range_components_in_bloom_filter_ != 0) {
+      pb->set_num_range_components_in_bloom_filter(num_range_components_in_bloom_filter_);
+    }
   }
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -444,6 +457,10 @@ class TableProperties {
     if (pb.has_copartition_table_id()) {
       table_properties.SetCopartitionTableId(pb.copartition_table_id());
     }
+    if (pb.has_num_range_components_in_bloom_filter()) {
+      table_properties.SetNumRangeComponentsInBloomFilter(
+          pb.num_range_components_in_bloom_filter());
+    }
     return table_properties;
   }
 
@@ -464,6 +481,7 @@ class TableProperties {
     contain_counters_ = false;
     is_transactional_ = false;
     copartition_table_id_ = kNoCopartitionTableId;
+    num_range_components_in_bloom_filter_ = 0;
   }
 
  private:
@@ -472,6 +490,9 @@ class TableProperties {
   bool contain_counters_;
   bool is_transactional_;
   TableId copartition_table_id_;
+  // Filter keys of the table DocDB are built from the hashed components and this number of range
+  // components. It defines the format of the table's bloom filters, so it is never altered.
+  size_t num_range_components_in_bloom_filter_;
 };
 
 // The schema for a set of rows.
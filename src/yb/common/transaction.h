@@ -16,6 +16,9 @@
 #ifndef YB_COMMON_TRANSACTION_H
 #define YB_COMMON_TRANSACTION_H
 
+#include <functional>
+#include <vector>
+
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -107,6 +110,17 @@ class TransactionStatusManager {
   virtual boost::optional<TransactionMetadata> Metadata(const TransactionId& id) = 0;
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
+
+  // Invokes callback once one of the blockers is applied or aborted in this tablet, or deadline is
+  // reached. The callback is invoked from a thread that is allowed to block.
+  // waiter - transaction that is blocked, if any. It is used to detect deadlocks, in this case
+  // callback is invoked with TryAgain without waiting.
+  virtual void WaitForTransactions(const boost::optional<TransactionId>& waiter,
+                                   const std::vector<TransactionId>& blockers,
+                                   MonoTime deadline,
+                                   std::function<void(const Status&)> callback) {
+    callback(STATUS(NotSupported, "Waiting for transactions is not supported"));
+  }
 };
 
 struct TransactionOperationContext {
@@ -67,6 +67,13 @@ DEFINE_int32(consensus_rpc_timeout_ms, 3000,
              "Timeout used for all consensus internal RPC communications.");
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
+DEFINE_bool(consensus_send_ops_as_sidecars, false,
+            "Send replicated operations to followers as RPC request sidecars, written to the "
+            "socket directly from the serialized operations kept in the log cache, instead of "
+            "serializing them as a part of every UpdateConsensus request. All tablet servers "
+            "should be able to parse such requests before it is turned on.");
+TAG_FLAG(consensus_send_ops_as_sidecars, advanced);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -187,7 +194,8 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   int64_t commit_index_before = request_.has_committed_index() ?
       request_.committed_index().index() : kMinimumOpIdIndex;
   Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
+      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful,
+      FLAGS_consensus_send_ops_as_sidecars ? &serialized_ops_ : nullptr);
   int64_t commit_index_after = request_.has_committed_index() ?
       request_.committed_index().index() : kMinimumOpIdIndex;
 
@@ -262,6 +270,17 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
   controller_.Reset();
 
+  if (!serialized_ops_.empty()) {
+    // The ops are sent straight from the buffers kept in the log cache, so they are removed from
+    // the request instead of being serialized once more. replicate_msg_refs_ keeps them alive.
+    DCHECK_EQ(serialized_ops_.size(), static_cast<size_t>(request_.ops_size()));
+    request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), /* elements */ nullptr);
+    for (auto& op : serialized_ops_) {
+      request_.add_ops_sidecars(controller_.AddRequestSidecar(std::move(op)));
+    }
+    serialized_ops_.clear();
+  }
+
   proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
                       std::bind(&Peer::ProcessResponse, this));
 }
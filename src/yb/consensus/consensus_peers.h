@@ -49,6 +49,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/locks.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/resettable_heartbeater.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/status.h"
@@ -221,6 +222,9 @@ class Peer {
   // them.
   ReplicateMsgs replicate_msg_refs_;
 
+  // Serialized form of the ops in request_, filled only when ops are sent as request sidecars.
+  std::vector<RefCntBuffer> serialized_ops_;
+
   rpc::RpcController controller_;
 
   // Held if there is an outstanding request.  This is used in order to ensure that we only have a
@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <map>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -52,6 +53,7 @@ DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
 DECLARE_int32(log_min_segments_to_retain);
+DECLARE_int32(log_min_bytes_to_compress);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
 DECLARE_int32(o_direct_block_alignment_bytes);
@@ -802,6 +804,45 @@ TEST_F(LogTest, TestWriteManyBatches) {
   }
 }
 
+// Checks that compressed entry batches take less space in the segment and are read back unchanged.
+TEST_F(LogTest, TestEntryCompression) {
+  FLAGS_log_min_bytes_to_compress = 0;
+  const std::string kValue(1000, 'x');
+  const int kNumBatches = 10;
+
+  std::map<LogEntryCompression, int64_t> entries_size;
+  for (auto compression : kLogEntryCompressionList) {
+    tablet_wal_path_ = GetTestPath(ToString(compression));
+    options_.entry_compression = compression;
+    BuildLog();
+    for (int i = 1; i <= kNumBatches; ++i) {
+      AppendReplicateBatch(MakeOpId(1, i), MakeOpId(0, 0), { TupleForAppend(i, 0, kValue) });
+    }
+    ASSERT_OK(log_->Close());
+
+    std::unique_ptr<LogReader> reader;
+    ASSERT_OK(LogReader::Open(fs_manager_.get(), nullptr, kTestTablet, tablet_wal_path_, nullptr,
+                              &reader));
+    SegmentSequence segments;
+    ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+    ASSERT_EQ(1, segments.size());
+    entries_.clear();
+    ASSERT_OK(segments[0]->ReadEntries(&entries_));
+    ASSERT_EQ(kNumBatches, entries_.size());
+    for (int i = 0; i != kNumBatches; ++i) {
+      ASSERT_EQ(i + 1, entries_[i]->replicate().id().index());
+      const auto& write_batch = entries_[i]->replicate().write_request().write_batch();
+      ASSERT_EQ(2, write_batch.kv_pairs_size());
+      ASSERT_EQ(PrimitiveValue(kValue).ToValue(), write_batch.kv_pairs(1).value());
+    }
+    entries_size[compression] = segments[0]->readable_up_to() - segments[0]->first_entry_offset();
+  }
+
+  LOG(INFO) << "Segment sizes: " << yb::ToString(entries_size);
+  ASSERT_LT(entries_size[LogEntryCompression::kSnappy], entries_size[LogEntryCompression::kNone]);
+  ASSERT_LT(entries_size[LogEntryCompression::kLz4], entries_size[LogEntryCompression::kNone]);
+}
+
 // This tests that querying LogReader works.
 // This sets up a reader with some segments to query which amount to the
 // following:
@@ -39,6 +39,7 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/scope_exit.hpp>
 #include "yb/common/wire_protocol.h"
+#include "yb/consensus/log_group_committer.h"
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
@@ -167,16 +168,31 @@ class Log::Appender {
   void Shutdown();
 
  private:
+  typedef std::vector<std::unique_ptr<LogEntryBatch>> EntryBatches;
+
   // Process the given log entry batch or does a sync if a null is passed.
   void ProcessBatch(LogEntryBatch* entry_batch);
   void GroupWork();
 
+  // Hands the sync of sync_batch_ over to the group committer, the callbacks are invoked from its
+  // thread once the sync is done.
+  void SubmitToGroupCommitter(LogGroupCommitter* group_committer);
+
+  // Invokes the callbacks of the given batches with the result of their sync and clears them.
+  void RunCallbacks(const Status& status, EntryBatches* batches);
+
   Log* const log_;
 
   // Lock to protect access to thread_ during shutdown.
   mutable std::mutex lock_;
   unique_ptr<TaskStream<LogEntryBatch>> task_stream_;
 
+  // Number of groups handed over to the group committer whose callbacks were not invoked yet.
+  // Shutdown waits for it to drop to zero, so no callback runs after the log is closed.
+  std::mutex group_commit_mutex_;
+  std::condition_variable group_commit_cond_;
+  size_t pending_group_commits_ = 0;
+
   // vector of entry batches in group, to execute callbacks after call to Sync.
   std::vector<std::unique_ptr<LogEntryBatch>> sync_batch_;
 
@@ -227,6 +243,7 @@ void Log::Appender::ProcessBatch(LogEntryBatch* entry_batch) {
     return;
   }
   if (!log_->sync_disabled_) {
+    std::lock_guard<std::mutex> lock(log_->segment_mutex_);
     bool expected = false;
     if (log_->periodic_sync_needed_.compare_exchange_strong(expected, true,
                                                             std::memory_order_acq_rel)) {
@@ -247,6 +264,12 @@ void Log::Appender::GroupWork() {
   }
   TRACE_EVENT1("log", "batch", "batch_size", sync_batch_.size());
 
+  auto* group_committer = log_->options_.group_committer;
+  if (group_committer != nullptr) {
+    SubmitToGroupCommitter(group_committer);
+    return;
+  }
+
   BOOST_SCOPE_EXIT(this_) {
     if (this_->log_->metrics_) {
       MonoTime time_now = MonoTime::Now();
@@ -256,20 +279,58 @@ void Log::Appender::GroupWork() {
     this_->sync_batch_.clear();
   } BOOST_SCOPE_EXIT_END;
 
-  Status s = log_->Sync();
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG(ERROR) << "Error syncing log" << s.ToString();
-    DLOG(FATAL) << "Aborting: " << s.ToString();
-    for (std::unique_ptr<LogEntryBatch>& entry_batch : sync_batch_) {
+  RunCallbacks(log_->Sync(), &sync_batch_);
+  VLOG(1) << "Exiting AppendTask for tablet " << log_->tablet_id();
+}
+
+void Log::Appender::SubmitToGroupCommitter(LogGroupCommitter* group_committer) {
+  auto batches = std::make_shared<EntryBatches>(std::move(sync_batch_));
+  sync_batch_.clear();
+  {
+    std::lock_guard<std::mutex> lock(group_commit_mutex_);
+    ++pending_group_commits_;
+  }
+
+  Log* log = log_;
+  auto time_started = time_started_;
+  auto status = group_committer->Submit(
+      log->tablet_wal_path_, log,
+      [log] { return log->Sync(); },
+      [this, batches, time_started](const Status& status) {
+        RunCallbacks(status, batches.get());
+        if (log_->metrics_) {
+          log_->metrics_->group_commit_latency->Increment(
+              MonoTime::Now().GetDeltaSince(time_started).ToMicroseconds());
+        }
+        std::lock_guard<std::mutex> lock(group_commit_mutex_);
+        if (--pending_group_commits_ == 0) {
+          group_commit_cond_.notify_all();
+        }
+      });
+  if (PREDICT_FALSE(!status.ok())) {
+    // The committer is shutting down, sync on this thread as usual.
+    {
+      std::lock_guard<std::mutex> lock(group_commit_mutex_);
+      --pending_group_commits_;
+    }
+    RunCallbacks(log_->Sync(), batches.get());
+  }
+}
+
+void Log::Appender::RunCallbacks(const Status& status, EntryBatches* batches) {
+  if (PREDICT_FALSE(!status.ok())) {
+    LOG(ERROR) << "Error syncing log" << status.ToString();
+    DLOG(FATAL) << "Aborting: " << status.ToString();
+    for (std::unique_ptr<LogEntryBatch>& entry_batch : *batches) {
       if (!entry_batch->callback().is_null()) {
-        entry_batch->callback().Run(s);
+        entry_batch->callback().Run(status);
       }
     }
   } else {
     TRACE_EVENT0("log", "Callbacks");
-    VLOG(2) << "Synchronized " << sync_batch_.size() << " entry batches";
+    VLOG(2) << "Synchronized " << batches->size() << " entry batches";
     SCOPED_WATCH_STACK(FLAGS_consensus_log_scoped_watch_delay_callback_threshold_ms);
-    for (std::unique_ptr<LogEntryBatch>& entry_batch : sync_batch_) {
+    for (std::unique_ptr<LogEntryBatch>& entry_batch : *batches) {
       if (PREDICT_TRUE(!entry_batch->failed_to_append() && !entry_batch->callback().is_null())) {
         entry_batch->callback().Run(Status::OK());
       }
@@ -277,9 +338,8 @@ void Log::Appender::GroupWork() {
       // from memory trackers, and the callback of a later batch may want to use that memory.
       entry_batch.reset();
     }
-    sync_batch_.clear();
   }
-  VLOG(1) << "Exiting AppendTask for tablet " << log_->tablet_id();
+  batches->clear();
 }
 
 void Log::Appender::Shutdown() {
@@ -290,6 +350,8 @@ void Log::Appender::Shutdown() {
     VLOG(1) << "Log append task stream for tablet " << log_->tablet_id() << " is shut down";
     task_stream_.reset();
   }
+  std::unique_lock<std::mutex> group_commit_lock(group_commit_mutex_);
+  group_commit_cond_.wait(group_commit_lock, [this] { return pending_group_commits_ == 0; });
 }
 
 // This task is submitted to allocation_pool_ in order to asynchronously pre-allocate new log
@@ -425,15 +487,18 @@ Status Log::CloseCurrentSegment() {
   return active_segment_->WriteFooterAndClose(footer_builder_);
 }
 
-Status Log::RollOver() {
+Status Log::RollOver(std::unique_lock<std::mutex>* segment_lock) {
   SCOPED_LATENCY_METRIC(metrics_, roll_latency);
 
+  // The segment being synced should not be closed.
+  WaitForSyncToFinish(segment_lock);
+
   // Check if any errors have occurred during allocation
   RETURN_NOT_OK(allocation_status_.Get());
 
   DCHECK_EQ(allocation_state(), kAllocationFinished);
 
-  RETURN_NOT_OK(Sync());
+  RETURN_NOT_OK(SyncUnlocked());
   RETURN_NOT_OK(CloseCurrentSegment());
 
   RETURN_NOT_OK(SwitchToAllocatedSegment());
@@ -518,6 +583,8 @@ Status Log::DoAppend(LogEntryBatch* entry_batch, bool caller_owns_operation) {
     return Status::OK();
   }
 
+  std::unique_lock<std::mutex> segment_lock(segment_mutex_);
+
   // if the size of this entry overflows the current segment, get a new one
   if (allocation_state() == kAllocationNotStarted) {
     if ((active_segment_->Size() + entry_batch_bytes + 4) > cur_max_segment_size_) {
@@ -526,13 +593,13 @@ Status Log::DoAppend(LogEntryBatch* entry_batch, bool caller_owns_operation) {
       RETURN_NOT_OK(AsyncAllocateSegment());
       if (!options_.async_preallocate_segments) {
         LOG_SLOW_EXECUTION(WARNING, 50, "Log roll took a long time") {
-          RETURN_NOT_OK(RollOver());
+          RETURN_NOT_OK(RollOver(&segment_lock));
         }
       }
     }
   } else if (allocation_state() == kAllocationFinished) {
     LOG_SLOW_EXECUTION(WARNING, 50, "Log roll took a long time") {
-      RETURN_NOT_OK(RollOver());
+      RETURN_NOT_OK(RollOver(&segment_lock));
     }
   } else {
     VLOG(1) << "Segment allocation already in progress...";
@@ -544,7 +611,7 @@ Status Log::DoAppend(LogEntryBatch* entry_batch, bool caller_owns_operation) {
     SCOPED_LATENCY_METRIC(metrics_, append_latency);
     SCOPED_WATCH_STACK(FLAGS_consensus_log_scoped_watch_delay_append_threshold_ms);
 
-    RETURN_NOT_OK(active_segment_->WriteEntryBatch(entry_batch_data));
+    RETURN_NOT_OK(active_segment_->WriteEntryBatch(entry_batch_data, options_.entry_compression));
 
     // We keep track of the last-written OpId here. This is needed to initialize Consensus on
     // startup.
@@ -619,7 +686,8 @@ void Log::UpdateFooterForBatch(LogEntryBatch* batch) {
 
 Status Log::AllocateSegmentAndRollOver() {
   RETURN_NOT_OK(AsyncAllocateSegment());
-  return RollOver();
+  std::unique_lock<std::mutex> segment_lock(segment_mutex_);
+  return RollOver(&segment_lock);
 }
 
 FsManager* Log::GetFsManager() {
@@ -630,52 +698,102 @@ Status Log::Sync() {
   TRACE_EVENT0("log", "Sync");
   SCOPED_LATENCY_METRIC(metrics_, sync_latency);
 
-  if (!sync_disabled_) {
-    if (PREDICT_FALSE(GetAtomicFlag(&FLAGS_log_inject_latency))) {
-      Random r(GetCurrentTimeMicros());
-      int sleep_ms = r.Normal(GetAtomicFlag(&FLAGS_log_inject_latency_ms_mean),
-                              GetAtomicFlag(&FLAGS_log_inject_latency_ms_stddev));
-      if (sleep_ms > 0) {
-        LOG(INFO) << "T " << tablet_id_ << ": Injecting "
-                  << sleep_ms << "ms of latency in Log::Sync()";
-        SleepFor(MonoDelta::FromMilliseconds(sleep_ms));
-      }
+  std::shared_ptr<WritableFile> file;
+  int64_t synced_offset;
+  {
+    std::unique_lock<std::mutex> segment_lock(segment_mutex_);
+    WaitForSyncToFinish(&segment_lock);
+    if (!ShouldFsyncUnlocked()) {
+      return FinishSyncUnlocked(active_segment_->written_offset());
     }
+    // The fsync is done without holding segment_mutex_, so entries could be appended to the active
+    // segment meanwhile. RollOver() and Close() wait for it, so the file is not closed under it.
+    file = active_segment_->writable_file();
+    synced_offset = active_segment_->written_offset();
+    sync_in_progress_ = true;
+  }
 
-    bool timed_or_data_limit_sync = false;
-    if (!durable_wal_write_ && periodic_sync_needed_.load()) {
-      if (interval_durable_wal_write_) {
-        if (MonoTime::Now() > periodic_sync_earliest_unsync_entry_time_
-            + interval_durable_wal_write_) {
-          timed_or_data_limit_sync = true;
-        }
+  Status status = FsyncSegment(file.get());
+
+  std::lock_guard<std::mutex> segment_lock(segment_mutex_);
+  sync_in_progress_ = false;
+  sync_finished_cond_.notify_all();
+  RETURN_NOT_OK(status);
+  return FinishSyncUnlocked(synced_offset);
+}
+
+Status Log::SyncUnlocked() {
+  TRACE_EVENT0("log", "Sync");
+  SCOPED_LATENCY_METRIC(metrics_, sync_latency);
+
+  DCHECK(!sync_in_progress_);
+  if (ShouldFsyncUnlocked()) {
+    RETURN_NOT_OK(FsyncSegment(active_segment_->writable_file().get()));
+  }
+  return FinishSyncUnlocked(active_segment_->written_offset());
+}
+
+void Log::WaitForSyncToFinish(std::unique_lock<std::mutex>* segment_lock) {
+  sync_finished_cond_.wait(*segment_lock, [this] { return !sync_in_progress_; });
+}
+
+bool Log::ShouldFsyncUnlocked() {
+  if (sync_disabled_) {
+    return false;
+  }
+
+  bool timed_or_data_limit_sync = false;
+  if (!durable_wal_write_ && periodic_sync_needed_.load()) {
+    if (interval_durable_wal_write_) {
+      if (MonoTime::Now() > periodic_sync_earliest_unsync_entry_time_
+          + interval_durable_wal_write_) {
+        timed_or_data_limit_sync = true;
       }
-      if (bytes_durable_wal_write_mb_ > 0) {
-        if (periodic_sync_unsynced_bytes_ >= bytes_durable_wal_write_mb_ * 1_MB) {
-          timed_or_data_limit_sync = true;
-        }
+    }
+    if (bytes_durable_wal_write_mb_ > 0) {
+      if (periodic_sync_unsynced_bytes_ >= bytes_durable_wal_write_mb_ * 1_MB) {
+        timed_or_data_limit_sync = true;
       }
     }
+  }
 
-    if (durable_wal_write_ || timed_or_data_limit_sync) {
-      periodic_sync_needed_.store(false);
-      periodic_sync_unsynced_bytes_ = 0;
-      LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+  if (!durable_wal_write_ && !timed_or_data_limit_sync) {
+    return false;
+  }
+  periodic_sync_needed_.store(false);
+  periodic_sync_unsynced_bytes_ = 0;
+  return true;
+}
 
-        if (log_hooks_) {
-          RETURN_NOT_OK_PREPEND(log_hooks_->PostSyncIfFsyncEnabled(),
-                                "PostSyncIfFsyncEnabled hook failed");
-        }
-      }
+Status Log::FsyncSegment(WritableFile* file) {
+  if (PREDICT_FALSE(GetAtomicFlag(&FLAGS_log_inject_latency))) {
+    Random r(GetCurrentTimeMicros());
+    int sleep_ms = r.Normal(GetAtomicFlag(&FLAGS_log_inject_latency_ms_mean),
+                            GetAtomicFlag(&FLAGS_log_inject_latency_ms_stddev));
+    if (sleep_ms > 0) {
+      LOG(INFO) << "T " << tablet_id_ << ": Injecting "
+                << sleep_ms << "ms of latency in Log::Sync()";
+      SleepFor(MonoDelta::FromMilliseconds(sleep_ms));
     }
   }
 
+  LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
+    RETURN_NOT_OK(file->Sync());
+
+    if (log_hooks_) {
+      RETURN_NOT_OK_PREPEND(log_hooks_->PostSyncIfFsyncEnabled(),
+                            "PostSyncIfFsyncEnabled hook failed");
+    }
+  }
+  return Status::OK();
+}
+
+Status Log::FinishSyncUnlocked(int64_t synced_offset) {
   if (log_hooks_) {
     RETURN_NOT_OK_PREPEND(log_hooks_->PostSync(), "PostSync hook failed");
   }
   // Update the reader on how far it can read the active segment.
-  reader_->UpdateLastSegmentOffset(active_segment_->written_offset());
+  reader_->UpdateLastSegmentOffset(synced_offset);
 
   return Status::OK();
 }
@@ -892,13 +1010,16 @@ Status Log::Close() {
   allocation_pool_->Shutdown();
   appender_->Shutdown();
 
+  // segment_mutex_ is acquired before state_lock_, the same order as in RollOver().
+  std::unique_lock<std::mutex> segment_lock(segment_mutex_);
+  WaitForSyncToFinish(&segment_lock);
   std::lock_guard<percpu_rwlock> l(state_lock_);
   switch (log_state_) {
     case kLogWriting:
       if (log_hooks_) {
         RETURN_NOT_OK_PREPEND(log_hooks_->PreClose(), "PreClose hook failed");
       }
-      RETURN_NOT_OK(Sync());
+      RETURN_NOT_OK(SyncUnlocked());
       RETURN_NOT_OK(CloseCurrentSegment());
       RETURN_NOT_OK(ReplaceSegmentInReaderUnlocked());
       log_state_ = kLogClosed;
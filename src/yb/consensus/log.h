@@ -34,8 +34,10 @@
 #define YB_CONSENSUS_LOG_H_
 
 #include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -278,8 +280,8 @@ class Log : public RefCountedThreadSafe<Log> {
   // Initializes a new one or continues an existing log.
   CHECKED_STATUS Init();
 
-  // Make segments roll over.
-  CHECKED_STATUS RollOver();
+  // Make segments roll over. Requires segment_mutex_ to be held by segment_lock.
+  CHECKED_STATUS RollOver(std::unique_lock<std::mutex>* segment_lock);
 
   // Writes the footer and closes the current segment.
   CHECKED_STATUS CloseCurrentSegment();
@@ -320,8 +322,26 @@ class Log : public RefCountedThreadSafe<Log> {
   // the same segment once properly closed.
   CHECKED_STATUS ReplaceSegmentInReaderUnlocked();
 
+  // Syncs the active segment. The fsync itself is done without holding segment_mutex_.
   CHECKED_STATUS Sync();
 
+  // Same as Sync(), but requires segment_mutex_ to be held during the whole sync.
+  CHECKED_STATUS SyncUnlocked();
+
+  // Waits until the sync running outside of segment_mutex_, if any, is finished.
+  void WaitForSyncToFinish(std::unique_lock<std::mutex>* segment_lock);
+
+  // Returns whether the active segment should be fsynced now, and resets the periodic sync state
+  // if so. Requires segment_mutex_ to be held.
+  bool ShouldFsyncUnlocked();
+
+  // Fsyncs the specified segment file.
+  CHECKED_STATUS FsyncSegment(WritableFile* file);
+
+  // Lets the reader read the active segment up to synced_offset. Requires segment_mutex_ to be
+  // held.
+  CHECKED_STATUS FinishSyncUnlocked(int64_t synced_offset);
+
   // Helper method to get the segment sequence to GC based on the provided min_op_idx.
   CHECKED_STATUS GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const;
 
@@ -349,6 +369,15 @@ class Log : public RefCountedThreadSafe<Log> {
   // The schema version
   uint32_t schema_version_;
 
+  // Serializes writes to and syncs of the active segment. They are done by different threads when
+  // the sync is handed over to a group committer.
+  std::mutex segment_mutex_;
+
+  // Set while Sync() fsyncs the active segment without holding segment_mutex_. Protected by
+  // segment_mutex_.
+  bool sync_in_progress_ = false;
+  std::condition_variable sync_finished_cond_;
+
   // The currently active segment being written.
   gscoped_ptr<WritableLogSegment> active_segment_;
 
@@ -139,7 +139,7 @@ Status LogCache::AppendOperations(const ReplicateMsgs& msgs,
   vector<CacheEntry> entries_to_insert;
   entries_to_insert.reserve(msgs.size());
   for (const auto& msg : msgs) {
-    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()) };
+    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()), RefCntBuffer() };
     mem_required += e.mem_usage;
     entries_to_insert.emplace_back(std::move(e));
   }
@@ -286,7 +286,8 @@ int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
-                         OpId* preceding_op) {
+                         OpId* preceding_op,
+                         std::vector<RefCntBuffer>* serialized_messages) {
   DCHECK_ONLY_NOTNULL(messages);
   DCHECK_ONLY_NOTNULL(preceding_op);
   DCHECK_GE(after_op_index, 0);
@@ -328,6 +329,9 @@ Status LogCache::ReadOps(int64_t after_op_index,
         remaining_space -= TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
           messages->push_back(msg);
+          if (serialized_messages) {
+            serialized_messages->emplace_back();
+          }
           next_index++;
         }
       }
@@ -347,13 +351,57 @@ Status LogCache::ReadOps(int64_t after_op_index,
         }
 
         messages->push_back(msg);
+        if (serialized_messages) {
+          serialized_messages->push_back(iter->second.serialized);
+        }
         next_index++;
       }
     }
   }
+
+  if (serialized_messages) {
+    l.unlock();
+    SerializeMessages(*messages, serialized_messages);
+  }
   return Status::OK();
 }
 
+void LogCache::SerializeMessages(const ReplicateMsgs& messages,
+                                 std::vector<RefCntBuffer>* serialized) {
+  DCHECK_EQ(messages.size(), serialized->size());
+
+  // Serialization is done outside the lock, it could be relatively expensive for large ops.
+  std::vector<size_t> new_serialized;
+  for (size_t i = 0; i != messages.size(); ++i) {
+    auto& buffer = (*serialized)[i];
+    if (buffer) {
+      continue;
+    }
+    const ReplicateMsg& msg = *messages[i];
+    buffer = RefCntBuffer(msg.ByteSize());
+    msg.SerializeWithCachedSizesToArray(buffer.udata());
+    new_serialized.push_back(i);
+  }
+  if (new_serialized.empty()) {
+    return;
+  }
+
+  std::lock_guard<simple_spinlock> l(lock_);
+  for (auto i : new_serialized) {
+    auto it = cache_.find(messages[i]->id().index());
+    // The op could be evicted or overwritten meanwhile.
+    if (it == cache_.end() || it->second.msg != messages[i] || it->second.serialized) {
+      continue;
+    }
+    auto& entry = it->second;
+    entry.serialized = (*serialized)[i];
+    const int64_t size = entry.serialized.size();
+    entry.mem_usage += size;
+    tracker_->Consume(size);
+    metrics_.log_cache_size->IncrementBy(size);
+  }
+}
+
 
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
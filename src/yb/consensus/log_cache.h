@@ -45,6 +45,7 @@
 #include "yb/util/async_util.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -94,10 +95,15 @@ class LogCache {
   // If the ops being requested are not available in the log, this will synchronously read these ops
   // from disk. Therefore, this function may take a substantial amount of time and should not be
   // called with important locks held, etc.
+  //
+  // If 'serialized_messages' is not null, it is filled with the serialized form of each returned
+  // op. The serialized form of a cached op is computed once and kept in the cache, so it can be
+  // sent to every peer without being serialized again.
   CHECKED_STATUS ReadOps(int64_t after_op_index,
                  int max_size_bytes,
                  ReplicateMsgs* messages,
-                 OpId* preceding_op);
+                 OpId* preceding_op,
+                 std::vector<RefCntBuffer>* serialized_messages = nullptr);
 
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
@@ -155,6 +161,8 @@ class LogCache {
     // The cached value of msg->SpaceUsedLong(). This method is expensive
     // to compute, so we compute it only once upon insertion.
     int64_t mem_usage;
+    // Serialized msg, filled on the first ReadOps that asks for it.
+    RefCntBuffer serialized;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
@@ -166,6 +174,10 @@ class LogCache {
   // given message.
   void AccountForMessageRemovalUnlocked(const CacheEntry& entry);
 
+  // Serializes messages that don't have a serialized form in 'serialized' yet, and keeps the
+  // result in the cache for the messages that are still there.
+  void SerializeMessages(const ReplicateMsgs& messages, std::vector<RefCntBuffer>* serialized);
+
   // Return a string with stats
   std::string StatsStringUnlocked() const;
 
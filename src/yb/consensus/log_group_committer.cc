@@ -0,0 +1,147 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_group_committer.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "yb/gutil/strings/util.h"
+#include "yb/util/debug/trace_event.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/thread.h"
+
+namespace yb {
+namespace log {
+
+LogGroupCommitter::LogGroupCommitter(std::vector<std::string> wal_root_dirs)
+    : wal_root_dirs_(std::move(wal_root_dirs)) {
+  // Tests and single drive setups may have no explicit roots, serve everything with one thread.
+  const size_t num_drives = std::max<size_t>(wal_root_dirs_.size(), 1);
+  drives_.reserve(num_drives);
+  for (size_t i = 0; i != num_drives; ++i) {
+    drives_.emplace_back(new Drive);
+    if (i < wal_root_dirs_.size()) {
+      drives_.back()->root_dir = wal_root_dirs_[i];
+    }
+  }
+}
+
+LogGroupCommitter::~LogGroupCommitter() {
+  Shutdown();
+}
+
+Status LogGroupCommitter::Start() {
+  for (size_t i = 0; i != drives_.size(); ++i) {
+    RETURN_NOT_OK(Thread::Create("log", Format("group-commit-$0", i),
+                                 &LogGroupCommitter::CommitThread, this, drives_[i].get(),
+                                 &drives_[i]->thread));
+  }
+  return Status::OK();
+}
+
+void LogGroupCommitter::Shutdown() {
+  if (closing_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  for (auto& drive : drives_) {
+    {
+      std::lock_guard<std::mutex> lock(drive->mutex);
+    }
+    drive->cond.notify_all();
+    if (drive->thread) {
+      CHECK_OK(ThreadJoiner(drive->thread.get()).Join());
+      drive->thread.reset();
+    }
+  }
+}
+
+size_t LogGroupCommitter::DriveIndex(const std::string& wal_path) const {
+  for (size_t i = 0; i != wal_root_dirs_.size(); ++i) {
+    if (HasPrefixString(wal_path, wal_root_dirs_[i])) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+Status LogGroupCommitter::Submit(const std::string& wal_path, const void* key, SyncFunctor sync,
+                                 DoneFunctor done) {
+  auto& drive = *drives_[DriveIndex(wal_path)];
+  {
+    std::lock_guard<std::mutex> lock(drive.mutex);
+    if (closing_.load(std::memory_order_acquire)) {
+      return STATUS(ServiceUnavailable, "Log group committer is shutting down");
+    }
+    drive.queue.push_back(Request{key, std::move(sync), std::move(done)});
+  }
+  drive.cond.notify_one();
+  return Status::OK();
+}
+
+void LogGroupCommitter::CommitThread(Drive* drive) {
+  std::vector<Request> requests;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(drive->mutex);
+      drive->cond.wait(lock, [this, drive] {
+        return !drive->queue.empty() || closing_.load(std::memory_order_acquire);
+      });
+      if (drive->queue.empty()) {
+        break;
+      }
+      requests.assign(std::make_move_iterator(drive->queue.begin()),
+                      std::make_move_iterator(drive->queue.end()));
+      drive->queue.clear();
+    }
+    ProcessPass(&requests);
+    requests.clear();
+  }
+
+  // Fail anything submitted after the last pass was taken, so no callback is lost.
+  std::deque<Request> leftover;
+  {
+    std::lock_guard<std::mutex> lock(drive->mutex);
+    leftover.swap(drive->queue);
+  }
+  const auto status = STATUS(ServiceUnavailable, "Log group committer is shutting down");
+  for (auto& request : leftover) {
+    request.done(status);
+  }
+}
+
+void LogGroupCommitter::ProcessPass(std::vector<Request>* requests) {
+  TRACE_EVENT1("log", "GroupCommitPass", "num_requests", requests->size());
+  num_passes_.fetch_add(1, std::memory_order_acq_rel);
+
+  std::unordered_map<const void*, Status> synced;
+  for (const auto& request : *requests) {
+    if (synced.count(request.key)) {
+      continue;
+    }
+    // Requests of the same key are served by the sync of the first one, it covers everything that
+    // was written to that log before any of them was submitted.
+    synced.emplace(request.key, request.sync());
+    num_syncs_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  VLOG(2) << "Group commit pass synced " << synced.size() << " logs for " << requests->size()
+          << " requests";
+
+  for (auto& request : *requests) {
+    request.done(synced[request.key]);
+  }
+}
+
+}  // namespace log
+}  // namespace yb
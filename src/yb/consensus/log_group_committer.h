@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_GROUP_COMMITTER_H_
+#define YB_CONSENSUS_LOG_GROUP_COMMITTER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+
+namespace log {
+
+// A tablet server wide group commit stage shared by the WALs of all tablets.
+//
+// Every WAL root directory (usually a separate data drive) gets its own commit thread. Appenders
+// write their entry batches to the active segment as before and then hand the sync over to this
+// stage instead of syncing on the append thread. A commit thread takes all requests that queued up
+// while it was busy, syncs each distinct log once, and only then runs the durability callbacks of
+// the requests. So N tablets appending concurrently to the same drive pay for one pass of syncs
+// instead of N independent sync cadences, and the append threads go on writing the next batches
+// while the previous ones are being synced.
+//
+// Requests for the same key are always processed in submission order, because a key is bound to a
+// single drive and each drive is served by a single thread.
+class LogGroupCommitter {
+ public:
+  typedef std::function<Status()> SyncFunctor;
+  typedef std::function<void(const Status&)> DoneFunctor;
+
+  explicit LogGroupCommitter(std::vector<std::string> wal_root_dirs);
+  ~LogGroupCommitter();
+
+  CHECKED_STATUS Start();
+
+  // Fails all pending requests with ServiceUnavailable and stops the commit threads.
+  void Shutdown();
+
+  // Enqueues a sync request. 'sync' is invoked on the commit thread at most once per pass for all
+  // requests with the same 'key', then 'done' is invoked with the result of that sync.
+  // 'wal_path' selects the drive, i.e. the commit thread, that serves the request.
+  CHECKED_STATUS Submit(const std::string& wal_path, const void* key, SyncFunctor sync,
+                        DoneFunctor done);
+
+  // Total number of sync calls issued and of commit passes run, used by tests and benchmarks.
+  int64_t num_syncs() const { return num_syncs_.load(std::memory_order_acquire); }
+  int64_t num_passes() const { return num_passes_.load(std::memory_order_acquire); }
+
+ private:
+  struct Request {
+    const void* key;
+    SyncFunctor sync;
+    DoneFunctor done;
+  };
+
+  struct Drive {
+    std::string root_dir;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Request> queue;
+    scoped_refptr<Thread> thread;
+  };
+
+  size_t DriveIndex(const std::string& wal_path) const;
+
+  void CommitThread(Drive* drive);
+
+  // Syncs every distinct key in 'requests' once and runs the done callbacks in order.
+  void ProcessPass(std::vector<Request>* requests);
+
+  const std::vector<std::string> wal_root_dirs_;
+  std::vector<std::unique_ptr<Drive>> drives_;
+  std::atomic<bool> closing_{false};
+
+  std::atomic<int64_t> num_syncs_{0};
+  std::atomic<int64_t> num_passes_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(LogGroupCommitter);
+};
+
+}  // namespace log
+}  // namespace yb
+
+#endif  // YB_CONSENSUS_LOG_GROUP_COMMITTER_H_
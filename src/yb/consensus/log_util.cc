@@ -32,6 +32,8 @@
 
 #include "yb/consensus/log_util.h"
 
+#include <strings.h>
+
 #include <algorithm>
 #include <iostream>
 #include <limits>
@@ -39,6 +41,8 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
+#include <snappy.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/ref_counted_replicate.h"
@@ -50,6 +54,7 @@
 #include "yb/gutil/strings/util.h"
 
 #include "yb/util/coding-inl.h"
+#include "yb/util/cast.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
@@ -96,6 +101,44 @@ DEFINE_bool(require_durable_wal_write, false, "Whether durable WAL write is requ
     "the system will soft downgrade the durable_wal_write flag.");
 TAG_FLAG(require_durable_wal_write, stable);
 
+DEFINE_string(log_entry_compression, "none",
+              "Codec used to compress WAL entry batches: none, snappy or lz4. Segments written "
+              "with compression can only be read by versions that support it.");
+TAG_FLAG(log_entry_compression, advanced);
+
+DEFINE_int32(log_min_bytes_to_compress, 512,
+             "WAL entry batches smaller than this are written uncompressed even if "
+             "log_entry_compression is set.");
+TAG_FLAG(log_min_bytes_to_compress, advanced);
+
+namespace {
+
+bool ParseLogEntryCompression(const std::string& name, yb::log::LogEntryCompression* result) {
+  for (auto compression : yb::log::kLogEntryCompressionList) {
+    // Skip the 'k' prefix of the enum value name.
+    if (strcasecmp(name.c_str(), ToCString(compression) + 1) == 0) {
+      *result = compression;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ValidateLogEntryCompression(const char* flagname, const std::string& value) {
+  yb::log::LogEntryCompression compression;
+  if (ParseLogEntryCompression(value, &compression)) {
+    return true;
+  }
+  LOG(ERROR) << flagname << " must be one of none, snappy or lz4, value " << value
+             << " is invalid";
+  return false;
+}
+
+} // namespace
+
+static bool log_entry_compression_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_entry_compression, &ValidateLogEntryCompression);
+
 namespace yb {
 namespace log {
 
@@ -122,6 +165,89 @@ const size_t kLogSegmentFooterMagicAndFooterLength  = 12;
 
 const size_t kEntryHeaderSize = 12;
 
+namespace {
+
+// The two most significant bits of the length field of an entry header hold the codec.
+constexpr int kEntryCompressionShift = 30;
+constexpr uint32_t kEntryLengthMask = (1u << kEntryCompressionShift) - 1;
+
+LogEntryCompression EntryCompressionFromFlag() {
+  LogEntryCompression result = LogEntryCompression::kNone;
+  DCHECK(log_entry_compression_dummy);
+  ParseLogEntryCompression(FLAGS_log_entry_compression, &result);
+  return result;
+}
+
+// Compresses 'data' into 'out'. Returns false if the codec could not compress it.
+bool CompressEntryBatch(LogEntryCompression compression, const Slice& data, faststring* out) {
+  out->clear();
+  switch (compression) {
+    case LogEntryCompression::kNone:
+      return false;
+    case LogEntryCompression::kSnappy: {
+      out->resize(snappy::MaxCompressedLength(data.size()));
+      size_t compressed_size = 0;
+      snappy::RawCompress(data.cdata(), data.size(), to_char_ptr(out->data()),
+                          &compressed_size);
+      out->resize(compressed_size);
+      return true;
+    }
+    case LogEntryCompression::kLz4: {
+      // LZ4 blocks do not record the uncompressed size, so it is prepended as a varint.
+      PutVarint32(out, static_cast<uint32_t>(data.size()));
+      const size_t prefix_size = out->size();
+      const int bound = LZ4_compressBound(static_cast<int>(data.size()));
+      out->resize(prefix_size + bound);
+      const int compressed_size = LZ4_compress_default(
+          data.cdata(), to_char_ptr(out->data() + prefix_size),
+          static_cast<int>(data.size()), bound);
+      if (compressed_size <= 0) {
+        return false;
+      }
+      out->resize(prefix_size + compressed_size);
+      return true;
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(LogEntryCompression, compression);
+}
+
+Status UncompressEntryBatch(LogEntryCompression compression, Slice data, faststring* out) {
+  switch (compression) {
+    case LogEntryCompression::kNone:
+      out->assign_copy(data.data(), data.size());
+      return Status::OK();
+    case LogEntryCompression::kSnappy: {
+      size_t size = 0;
+      if (!snappy::GetUncompressedLength(data.cdata(), data.size(), &size)) {
+        return STATUS(Corruption, "Invalid snappy compressed log entry batch");
+      }
+      out->resize(size);
+      if (!snappy::RawUncompress(data.cdata(), data.size(), to_char_ptr(out->data()))) {
+        return STATUS(Corruption, "Failed to uncompress snappy log entry batch");
+      }
+      return Status::OK();
+    }
+    case LogEntryCompression::kLz4: {
+      uint32_t size = 0;
+      if (!GetVarint32(&data, &size)) {
+        return STATUS(Corruption, "Invalid lz4 compressed log entry batch");
+      }
+      out->resize(size);
+      const int uncompressed_size = LZ4_decompress_safe(
+          data.cdata(), to_char_ptr(out->data()), static_cast<int>(data.size()),
+          static_cast<int>(size));
+      if (uncompressed_size != static_cast<int>(size)) {
+        return STATUS_FORMAT(Corruption, "Failed to uncompress lz4 log entry batch: $0 of $1 bytes",
+                             uncompressed_size, size);
+      }
+      return Status::OK();
+    }
+  }
+  return STATUS_FORMAT(Corruption, "Unknown log entry compression: $0", compression);
+}
+
+} // namespace
+
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
@@ -137,7 +263,8 @@ LogOptions::LogOptions()
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
       preallocate_segments(FLAGS_log_preallocate_segments),
-      async_preallocate_segments(FLAGS_log_async_preallocate_segments) {
+      async_preallocate_segments(FLAGS_log_async_preallocate_segments),
+      entry_compression(EntryCompressionFromFlag()) {
 }
 
 Status ReadableLogSegment::Open(Env* env,
@@ -656,7 +783,7 @@ Status ReadableLogSegment::ReadEntryHeader(int64_t *offset, EntryHeader* header)
 
 Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* header) {
   DCHECK_EQ(kEntryHeaderSize, data.size());
-  header->msg_length = DecodeFixed32(data.data());
+  uint32_t length_and_compression = DecodeFixed32(data.data());
   header->msg_crc    = DecodeFixed32(data.data() + 4);
   header->header_crc = DecodeFixed32(data.data() + 8);
 
@@ -667,6 +794,14 @@ Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* hea
         Corruption, "Invalid checksum in log entry head header: found=$0, computed=$1",
         header->header_crc, computed_crc);
   }
+
+  header->msg_length = length_and_compression & kEntryLengthMask;
+  header->compression = static_cast<LogEntryCompression>(
+      length_and_compression >> kEntryCompressionShift);
+  if (ToCString(header->compression) == nullptr) {
+    return STATUS_FORMAT(Corruption, "Unknown compression in log entry header: $0",
+                         header->compression);
+  }
   return Status::OK();
 }
 
@@ -714,10 +849,21 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  // The buffer keeps the bytes as they are stored on disk, so uncompress into a separate one.
+  faststring uncompressed;
+  Slice entry_batch_data = entry_batch_slice;
+  if (header.compression != LogEntryCompression::kNone) {
+    RETURN_NOT_OK_PREPEND(
+        UncompressEntryBatch(header.compression, entry_batch_slice, &uncompressed),
+        Substitute("Could not uncompress entry in byte range $0-$1",
+                   *offset, *offset + header.msg_length));
+    entry_batch_data = Slice(uncompressed);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_data.data(),
+                              entry_batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -788,13 +934,32 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data,
+                                           LogEntryCompression compression) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
-  // First encode the length of the message.
-  uint32_t len = data.size();
+  Slice data = entry_batch_data;
+  if (compression != LogEntryCompression::kNone &&
+      data.size() >= FLAGS_log_min_bytes_to_compress) {
+    // Keep the compressed form only if it actually saves space.
+    if (CompressEntryBatch(compression, data, &compress_buffer_) &&
+        compress_buffer_.size() < data.size()) {
+      data = Slice(compress_buffer_);
+    } else {
+      compression = LogEntryCompression::kNone;
+    }
+  } else {
+    compression = LogEntryCompression::kNone;
+  }
+  if (PREDICT_FALSE(data.size() > kEntryLengthMask)) {
+    return STATUS_FORMAT(InvalidArgument, "Log entry batch too large: $0 bytes", data.size());
+  }
+
+  // First encode the length of the message, together with the codec it was compressed with.
+  uint32_t len = static_cast<uint32_t>(data.size()) |
+                 (static_cast<uint32_t>(compression) << kEntryCompressionShift);
   InlineEncodeFixed32(&header_buf[0], len);
 
   // Then the CRC of the message.
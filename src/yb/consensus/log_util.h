@@ -47,7 +47,9 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/atomic.h"
+#include "yb/util/enums.h"
 #include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 
 // Used by other classes, now part of the API.
@@ -72,9 +74,15 @@ extern const char kTmpSuffix[];
 // and checksum of the other two fields (see EntryHeader struct below).
 extern const size_t kEntryHeaderSize;
 
+// Codec used for the data of a log entry batch. It is stored in the two most significant bits of
+// the length field of the entry header, so entries written without compression keep the original
+// format and each batch can be decoded on its own.
+YB_DEFINE_ENUM(LogEntryCompression, ((kNone, 0))((kSnappy, 1))((kLz4, 2)));
+
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
+class LogGroupCommitter;
 class ReadableLogSegment;
 
 // Options for the State Machine/Write Ahead Log
@@ -99,6 +107,13 @@ struct LogOptions {
   // Whether the allocation should happen asynchronously.
   bool async_preallocate_segments;
 
+  // Codec applied to entry batches that are large enough to be worth compressing.
+  LogEntryCompression entry_compression;
+
+  // If set, syncs of appended batches are handed over to this tablet server wide stage instead of
+  // being done on the append thread. Not owned.
+  LogGroupCommitter* group_committer = nullptr;
+
   LogOptions();
 };
 
@@ -217,10 +232,13 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
 
   struct EntryHeader {
-    // The length of the batch data.
+    // The length of the batch data, as stored on disk.
     uint32_t msg_length;
 
-    // The CRC32C of the batch data.
+    // The codec the batch data was compressed with.
+    LogEntryCompression compression;
+
+    // The CRC32C of the batch data, as stored on disk.
     uint32_t msg_crc;
 
     // The CRC32C of this EntryHeader.
@@ -340,7 +358,9 @@ class WritableLogSegment {
   // Appends the provided batch of data, including a header
   // and checksum.
   // Makes sure that the log segment has not been closed.
-  CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data);
+  // The data is compressed with 'compression' when it is large enough and actually gets smaller.
+  CHECKED_STATUS WriteEntryBatch(const Slice& entry_batch_data,
+                                 LogEntryCompression compression = LogEntryCompression::kNone);
 
   // Makes sure the I/O buffers in the underlying writable file are flushed.
   CHECKED_STATUS Sync() {
@@ -379,18 +399,21 @@ class WritableLogSegment {
     return written_offset_;
   }
 
- private:
-
   const std::shared_ptr<WritableFile>& writable_file() const {
     return writable_file_;
   }
 
+ private:
+
   // The path to the log file.
   const std::string path_;
 
   // The writable file to which this LogSegment will be written.
   const std::shared_ptr<WritableFile> writable_file_;
 
+  // Reused buffer for the compressed data of an entry batch.
+  faststring compress_buffer_;
+
   bool is_header_written_;
 
   bool is_footer_written_;
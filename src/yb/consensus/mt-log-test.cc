@@ -31,14 +31,17 @@
 //
 
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <vector>
 
 #include "yb/consensus/log-test-base.h"
+#include "yb/consensus/log_group_committer.h"
 #include "yb/consensus/log_index.h"
 #include "yb/gutil/algorithm.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/locks.h"
 #include "yb/util/random.h"
 #include "yb/util/thread.h"
@@ -49,6 +52,10 @@
 DEFINE_int32(num_writer_threads, 1, "Number of threads writing to the log");
 DEFINE_int32(num_batches_per_thread, 2000, "Number of batches per thread");
 DEFINE_int32(num_ops_per_batch_avg, 5, "Target average number of ops per batch");
+DEFINE_int32(num_logs_for_group_commit, 8,
+             "Number of logs written concurrently by the group commit benchmark");
+
+METRIC_DECLARE_histogram(log_sync_latency);
 
 namespace yb {
 namespace log {
@@ -81,6 +88,63 @@ class CustomLatchCallback : public RefCountedThreadSafe<CustomLatchCallback> {
   vector<Status>* errors_;
 };
 
+// Records the time from creation to the invocation of the callback.
+class LatencyCallback : public CustomLatchCallback {
+ public:
+  LatencyCallback(CountDownLatch* latch, vector<Status>* errors, HdrHistogram* latency_us)
+      : CustomLatchCallback(latch, errors),
+        latency_us_(latency_us),
+        start_(MonoTime::Now()) {
+  }
+
+  void LatencyStatusCB(const Status& s) {
+    latency_us_->Increment(MonoTime::Now().GetDeltaSince(start_).ToMicroseconds());
+    StatusCB(s);
+  }
+
+  StatusCallback AsStatusCallback() {
+    return Bind(&LatencyCallback::LatencyStatusCB, this);
+  }
+
+ private:
+  HdrHistogram* latency_us_;
+  MonoTime start_;
+};
+
+// Counts entries appended to the log while its active segment is being fsynced. The first syncs
+// are held for a moment, so that appends issued meanwhile could be observed.
+class AppendDuringSyncHooks : public Log::LogFaultHooks {
+ public:
+  CHECKED_STATUS PostSyncIfFsyncEnabled() override {
+    if (num_held_syncs_ < kMaxHeldSyncs) {
+      ++num_held_syncs_;
+      syncing_.store(true, std::memory_order_release);
+      SleepFor(MonoDelta::FromMilliseconds(5));
+      syncing_.store(false, std::memory_order_release);
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS PostAppend() override {
+    if (syncing_.load(std::memory_order_acquire)) {
+      appends_during_sync_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    return Status::OK();
+  }
+
+  int64_t appends_during_sync() const {
+    return appends_during_sync_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr int kMaxHeldSyncs = 20;
+
+  // Syncs of one log are serialized, so it is accessed by one thread at a time.
+  int num_held_syncs_ = 0;
+  std::atomic<bool> syncing_{false};
+  std::atomic<int64_t> appends_during_sync_{0};
+};
+
 } // anonymous namespace
 
 extern const char *kTestTablet;
@@ -142,6 +206,83 @@ class MultiThreadedLogTest : public LogTestBase {
     ASSERT_EQ(0, errors.size());
   }
 
+  struct AppendStats {
+    int64_t num_syncs;
+    uint64_t p99_latency_us;
+    int64_t appends_during_sync;
+  };
+
+  // Opens FLAGS_num_logs_for_group_commit logs with durable WAL writes and appends
+  // FLAGS_num_batches_per_thread batches to each of them from its own thread, measuring the time
+  // from AsyncAppend() to the durability callback of every batch, and counting the entries appended
+  // while a log was being fsynced.
+  AppendStats AppendToManyLogs(const std::string& name, LogGroupCommitter* group_committer) {
+    auto metric_entity = METRIC_ENTITY_tablet.Instantiate(metric_registry_.get(), name);
+    LogOptions options;
+    options.durable_wal_write = true;
+    options.group_committer = group_committer;
+
+    Schema schema_with_ids = SchemaBuilder(schema_).Build();
+    vector<scoped_refptr<Log>> logs(FLAGS_num_logs_for_group_commit);
+    vector<std::shared_ptr<AppendDuringSyncHooks>> hooks;
+    for (int i = 0; i != FLAGS_num_logs_for_group_commit; ++i) {
+      auto tablet_id = strings::Substitute("$0-$1", name, i);
+      CHECK_OK(Log::Open(options, fs_manager_.get(), tablet_id,
+                         fs_manager_->GetFirstTabletWalDirOrDie(kTestTable, tablet_id),
+                         schema_with_ids, 0 /* schema_version */, metric_entity,
+                         append_pool_.get(), &logs[i]));
+      hooks.push_back(std::make_shared<AppendDuringSyncHooks>());
+      logs[i]->SetLogFaultHooksForTests(hooks.back());
+    }
+
+    HdrHistogram latency_us(60000000, 2);
+    vector<scoped_refptr<yb::Thread>> threads;
+    for (int i = 0; i != FLAGS_num_logs_for_group_commit; ++i) {
+      scoped_refptr<yb::Thread> thread;
+      CHECK_OK(yb::Thread::Create("test", "appender", [&logs, &latency_us, this, i] {
+        AppendToLog(logs[i].get(), &latency_us);
+      }, &thread));
+      threads.push_back(thread);
+    }
+    for (auto& thread : threads) {
+      CHECK_OK(ThreadJoiner(thread.get()).Join());
+    }
+    for (auto& log : logs) {
+      CHECK_OK(log->Close());
+    }
+
+    int64_t appends_during_sync = 0;
+    for (const auto& log_hooks : hooks) {
+      appends_during_sync += log_hooks->appends_during_sync();
+    }
+
+    auto sync_latency = METRIC_log_sync_latency.Instantiate(metric_entity);
+    return AppendStats{ static_cast<int64_t>(sync_latency->TotalCount()),
+                        latency_us.ValueAtPercentile(99),
+                        appends_during_sync };
+  }
+
+  void AppendToLog(Log* log, HdrHistogram* latency_us) {
+    CountDownLatch latch(FLAGS_num_batches_per_thread);
+    vector<Status> errors;
+    for (int i = 0; i < FLAGS_num_batches_per_thread; i++) {
+      auto replicate = std::make_shared<ReplicateMsg>();
+      replicate->mutable_id()->set_term(0);
+      replicate->mutable_id()->set_index(i + 1);
+      replicate->set_op_type(WRITE_OP);
+      replicate->set_hybrid_time(clock_->Now().ToUint64());
+      AddTestRowInsert(i, 0, "this is a test insert", replicate->mutable_write_request());
+
+      auto cb = new LatencyCallback(&latch, &errors, latency_us);
+      CHECK_OK(log->AsyncAppendReplicates({ replicate }, cb->AsStatusCallback()));
+    }
+    latch.Wait();
+    for (const Status& status : errors) {
+      WARN_NOT_OK(status, "Unexpected failure during AsyncAppend");
+    }
+    CHECK_EQ(0, errors.size());
+  }
+
   void Run() {
     for (int i = 0; i < FLAGS_num_writer_threads; i++) {
       scoped_refptr<yb::Thread> new_thread;
@@ -186,5 +327,31 @@ TEST_F(MultiThreadedLogTest, TestAppends) {
   ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
 }
 
+// Compares the per-log sync path against the shared group commit stage for many logs appending
+// concurrently to the same drive.
+TEST_F(MultiThreadedLogTest, GroupCommitAcrossLogs) {
+  auto per_log = AppendToManyLogs("per-log", nullptr);
+
+  LogGroupCommitter group_committer(fs_manager_->GetWalRootDirs());
+  ASSERT_OK(group_committer.Start());
+  auto group_commit = AppendToManyLogs("group-commit", &group_committer);
+  group_committer.Shutdown();
+
+  LOG(INFO) << "Per log: syncs: " << per_log.num_syncs
+            << ", p99 append latency: " << per_log.p99_latency_us << "us";
+  LOG(INFO) << "Group commit: syncs: " << group_commit.num_syncs
+            << ", passes: " << group_committer.num_passes()
+            << ", p99 append latency: " << group_commit.p99_latency_us << "us"
+            << ", appends during sync: " << group_commit.appends_during_sync;
+
+  const int64_t num_batches =
+      static_cast<int64_t>(FLAGS_num_logs_for_group_commit) * FLAGS_num_batches_per_thread;
+  ASSERT_GT(group_committer.num_syncs(), 0);
+  ASSERT_LE(group_committer.num_syncs(), num_batches);
+  ASSERT_LE(group_committer.num_passes(), group_committer.num_syncs());
+  // The committer fsyncs a log without blocking its appender.
+  ASSERT_GT(group_commit.appends_during_sync, 0);
+}
+
 } // namespace log
 } // namespace yb
@@ -25,9 +25,29 @@
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 
 using namespace std::placeholders;
 
+DEFINE_bool(enable_transaction_wait_queues, false,
+            "Whether write operations that conflict with pending transactions should wait for "
+            "their completion, instead of aborting them or failing right away.");
+TAG_FLAG(enable_transaction_wait_queues, runtime);
+TAG_FLAG(enable_transaction_wait_queues, advanced);
+
+DEFINE_int32(transaction_conflict_max_wait_ms, 5000,
+             "Maximal time a write operation waits for completion of conflicting transactions, "
+             "when enable_transaction_wait_queues is set. After that conflicts are resolved by "
+             "aborting lower priority transactions as usual.");
+TAG_FLAG(transaction_conflict_max_wait_ms, runtime);
+TAG_FLAG(transaction_conflict_max_wait_ms, advanced);
+
+DEFINE_int32(transaction_conflict_wait_poll_ms, 100,
+             "Interval at which a waiting write operation rechecks statuses of conflicting "
+             "transactions, since an abort is not noticed by the tablet otherwise.");
+TAG_FLAG(transaction_conflict_wait_poll_ms, runtime);
+TAG_FLAG(transaction_conflict_wait_poll_ms, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -77,32 +97,44 @@ class ConflictResolverContext {
 
   virtual bool IgnoreConflictsWith(const TransactionId& other) = 0;
 
- protected:
-  ~ConflictResolverContext() {}
+  // Transaction that performs this operation, if any.
+  virtual boost::optional<TransactionId> WaiterId() = 0;
+
+  virtual ~ConflictResolverContext() {}
 };
 
-class ConflictResolver {
+// Resolves conflicts of an operation. It is owned by the callbacks of the requests it sends, so it
+// lives until the resolution callback is invoked.
+class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
  public:
-  ConflictResolver(rocksdb::DB* db,
+  ConflictResolver(const DocDB& doc_db,
                    TransactionStatusManager* status_manager,
-                   ConflictResolverContext* context)
-    : db_(db), status_manager_(*status_manager), context_(*context) {}
+                   std::unique_ptr<ConflictResolverContext> context,
+                   ResolutionCallback callback)
+    : doc_db_(doc_db), status_manager_(*status_manager), context_(std::move(context)),
+      callback_(std::move(callback)) {}
 
   TransactionStatusManager& status_manager() {
     return status_manager_;
   }
 
-  rocksdb::DB* db() {
-    return db_;
+  const DocDB& doc_db() {
+    return doc_db_;
   }
 
   boost::optional<TransactionMetadata> Metadata(const TransactionId& id) {
     return status_manager_.Metadata(id);
   }
 
-  CHECKED_STATUS Resolve() {
-    RETURN_NOT_OK(context_.ReadConflicts(this));
-    return ResolveConflicts();
+  void Resolve() {
+    auto status = context_->ReadConflicts(this);
+    // The iterator should not pin the intents DB while waiting for conflicting transactions.
+    intent_iter_.reset();
+    if (!status.ok()) {
+      InvokeCallback(status);
+      return;
+    }
+    ResolveConflicts();
   }
 
   // Reads conflicts for specified intent from DB.
@@ -141,7 +173,7 @@ class ConflictResolver {
         auto transaction_id = VERIFY_RESULT(FullyDecodeTransactionId(
             Slice(existing_value.data(), TransactionId::static_size())));
 
-        if (!context_.IgnoreConflictsWith(transaction_id)) {
+        if (!context_->IgnoreConflictsWith(transaction_id)) {
           conflicts_.insert(transaction_id);
         }
       }
@@ -153,23 +185,27 @@ class ConflictResolver {
   }
 
  private:
-  CHECKED_STATUS ResolveConflicts() {
-    if (!conflicts_.empty()) {
-      transactions_.reserve(conflicts_.size());
-      for (const auto& transaction_id : conflicts_) {
-        transactions_.push_back({ transaction_id });
-      }
-
-      return DoResolveConflicts();
+  void ResolveConflicts() {
+    if (conflicts_.empty()) {
+      InvokeCallback(context_->GetHybridTime());
+      return;
     }
 
-    return Status::OK();
+    transactions_.reserve(conflicts_.size());
+    for (const auto& transaction_id : conflicts_) {
+      transactions_.push_back({ transaction_id });
+    }
+    if (GetAtomicFlag(&FLAGS_enable_transaction_wait_queues)) {
+      wait_deadline_ = MonoTime::Now() + MonoDelta::FromMilliseconds(
+          GetAtomicFlag(&FLAGS_transaction_conflict_max_wait_ms));
+    }
+    DoResolveConflicts();
   }
 
   void EnsureIntentIteratorCreated() {
     if (!intent_iter_) {
       intent_iter_ = CreateRocksDBIterator(
-          db_,
+          doc_db_.intents,
           BloomFilterMode::DONT_USE_BLOOM_FILTER,
           boost::none /* user_key_for_filter */,
           rocksdb::kDefaultQueryId,
@@ -178,29 +214,87 @@ class ConflictResolver {
     }
   }
 
-  CHECKED_STATUS DoResolveConflicts() {
+  // Resolves conflicts with the remaining transactions. When it has to wait for them, resolution
+  // continues from the wait callback.
+  void DoResolveConflicts() {
     for (;;) {
-      RETURN_NOT_OK(CheckLocalCommits());
-
-      FetchTransactionStatuses();
-
-      RETURN_NOT_OK(Cleanup());
+      auto status = CheckLocalCommits();
+      if (status.ok()) {
+        FetchTransactionStatuses();
+        status = Cleanup();
+      }
+      if (!status.ok()) {
+        InvokeCallback(status);
+        return;
+      }
       if (transactions_.empty()) {
-        return Status::OK();
+        InvokeCallback(context_->GetHybridTime());
+        return;
       }
 
-      RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
-
-      AbortTransactions();
-
-      RETURN_NOT_OK(Cleanup());
+      if (StartWaitForTransactions()) {
+        return;
+      }
 
+      status = context_->CheckPriority(this, &transactions_);
+      if (status.ok()) {
+        AbortTransactions();
+        status = Cleanup();
+      }
+      if (!status.ok()) {
+        InvokeCallback(status);
+        return;
+      }
       if (transactions_.empty()) {
-        return Status::OK();
+        InvokeCallback(context_->GetHybridTime());
+        return;
       }
     }
   }
 
+  // Starts waiting until one of the conflicting transactions is applied or aborted, or the poll
+  // interval elapses, after which resolution continues with their updated statuses.
+  // Returns false when waiting is over, and conflicts should be resolved as usual.
+  bool StartWaitForTransactions() {
+    if (!wait_deadline_.Initialized()) {
+      return false;
+    }
+    auto now = MonoTime::Now();
+    if (now >= wait_deadline_) {
+      wait_deadline_ = MonoTime();
+      return false;
+    }
+    std::vector<TransactionId> blockers;
+    blockers.reserve(transactions_.size());
+    for (const auto& transaction : transactions_) {
+      blockers.push_back(transaction.id);
+    }
+    auto deadline = std::min(
+        wait_deadline_,
+        now + MonoDelta::FromMilliseconds(GetAtomicFlag(&FLAGS_transaction_conflict_wait_poll_ms)));
+    status_manager().WaitForTransactions(
+        context_->WaiterId(), blockers, deadline,
+        [self = shared_from_this()](const Status& status) {
+          self->WaitForTransactionsDone(status);
+        });
+    return true;
+  }
+
+  void WaitForTransactionsDone(const Status& status) {
+    if (status.IsNotSupported()) {
+      wait_deadline_ = MonoTime();
+    } else if (!status.ok()) {
+      InvokeCallback(status);
+      return;
+    }
+    DoResolveConflicts();
+  }
+
+  void InvokeCallback(const Result<HybridTime>& result) {
+    auto callback = std::move(callback_);
+    callback(result);
+  }
+
   CHECKED_STATUS CheckLocalCommits() {
     auto write_iterator = transactions_.begin();
     for (const auto& transaction : transactions_) {
@@ -210,7 +304,7 @@ class ConflictResolver {
         ++write_iterator;
         continue;
       }
-      RETURN_NOT_OK(context_.CheckConflictWithCommitted(transaction.id, commit_time));
+      RETURN_NOT_OK(context_->CheckConflictWithCommitted(transaction.id, commit_time));
     }
     transactions_.erase(write_iterator, transactions_.end());
 
@@ -225,7 +319,8 @@ class ConflictResolver {
       RETURN_NOT_OK(transaction.failure);
       auto status = transaction.status;
       if (status == TransactionStatus::COMMITTED) {
-        RETURN_NOT_OK(context_.CheckConflictWithCommitted(transaction.id, transaction.commit_time));
+        RETURN_NOT_OK(context_->CheckConflictWithCommitted(
+            transaction.id, transaction.commit_time));
         continue;
       } else if (status == TransactionStatus::ABORTED) {
         continue;
@@ -248,8 +343,8 @@ class ConflictResolver {
       auto& transaction = i;
       StatusRequest request = {
         &transaction.id,
-        context_.GetHybridTime(),
-        context_.GetHybridTime(),
+        context_->GetHybridTime(),
+        context_->GetHybridTime(),
         0, // serial no. Could use 0 here, because read_ht == global_limit_ht.
            // So we cannot accept status with time >= read_ht and < global_limit_ht.
         [&transaction, &latch](Result<TransactionStatusResult> result) {
@@ -287,13 +382,17 @@ class ConflictResolver {
     latch.Wait();
   }
 
-  rocksdb::DB* db_;
+  DocDB doc_db_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   Slice intent_key_upperbound_;
   TransactionStatusManager& status_manager_;
-  ConflictResolverContext& context_;
+  std::unique_ptr<ConflictResolverContext> context_;
+  ResolutionCallback callback_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
+  // Until when to wait for conflicting transactions, instead of aborting them. Not initialized
+  // when resolution should not wait.
+  MonoTime wait_deadline_;
 };
 
 // Utility class for ResolveTransactionConflicts implementation.
@@ -348,7 +447,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
       key_slice.consume_byte();
 
       auto value_iter = CreateRocksDBIterator(
-          resolver->db(),
+          resolver->doc_db().regular,
           BloomFilterMode::USE_BLOOM_FILTER,
           key_slice,
           rocksdb::kDefaultQueryId);
@@ -409,6 +508,10 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     return other == *transaction_id_;
   }
 
+  boost::optional<TransactionId> WaiterId() override {
+    return *transaction_id_;
+  }
+
   const KeyValueWriteBatchPB& write_batch_;
   HybridTime hybrid_time_;
   Result<TransactionId> transaction_id_;
@@ -466,6 +569,10 @@ class OperationConflictResolverContext : public ConflictResolverContext {
     return false;
   }
 
+  boost::optional<TransactionId> WaiterId() override {
+    return boost::none;
+  }
+
   CHECKED_STATUS CheckConflictWithCommitted(
       const TransactionId& id, HybridTime commit_time) override {
     hybrid_time_.MakeAtLeast(commit_time);
@@ -479,24 +586,29 @@ class OperationConflictResolverContext : public ConflictResolverContext {
 
 } // namespace
 
-Status ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
-                                   HybridTime hybrid_time,
-                                   rocksdb::DB* db,
-                                   TransactionStatusManager* status_manager) {
+void ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
+                                 HybridTime hybrid_time,
+                                 const DocDB& doc_db,
+                                 TransactionStatusManager* status_manager,
+                                 ResolutionCallback callback) {
   DCHECK(hybrid_time.is_valid());
-  TransactionConflictResolverContext context(write_batch, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
-  return resolver.Resolve();
+  auto resolver = std::make_shared<ConflictResolver>(
+      doc_db, status_manager,
+      std::make_unique<TransactionConflictResolverContext>(write_batch, hybrid_time),
+      std::move(callback));
+  resolver->Resolve();
 }
 
-Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
-                                             HybridTime hybrid_time,
-                                             rocksdb::DB* db,
-                                             TransactionStatusManager* status_manager) {
-  OperationConflictResolverContext context(&doc_ops, hybrid_time);
-  ConflictResolver resolver(db, status_manager, &context);
-  RETURN_NOT_OK(resolver.Resolve());
-  return context.GetHybridTime();
+void ResolveOperationConflicts(const DocOperations& doc_ops,
+                               HybridTime hybrid_time,
+                               const DocDB& doc_db,
+                               TransactionStatusManager* status_manager,
+                               ResolutionCallback callback) {
+  auto resolver = std::make_shared<ConflictResolver>(
+      doc_db, status_manager,
+      std::make_unique<OperationConflictResolverContext>(&doc_ops, hybrid_time),
+      std::move(callback));
+  resolver->Resolve();
 }
 
 #define INTENT_KEY_SCHECK(lhs, op, rhs, msg) \
@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_CONFLICT_RESOLUTION_H
 #define YB_DOCDB_CONFLICT_RESOLUTION_H
 
+#include <functional>
+
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/value_type.h"
 
@@ -35,20 +37,28 @@ namespace docdb {
 
 class KeyValueWriteBatchPB;
 
+// Invoked with the result of conflict resolution. It is invoked synchronously, unless resolution
+// has to wait for conflicting transactions, in which case it is invoked from the thread that
+// continued resolution after the wait.
+typedef std::function<void(const Result<HybridTime>&)> ResolutionCallback;
+
 // Resolves conflicts for write batch of transaction.
 // Read all intents that could conflict with intents generated by provided write_batch.
 // Forms set of conflicting transactions.
 // Tries to abort transactions with lower priority.
 // If it conflicts with transaction with higher priority or committed one then error is returned.
 //
-// write_batch - values that would be written as part of transaction.
+// write_batch - values that would be written as part of transaction, should be alive until
+//               callback is invoked.
 // hybrid_time - current hybrid time.
-// db - db that contains tablet data.
+// doc_db - DocDB that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
-CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
-                                           HybridTime hybrid_time,
-                                           rocksdb::DB* db,
-                                           TransactionStatusManager* status_manager);
+// callback - invoked with hybrid_time when there are no conflicts left.
+void ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_batch,
+                                 HybridTime hybrid_time,
+                                 const DocDB& doc_db,
+                                 TransactionStatusManager* status_manager,
+                                 ResolutionCallback callback);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
@@ -58,14 +68,17 @@ CHECKED_STATUS ResolveTransactionConflicts(const KeyValueWriteBatchPB& write_bat
 // transaction. So we could update local clock and apply those operations later than conflicting
 // transaction.
 //
-// doc_ops - doc operations that would be applied as part of operation.
+// doc_ops - doc operations that would be applied as part of operation, should be alive until
+//           callback is invoked.
 // hybrid_time - current hybrid time.
-// db - db that contains tablet data.
+// doc_db - DocDB that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
-Result<HybridTime> ResolveOperationConflicts(const DocOperations& doc_ops,
-                                             HybridTime hybrid_time,
-                                             rocksdb::DB* db,
-                                             TransactionStatusManager* status_manager);
+// callback - invoked with the hybrid time to apply the operations at.
+void ResolveOperationConflicts(const DocOperations& doc_ops,
+                               HybridTime hybrid_time,
+                               const DocDB& doc_db,
+                               TransactionStatusManager* status_manager,
+                               ResolutionCallback callback);
 
 struct ParsedIntent {
   // Intent DocPath.
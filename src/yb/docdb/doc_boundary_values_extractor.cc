@@ -13,10 +13,16 @@
 //
 //
 
+#include <algorithm>
+
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/value.h"
+
+#include "yb/gutil/endian.h"
 
 namespace yb {
 namespace docdb {
@@ -30,6 +36,10 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+// Expiration time of entries that have explicit TTL, only the largest value is used.
+constexpr rocksdb::UserBoundaryTag kExplicitTtlExpirationTag = 2;
+// Hybrid time of entries that expire according to the table TTL, only the largest value is used.
+constexpr rocksdb::UserBoundaryTag kTableTtlHybridTimeTag = 3;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +90,62 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores plain HybridTime under the specified tag.
+class HybridTimeBoundaryValue : public rocksdb::UserBoundaryValue {
+ public:
+  HybridTimeBoundaryValue(rocksdb::UserBoundaryTag tag, HybridTime hybrid_time) : tag_(tag) {
+    BigEndian::Store64(buffer_, hybrid_time.ToUint64());
+  }
+
+  static CHECKED_STATUS Create(rocksdb::UserBoundaryTag tag, Slice data,
+                               rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_FORMAT(Corruption, "Wrong size of encoded hybrid time: $0", data.size());
+    }
+
+    *value = std::make_shared<HybridTimeBoundaryValue>(
+        tag, HybridTime(BigEndian::Load64(data.data())));
+    return Status::OK();
+  }
+
+  virtual ~HybridTimeBoundaryValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return tag_;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const HybridTimeBoundaryValue*>(&pre_rhs);
+    return Slice(buffer_, sizeof(buffer_)).compare(Slice(rhs->buffer_, sizeof(rhs->buffer_)));
+  }
+
+  HybridTime value() const {
+    return HybridTime(BigEndian::Load64(buffer_));
+  }
+
+ private:
+  rocksdb::UserBoundaryTag tag_;
+  uint8_t buffer_[sizeof(uint64_t)];
+};
+
+// Returns the time when an entry written at write_ht with the given explicit TTL expires.
+HybridTime ExplicitTtlExpiration(HybridTime write_ht, MonoDelta ttl) {
+  if (ttl.ToMilliseconds() == kResetTTL) {
+    return HybridTime::kMax;
+  }
+  // TTL is provided by the user and could be arbitrarily large.
+  const auto ttl_micros = static_cast<MicrosTime>(std::max<int64_t>(ttl.ToMicroseconds(), 0));
+  if (ttl_micros >= kMaxHybridTimePhysicalMicros - write_ht.GetPhysicalValueMicros()) {
+    return HybridTime::kMax;
+  }
+  return write_ht.AddMicroseconds(ttl_micros);
+}
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +213,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kExplicitTtlExpirationTag || tag == kTableTtlHybridTimeTag) {
+      return HybridTimeBoundaryValue::Create(tag, data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -155,15 +224,23 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
   }
 
   Status Extract(Slice user_key, Slice value, rocksdb::UserBoundaryValues* values) override {
-    if (user_key.size() >= 2 &&
-        static_cast<ValueType>(user_key[0]) == ValueType::kIntentPrefix &&
+    CHECK_NOTNULL(values);
+    const bool is_intent =
+        !user_key.empty() && static_cast<ValueType>(user_key[0]) == ValueType::kIntentPrefix;
+    if (is_intent) {
+      // Intents never expire, so a file that contains them should not be dropped by TTL.
+      rocksdb::UpdateUserValue(
+          values,
+          std::make_shared<HybridTimeBoundaryValue>(kExplicitTtlExpirationTag, HybridTime::kMax),
+          rocksdb::UpdateUserValueType::kLargest);
+    }
+    if (is_intent && user_key.size() >= 2 &&
         static_cast<ValueType>(user_key[1]) == ValueType::kTransactionId) {
       // Skipping reverse index from transaction id to keys of write intents belonging to that
       // transaction.
       return Status::OK();
     }
 
-    CHECK_NOTNULL(values);
     boost::container::small_vector<Slice, 20> slices;
     auto user_key_copy = user_key;
     RETURN_NOT_OK(SubDocKey::PartiallyDecode(&user_key_copy, &slices));
@@ -183,6 +260,20 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       values->push_back(std::move(temp));
     }
 
+    if (!is_intent) {
+      DocHybridTime doc_ht;
+      RETURN_NOT_OK(doc_ht.FullyDecodeFrom(slices.back()));
+      MonoDelta ttl;
+      RETURN_NOT_OK(Value::DecodeTTL(value, &ttl));
+      if (ttl.Equals(Value::kMaxTtl)) {
+        values->push_back(std::make_shared<HybridTimeBoundaryValue>(
+            kTableTtlHybridTimeTag, doc_ht.hybrid_time()));
+      } else {
+        values->push_back(std::make_shared<HybridTimeBoundaryValue>(
+            kExplicitTtlExpirationTag, ExplicitTtlExpiration(doc_ht.hybrid_time(), ttl)));
+      }
+    }
+
     DCHECK(PerformSanityCheck(user_key, slices, *values));
 
     return Status::OK();
@@ -253,6 +344,19 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+// Fills max_table_ttl_ht and max_explicit_ttl_expiration from the largest boundary values of a
+// file. Each of them is left invalid when the file has no entries of the corresponding kind.
+void GetTtlBoundaries(const rocksdb::UserBoundaryValues& largest,
+                      HybridTime* max_table_ttl_ht,
+                      HybridTime* max_explicit_ttl_expiration) {
+  auto value = rocksdb::UserValueWithTag(largest, kTableTtlHybridTimeTag);
+  *max_table_ttl_ht = value ? down_cast<HybridTimeBoundaryValue*>(value.get())->value()
+                            : HybridTime::kInvalid;
+  value = rocksdb::UserValueWithTag(largest, kExplicitTtlExpirationTag);
+  *max_explicit_ttl_expiration = value ? down_cast<HybridTimeBoundaryValue*>(value.get())->value()
+                                       : HybridTime::kInvalid;
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
@@ -373,6 +373,47 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestRangeComponentsKeyMatching) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* num_range_components */);
+  std::string keys[] = { "foo", "bar", "test" };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& key : keys) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(EncodeSimpleSubDocKey(key)));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& sub_doc_key_str) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(sub_doc_key_str));
+  };
+
+  for (const auto &key : keys) {
+    ASSERT_TRUE(may_match(EncodeSimpleSubDocKey(key))) << "Key: " << key;
+    ASSERT_TRUE(may_match(EncodeSubDocKey(key, "range_key", "another_sub_key", 55555L)))
+        << "Key: " << key;
+    // Range component is part of the filter key, so rows of the same hash key are distinguished.
+    ASSERT_FALSE(may_match(EncodeSimpleSubDocKeyWithDifferentNonHashPart(key))) << "Key: " << key;
+  }
+
+  // Keys that do not contain the range component could not be checked against such a filter.
+  const DocKey hashed_only(0, PrimitiveValues("foo"), PrimitiveValues());
+  ASSERT_FALSE(policy.CanFilter(hashed_only.Encode().AsSlice()));
+  ASSERT_TRUE(policy.CanFilter(EncodeSimpleSubDocKey("foo")));
+
+  const DocKey with_range(0, PrimitiveValues("foo"), PrimitiveValues("range_key"));
+  ASSERT_TRUE(with_range.PrefixComponentsEqual(
+      DocKey(0, PrimitiveValues("foo"), PrimitiveValues("range_key", 10)), 1));
+  ASSERT_FALSE(with_range.PrefixComponentsEqual(
+      DocKey(0, PrimitiveValues("foo"), PrimitiveValues("another_range_key")), 1));
+  ASSERT_FALSE(with_range.PrefixComponentsEqual(hashed_only, 1));
+  ASSERT_TRUE(with_range.PrefixComponentsEqual(hashed_only, 0));
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
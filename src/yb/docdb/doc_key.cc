@@ -13,6 +13,7 @@
 
 #include "yb/docdb/doc_key.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -25,6 +26,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/util/enums.h"
+#include "yb/util/format.h"
 #include "yb/util/compare_util.h"
 
 using std::ostringstream;
@@ -190,6 +192,22 @@ Result<size_t> DocKey::EncodedSize(Slice slice, DocKeyPart part) {
   return slice.cdata() - initial_begin;
 }
 
+Result<size_t> DocKey::EncodedSizeWithRangeComponents(Slice slice, size_t num_range_components) {
+  auto initial_begin = slice.cdata();
+  RETURN_NOT_OK(DoDecode(&slice, DocKeyPart::HASHED_PART_ONLY, DummyCallback()));
+  for (size_t i = 0; i != num_range_components; ++i) {
+    if (slice.empty()) {
+      return STATUS(Corruption, "Unexpected end of key when decoding document key");
+    }
+    if (static_cast<ValueType>(*slice.data()) == ValueType::kGroupEnd) {
+      break;
+    }
+    RETURN_NOT_OK_PREPEND(PrimitiveValue::DecodeKey(&slice, nullptr),
+        "Error when decoding range components of a document key");
+  }
+  return slice.cdata() - initial_begin;
+}
+
 class DocKey::DecodeFromCallback {
  public:
   explicit DecodeFromCallback(DocKey* key) : key_(key) {
@@ -313,6 +331,16 @@ bool DocKey::HashedComponentsEqual(const DocKey& other) const {
       (!hash_present_ || (hash_ == other.hash_ && hashed_group_ == other.hashed_group_));
 }
 
+bool DocKey::PrefixComponentsEqual(const DocKey& other, size_t num_range_components) const {
+  if (range_group_.size() < num_range_components ||
+      other.range_group_.size() < num_range_components ||
+      !HashedComponentsEqual(other)) {
+    return false;
+  }
+  return std::equal(range_group_.begin(), range_group_.begin() + num_range_components,
+                    other.range_group_.begin());
+}
+
 void DocKey::AddRangeComponent(const PrimitiveValue& val) {
   range_group_.push_back(val);
 }
@@ -682,8 +710,59 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+// Extracts the hashed components and the first num_range_components range components. Keys with
+// less range components, e.g. static columns, are cut at the end of their range group, so the order
+// of keys is preserved.
+class RangeComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangeComponentsExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+  RangeComponentsExtractor(const RangeComponentsExtractor&) = delete;
+  RangeComponentsExtractor& operator=(const RangeComponentsExtractor&) = delete;
+
+  Slice Transform(Slice key) const override {
+    auto size = DocKey::EncodedSizeWithRangeComponents(key, num_range_components_);
+    CHECK_OK(size);
+    return Slice(key.data(), *size);
+  }
+
+ private:
+  const size_t num_range_components_;
+};
+
+std::string FilterPolicyName(size_t num_range_components) {
+  if (num_range_components == 0) {
+    return "DocKeyHashedComponentsFilter";
+  }
+  return Format("DocKeyHashedAnd$0RangeComponentsFilter", num_range_components);
+}
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components)
+    : num_range_components_(num_range_components),
+      name_(FilterPolicyName(num_range_components)) {
+  builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
+      filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+  if (num_range_components_ != 0) {
+    key_transformer_.reset(new RangeComponentsExtractor(num_range_components_));
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() {
+}
+
+bool DocDbAwareFilterPolicy::CanFilter(Slice user_key) const {
+  if (num_range_components_ == 0) {
+    return true;
+  }
+  // The key should not end within the range components that are included to the filter key.
+  boost::container::small_vector<Slice, 8> range_group;
+  return DocKey::PartiallyDecode(&user_key, &range_group).ok() &&
+         range_group.size() >= num_range_components_;
+}
+
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -710,6 +789,9 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (key_transformer_) {
+    return key_transformer_.get();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
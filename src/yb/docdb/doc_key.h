@@ -14,7 +14,10 @@
 #ifndef YB_DOCDB_DOC_KEY_H_
 #define YB_DOCDB_DOC_KEY_H_
 
+#include <limits>
+#include <memory>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
@@ -32,6 +35,22 @@ namespace docdb {
 
 using DocKeyHash = uint16_t;
 
+// Hash codes of the document keys that belong to a tablet, both ends are inclusive. The tablets
+// created by a split start with all the data of the split tablet, so keys outside of this range
+// are skipped by scans and removed by compactions.
+struct DocKeyHashRange {
+  DocKeyHash first = 0;
+  DocKeyHash last = std::numeric_limits<DocKeyHash>::max();
+
+  bool Contains(DocKeyHash hash) const {
+    return first <= hash && hash <= last;
+  }
+
+  bool IsFull() const {
+    return first == 0 && last == std::numeric_limits<DocKeyHash>::max();
+  }
+};
+
 class DocPath;
 
 // ------------------------------------------------------------------------------------------------
@@ -122,6 +141,10 @@ class DocKey {
 
   static Result<size_t> EncodedSize(Slice slice, DocKeyPart part);
 
+  // Returns the size of the encoded key prefix that consists of the hashed part and at most
+  // num_range_components first range components, without the range group end.
+  static Result<size_t> EncodedSizeWithRangeComponents(Slice slice, size_t num_range_components);
+
   // Decode the current document key from the given slice, but expect all bytes to be consumed, and
   // return an error status if that is not the case.
   CHECKED_STATUS FullyDecodeFrom(const rocksdb::Slice& slice);
@@ -142,6 +165,10 @@ class DocKey {
 
   bool HashedComponentsEqual(const DocKey& other) const;
 
+  // Checks that both keys have at least num_range_components range components, and that their
+  // hashed components and first num_range_components range components are equal.
+  bool PrefixComponentsEqual(const DocKey& other, size_t num_range_components) const;
+
   void AddRangeComponent(const PrimitiveValue& val);
 
   int CompareTo(const DocKey& other) const;
@@ -505,15 +532,20 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys and, optionally, the first
+// num_range_components range components for filtering.
+//
+// Filter keys with range components are only useful to lookups that fix those components, and the
+// name of the policy depends on their number, so filters built with another number of range
+// components are never used with it.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger,
+                         size_t num_range_components = 0);
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  ~DocDbAwareFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -527,8 +559,17 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
 
   const KeyTransformer* GetKeyTransformer() const override;
 
+  size_t num_range_components() const { return num_range_components_; }
+
+  // Returns true if user_key contains all the components of its filter key, i.e. it could be
+  // checked against filters of this policy.
+  bool CanFilter(Slice user_key) const;
+
  private:
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  const size_t num_range_components_;
+  const std::string name_;
+  std::unique_ptr<const KeyTransformer> key_transformer_;
 };
 
 }  // namespace docdb
@@ -207,7 +207,7 @@ SubDocKey(DocKey(0x0000, [1], []), [ColumnId(3); HT{ <max> w: 2 }]) -> 4
     }
 
     QLReadOperation read_op(ql_read_req, kNonTransactionalOperationContext);
-    QLRocksDBStorage ql_storage(rocksdb());
+    QLRocksDBStorage ql_storage(doc_db());
     QLResultSet resultset;
     HybridTime read_restart_ht;
     EXPECT_OK(read_op.Execute(
@@ -372,7 +372,7 @@ SubDocKey(DocKey(0x0000, [100], []), [ColumnId(3); HT{ physical: 0 logical: 3000
       )#");
 
   Schema schema = CreateSchema();
-  DocRowwiseIterator iter(schema, schema, kNonTransactionalOperationContext, rocksdb(),
+  DocRowwiseIterator iter(schema, schema, kNonTransactionalOperationContext, doc_db(),
                           ReadHybridTime::FromUint64(3000));
   ASSERT_OK(iter.Init());
   ASSERT_FALSE(iter.HasNext());
@@ -402,7 +402,7 @@ SubDocKey(DocKey(0x0000, [100], []), [ColumnId(3); HT{ physical: 0 logical: 3000
   DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, /* request = */ nullptr,
                              rocksdb::kDefaultQueryId);
   DocRowwiseIterator ql_iter(
-      schema, schema, kNonTransactionalOperationContext, rocksdb(),
+      schema, schema, kNonTransactionalOperationContext, doc_db(),
       ReadHybridTime::FromMicros(3000));
   ASSERT_OK(ql_iter.Init(ql_scan_spec));
   ASSERT_TRUE(ql_iter.HasNext());
@@ -449,7 +449,7 @@ SubDocKey(DocKey(0x0000, [101], []), [ColumnId(3); HT{ physical: 0 logical: 3000
   DocQLScanSpec ql_scan_spec_system(schema, -1, -1, hashed_components_system, nullptr,
                                     rocksdb::kDefaultQueryId);
   DocRowwiseIterator ql_iter_system(
-      schema, schema, kNonTransactionalOperationContext, rocksdb(),
+      schema, schema, kNonTransactionalOperationContext, doc_db(),
       ReadHybridTime::FromMicros(3000));
   ASSERT_OK(ql_iter_system.Init(ql_scan_spec_system));
   ASSERT_TRUE(ql_iter_system.HasNext());
@@ -586,7 +586,7 @@ void DocOperationRangeFilterTest::TestWithSortingType(ColumnSchema::SortingType
       }
       DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, &condition,
                                  rocksdb::kDefaultQueryId, is_forward_scan);
-      DocRowwiseIterator ql_iter(schema, schema, boost::none, rocksdb(),
+      DocRowwiseIterator ql_iter(schema, schema, boost::none, doc_db(),
           ReadHybridTime::FromMicros(3000));
       ASSERT_OK(ql_iter.Init(ql_scan_spec));
       LOG(INFO) << "Expected rows: " << yb::ToString(expected_rows);
@@ -631,6 +631,210 @@ TEST_F_EX(DocOperationTest, TestQLDescAscScan, DocOperationRangeFilterTest) {
   TestWithSortingType(ColumnSchema::kDescending, false);
 }
 
+namespace {
+
+void AddRangeInCondition(ColumnId column_id, const std::vector<int32_t>& values,
+                         QLConditionPB* condition) {
+  condition->set_op(QL_OP_IN);
+  condition->add_operands()->set_column_id(column_id);
+  auto* list = condition->add_operands()->mutable_value()->mutable_list_value();
+  for (auto value : values) {
+    list->add_elems()->set_int32_value(value);
+  }
+}
+
+} // namespace
+
+class DocOperationRangeOptionsTest : public DocOperationTest {
+ public:
+  void TestRangeOptionsScan(ColumnSchema::SortingType r1_sorting_type,
+                            ColumnSchema::SortingType r2_sorting_type);
+};
+
+// IN lists on range columns should make the iterator seek to the matching key prefixes only, also
+// when a leading range column is unrestricted. Rows are returned in key order, that is defined by
+// the sorting types of the range columns.
+void DocOperationRangeOptionsTest::TestRangeOptionsScan(
+    ColumnSchema::SortingType r1_sorting_type, ColumnSchema::SortingType r2_sorting_type) {
+  ColumnSchema hash_column("k", INT32, false, true);
+  ColumnSchema range_column1("r1", INT32, false, false, false, false, 1, r1_sorting_type);
+  ColumnSchema range_column2("r2", INT32, false, false, false, false, 2, r2_sorting_type);
+  ColumnSchema value_column("v", INT32, false, false);
+  auto columns = { hash_column, range_column1, range_column2, value_column };
+  Schema schema(columns, CreateColumnIds(columns.size()), 3);
+
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kNumValues = 6;
+  auto t = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0);
+  for (int32_t r1 = 0; r1 != kNumValues; ++r1) {
+    for (int32_t r2 = 0; r2 != kNumValues; ++r2) {
+      WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema,
+                 { kKey, r1, r2, r1 * kNumValues + r2 }, 1000, t);
+    }
+  }
+
+  // Orders rows the same way as their keys.
+  auto key_order = [r1_sorting_type, r2_sorting_type](
+      const std::pair<int32_t, int32_t>& lhs, const std::pair<int32_t, int32_t>& rhs) {
+    if (lhs.first != rhs.first) {
+      return (r1_sorting_type == ColumnSchema::kDescending) ? lhs.first > rhs.first
+                                                            : lhs.first < rhs.first;
+    }
+    return (r2_sorting_type == ColumnSchema::kDescending) ? lhs.second > rhs.second
+                                                          : lhs.second < rhs.second;
+  };
+
+  auto check_scan = [&](const QLConditionPB& condition,
+                        std::vector<std::pair<int32_t, int32_t>> expected) {
+    std::sort(expected.begin(), expected.end(), key_order);
+    std::vector<PrimitiveValue> hashed_components = { PrimitiveValue::Int32(kKey) };
+    DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, &condition,
+                               rocksdb::kDefaultQueryId);
+    DocRowwiseIterator ql_iter(schema, schema, boost::none, doc_db(),
+                               ReadHybridTime::FromMicros(3000));
+    ASSERT_OK(ql_iter.Init(ql_scan_spec));
+    std::vector<std::pair<int32_t, int32_t>> fetched;
+    while (ql_iter.HasNext()) {
+      QLTableRow value_map;
+      ASSERT_OK(ql_iter.NextRow(&value_map));
+      fetched.emplace_back(value_map.TestValue(1_ColId).value.int32_value(),
+                           value_map.TestValue(2_ColId).value.int32_value());
+    }
+    ASSERT_EQ(expected, fetched);
+  };
+
+  // r1 IN (4, 1, 9) AND r2 IN (5, 2)
+  QLConditionPB condition;
+  condition.set_op(QL_OP_AND);
+  AddRangeInCondition(1_ColId, {4, 1, 9}, condition.add_operands()->mutable_condition());
+  AddRangeInCondition(2_ColId, {5, 2}, condition.add_operands()->mutable_condition());
+  check_scan(condition, {{1, 2}, {1, 5}, {4, 2}, {4, 5}});
+
+  // r2 IN (3, 0), skip-scans over r1.
+  condition.Clear();
+  AddRangeInCondition(2_ColId, {3, 0}, &condition);
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (int32_t r1 = 0; r1 != kNumValues; ++r1) {
+    expected.emplace_back(r1, 0);
+    expected.emplace_back(r1, 3);
+  }
+  check_scan(condition, expected);
+}
+
+TEST_F_EX(DocOperationTest, QLRangeOptionsScan, DocOperationRangeOptionsTest) {
+  TestRangeOptionsScan(ColumnSchema::kAscending, ColumnSchema::kAscending);
+}
+
+TEST_F_EX(DocOperationTest, QLRangeOptionsScanDescending, DocOperationRangeOptionsTest) {
+  TestRangeOptionsScan(ColumnSchema::kDescending, ColumnSchema::kDescending);
+}
+
+TEST_F_EX(DocOperationTest, QLRangeOptionsScanMixedOrder, DocOperationRangeOptionsTest) {
+  TestRangeOptionsScan(ColumnSchema::kDescending, ColumnSchema::kAscending);
+}
+
+class DocOperationRangeBloomFilterTest : public DocOperationTest {
+ protected:
+  size_t num_range_components_in_bloom_filter() const override { return 1; }
+};
+
+// With the first range component in bloom filter keys, point reads and scans restricted to a single
+// r1 value should skip SST files that do not contain that r1, while still returning every row.
+TEST_F_EX(DocOperationTest, QLRangeComponentsBloomFilter, DocOperationRangeBloomFilterTest) {
+  ASSERT_OK(DisableCompactions());
+
+  ColumnSchema hash_column("k", INT32, false, true);
+  ColumnSchema range_column1("r1", INT32, false, false, false, false, 1, ColumnSchema::kAscending);
+  ColumnSchema range_column2("r2", INT32, false, false, false, false, 2, ColumnSchema::kAscending);
+  ColumnSchema value_column("v", INT32, false, false);
+  auto columns = { hash_column, range_column1, range_column2, value_column };
+  TableProperties table_properties;
+  table_properties.SetNumRangeComponentsInBloomFilter(num_range_components_in_bloom_filter());
+  Schema schema(columns, CreateColumnIds(columns.size()), 3, table_properties);
+
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kNumFiles = 3;
+  constexpr int32_t kNumPrefixes = 9;
+  constexpr int32_t kNumRowsPerPrefix = 3;
+  auto t = HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 0);
+  // Interleave r1 values across files, so min/max range of every file covers almost every r1 and
+  // only the bloom filter could tell files apart.
+  for (int32_t file = 0; file != kNumFiles; ++file) {
+    for (int32_t r1 = file; r1 < kNumPrefixes; r1 += kNumFiles) {
+      for (int32_t r2 = 0; r2 != kNumRowsPerPrefix; ++r2) {
+        WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema,
+                   { kKey, r1, r2, r1 * kNumRowsPerPrefix + r2 }, 1000, t);
+      }
+    }
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+  std::vector<rocksdb::LiveFileMetaData> live_files;
+  rocksdb()->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(kNumFiles, live_files.size());
+
+  auto* statistics = rocksdb()->GetDBOptions().statistics.get();
+  auto check_scan = [&](const QLConditionPB* condition,
+                        const std::vector<std::pair<int32_t, int32_t>>& expected) {
+    std::vector<PrimitiveValue> hashed_components = { PrimitiveValue::Int32(kKey) };
+    DocQLScanSpec ql_scan_spec(schema, -1, -1, hashed_components, condition,
+                               rocksdb::kDefaultQueryId);
+    DocRowwiseIterator ql_iter(schema, schema, boost::none, doc_db(),
+                               ReadHybridTime::FromMicros(3000));
+    ASSERT_OK(ql_iter.Init(ql_scan_spec));
+    std::vector<std::pair<int32_t, int32_t>> fetched;
+    while (ql_iter.HasNext()) {
+      QLTableRow value_map;
+      ASSERT_OK(ql_iter.NextRow(&value_map));
+      const auto r1 = value_map.TestValue(1_ColId).value.int32_value();
+      const auto r2 = value_map.TestValue(2_ColId).value.int32_value();
+      ASSERT_EQ(r1 * kNumRowsPerPrefix + r2, value_map.TestValue(3_ColId).value.int32_value());
+      fetched.emplace_back(r1, r2);
+    }
+    ASSERT_EQ(expected, fetched);
+  };
+
+  for (int32_t r1 = 0; r1 != kNumPrefixes; ++r1) {
+    // Prefix scan: r1 = x.
+    QLConditionPB condition;
+    condition.add_operands()->set_column_id(1_ColId);
+    condition.set_op(QL_OP_EQUAL);
+    condition.add_operands()->mutable_value()->set_int32_value(r1);
+    std::vector<std::pair<int32_t, int32_t>> expected;
+    for (int32_t r2 = 0; r2 != kNumRowsPerPrefix; ++r2) {
+      expected.emplace_back(r1, r2);
+    }
+    auto old_useful = statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+    check_scan(&condition, expected);
+    ASSERT_GT(statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL), old_useful);
+
+    // Point read: r1 = x AND r2 = y.
+    for (int32_t r2 = 0; r2 != kNumRowsPerPrefix; ++r2) {
+      QLConditionPB point_condition;
+      point_condition.set_op(QL_OP_AND);
+      const std::vector<std::pair<ColumnId, int32_t>> column_values = {
+          { 1_ColId, r1 }, { 2_ColId, r2 } };
+      for (const auto& column_and_value : column_values) {
+        auto* operand = point_condition.add_operands()->mutable_condition();
+        operand->add_operands()->set_column_id(column_and_value.first);
+        operand->set_op(QL_OP_EQUAL);
+        operand->add_operands()->mutable_value()->set_int32_value(column_and_value.second);
+      }
+      old_useful = statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+      check_scan(&point_condition, {{r1, r2}});
+      ASSERT_GT(statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL), old_useful);
+    }
+  }
+
+  // Full scan of the hash key does not use the bloom filter and still returns every row.
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (int32_t r1 = 0; r1 != kNumPrefixes; ++r1) {
+    for (int32_t r2 = 0; r2 != kNumRowsPerPrefix; ++r2) {
+      expected.emplace_back(r1, r2);
+    }
+  }
+  check_scan(nullptr, expected);
+}
+
 TEST_F(DocOperationTest, TestQLCompactions) {
   yb::QLWriteRequestPB ql_writereq_pb;
   yb::QLResponsePB ql_writeresp_pb;
@@ -811,5 +1015,48 @@ TEST_F(DocOperationTest, MaxFileSizeWithWritesTrigger) {
   ASSERT_EQ(0, stats->GetCFStats(rocksdb::InternalStats::LEVEL0_SLOWDOWN_TOTAL));
 }
 
+TEST_F(DocOperationTest, DropExpiredFiles) {
+  ASSERT_OK(DisableCompactions());
+  auto schema = CreateSchema();
+  auto t0 = HybridTime::FromMicrosecondsAndLogicalValue(1000, 0);
+  auto t1 = HybridClock::AddPhysicalTimeToHybridTime(t0, MonoDelta::FromMilliseconds(100));
+  auto t2 = HybridClock::AddPhysicalTimeToHybridTime(t0, MonoDelta::FromMilliseconds(200));
+
+  // Two files with rows expiring in one second and the newest file with a long living row.
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {1, 1, 1, 1}, 1000, t0);
+  ASSERT_OK(FlushRocksDbAndWait());
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {2, 2, 2, 2}, 1000, t1);
+  ASSERT_OK(FlushRocksDbAndWait());
+  WriteQLRow(QLWriteRequestPB_QLStmtType_QL_STMT_INSERT, schema, {3, 3, 3, 3}, 1000000, t2);
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  rocksdb()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3, files.size());
+
+  // Only the oldest file is expired at this history cutoff.
+  SetHistoryCutoffHybridTime(
+      HybridClock::AddPhysicalTimeToHybridTime(t0, MonoDelta::FromMilliseconds(1050)));
+  ASSERT_OK(ReinitDBOptions());
+  WaitCompactionsDone(rocksdb());
+
+  files.clear();
+  rocksdb()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(2, files.size());
+  ASSERT_EQ(0, ReadQLRow(schema, 1, t1).row_count());
+  ASSERT_EQ(1, ReadQLRow(schema, 2, t1).row_count());
+
+  // The second file is expired as well, while the newest one should be kept.
+  SetHistoryCutoffHybridTime(
+      HybridClock::AddPhysicalTimeToHybridTime(t0, MonoDelta::FromMilliseconds(2000)));
+  ASSERT_OK(ReinitDBOptions());
+  WaitCompactionsDone(rocksdb());
+
+  files.clear();
+  rocksdb()->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(1, ReadQLRow(schema, 3, t2).row_count());
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -13,7 +13,12 @@
 
 #include "yb/docdb/doc_operation.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "yb/common/partition.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_protocol_util.h"
 #include "yb/common/ql_scanspec.h"
@@ -46,6 +51,13 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_bool(ql_aggregate_by_column_batch, true,
+    "Evaluate COUNT, SUM, MIN and MAX aggregates of CQL reads on batches of rows stored column by "
+    "column instead of row by row.");
+
+DEFINE_int32(ql_aggregate_column_batch_size, 1024,
+    "Number of rows read from the iterator at once when aggregating on column batches.");
+
 namespace yb {
 namespace docdb {
 
@@ -485,6 +497,77 @@ void GetNormalizedBounds(int64 low_idx, int64 high_idx, int64 card, bool reverse
   }
 }
 
+// Matches str against a glob-style pattern with the same rules as Redis uses for KEYS and the
+// MATCH option of SCAN: '*', '?', '[...]' with '^' negation and ranges, and '\\' escaping.
+bool MatchesRedisPattern(Slice pattern, Slice str) {
+  while (!pattern.empty()) {
+    char p = pattern[0];
+    pattern.remove_prefix(1);
+    if (p == '*') {
+      while (!pattern.empty() && pattern[0] == '*') {
+        pattern.remove_prefix(1);
+      }
+      if (pattern.empty()) {
+        return true;
+      }
+      for (; !str.empty(); str.remove_prefix(1)) {
+        if (MatchesRedisPattern(pattern, str)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    if (str.empty()) {
+      return false;
+    }
+    const uint8_t c = str[0];
+    str.remove_prefix(1);
+    if (p == '?') {
+      continue;
+    }
+    if (p == '[') {
+      const bool negate = !pattern.empty() && pattern[0] == '^';
+      if (negate) {
+        pattern.remove_prefix(1);
+      }
+      bool match = false;
+      while (!pattern.empty() && pattern[0] != ']') {
+        if (pattern[0] == '\\' && pattern.size() > 1) {
+          pattern.remove_prefix(1);
+          match = match || static_cast<uint8_t>(pattern[0]) == c;
+        } else if (pattern.size() > 2 && pattern[1] == '-') {
+          uint8_t low = pattern[0];
+          uint8_t high = pattern[2];
+          if (low > high) {
+            std::swap(low, high);
+          }
+          match = match || (c >= low && c <= high);
+          pattern.remove_prefix(2);
+        } else {
+          match = match || static_cast<uint8_t>(pattern[0]) == c;
+        }
+        pattern.remove_prefix(1);
+      }
+      if (!pattern.empty()) {
+        // Skip the closing bracket.
+        pattern.remove_prefix(1);
+      }
+      if (match == negate) {
+        return false;
+      }
+      continue;
+    }
+    if (p == '\\' && !pattern.empty()) {
+      p = pattern[0];
+      pattern.remove_prefix(1);
+    }
+    if (static_cast<uint8_t>(p) != c) {
+      return false;
+    }
+  }
+  return str.empty();
+}
+
 } // anonymous namespace
 
 void RedisWriteOperation::InitializeIterator(const DocOperationApplyData& data) {
@@ -492,7 +575,7 @@ void RedisWriteOperation::InitializeIterator(const DocOperationApplyData& data)
       request_.key_value().hash_code(), request_.key_value().key()));
 
   auto iter = yb::docdb::CreateIntentAwareIterator(
-      data.doc_write_batch->rocksdb(), BloomFilterMode::USE_BLOOM_FILTER,
+      data.doc_write_batch->doc_db(), BloomFilterMode::USE_BLOOM_FILTER,
       subdoc_key.Encode().AsSlice(),
       redis_query_id(), /* txn_op_context */ boost::none, data.read_time);
 
@@ -621,7 +704,7 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
           GetSubDocumentData get_data = { encoded_key_reverse, &subdoc_reverse,
                                           &subdoc_reverse_found };
           RETURN_NOT_OK(GetSubDocument(
-              data.doc_write_batch->rocksdb(), get_data, redis_query_id(),
+              data.doc_write_batch->doc_db(), get_data, redis_query_id(),
               boost::none /* txn_op_context */, data.read_time));
 
           // Flag indicating whether we should add the given entry to the sorted set.
@@ -871,7 +954,7 @@ Status RedisWriteOperation::ApplyDel(const DocOperationApplyData& data) {
         GetSubDocumentData get_data = { encoded_subdoc_key_reverse, &doc_reverse,
                                         &doc_reverse_found };
         RETURN_NOT_OK(GetSubDocument(
-        data.doc_write_batch->rocksdb(), get_data, redis_query_id(),
+        data.doc_write_batch->doc_db(), get_data, redis_query_id(),
         boost::none /* txn_op_context */, data.read_time));
         if (doc_reverse_found && doc_reverse.value_type() != ValueType::kTombstone) {
           // The value is already in the doc, needs to be removed.
@@ -1099,8 +1182,12 @@ Status RedisWriteOperation::ApplyRemove(const DocOperationApplyData& data) {
 Status RedisReadOperation::Execute() {
   SubDocKey doc_key(
       DocKey::FromRedisKey(request_.key_value().hash_code(), request_.key_value().key()));
+  // SCAN walks over all the keys of the tablet, so the bloom filter of a single key does not apply.
+  const bool keyspace_scan = request_.has_scan_request() &&
+      request_.scan_request().request_type() == RedisScanRequestPB_ScanRequestType_SCAN;
   auto iter = yb::docdb::CreateIntentAwareIterator(
-      db_, BloomFilterMode::USE_BLOOM_FILTER,
+      doc_db_,
+      keyspace_scan ? BloomFilterMode::DONT_USE_BLOOM_FILTER : BloomFilterMode::USE_BLOOM_FILTER,
       doc_key.Encode().AsSlice(),
       redis_query_id(), /* txn_op_context */ boost::none, read_time_);
   iterator_ = std::move(iter);
@@ -1116,6 +1203,8 @@ Status RedisReadOperation::Execute() {
       return ExecuteGetRange();
     case RedisReadRequestPB::RequestCase::kGetCollectionRangeRequest:
       return ExecuteCollectionGetRange();
+    case RedisReadRequestPB::RequestCase::kScanRequest:
+      return ExecuteScan();
     default:
       return STATUS(Corruption,
           Substitute("Unsupported redis write operation: $0", request_.request_case()));
@@ -1372,6 +1461,148 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
   return Status::OK();
 }
 
+Status RedisReadOperation::ExecuteScan() {
+  const auto& scan_request = request_.scan_request();
+  if (scan_request.count() <= 0) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Scan count should be positive: $0",
+                             scan_request.count());
+  }
+
+  RedisDataType expected_type;
+  switch (scan_request.request_type()) {
+    case RedisScanRequestPB_ScanRequestType_SCAN:
+      return ExecuteKeyspaceScan();
+    case RedisScanRequestPB_ScanRequestType_HSCAN:
+      expected_type = REDIS_TYPE_HASH;
+      break;
+    case RedisScanRequestPB_ScanRequestType_SSCAN:
+      expected_type = REDIS_TYPE_SET;
+      break;
+    case RedisScanRequestPB_ScanRequestType_ZSCAN:
+      expected_type = REDIS_TYPE_SORTEDSET;
+      break;
+    default:
+      return STATUS_SUBSTITUTE(InvalidArgument, "Unsupported scan request type: $0",
+                               scan_request.request_type());
+  }
+
+  response_.set_allocated_array_response(new RedisArrayPB());
+  const auto type = VERIFY_RESULT(GetValueType());
+  if (!VerifyTypeAndSetCode(expected_type, type, &response_, VerifySuccessIfMissing::kTrue)) {
+    return Status::OK();
+  }
+  // A missing key is scanned as an empty collection.
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  if (type == REDIS_TYPE_NONE) {
+    return Status::OK();
+  }
+
+  // Sorted set members are scanned in the reverse mapping, where they are the subkeys and the
+  // scores are the values.
+  auto encoded_doc_key = DocKey::EncodedFromRedisKey(
+      request_.key_value().hash_code(), request_.key_value().key());
+  if (expected_type == REDIS_TYPE_SORTEDSET) {
+    PrimitiveValue(ValueType::kSSReverse).AppendToKey(&encoded_doc_key);
+  }
+  KeyBytes cursor_key;
+  SliceKeyBound low_subkey;
+  if (scan_request.has_cursor()) {
+    cursor_key = encoded_doc_key;
+    PrimitiveValue(scan_request.cursor()).AppendToKey(&cursor_key);
+    low_subkey = SliceKeyBound(cursor_key, LowerBound(/* exclusive */ true));
+  }
+
+  SubDocument doc;
+  bool doc_found = false;
+  GetSubDocumentData data = { encoded_doc_key, &doc, &doc_found };
+  data.low_subkey = &low_subkey;
+  data.limit = scan_request.count();
+  RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
+      SeekFwdSuffices::kFalse));
+  if (!doc_found) {
+    return Status::OK();
+  }
+
+  const auto& children = doc.object_container();
+  auto* array_response = response_.mutable_array_response();
+  for (const auto& child : children) {
+    if (scan_request.has_pattern() &&
+        !MatchesRedisPattern(scan_request.pattern(), child.first.GetString())) {
+      continue;
+    }
+    RETURN_NOT_OK(AddPrimitiveValueToResponseArray(child.first, array_response));
+    if (expected_type != REDIS_TYPE_SET) {
+      RETURN_NOT_OK(AddPrimitiveValueToResponseArray(child.second, array_response));
+    }
+  }
+  // Fewer subkeys than requested means the collection has been scanned to the end.
+  if (children.size() == static_cast<size_t>(scan_request.count())) {
+    response_.set_scan_cursor(children.rbegin()->first.GetString());
+  }
+  return Status::OK();
+}
+
+Status RedisReadOperation::ExecuteKeyspaceScan() {
+  const auto& scan_request = request_.scan_request();
+  const DocKeyHash hash_code = request_.key_value().hash_code();
+  KeyBytes seek_key;
+  if (scan_request.has_cursor() && hash_range_.Contains(hash_code)) {
+    seek_key = DocKey::EncodedFromRedisKey(hash_code, scan_request.cursor());
+    iterator_->SeekOutOfSubDoc(&seek_key);
+  } else {
+    seek_key.AppendValueType(ValueType::kUInt16Hash);
+    seek_key.AppendUInt16(std::max(hash_code, hash_range_.first));
+    iterator_->Seek(seek_key);
+  }
+
+  response_.set_code(RedisResponsePB_RedisStatusCode_OK);
+  auto* array_response = response_.mutable_array_response();
+  RedisKeyValuePB key_value;
+  int32_t num_examined = 0;
+  bool has_more = false;
+  while (iterator_->valid()) {
+    const auto key = VERIFY_RESULT(iterator_->FetchKey());
+    DocKey doc_key;
+    const size_t doc_key_size = VERIFY_RESULT(doc_key.DecodeFrom(key));
+    // Keys past the tablet partition belong to the sibling tablet created by the same split.
+    if (!doc_key.hashed_group().empty() && doc_key.hash() > hash_range_.last) {
+      break;
+    }
+    if (num_examined >= scan_request.count()) {
+      has_more = true;
+      break;
+    }
+    KeyBytes encoded_doc_key(Slice(key.data(), doc_key_size));
+    if (doc_key.hashed_group().size() == 1 &&
+        doc_key.hashed_group()[0].value_type() == ValueType::kString) {
+      key_value.set_hash_code(doc_key.hash());
+      key_value.set_key(doc_key.hashed_group()[0].GetString());
+      ++num_examined;
+      // Skip the keys that are deleted or expired as of the read time.
+      if (VERIFY_RESULT(GetRedisValueType(iterator_.get(), key_value)) != REDIS_TYPE_NONE &&
+          (!scan_request.has_pattern() ||
+           MatchesRedisPattern(scan_request.pattern(), key_value.key()))) {
+        array_response->add_elements(key_value.key());
+      }
+    }
+    iterator_->SeekOutOfSubDoc(&encoded_doc_key);
+  }
+
+  if (has_more) {
+    // The tablet has more keys, resume after the last examined one.
+    response_.set_scan_cursor(
+        PartitionSchema::EncodeMultiColumnHashValue(key_value.hash_code()) + key_value.key());
+  } else if (hash_code > hash_range_.last) {
+    // Request routed by outdated partitions, let the proxy pick the next partition itself.
+  } else if (hash_range_.last == std::numeric_limits<DocKeyHash>::max()) {
+    response_.set_scan_next_partition("");
+  } else {
+    response_.set_scan_next_partition(
+        PartitionSchema::EncodeMultiColumnHashValue(hash_range_.last + 1));
+  }
+  return Status::OK();
+}
+
 Result<RedisDataType> RedisReadOperation::GetValueType(int subkey_index) {
   return GetRedisValueType(iterator_.get(), request_.key_value(),
                            nullptr /* doc_write_batch */, subkey_index);
@@ -1799,7 +2030,7 @@ Status QLWriteOperation::ReadColumns(const DocOperationApplyData& data,
   if (hashed_doc_key_ != nullptr) {
     DocQLScanSpec spec(*static_projection, *hashed_doc_key_, request_.query_id());
     DocRowwiseIterator iterator(*static_projection, schema_, txn_op_context_,
-                                data.doc_write_batch->rocksdb(), data.read_time);
+                                data.doc_write_batch->doc_db(), data.read_time);
     RETURN_NOT_OK(iterator.Init(spec));
     if (iterator.HasNext()) {
       RETURN_NOT_OK(iterator.NextRow(table_row));
@@ -1809,7 +2040,7 @@ Status QLWriteOperation::ReadColumns(const DocOperationApplyData& data,
   if (pk_doc_key_ != nullptr) {
     DocQLScanSpec spec(*non_static_projection, *pk_doc_key_, request_.query_id());
     DocRowwiseIterator iterator(*non_static_projection, schema_, txn_op_context_,
-                                data.doc_write_batch->rocksdb(), data.read_time);
+                                data.doc_write_batch->doc_db(), data.read_time);
     RETURN_NOT_OK(iterator.Init(spec));
     if (iterator.HasNext()) {
       RETURN_NOT_OK(iterator.NextRow(table_row));
@@ -2092,7 +2323,7 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
 
           // Create iterator.
           DocRowwiseIterator iterator(projection, schema_, txn_op_context_,
-                                      data.doc_write_batch->rocksdb(), data.read_time);
+                                      data.doc_write_batch->doc_db(), data.read_time);
           RETURN_NOT_OK(iterator.Init(spec));
 
           // Iterate through rows and delete those that match the condition.
@@ -2339,8 +2570,16 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     }
   }
 
-  // Begin the normal fetch.
   int match_count = 0;
+  // Aggregate on column batches when possible. This consumes the whole iterator, so the row by row
+  // fetch below finds no more rows.
+  if (FLAGS_ql_aggregate_by_column_batch && static_row_spec == nullptr &&
+      CanAggregateByColumnBatch(schema)) {
+    RETURN_NOT_OK(AggregateByColumnBatch(
+        schema, non_static_projection, *spec, iter.get(), &match_count));
+  }
+
+  // Begin the normal fetch.
   bool static_dealt_with = true;
   while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
     const bool last_read_static = iter->IsNextStaticColumn();
@@ -2461,6 +2700,269 @@ CHECKED_STATUS QLReadOperation::EvalAggregate(const QLTableRow& table_row) {
   return Status::OK();
 }
 
+namespace {
+
+bool IsBatchAggregate(bfql::TSOpcode opcode) {
+  switch (opcode) {
+    case bfql::TSOpcode::kCount: FALLTHROUGH_INTENDED;
+    case bfql::TSOpcode::kSum: FALLTHROUGH_INTENDED;
+    case bfql::TSOpcode::kMin: FALLTHROUGH_INTENDED;
+    case bfql::TSOpcode::kMax:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the value of an integer aggregate as int64.
+int64_t IntAggregateValue(const QLValue& value) {
+  switch (value.type()) {
+    case QLValuePB::kInt8Value: return value.int8_value();
+    case QLValuePB::kInt16Value: return value.int16_value();
+    case QLValuePB::kInt32Value: return value.int32_value();
+    case QLValuePB::kInt64Value: return value.int64_value();
+    default: break;
+  }
+  LOG(DFATAL) << "Unexpected aggregate value: " << value.ToString();
+  return 0;
+}
+
+// Sums selected non-null values of the column into the aggregate, keeping the type of the column
+// like DocExprExecutor::EvalSum does. Integer sums wrap around the same way as adding values one by
+// one, so they are accumulated in uint64 and truncated to the column type at the end.
+void SumColumn(const QLColumnVector& column, const std::vector<uint8_t>& selection,
+               QLValue* aggr_sum) {
+  bool found = !aggr_sum->IsNull();
+  switch (column.data_type()) {
+    case INT8: FALLTHROUGH_INTENDED;
+    case INT16: FALLTHROUGH_INTENDED;
+    case INT32: FALLTHROUGH_INTENDED;
+    case INT64: {
+      uint64_t sum = found ? static_cast<uint64_t>(IntAggregateValue(*aggr_sum)) : 0;
+      for (size_t row = 0; row != selection.size(); ++row) {
+        if (selection[row] && !column.IsNull(row)) {
+          sum += static_cast<uint64_t>(column.int_value(row));
+          found = true;
+        }
+      }
+      if (!found) {
+        return;
+      }
+      const int64_t value = static_cast<int64_t>(sum);
+      switch (column.data_type()) {
+        case INT8: aggr_sum->set_int8_value(static_cast<int8_t>(value)); return;
+        case INT16: aggr_sum->set_int16_value(static_cast<int16_t>(value)); return;
+        case INT32: aggr_sum->set_int32_value(static_cast<int32_t>(value)); return;
+        default: aggr_sum->set_int64_value(value); return;
+      }
+    }
+    case FLOAT: {
+      float sum = found ? aggr_sum->float_value() : 0;
+      for (size_t row = 0; row != selection.size(); ++row) {
+        if (selection[row] && !column.IsNull(row)) {
+          const float value = static_cast<float>(column.double_value(row));
+          sum = found ? sum + value : value;
+          found = true;
+        }
+      }
+      if (found) {
+        aggr_sum->set_float_value(sum);
+      }
+      return;
+    }
+    case DOUBLE: {
+      double sum = found ? aggr_sum->double_value() : 0;
+      for (size_t row = 0; row != selection.size(); ++row) {
+        if (selection[row] && !column.IsNull(row)) {
+          sum = found ? sum + column.double_value(row) : column.double_value(row);
+          found = true;
+        }
+      }
+      if (found) {
+        aggr_sum->set_double_value(sum);
+      }
+      return;
+    }
+    default:
+      break;
+  }
+  LOG(DFATAL) << "Unexpected column type for SUM: " << DataType_Name(column.data_type());
+}
+
+// Returns the index of the selected non-null row with the minimum (or maximum) value of the column,
+// or -1 when there is no such row. Values are compared the same way as QLValue does.
+ssize_t FindExtremeRow(const QLColumnVector& column, const std::vector<uint8_t>& selection,
+                       bool find_max) {
+  auto compare = [&column](size_t lhs, size_t rhs) {
+    switch (column.layout()) {
+      case QLColumnVectorLayout::kInt: {
+        const int64_t lhs_value = column.int_value(lhs);
+        const int64_t rhs_value = column.int_value(rhs);
+        return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+      }
+      case QLColumnVectorLayout::kDouble: {
+        const double lhs_value = column.double_value(lhs);
+        const double rhs_value = column.double_value(rhs);
+        const bool lhs_is_nan = std::isnan(lhs_value);
+        const bool rhs_is_nan = std::isnan(rhs_value);
+        if (lhs_is_nan || rhs_is_nan) {
+          return lhs_is_nan == rhs_is_nan ? 0 : (lhs_is_nan ? 1 : -1);
+        }
+        return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+      }
+      case QLColumnVectorLayout::kBytes:
+        return column.bytes_value(lhs).compare(column.bytes_value(rhs));
+      case QLColumnVectorLayout::kValue:
+        break;
+    }
+    LOG(DFATAL) << "Unexpected column layout: " << ToString(column.layout());
+    return 0;
+  };
+
+  ssize_t result = -1;
+  for (size_t row = 0; row != selection.size(); ++row) {
+    if (!selection[row] || column.IsNull(row)) {
+      continue;
+    }
+    if (result < 0) {
+      result = row;
+      continue;
+    }
+    const int cmp = compare(row, result);
+    if (find_max ? cmp > 0 : cmp < 0) {
+      result = row;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+bool QLReadOperation::CanAggregateByColumnBatch(const Schema& schema) const {
+  if (!request_.is_aggregate() || request_.distinct() || schema.has_statics()) {
+    return false;
+  }
+
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    if (!expr.has_tscall() || expr.tscall().operands().size() != 1) {
+      return false;
+    }
+    const auto opcode = static_cast<bfql::TSOpcode>(expr.tscall().opcode());
+    if (!IsBatchAggregate(opcode)) {
+      return false;
+    }
+    // COUNT of any column is computed from nulls only, COUNT(*) counts the selected rows.
+    if (opcode == bfql::TSOpcode::kCount) {
+      continue;
+    }
+    const QLExpressionPB& operand = expr.tscall().operands(0);
+    if (!operand.has_column_id()) {
+      return false;
+    }
+    const int index = schema.find_column_by_id(ColumnId(operand.column_id()));
+    if (index < 0) {
+      return false;
+    }
+    const DataType data_type = schema.column(index).type()->main();
+    if (opcode == bfql::TSOpcode::kSum) {
+      switch (data_type) {
+        case INT8: FALLTHROUGH_INTENDED;
+        case INT16: FALLTHROUGH_INTENDED;
+        case INT32: FALLTHROUGH_INTENDED;
+        case INT64: FALLTHROUGH_INTENDED;
+        case FLOAT: FALLTHROUGH_INTENDED;
+        case DOUBLE:
+          break;
+        default:
+          return false;
+      }
+    } else if (QLColumnVector::LayoutFor(data_type) == QLColumnVectorLayout::kValue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CHECKED_STATUS QLReadOperation::AggregateByColumnBatch(const Schema& schema,
+                                                       const Schema& projection,
+                                                       const common::QLScanSpec& spec,
+                                                       common::YQLRowwiseIteratorIf* iter,
+                                                       int* match_count) {
+  // Same columns as DocRowwiseIterator::NextRow() populates: all key columns and the projection.
+  QLColumnBatch batch;
+  for (size_t i = 0; i < schema.num_key_columns(); i++) {
+    batch.AddColumn(schema.column_id(i), schema.column(i).type()->main());
+  }
+  for (size_t i = 0; i < projection.num_columns(); i++) {
+    batch.AddColumn(projection.column_id(i), projection.column(i).type()->main());
+  }
+
+  if (aggr_result_.empty()) {
+    aggr_result_.resize(request_.selected_exprs().size());
+  }
+
+  std::vector<uint8_t> selection;
+  while (iter->HasNext()) {
+    batch.Clear();
+    RETURN_NOT_OK(iter->NextBatch(FLAGS_ql_aggregate_column_batch_size, &batch));
+    RETURN_NOT_OK(spec.MatchBatch(batch, &selection));
+    *match_count += std::count(selection.begin(), selection.end(), 1);
+    RETURN_NOT_OK(EvalAggregate(batch, selection));
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS QLReadOperation::EvalAggregate(const QLColumnBatch& batch,
+                                              const std::vector<uint8_t>& selection) {
+  int aggr_index = 0;
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    QLValue* aggr_result = &aggr_result_[aggr_index++];
+    const QLExpressionPB& operand = expr.tscall().operands(0);
+    // A column that is not read is null in every row.
+    const QLColumnVector* column =
+        operand.has_column_id() ? batch.FindColumn(operand.column_id()) : nullptr;
+
+    switch (static_cast<bfql::TSOpcode>(expr.tscall().opcode())) {
+      case bfql::TSOpcode::kCount: {
+        int64_t count = 0;
+        for (size_t row = 0; row != selection.size(); ++row) {
+          if (selection[row] && (!operand.has_column_id() ||
+                                 (column != nullptr && !column->IsNull(row)))) {
+            ++count;
+          }
+        }
+        if (count != 0) {
+          aggr_result->set_int64_value((aggr_result->IsNull() ? 0 : aggr_result->int64_value()) +
+                                       count);
+        }
+        break;
+      }
+
+      case bfql::TSOpcode::kSum:
+        if (column != nullptr) {
+          SumColumn(*column, selection, aggr_result);
+        }
+        break;
+
+      case bfql::TSOpcode::kMin: FALLTHROUGH_INTENDED;
+      case bfql::TSOpcode::kMax: {
+        const bool find_max = expr.tscall().opcode() == static_cast<int>(bfql::TSOpcode::kMax);
+        const ssize_t row = column != nullptr ? FindExtremeRow(*column, selection, find_max) : -1;
+        if (row >= 0) {
+          QLValue value;
+          column->GetValue(row, value.mutable_value());
+          RETURN_NOT_OK(find_max ? EvalMax(value, aggr_result) : EvalMin(value, aggr_result));
+        }
+        break;
+      }
+
+      default:
+        return STATUS_FORMAT(IllegalState, "Unexpected aggregate: $0", expr.ShortDebugString());
+    }
+  }
+  return Status::OK();
+}
+
 CHECKED_STATUS QLReadOperation::PopulateAggregate(const QLTableRow& table_row,
                                                   QLResultSet *resultset) {
   int column_count = request_.selected_exprs().size();
@@ -2633,7 +3135,7 @@ CHECKED_STATUS PgsqlWriteOperation::ReadColumns(const DocOperationApplyData& dat
     DocRowwiseIterator iterator(column_projection,
                                 schema_,
                                 txn_op_context_,
-                                data.doc_write_batch->rocksdb(),
+                                data.doc_write_batch->doc_db(),
                                 data.read_time);
     RETURN_NOT_OK(iterator.Init(spec));
     if (iterator.HasNext()) {
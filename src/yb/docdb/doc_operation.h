@@ -120,9 +120,13 @@ class RedisWriteOperation : public DocOperation {
 
 class RedisReadOperation {
  public:
-  explicit RedisReadOperation(const yb::RedisReadRequestPB& request,
-                              rocksdb::DB* db,
-      const ReadHybridTime& read_time) : request_(request), db_(db), read_time_(read_time) {}
+  // hash_range is the range of hash codes of the tablet partition. Tablets created by a split keep
+  // the keys of their sibling until compaction, so keyspace scans skip keys outside of it.
+  RedisReadOperation(const yb::RedisReadRequestPB& request,
+                     const DocDB& doc_db,
+                     const ReadHybridTime& read_time,
+                     DocKeyHashRange hash_range)
+      : request_(request), doc_db_(doc_db), read_time_(read_time), hash_range_(hash_range) {}
 
   CHECKED_STATUS Execute();
 
@@ -144,13 +148,17 @@ class RedisReadOperation {
   CHECKED_STATUS ExecuteExists();
   CHECKED_STATUS ExecuteGetRange();
   CHECKED_STATUS ExecuteCollectionGetRange();
+  // Used to implement SCAN, HSCAN, SSCAN, ZSCAN.
+  CHECKED_STATUS ExecuteScan();
+  CHECKED_STATUS ExecuteKeyspaceScan();
 
   rocksdb::QueryId redis_query_id() { return reinterpret_cast<rocksdb::QueryId> (&request_); }
 
   const RedisReadRequestPB& request_;
   RedisResponsePB response_;
-  rocksdb::DB* db_;
+  const DocDB doc_db_;
   ReadHybridTime read_time_;
+  const DocKeyHashRange hash_range_;
   // TODO: Move iterator_ to a superclass of RedisWriteOperation RedisReadOperation
   // Make these two classes similar in terms of how rocksdb state is passed to them.
   // Currently ReadOperations get the state during construction, but Write operations get them when
@@ -277,6 +285,21 @@ class QLReadOperation : public DocExprExecutor {
   QLResponsePB& response() { return response_; }
 
  private:
+  // Whether the aggregates of the request could be evaluated on column batches by
+  // AggregateByColumnBatch().
+  bool CanAggregateByColumnBatch(const Schema& schema) const;
+
+  // Reads all remaining rows of the iterator in column batches and evaluates the aggregates on
+  // the rows that match the scan spec.
+  CHECKED_STATUS AggregateByColumnBatch(const Schema& schema,
+                                        const Schema& projection,
+                                        const common::QLScanSpec& spec,
+                                        common::YQLRowwiseIteratorIf* iter,
+                                        int* match_count);
+
+  // Evaluate aggregates for the selected rows of the batch.
+  CHECKED_STATUS EvalAggregate(const QLColumnBatch& batch, const std::vector<uint8_t>& selection);
+
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
   QLResponsePB response_;
@@ -11,6 +11,8 @@
 // under the License.
 //
 
+#include <algorithm>
+
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/rocksdb/db/compaction.h"
@@ -18,6 +20,87 @@
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Collects the discrete values range columns are restricted to by the conjuncts of 'condition'.
+void CollectRangeOptions(const Schema& schema, const QLConditionPB& condition,
+                         DocQLScanSpec::RangeOptions* options) {
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_AND:
+      for (const auto& operand : operands) {
+        if (operand.expr_case() == QLExpressionPB::ExprCase::kCondition) {
+          CollectRangeOptions(schema, operand.condition(), options);
+        }
+      }
+      return;
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_IN:
+      break;
+    default:
+      // Values under OR / NOT or of other operators are not a restriction of the whole condition.
+      return;
+  }
+
+  if (operands.size() != 2) {
+    return;
+  }
+  const QLExpressionPB* col_expr = &operands.Get(0);
+  const QLExpressionPB* val_expr = &operands.Get(1);
+  if (condition.op() == QL_OP_EQUAL &&
+      col_expr->expr_case() == QLExpressionPB::ExprCase::kValue) {
+    std::swap(col_expr, val_expr);
+  }
+  if (col_expr->expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+      val_expr->expr_case() != QLExpressionPB::ExprCase::kValue) {
+    return;
+  }
+  const int column_idx = schema.find_column_by_id(ColumnId(col_expr->column_id()));
+  if (column_idx == Schema::kColumnNotFound || !schema.is_range_column(column_idx)) {
+    return;
+  }
+  auto& column_options = (*options)[column_idx - schema.num_hash_key_columns()];
+  if (!column_options.empty()) {
+    // Already restricted by another conjunct, either list is a superset of the matching values.
+    return;
+  }
+
+  const auto sorting_type = schema.column(column_idx).sorting_type();
+  if (condition.op() == QL_OP_EQUAL) {
+    if (!IsNull(val_expr->value())) {
+      column_options.push_back(PrimitiveValue::FromQLValuePB(val_expr->value(), sorting_type));
+    }
+    return;
+  }
+  for (const auto& value : val_expr->value().list_value().elems()) {
+    // NULL never equals to a column value.
+    if (!IsNull(value)) {
+      column_options.push_back(PrimitiveValue::FromQLValuePB(value, sorting_type));
+    }
+  }
+  std::sort(column_options.begin(), column_options.end());
+  column_options.erase(std::unique(column_options.begin(), column_options.end()),
+                       column_options.end());
+}
+
+DocQLScanSpec::RangeOptions RangeOptionsFromCondition(const Schema& schema,
+                                                      const QLConditionPB* condition) {
+  DocQLScanSpec::RangeOptions result;
+  if (condition == nullptr || schema.num_range_key_columns() == 0) {
+    return result;
+  }
+  result.resize(schema.num_range_key_columns());
+  CollectRangeOptions(schema, *condition, &result);
+  for (const auto& column_options : result) {
+    if (!column_options.empty()) {
+      return result;
+    }
+  }
+  return DocQLScanSpec::RangeOptions();
+}
+
+} // namespace
+
 DocQLScanSpec::DocQLScanSpec(const Schema& schema,
                              const DocKey& doc_key,
                              const rocksdb::QueryId query_id,
@@ -56,6 +139,7 @@ DocQLScanSpec::DocQLScanSpec(const Schema& schema,
       lower_doc_key_(bound_key(true)),
       upper_doc_key_(bound_key(false)),
       include_static_columns_(include_static_columns),
+      range_options_(RangeOptionsFromCondition(schema, condition)),
       query_id_(query_id) {
 }
 
@@ -26,6 +26,10 @@ namespace docdb {
 // DocDB variant of QL scanspec.
 class DocQLScanSpec : public common::QLScanSpec {
  public:
+  // For every range column in key order, the discrete values it is restricted to by the WHERE
+  // clause (<column> = <value> or <column> IN (<values>)), sorted in key order. The list of a
+  // column that is not restricted that way is empty.
+  typedef std::vector<std::vector<PrimitiveValue>> RangeOptions;
 
   // Scan for the specified doc_key. If the doc_key specify a full primary key, the scan spec will
   // not include any static column for the primary key. If the static columns are needed, a separate
@@ -58,6 +62,11 @@ class DocQLScanSpec : public common::QLScanSpec {
     return query_id_;
   }
 
+  // Range column options to seek to, empty if no range column is restricted to discrete values.
+  const RangeOptions& range_options() const {
+    return range_options_;
+  }
+
  private:
 
   // Return inclusive lower/upper range doc key considering the start_doc_key.
@@ -102,6 +111,9 @@ class DocQLScanSpec : public common::QLScanSpec {
   // Does the scan include static columns also?
   const bool include_static_columns_;
 
+  // Discrete values of the range columns, see RangeOptions.
+  const RangeOptions range_options_;
+
   // Query ID of this scan.
   const rocksdb::QueryId query_id_;
 };
@@ -13,7 +13,10 @@
 
 #include "yb/docdb/doc_rowwise_iterator.h"
 
+#include <algorithm>
+
 #include "yb/common/partition.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/transaction.h"
 #include "yb/common/ql_scanspec.h"
 #include "yb/docdb/docdb.h"
@@ -38,14 +41,14 @@ DocRowwiseIterator::DocRowwiseIterator(
     const Schema &projection,
     const Schema &schema,
     const TransactionOperationContextOpt& txn_op_context,
-    rocksdb::DB *db,
+    const DocDB& doc_db,
     const ReadHybridTime& read_time,
     yb::util::PendingOperationCounter* pending_op_counter)
     : projection_(projection),
       schema_(schema),
       txn_op_context_(txn_op_context),
       read_time_(read_time),
-      db_(db),
+      doc_db_(doc_db),
       has_bound_key_(false),
       pending_op_(pending_op_counter),
       done_(false) {
@@ -64,7 +67,7 @@ Status DocRowwiseIterator::Init() {
   auto query_id = rocksdb::kDefaultQueryId;
 
   db_iter_ = CreateIntentAwareIterator(
-      db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+      doc_db_, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
       query_id, txn_op_context_, read_time_);
 
   row_key_ = DocKey();
@@ -89,7 +92,8 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
 
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
   const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
+      upper_doc_key.PrefixComponentsEqual(
+          lower_doc_key, schema_.table_properties().num_range_components_in_bloom_filter());
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
@@ -97,7 +101,7 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
   db_iter_ = CreateIntentAwareIterator(
-      db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
+      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
 
   db_iter_->Seek(row_key_encoded);
@@ -119,6 +123,7 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
     if (has_bound_key_) {
       db_iter_->Seek(lower_doc_key);
     }
+    range_options_ = doc_spec.range_options();
   } else {
     if (has_bound_key_) {
       db_iter_->PrevDocKey(upper_doc_key);
@@ -144,7 +149,8 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
 
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
   const bool is_fixed_point_get = !lower_doc_key.empty() &&
-      upper_doc_key.HashedComponentsEqual(lower_doc_key);
+      upper_doc_key.PrefixComponentsEqual(
+          lower_doc_key, schema_.table_properties().num_range_components_in_bloom_filter());
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER :
       BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
@@ -152,7 +158,7 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
 
   db_iter_ = CreateIntentAwareIterator(
-      db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
+      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_, read_time_,
       doc_spec.CreateFileFilter());
 
   db_iter_->Seek(row_key_encoded);
@@ -240,6 +246,10 @@ bool DocRowwiseIterator::HasNext() const {
       return false;
     }
 
+    if (SeekToNextRangeOption()) {
+      continue;
+    }
+
     // Prepare the DocKey to get the SubDocument. Trim the DocKey to contain just the primary key.
     Slice sub_doc_key(iter_key_.data().data(), *dockey_size);
     GetSubDocumentData data = { sub_doc_key, &row_, &doc_found };
@@ -274,6 +284,81 @@ bool DocRowwiseIterator::HasNext() const {
   return true;
 }
 
+bool DocRowwiseIterator::SeekToNextRangeOption() const {
+  const auto& components = row_key_.range_group();
+  // Rows of static columns have no range components.
+  if (range_options_.empty() || components.size() != range_options_.size()) {
+    return false;
+  }
+
+  // Find the first range column that does not match its options.
+  size_t column = 0;
+  const PrimitiveValue* next_value = nullptr;
+  for (; column != range_options_.size(); ++column) {
+    const auto& options = range_options_[column];
+    if (options.empty()) {
+      continue;
+    }
+    auto it = std::lower_bound(options.begin(), options.end(), components[column]);
+    if (it != options.end() && *it == components[column]) {
+      continue;
+    }
+    if (it != options.end()) {
+      next_value = &*it;
+    }
+    break;
+  }
+  if (column == range_options_.size()) {
+    return false;
+  }
+
+  // A key that has only a prefix of the range components sorts before all keys extending it, so
+  // the target may omit the components that follow the changed one.
+  DocKey target = row_key_;
+  target.ClearRangeComponents();
+  if (next_value == nullptr) {
+    // The column is past its last option, move on to the next value of a preceding column. For an
+    // unrestricted column that is any greater value, for a restricted one its next option. If
+    // there is none, we are done with this hash key.
+    bool found = false;
+    while (column > 0 && !found) {
+      --column;
+      const auto& options = range_options_[column];
+      if (options.empty()) {
+        found = true;
+      } else {
+        auto it = std::upper_bound(options.begin(), options.end(), components[column]);
+        if (it != options.end()) {
+          next_value = &*it;
+          found = true;
+        }
+      }
+    }
+    if (!found) {
+      target.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
+    } else {
+      for (size_t i = 0; i != column; ++i) {
+        target.AddRangeComponent(components[i]);
+      }
+      if (next_value != nullptr) {
+        target.AddRangeComponent(*next_value);
+      } else {
+        target.AddRangeComponent(components[column]);
+        target.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
+      }
+    }
+  } else {
+    for (size_t i = 0; i != column; ++i) {
+      target.AddRangeComponent(components[i]);
+    }
+    target.AddRangeComponent(*next_value);
+  }
+
+  VLOG(4) << "Skipping from " << row_key_.ToString() << " to " << target.ToString();
+  db_iter_->Seek(target);
+  return true;
+}
+
 string DocRowwiseIterator::ToString() const {
   return "DocRowwiseIterator";
 }
@@ -305,6 +390,56 @@ CHECKED_STATUS SetQLPrimaryKeyColumnValues(const Schema& schema,
   return Status::OK();
 }
 
+// Appends a primitive value to the column vector. Types that the vector stores unboxed are
+// converted the same way as PrimitiveValue::ToQLValuePB does, but without building a QLValuePB.
+void AppendPrimitiveValue(const PrimitiveValue& value,
+                          const std::shared_ptr<QLType>& ql_type,
+                          QLColumnVector* column) {
+  if (value.value_type() == ValueType::kNull ||
+      value.value_type() == ValueType::kNullDescending ||
+      value.value_type() == ValueType::kInvalid) {
+    column->AppendNull();
+    return;
+  }
+
+  switch (column->data_type()) {
+    case INT8:
+      column->AppendInt(static_cast<int8_t>(value.GetInt32()));
+      return;
+    case INT16:
+      column->AppendInt(static_cast<int16_t>(value.GetInt32()));
+      return;
+    case INT32:
+      column->AppendInt(value.GetInt32());
+      return;
+    case INT64:
+      column->AppendInt(value.GetInt64());
+      return;
+    case BOOL:
+      column->AppendInt(value.value_type() == ValueType::kTrue ? 1 : 0);
+      return;
+    case TIMESTAMP:
+      column->AppendInt(value.GetTimestamp().ToInt64());
+      return;
+    case FLOAT:
+      column->AppendDouble(value.GetFloat());
+      return;
+    case DOUBLE:
+      column->AppendDouble(value.GetDouble());
+      return;
+    case STRING: FALLTHROUGH_INTENDED;
+    case BINARY:
+      column->AppendBytes(value.GetString());
+      return;
+    default: {
+      QLValuePB ql_value;
+      PrimitiveValue::ToQLValuePB(value, ql_type, &ql_value);
+      column->AppendValue(ql_value);
+      return;
+    }
+  }
+}
+
 } // namespace
 
 void DocRowwiseIterator::SkipRow() {
@@ -369,6 +504,80 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   return Status::OK();
 }
 
+Status DocRowwiseIterator::NextBatch(size_t max_rows, QLColumnBatch* batch) {
+  // Where to take the value of each batch column from: a hash or range component of the doc key,
+  // or a sub-document of the row.
+  struct ColumnSource {
+    const std::vector<PrimitiveValue>* key_group = nullptr;
+    size_t key_index = 0;
+    PrimitiveValue subkey;
+    std::shared_ptr<QLType> ql_type;
+  };
+  std::vector<ColumnSource> sources(batch->num_columns());
+  for (size_t i = 0; i != batch->num_columns(); ++i) {
+    const ColumnId column_id(batch->column(i).column_id());
+    const int column_index = schema_.find_column_by_id(column_id);
+    if (column_index < 0) {
+      return STATUS_FORMAT(InvalidArgument, "Column id $0 not found", column_id.rep());
+    }
+    const size_t index = column_index;
+    auto& source = sources[i];
+    source.ql_type = schema_.column(index).type();
+    if (index < schema_.num_hash_key_columns()) {
+      source.key_group = &row_key_.hashed_group();
+      source.key_index = index;
+    } else if (index < schema_.num_key_columns()) {
+      source.key_group = &row_key_.range_group();
+      source.key_index = index - schema_.num_hash_key_columns();
+    } else {
+      source.subkey = PrimitiveValue(column_id);
+    }
+  }
+
+  for (size_t row = 0; row != max_rows && HasNext(); ++row) {
+    // Same checks as in DoNextRow: an error in HasNext is reported here.
+    RETURN_NOT_OK(status_);
+    if (!row_key_.range_group().empty() &&
+        row_key_.range_group().size() != schema_.num_range_key_columns()) {
+      return STATUS_FORMAT(Corruption, "$0 range primary key columns found but $1 expected",
+                           row_key_.range_group().size(), schema_.num_range_key_columns());
+    }
+    if (row_key_.hashed_group().size() != schema_.num_hash_key_columns()) {
+      return STATUS_FORMAT(Corruption, "$0 hash primary key columns found but $1 expected",
+                           row_key_.hashed_group().size(), schema_.num_hash_key_columns());
+    }
+
+    for (size_t i = 0; i != batch->num_columns(); ++i) {
+      const auto& source = sources[i];
+      QLColumnVector& column = batch->column(i);
+      if (source.key_group != nullptr) {
+        // Range columns are absent for rows that have static columns only.
+        if (source.key_group->empty()) {
+          column.AppendNull();
+        } else {
+          AppendPrimitiveValue((*source.key_group)[source.key_index], source.ql_type, &column);
+        }
+        continue;
+      }
+
+      const SubDocument* column_value = row_.GetChild(source.subkey);
+      if (column_value == nullptr) {
+        column.AppendNull();
+      } else if (column.layout() != QLColumnVectorLayout::kValue) {
+        AppendPrimitiveValue(*column_value, source.ql_type, &column);
+      } else {
+        QLValuePB ql_value;
+        SubDocument::ToQLValuePB(*column_value, source.ql_type, &ql_value);
+        column.AppendValue(ql_value);
+      }
+    }
+    batch->FinishRow();
+    row_ready_ = false;
+  }
+
+  return status_;
+}
+
 bool DocRowwiseIterator::LivenessColumnExists() const {
   const SubDocument* subdoc = row_.GetChild(
       PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
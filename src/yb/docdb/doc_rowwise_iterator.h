@@ -24,6 +24,7 @@
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/read_hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_types.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_pgsql_scanspec.h"
@@ -42,17 +43,18 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   DocRowwiseIterator(const Schema &projection,
                      const Schema &schema,
                      const TransactionOperationContextOpt& txn_op_context,
-                     rocksdb::DB *db,
+                     const DocDB& doc_db,
                      const ReadHybridTime& read_time,
                      yb::util::PendingOperationCounter* pending_op_counter = nullptr);
 
   DocRowwiseIterator(std::unique_ptr<Schema> projection,
                      const Schema &schema,
                      const TransactionOperationContextOpt& txn_op_context,
-                     rocksdb::DB *db,
+                     const DocDB& doc_db,
                      const ReadHybridTime& read_time,
                      yb::util::PendingOperationCounter* pending_op_counter = nullptr)
-      : DocRowwiseIterator(*projection, schema, txn_op_context, db, read_time, pending_op_counter) {
+      : DocRowwiseIterator(
+            *projection, schema, txn_op_context, doc_db, read_time, pending_op_counter) {
     projection_owner_ = std::move(projection);
   }
 
@@ -96,6 +98,9 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   HybridTime RestartReadHt() override;
 
+  // Fills the batch directly from the DocDB rows, without building a QLTableRow per row.
+  CHECKED_STATUS NextBatch(size_t max_rows, QLColumnBatch* batch) override;
+
  private:
 
   // Retrieves the next key to read after the iterator finishes for the given page.
@@ -137,6 +142,11 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
+  // If the range components of row_key_ do not match range_options_, seeks to the first key after
+  // it that might match and returns true. Unrestricted range columns in front of a restricted one
+  // are skip-scanned, i.e. every distinct value of them is combined with the options that follow.
+  bool SeekToNextRangeOption() const;
+
   const Schema& projection_;
   // Used to maintain ownership of projection_.
   // Separate field is used since ownership could be optional.
@@ -151,7 +161,7 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   const ReadHybridTime read_time_;
 
-  rocksdb::DB* const db_;
+  const DocDB doc_db_;
 
   // A copy of the bound key of the end of the scan range (if any). We stop scan if iterator
   // reaches this point. This is exclusive bound for forward scans and inclusive bound for
@@ -159,6 +169,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   bool has_bound_key_;
   DocKey bound_key_;
 
+  // Discrete values of the range columns to seek to in forward scans, see
+  // DocQLScanSpec::RangeOptions.
+  DocQLScanSpec::RangeOptions range_options_;
+
   std::unique_ptr<IntentAwareIterator> db_iter_;
 
   // We keep the "pending operation" counter incremented for the lifetime of this iterator so that
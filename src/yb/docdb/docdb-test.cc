@@ -219,7 +219,7 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey_b", "subkey_d"; HT{ physica
     auto encoded_subdoc_key = subdoc_key.EncodeWithoutHt();
     GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
     EXPECT_OK(GetSubDocument(
-        rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
         ReadHybridTime::SingleTime(ht)));
     if (subdoc_string.empty()) {
       EXPECT_FALSE(subdoc_found_in_rocksdb);
@@ -421,7 +421,7 @@ void DocDBTest::CheckExpectedLatestDBState() {
   auto encoded_subdoc_key = subdoc_key.EncodeWithoutHt();
   GetSubDocumentData data = { encoded_subdoc_key, &subdoc, &doc_found };
   ASSERT_OK(GetSubDocument(
-      rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext));
+      doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext));
   ASSERT_TRUE(doc_found);
   ASSERT_STR_EQ_VERBOSE_TRIMMED(
       R"#(
@@ -1671,7 +1671,7 @@ TEST_F(DocDBTest, BloomFilterTest) {
     auto encoded_subdoc_key = SubDocKey(key).EncodeWithoutHt();
     GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
     ASSERT_OK(GetSubDocument(
-        rocksdb(), data, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */));
+        doc_db(), data, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */));
   };
 
   ASSERT_NO_FATALS(CheckBloom(0, &total_bloom_useful, 0, &total_table_iterators));
@@ -1794,7 +1794,7 @@ TEST_F(DocDBTest, TestDisambiguationOnWriteId) {
   // TODO(dtxn) - check both transaction and non-transaction path?
   auto encoded_subdoc_key = subdoc_key.EncodeWithoutHt();
   GetSubDocumentData data = { encoded_subdoc_key, &subdoc, &doc_found };
-  GetSubDocument(rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
+  GetSubDocument(doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
   ASSERT_FALSE(doc_found);
 
   CaptureLogicalSnapshot();
@@ -1804,7 +1804,7 @@ TEST_F(DocDBTest, TestDisambiguationOnWriteId) {
     // The row should still be absent after a compaction.
     // TODO(dtxn) - check both transaction and non-transaction path?
     FullyCompactHistoryBefore(HybridTime::FromMicros(cutoff_time_ms));
-    GetSubDocument(rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
+    GetSubDocument(doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
     ASSERT_FALSE(doc_found);
     AssertDocDbDebugDumpStrEq("");
   }
@@ -1820,7 +1820,7 @@ TEST_F(DocDBTest, TestDisambiguationOnWriteId) {
   SubDocKey subdoc_key2(kDocKey2);
   auto encoded_subdoc_key2 = subdoc_key2.EncodeWithoutHt();
   data.subdocument_key = encoded_subdoc_key2;
-  GetSubDocument(rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
+  GetSubDocument(doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
   ASSERT_TRUE(doc_found);
 
   // The row should still exist after a compaction. The deletion marker should be compacted away.
@@ -1829,7 +1829,7 @@ TEST_F(DocDBTest, TestDisambiguationOnWriteId) {
     RestoreToLastLogicalRocksDBSnapshot();
     FullyCompactHistoryBefore(HybridTime::FromMicros(cutoff_time_ms));
     // TODO(dtxn) - check both transaction and non-transaction path?
-    GetSubDocument(rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
+    GetSubDocument(doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext);
     ASSERT_TRUE(doc_found);
     AssertDocDbDebugDumpStrEq(R"#(
 SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(10); HT{ physical: 2000 w: 1 }]) -> "value2"
@@ -2092,8 +2092,8 @@ void QueryBounds(const DocKey& doc_key, int lower, int upper, int base, rocksdb:
   data.low_subkey = &lower_bound;
   data.high_subkey = &upper_bound;
   EXPECT_OK(GetSubDocument(
-      rocksdb, data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
-      ReadHybridTime::SingleTime(ht)));
+      DocDB::FromSingleRocksDB(rocksdb), data, rocksdb::kDefaultQueryId,
+      kNonTransactionalOperationContext, ReadHybridTime::SingleTime(ht)));
 }
 
 void VerifyBounds(SubDocument* doc_from_rocksdb, int lower, int upper, int base) {
@@ -2192,7 +2192,7 @@ TEST_F(DocDBTest, TestCompactionForCollectionsWithTTL) {
   bool subdoc_found_in_rocksdb = false;
   GetSubDocumentData data = { subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
   EXPECT_OK(GetSubDocument(
-      rocksdb(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+      doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
       ReadHybridTime::FromMicros(1200)));
   ASSERT_TRUE(subdoc_found_in_rocksdb);
 
@@ -2333,6 +2333,48 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -
       )#");
 }
 
+#ifdef NDEBUG
+// Measures the CPU cost of the compaction filter on a synthetic wide-row table. Every row has many
+// columns with several versions each, so consecutive keys share long prefixes.
+TEST_F(DocDBTest, BenchmarkCompactionFilter) {
+  constexpr int kRows = 2000;
+  constexpr int kColumns = 50;
+  constexpr int kVersions = 3;
+  constexpr int kIterations = 10;
+
+  std::vector<std::string> keys;
+  keys.reserve(kRows * kColumns * kVersions);
+  for (int row = 0; row != kRows; ++row) {
+    DocKey doc_key(row, PrimitiveValues(Format("row_$0", row)), PrimitiveValues(row));
+    for (int column = 0; column != kColumns; ++column) {
+      for (int version = kVersions; version != 0; --version) {
+        keys.push_back(SubDocKey(doc_key, PrimitiveValue(ColumnId(column + 10)),
+                                 HybridTime::FromMicros(version * 1000)).Encode().AsStringRef());
+      }
+    }
+  }
+  const auto value = Value(PrimitiveValue(1)).Encode();
+
+  size_t removed = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i != kIterations; ++i) {
+    DocDBCompactionFilter filter(HybridTime::FromMicros(kVersions * 1000),
+                                 std::make_shared<ColumnIds>(), /* is_major_compaction */ true,
+                                 Value::kMaxTtl);
+    for (const auto& key : keys) {
+      std::string new_value;
+      bool value_changed = false;
+      removed += filter.Filter(0, key, value, &new_value, &value_changed);
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+      std::chrono::steady_clock::now() - begin);
+
+  // Only the latest version of every column survives a major compaction.
+  ASSERT_EQ(kIterations * kRows * kColumns * (kVersions - 1), removed);
+  LOG(INFO) << "Filtered keys per second: " << kIterations * keys.size() / elapsed.count();
+}
+#endif
 
 }  // namespace docdb
 }  // namespace yb
@@ -163,13 +163,13 @@ void PrepareDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_
 
 Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_write_ops,
                                 const ReadHybridTime& read_time,
-                                rocksdb::DB *rocksdb,
+                                const DocDB& doc_db,
                                 KeyValueWriteBatchPB* write_batch,
                                 InitMarkerBehavior init_marker_behavior,
                                 std::atomic<int64_t>* monotonic_counter,
                                 HybridTime* restart_read_ht) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
-  DocWriteBatch doc_write_batch(rocksdb, init_marker_behavior, monotonic_counter);
+  DocWriteBatch doc_write_batch(doc_db, init_marker_behavior, monotonic_counter);
   DocOperationApplyData data = {&doc_write_batch, read_time, restart_read_ht};
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     RETURN_NOT_OK(doc_op->Apply(data));
@@ -596,13 +596,13 @@ CHECKED_STATUS BuildSubDocument(
 }  // namespace
 
 yb::Status GetSubDocument(
-    rocksdb::DB *db,
+    const DocDB& doc_db,
     const GetSubDocumentData& data,
     const rocksdb::QueryId query_id,
     const TransactionOperationContextOpt& txn_op_context,
     const ReadHybridTime& read_time) {
   auto iter = CreateIntentAwareIterator(
-      db, BloomFilterMode::USE_BLOOM_FILTER, data.subdocument_key, query_id, txn_op_context,
+      doc_db, BloomFilterMode::USE_BLOOM_FILTER, data.subdocument_key, query_id, txn_op_context,
       read_time);
   return GetSubDocument(iter.get(), data, nullptr /* projection */, SeekFwdSuffices::kFalse);
 }
@@ -923,14 +923,15 @@ Slice DocHybridTimeBuffer::EncodeWithValueType(const DocHybridTime& doc_ht) {
 
 Status PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
-    rocksdb::DB* db, rocksdb::WriteBatch* write_batch) {
+    rocksdb::DB* intents_db, rocksdb::WriteBatch* regular_batch,
+    rocksdb::WriteBatch* intents_batch) {
   Slice reverse_index_upperbound;
   auto reverse_index_iter = CreateRocksDBIterator(
-      db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId, nullptr,
-      &reverse_index_upperbound);
+      intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+      nullptr, &reverse_index_upperbound);
 
   auto intent_iter = CreateRocksDBIterator(
-      db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId);
+      intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId);
 
   KeyBytes txn_reverse_index_prefix;
   Slice transaction_id_slice(transaction_id.data, TransactionId::static_size());
@@ -966,7 +967,7 @@ Status PrepareApplyIntentsBatch(
       }
       auto intent = VERIFY_RESULT(ParseIntentKey(intent_iter->key(), transaction_id_slice));
 
-      if (IsStrongIntent(intent.type)) {
+      if (regular_batch && IsStrongIntent(intent.type)) {
         IntraTxnWriteId stored_write_id;
         Slice intent_value;
         RETURN_NOT_OK(DecodeIntentValue(
@@ -987,14 +988,18 @@ Status PrepareApplyIntentsBatch(
             intent.doc_ht,
             intent_value,
         }};
-        write_batch->Put(key_parts, value_parts);
+        regular_batch->Put(key_parts, value_parts);
         ++write_id;
       }
 
-      write_batch->Delete(intent_iter->key());
+      if (intents_batch) {
+        intents_batch->Delete(intent_iter->key());
+      }
     }
 
-    write_batch->Delete(reverse_index_iter->key());
+    if (intents_batch) {
+      intents_batch->Delete(reverse_index_iter->key());
+    }
 
     reverse_index_iter->Next();
   }
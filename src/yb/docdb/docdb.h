@@ -34,6 +34,7 @@
 #include "yb/docdb/doc_write_batch.h"
 #include "yb/docdb/doc_write_batch_cache.h"
 #include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/docdb_types.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/internal_doc_iterator.h"
 #include "yb/docdb/primitive_value.h"
@@ -120,7 +121,7 @@ void PrepareDocWriteOperation(const std::vector<std::unique_ptr<DocOperation>>&
 CHECKED_STATUS ExecuteDocWriteOperation(
     const std::vector<std::unique_ptr<DocOperation>>& doc_write_ops,
     const ReadHybridTime& read_time,
-    rocksdb::DB *rocksdb,
+    const DocDB& doc_db,
     KeyValueWriteBatchPB* write_batch,
     InitMarkerBehavior init_marker_behavior,
     std::atomic<int64_t>* monotonic_counter,
@@ -157,9 +158,15 @@ void PrepareTransactionWriteBatch(
     IsolationLevel isolation_level,
     IntraTxnWriteId* write_id);
 
+// Prepares batches that apply intents of the committed transaction. Regular records are added to
+// regular_batch, deletions of the applied intents and of the reverse index are added to
+// intents_batch. The same batch could be passed for both when intents are stored in the regular
+// RocksDB. Either batch could be nullptr, in which case corresponding records are not generated,
+// for instance when they are already persisted in the target RocksDB.
 CHECKED_STATUS PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
-    rocksdb::DB* db, rocksdb::WriteBatch* write_batch);
+    rocksdb::DB* intents_db, rocksdb::WriteBatch* regular_batch,
+    rocksdb::WriteBatch* intents_batch);
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
@@ -400,7 +407,7 @@ yb::Status GetSubDocument(
 // that we include only a particular set of subkeys for the first level of the subdocument that
 // we're looking for.
 yb::Status GetSubDocument(
-    rocksdb::DB* db,
+    const DocDB& doc_db,
     const GetSubDocumentData& data,
     const rocksdb::QueryId query_id,
     const TransactionOperationContextOpt& txn_op_context,
@@ -13,14 +13,19 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db/version_edit.h"
+#include "yb/gutil/endian.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -31,21 +36,35 @@ using std::unordered_set;
 using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 
+DEFINE_bool(docdb_drop_expired_files, true,
+            "Delete the oldest SST files as a whole once all of their data has expired by TTL, "
+            "instead of rewriting them during compactions.");
+TAG_FLAG(docdb_drop_expired_files, runtime);
+TAG_FLAG(docdb_drop_expired_files, advanced);
+
 namespace yb {
 namespace docdb {
 
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+
+void GetTtlBoundaries(const rocksdb::UserBoundaryValues& largest,
+                      HybridTime* max_table_ttl_ht,
+                      HybridTime* max_explicit_ttl_expiration);
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
                                              ColumnIdsPtr deleted_cols,
                                              bool is_major_compaction,
-                                             MonoDelta table_ttl)
+                                             MonoDelta table_ttl,
+                                             DocKeyHashRange hash_range)
     : history_cutoff_(history_cutoff),
       is_major_compaction_(is_major_compaction),
       is_first_key_value_(true),
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
-      deleted_cols_(deleted_cols) {
+      deleted_cols_(deleted_cols),
+      hash_range_(hash_range) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -64,16 +83,26 @@ bool DocDBCompactionFilter::Filter(int level,
   }
 
   // Skip transaction metadata.
-  if (DecodeValueType(key) == ValueType::kIntentPrefix) {
+  const ValueType first_value_type = DecodeValueType(key);
+  if (first_value_type == ValueType::kIntentPrefix) {
     return false;
   }
 
-  SubDocKey subdoc_key;
+  // Remove the documents that do not belong to this tablet, i.e. were left by a tablet split.
+  // Whole documents are removed, so this does not affect the overwrite tracking below.
+  if (first_value_type == ValueType::kUInt16Hash && !hash_range_.IsFull() &&
+      key.size() >= 1 + sizeof(DocKeyHash) &&
+      !hash_range_.Contains(BigEndian::Load16(key.data() + 1))) {
+    return true;
+  }
+
+  ComponentEnds component_ends;
+  DocHybridTime ht;
 
   // TODO: Find a better way for handling of data corruption encountered during compactions.
-  const Status key_decode_status = subdoc_key.FullyDecodeFrom(key);
-  CHECK(key_decode_status.ok())
-      << "Error decoding a key during compaction: " << key_decode_status.ToString() << "\n"
+  const auto num_shared_components = DecodeKey(key, &component_ends, &ht);
+  CHECK(num_shared_components.ok())
+      << "Error decoding a key during compaction: " << num_shared_components.status() << "\n"
       << "    Key (raw): " << FormatRocksDBSliceAsStr(key) << "\n"
       << "    Key (best-effort decoded): " << BestEffortDocDBKeyToStr(key);
 
@@ -82,13 +111,9 @@ bool DocDBCompactionFilter::Filter(int level,
     is_first_key_value_ = false;
   }
 
-  const size_t num_shared_components = prev_subdoc_key_.NumSharedPrefixComponents(subdoc_key);
-
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
-  overwrite_ht_.resize(min(overwrite_ht_.size(), num_shared_components));
-
-  const DocHybridTime& ht = subdoc_key.doc_hybrid_time();
+  overwrite_ht_.resize(min(overwrite_ht_.size(), *num_shared_components));
 
   // We're comparing the hybrid time in this key with the stack top of overwrite_ht_ after
   // truncating the stack to the number of components in the common prefix of previous and current
@@ -131,7 +156,7 @@ bool DocDBCompactionFilter::Filter(int level,
     return true;  // Remove this key/value pair.
   }
 
-  const int new_stack_size = subdoc_key.num_subkeys() + 1;
+  const size_t new_stack_size = component_ends.size();
 
   // Every subdocument was fully overwritten at least at the time any of its parents was fully
   // overwritten.
@@ -162,16 +187,20 @@ bool DocDBCompactionFilter::Filter(int level,
   //
   // TODO: could there be a case when there is still a read request running that uses an old schema,
   //       and we end up removing some data that the client expects to see?
-  if (subdoc_key.num_subkeys() > 0) {
-    const auto& first_subkey = subdoc_key.subkeys()[0];
+  if (component_ends.size() > 1 && !deleted_cols_->empty()) {
+    Slice first_subkey(key.data() + component_ends[0], component_ends[1] - component_ends[0]);
     // Column ID is the first subkey in every CQL row.
-    if (first_subkey.value_type() == ValueType::kColumnId &&
-        deleted_cols_->find(first_subkey.GetColumnId()) != deleted_cols_->end()) {
-      return true;
+    if (DecodeValueType(first_subkey) == ValueType::kColumnId) {
+      PrimitiveValue column_id;
+      CHECK_OK(column_id.DecodeFromKey(&first_subkey));
+      if (deleted_cols_->find(column_id.GetColumnId()) != deleted_cols_->end()) {
+        return true;
+      }
     }
   }
 
-  prev_subdoc_key_ = std::move(subdoc_key);
+  prev_key_.assign(key.cdata(), key.size());
+  prev_key_component_ends_ = std::move(component_ends);
 
   ValueType value_type;
   CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type));
@@ -185,7 +214,7 @@ bool DocDBCompactionFilter::Filter(int level,
   if (ht_at_or_below_cutoff) {
     // Only check for expiration if the current hybrid time is at or below history cutoff.
     // The key could not have possibly expired by history_cutoff_ otherwise.
-    CHECK_OK(HasExpiredTTL(subdoc_key.hybrid_time(), ComputeTTL(ttl, table_ttl_), history_cutoff_,
+    CHECK_OK(HasExpiredTTL(ht.hybrid_time(), ComputeTTL(ttl, table_ttl_), history_cutoff_,
                            &has_expired));
   }
 
@@ -213,6 +242,42 @@ bool DocDBCompactionFilter::Filter(int level,
   return value_type == ValueType::kTombstone && ht_at_or_below_cutoff && is_major_compaction_;
 }
 
+Result<size_t> DocDBCompactionFilter::DecodeKey(const rocksdb::Slice& key,
+                                                ComponentEnds* component_ends,
+                                                DocHybridTime* ht) const {
+  // Encoded components are self-delimiting, so every component of the previous key that ends
+  // within the common prefix is also a component of the current key.
+  const size_t common_prefix = key.difference_offset(prev_key_);
+  size_t num_shared_components = 0;
+  while (num_shared_components != prev_key_component_ends_.size() &&
+         prev_key_component_ends_[num_shared_components] <= common_prefix) {
+    ++num_shared_components;
+  }
+  component_ends->assign(prev_key_component_ends_.begin(),
+                         prev_key_component_ends_.begin() + num_shared_components);
+
+  Slice slice = key;
+  if (num_shared_components == 0) {
+    component_ends->push_back(VERIFY_RESULT(DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY)));
+  }
+  slice.remove_prefix(component_ends->back());
+  while (VERIFY_RESULT(SubDocKey::DecodeSubkey(&slice))) {
+    component_ends->push_back(slice.cdata() - key.cdata());
+  }
+
+  if (slice.empty()) {
+    return STATUS_FORMAT(Corruption, "No hybrid time in the end of a SubDocKey: $0",
+                         key.ToDebugHexString());
+  }
+  slice.consume_byte();
+  RETURN_NOT_OK(ConsumeHybridTimeFromKey(&slice, ht));
+  if (!slice.empty()) {
+    return STATUS_FORMAT(Corruption, "Extra bytes after hybrid time in a SubDocKey: $0",
+                         key.ToDebugHexString());
+  }
+  return num_shared_components;
+}
+
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
@@ -220,9 +285,10 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    shared_ptr<HistoryRetentionPolicy> retention_policy, DocKeyHashRange hash_range)
     :
-    retention_policy_(retention_policy) {
+    retention_policy_(retention_policy),
+    hash_range_(hash_range) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -233,12 +299,105 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
   return unique_ptr<DocDBCompactionFilter>(
       new DocDBCompactionFilter(retention_policy_->GetHistoryCutoff(),
                                 retention_policy_->GetDeletedColumns(),
-                                context.is_full_compaction, retention_policy_->GetTableTTL()));
+                                context.is_full_compaction, retention_policy_->GetTableTTL(),
+                                hash_range_));
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+
+// Returns true if no read at or after history_cutoff could see any entry of the file.
+bool FileExpired(const rocksdb::FileMetaData& file, HybridTime history_cutoff,
+                 MonoDelta table_ttl) {
+  HybridTime max_table_ttl_ht, max_explicit_ttl_expiration;
+  GetTtlBoundaries(file.largest.user_values, &max_table_ttl_ht, &max_explicit_ttl_expiration);
+  if (!max_table_ttl_ht.is_valid() && !max_explicit_ttl_expiration.is_valid()) {
+    // The file does not contain DocDB entries or was written without TTL boundaries.
+    return false;
+  }
+  if (max_explicit_ttl_expiration.is_valid() && max_explicit_ttl_expiration >= history_cutoff) {
+    return false;
+  }
+  if (max_table_ttl_ht.is_valid()) {
+    if (table_ttl.Equals(Value::kMaxTtl)) {
+      return false;
+    }
+    bool has_expired = false;
+    CHECK_OK(HasExpiredTTL(max_table_ttl_ht, table_ttl, history_cutoff, &has_expired));
+    if (!has_expired) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the smallest or the largest hybrid time of entries in the file, or 'fallback' when it
+// is not known.
+HybridTime FileHybridTime(const rocksdb::FileMetaData& file, bool largest, HybridTime fallback) {
+  DocHybridTime doc_ht;
+  auto status = GetDocHybridTime(
+      largest ? file.largest.user_values : file.smallest.user_values, &doc_ht);
+  return status.ok() ? doc_ht.hybrid_time() : fallback;
+}
+
+} // namespace
+
+DocDBExpiredFilesFilter::DocDBExpiredFilesFilter(
+    shared_ptr<HistoryRetentionPolicy> retention_policy)
+    : retention_policy_(std::move(retention_policy)) {
+}
+
+DocDBExpiredFilesFilter::~DocDBExpiredFilesFilter() {
+}
+
+size_t DocDBExpiredFilesFilter::NumExpiredOldestFiles(
+    const std::vector<rocksdb::FileMetaData*>& files) const {
+  if (!FLAGS_docdb_drop_expired_files || files.empty()) {
+    return 0;
+  }
+  const HybridTime history_cutoff = retention_policy_->GetHistoryCutoff();
+  const MonoDelta table_ttl = retention_policy_->GetTableTTL();
+
+  // Files are ordered from the newest to the oldest, so the expired ones are at the end.
+  const size_t num_files = files.size();
+  size_t first_expired = num_files;
+  while (first_expired != 0 && FileExpired(*files[first_expired - 1], history_cutoff, table_ttl)) {
+    --first_expired;
+  }
+  if (first_expired == num_files) {
+    return 0;
+  }
+
+  // Usually newer files contain only newer hybrid times, but that is not guaranteed, e.g. for
+  // transactions applied some time after their commit. Dropping an expired entry must not make
+  // visible an older version of the same key from a file that we keep, so the dropped files
+  // should be older than any remaining file in terms of hybrid time.
+  // prefix_min_ht[i] is the min hybrid time of files [0, i), suffix_max_ht[i] is the max hybrid
+  // time of files [i, num_files).
+  std::vector<HybridTime> prefix_min_ht(num_files + 1, HybridTime::kMax);
+  std::vector<HybridTime> suffix_max_ht(num_files + 1, HybridTime::kMin);
+  for (size_t i = 0; i != num_files; ++i) {
+    prefix_min_ht[i + 1] = std::min(
+        prefix_min_ht[i], FileHybridTime(*files[i], /* largest= */ false, HybridTime::kMin));
+  }
+  for (size_t i = num_files; i-- > 0;) {
+    suffix_max_ht[i] = std::max(
+        suffix_max_ht[i + 1], FileHybridTime(*files[i], /* largest= */ true, HybridTime::kMax));
+  }
+  for (size_t i = first_expired; i != num_files; ++i) {
+    if (suffix_max_ht[i] < prefix_min_ht[i]) {
+      VLOG(2) << "Dropping " << num_files - i << " expired files, history cutoff: "
+              << history_cutoff << ", table TTL: " << table_ttl.ToString();
+      return num_files - i;
+    }
+  }
+  return 0;
+}
+
 }  // namespace docdb
 }  // namespace yb
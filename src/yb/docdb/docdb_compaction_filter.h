@@ -18,11 +18,15 @@
 #include <memory>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/options.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/util/result.h"
 
 namespace yb {
 namespace docdb {
@@ -32,7 +36,8 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   DocDBCompactionFilter(HybridTime history_cutoff,
                         ColumnIdsPtr deleted_cols,
                         bool is_major_compaction,
-                        MonoDelta table_ttl);
+                        MonoDelta table_ttl,
+                        DocKeyHashRange hash_range = DocKeyHashRange());
 
   ~DocDBCompactionFilter() override;
   bool Filter(int level,
@@ -43,6 +48,17 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const char* Name() const override;
 
  private:
+  // End offsets of the encoded DocKey and of every encoded subkey within a key.
+  typedef boost::container::small_vector<size_t, 16> ComponentEnds;
+
+  // Splits the key into components and decodes its hybrid time. Components up to the first byte
+  // that differs from prev_key_ are taken from prev_key_component_ends_ and not decoded again.
+  // Returns the number of leading components shared with prev_key_, counting the DocKey as the
+  // first one, the same way as SubDocKey::NumSharedPrefixComponents does.
+  Result<size_t> DecodeKey(const rocksdb::Slice& key,
+                           ComponentEnds* component_ends,
+                           DocHybridTime* ht) const;
+
   // We will not keep history below this hybrid_time. The view of the database at this hybrid_time
   // is preserved, but after the compaction completes, we should not expect to be able to do
   // consistent scans at DocDB hybrid times lower than this. Those scans will result in missing
@@ -52,7 +68,11 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const bool is_major_compaction_;
 
   mutable bool is_first_key_value_;
-  mutable SubDocKey prev_subdoc_key_;
+
+  // The previous key that was not removed by the overwrite or deleted column checks, and the
+  // components it consists of.
+  mutable std::string prev_key_;
+  mutable ComponentEnds prev_key_component_ends_;
 
   // A stack of highest hybrid_times lower than or equal to history_cutoff_ at which parent
   // subdocuments of the key that has just been processed, or the subdocument / primitive value
@@ -100,6 +120,8 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
 
   ColumnIdsPtr deleted_cols_;
+
+  const DocKeyHashRange hash_range_;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -139,12 +161,27 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+                                        DocKeyHashRange hash_range = DocKeyHashRange());
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+ private:
+  std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const DocKeyHashRange hash_range_;
+};
+
+// Lets universal compaction delete the oldest SST files without reading them, once all of their
+// entries have expired by TTL before the history cutoff.
+class DocDBExpiredFilesFilter : public rocksdb::ExpiredFilesFilter {
+ public:
+  explicit DocDBExpiredFilesFilter(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  ~DocDBExpiredFilesFilter() override;
+
+  size_t NumExpiredOldestFiles(const std::vector<rocksdb::FileMetaData*>& files) const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
 };
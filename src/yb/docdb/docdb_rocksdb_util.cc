@@ -315,6 +315,19 @@ void PerformRocksDBReverseSeek(
 
 namespace {
 
+// Checks that the key could be used to filter out SST files with the DocDB aware bloom filter of the
+// table factory, i.e. that the key contains all components of its filter key.
+bool CanFilter(rocksdb::TableFactory* table_factory, const Slice& user_key) {
+  auto* table_options = static_cast<const rocksdb::BlockBasedTableOptions*>(
+      table_factory->GetOptions());
+  if (table_options == nullptr) {
+    return true;
+  }
+  auto* filter_policy = dynamic_cast<const DocDbAwareFilterPolicy*>(
+      table_options->filter_policy.get());
+  return filter_policy == nullptr || filter_policy->CanFilter(user_key);
+}
+
 rocksdb::ReadOptions PrepareReadOptions(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -327,8 +340,11 @@ rocksdb::ReadOptions PrepareReadOptions(
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
-    read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
-        NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
+    const auto table_factory = rocksdb->GetOptions().table_factory;
+    if (CanFilter(table_factory.get(), user_key_for_filter.get())) {
+      read_opts.table_aware_file_filter = table_factory->NewTableAwareReadFileFilter(
+          read_opts, user_key_for_filter.get());
+    }
   }
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
@@ -350,7 +366,7 @@ unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
 }
 
 unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
-    rocksdb::DB* rocksdb,
+    const DocDB& doc_db,
     BloomFilterMode bloom_filter_mode,
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
@@ -358,15 +374,16 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
     const Slice* iterate_upper_bound) {
-  rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
+  rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
-  return std::make_unique<IntentAwareIterator>(rocksdb, read_opts, read_time, txn_op_context);
+  return std::make_unique<IntentAwareIterator>(doc_db, read_opts, read_time, txn_op_context);
 }
 
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& tablet_id,
     const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
+    const tablet::TabletOptions& tablet_options,
+    size_t num_range_components_in_bloom_filter) {
   options->create_if_missing = true;
   options->disableDataSync = true;
   options->statistics = statistics;
@@ -400,7 +417,8 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        num_range_components_in_bloom_filter));
   }
 
   if (FLAGS_use_multi_level_index) {
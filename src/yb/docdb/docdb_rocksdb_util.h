@@ -20,6 +20,7 @@
 #include "yb/common/transaction.h"
 
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_types.h"
 #include "yb/docdb/value.h"
 
 #include "yb/rocksdb/cache.h"
@@ -104,7 +105,9 @@ enum class BloomFilterMode {
 
 // It is only allowed to use bloom filters on scans within the same hashed components of the key,
 // because BloomFilterAwareIterator relies on it and ignores SST file completely if there are no
-// keys with the same hashed components as key specified for seek operation.
+// keys with the same hashed components as key specified for seek operation. When the bloom filter
+// of the DB also includes range components, the scan should be within the same range components
+// as well. The filter is not used if user_key_for_filter does not contain all of them.
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
 // have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
@@ -119,7 +122,7 @@ std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
 std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
-    rocksdb::DB* rocksdb,
+    const DocDB& doc_db,
     BloomFilterMode bloom_filter_mode,
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
@@ -130,11 +133,13 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
 
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
-// specified by 'tablet_id'.
+// specified by 'tablet_id'. 'num_range_components_in_bloom_filter' first range components of
+// DocKeys are included into the bloom filter keys in addition to the hashed components.
 void InitRocksDBOptions(
     rocksdb::Options* options, const std::string& tablet_id,
     const std::shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options);
+    const tablet::TabletOptions& tablet_options,
+    size_t num_range_components_in_bloom_filter = 0);
 
 }  // namespace docdb
 }  // namespace yb
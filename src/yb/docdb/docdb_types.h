@@ -0,0 +1,50 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOCDB_TYPES_H
+#define YB_DOCDB_DOCDB_TYPES_H
+
+#include "yb/util/enums.h"
+
+namespace rocksdb {
+
+class DB;
+
+}  // namespace rocksdb
+
+namespace yb {
+namespace docdb {
+
+YB_DEFINE_ENUM(StorageDbType, (kRegular)(kIntents));
+
+// RocksDB instances that make up DocDB of a single tablet. Transaction intents could be stored in
+// a separate RocksDB instance, so that they don't get mixed with regular records in the same
+// memtables and SSTables. When both pointers are equal, intents are stored together with regular
+// records.
+struct DocDB {
+  rocksdb::DB* regular = nullptr;
+  rocksdb::DB* intents = nullptr;
+
+  static DocDB FromSingleRocksDB(rocksdb::DB* db) {
+    return DocDB{db, db};
+  }
+
+  rocksdb::DB* operator[](StorageDbType type) const {
+    return type == StorageDbType::kRegular ? regular : intents;
+  }
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_DOCDB_TYPES_H
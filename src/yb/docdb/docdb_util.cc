@@ -229,10 +229,12 @@ Status DocDBRocksDBUtil::InitCommonRocksDBOptions() {
   tablet::TabletOptions tablet_options;
   tablet_options.block_cache = block_cache_;
   docdb::InitRocksDBOptions(&rocksdb_options_, tablet_id(), rocksdb::CreateDBStatistics(),
-                            tablet_options);
+                            tablet_options, num_range_components_in_bloom_filter());
   InitRocksDBWriteOptions(&write_options_);
   rocksdb_options_.compaction_filter_factory =
       std::make_shared<docdb::DocDBCompactionFilterFactory>(retention_policy_);
+  rocksdb_options_.expired_files_filter =
+      std::make_shared<docdb::DocDBExpiredFilesFilter>(retention_policy_);
   return Status::OK();
 }
 
@@ -346,11 +348,11 @@ Status DocDBRocksDBUtil::ReinitDBOptions() {
 }
 
 DocWriteBatch DocDBRocksDBUtil::MakeDocWriteBatch() {
-  return DocWriteBatch(rocksdb_.get(), init_marker_behavior_, &monotonic_counter_);
+  return DocWriteBatch(doc_db(), init_marker_behavior_, &monotonic_counter_);
 }
 
 DocWriteBatch DocDBRocksDBUtil::MakeDocWriteBatch(InitMarkerBehavior init_marker_behavior) {
-  return DocWriteBatch(rocksdb_.get(), init_marker_behavior, &monotonic_counter_);
+  return DocWriteBatch(doc_db(), init_marker_behavior, &monotonic_counter_);
 }
 
 void DocDBRocksDBUtil::SetInitMarkerBehavior(InitMarkerBehavior init_marker_behavior) {
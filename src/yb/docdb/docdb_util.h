@@ -62,8 +62,15 @@ class DocDBRocksDBUtil {
   // Size of block cache for RocksDB, 0 means don't use block cache.
   virtual size_t block_cache_size() const { return 16 * 1024 * 1024; }
 
+  // Number of range components of the DocKey included in bloom filter keys, should match the
+  // table property of the table whose data is stored in this RocksDB.
+  virtual size_t num_range_components_in_bloom_filter() const { return 0; }
+
   rocksdb::DB* rocksdb();
 
+  // DocDB that stores intents together with regular records in the same RocksDB.
+  DocDB doc_db() { return DocDB::FromSingleRocksDB(rocksdb()); }
+
   CHECKED_STATUS InitCommonRocksDBOptions();
 
   const rocksdb::WriteOptions& write_options() const { return write_options_; }
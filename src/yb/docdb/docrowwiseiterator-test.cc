@@ -14,6 +14,8 @@
 #include <memory>
 #include <string>
 
+#include "yb/common/ql_column_batch.h"
+
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
@@ -129,7 +131,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2000));
     ASSERT_OK(iter.Init());
 
@@ -169,7 +171,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(5000));
     ASSERT_OK(iter.Init());
 
@@ -242,7 +244,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorDeletedDocumentTest) {
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2500));
     ASSERT_OK(iter.Init());
 
@@ -299,7 +301,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(40); HT{ physical: 2800 w: 1 }]
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init());
 
@@ -357,7 +359,7 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 2800 }]) ->
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init());
 
@@ -407,7 +409,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorIncompleteProjection) {
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init());
 
@@ -491,7 +493,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2800 w: 3 }]
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(), read_time);
+        projection, schema, kNonTransactionalOperationContext, doc_db(), read_time);
     ASSERT_OK(iter.Init());
 
     QLTableRow row;
@@ -551,7 +553,7 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorValidColumnNotInProjection) {
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init());
 
@@ -605,7 +607,7 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
 
   {
     DocRowwiseIterator iter(
-        projection, schema, kNonTransactionalOperationContext, rocksdb(),
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
         ReadHybridTime::FromMicros(2800));
     ASSERT_OK(iter.Init());
 
@@ -625,6 +627,87 @@ SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(50); HT{ physical: 1000 w: 1 }]
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorNextBatch) {
+  auto dwb = MakeDocWriteBatch();
+
+  // Row 1 has all columns, row 2 has only column d and row 3 has only column c.
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000)));
+  ASSERT_OK(dwb.SetPrimitive(
+      DocPath(DocKey(PrimitiveValues("row3", 33333)).Encode(), PrimitiveValue(30_ColId)),
+      PrimitiveValue("row3_c")));
+
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  // Read the rows one by one for reference.
+  std::vector<QLTableRow> expected_rows;
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init());
+    while (iter.HasNext()) {
+      expected_rows.emplace_back();
+      ASSERT_OK(iter.NextRow(&expected_rows.back()));
+    }
+  }
+  ASSERT_EQ(3U, expected_rows.size());
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  QLColumnBatch batch;
+  for (size_t i = 0; i < schema.num_columns(); i++) {
+    batch.AddColumn(schema.column_id(i), schema.column(i).type()->main());
+  }
+
+  // Read the rows in batches of 2, the second batch is not full.
+  std::vector<size_t> batch_sizes;
+  size_t row_index = 0;
+  while (iter.HasNext()) {
+    batch.Clear();
+    ASSERT_OK(iter.NextBatch(2, &batch));
+    batch_sizes.push_back(batch.num_rows());
+    for (size_t i = 0; i < batch.num_rows(); i++, row_index++) {
+      ASSERT_LT(row_index, expected_rows.size());
+      const auto& expected = expected_rows[row_index];
+      for (size_t j = 0; j < batch.num_columns(); j++) {
+        const QLColumnVector& column = batch.column(j);
+        auto expected_value = expected.GetValue(column.column_id());
+        QLValuePB value;
+        column.GetValue(i, &value);
+        if (!expected_value) {
+          ASSERT_TRUE(column.IsNull(i)) << "Row " << row_index << ", column " << j;
+        } else {
+          ASSERT_EQ(expected_value->ShortDebugString(), value.ShortDebugString())
+              << "Row " << row_index << ", column " << j;
+        }
+      }
+    }
+  }
+  ASSERT_EQ(std::vector<size_t>({2, 1}), batch_sizes);
+
+  const QLColumnVector* column_d = batch.FindColumn(40_ColId.rep());
+  ASSERT_NE(column_d, nullptr);
+  ASSERT_EQ(QLColumnVectorLayout::kInt, column_d->layout());
+  ASSERT_TRUE(column_d->IsNull(0));
+  const QLColumnVector* column_c = batch.FindColumn(30_ColId.rep());
+  ASSERT_NE(column_c, nullptr);
+  ASSERT_EQ(QLColumnVectorLayout::kBytes, column_c->layout());
+  ASSERT_EQ("row3_c", column_c->bytes_value(0).ToBuffer());
+}
+
 namespace {
 
 class TransactionStatusManagerMock : public TransactionStatusManager {
@@ -780,7 +863,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
 
   {
     DocRowwiseIterator iter(
-        projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(2000));
+        projection, schema, txn_context, doc_db(), ReadHybridTime::FromMicros(2000));
     ASSERT_OK(iter.Init());
 
     QLTableRow row;
@@ -823,7 +906,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
   LOG(INFO) << "===============================================";
   {
     DocRowwiseIterator iter(
-        projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(5000));
+        projection, schema, txn_context, doc_db(), ReadHybridTime::FromMicros(5000));
     ASSERT_OK(iter.Init());
     QLTableRow row;
     QLValue value;
@@ -864,7 +947,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(50); HT{ physical: 2000 }]) ->
 
   {
     DocRowwiseIterator iter(
-        projection, schema, txn_context, rocksdb(), ReadHybridTime::FromMicros(6000));
+        projection, schema, txn_context, doc_db(), ReadHybridTime::FromMicros(6000));
     ASSERT_OK(iter.Init());
 
     QLTableRow row;
@@ -938,7 +1021,7 @@ SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(40); HT{ physical: 1000 }]) ->
   // Create a new IntentAwareIterator and seek to an empty DocKey. Verify that it returns the
   // first non-intent key.
   IntentAwareIterator iter(
-      rocksdb(), rocksdb::ReadOptions(), ReadHybridTime::FromMicros(1000), boost::none);
+      doc_db(), rocksdb::ReadOptions(), ReadHybridTime::FromMicros(1000), boost::none);
   iter.Seek(DocKey());
   ASSERT_TRUE(iter.valid());
   DocHybridTime doc_ht;
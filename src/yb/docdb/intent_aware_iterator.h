@@ -19,6 +19,7 @@
 #include "yb/common/read_hybrid_time.h"
 
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_types.h"
 #include "yb/docdb/key_bytes.h"
 
 #include "yb/rocksdb/db.h"
@@ -75,7 +76,7 @@ class TransactionStatusCache {
 class IntentAwareIterator {
  public:
   IntentAwareIterator(
-      rocksdb::DB* rocksdb,
+      const DocDB& doc_db,
       const rocksdb::ReadOptions& read_opts,
       const ReadHybridTime& read_time,
       const TransactionOperationContextOpt& txn_op_context);
@@ -20,8 +20,25 @@
 namespace yb {
 namespace docdb {
 
-QLRocksDBStorage::QLRocksDBStorage(rocksdb::DB *rocksdb)
-    : rocksdb_(rocksdb) {
+namespace {
+
+// Limits the hash codes of a scan to the given range. Unspecified hash codes are -1.
+void LimitHashCodes(const DocKeyHashRange& range, int32_t* hash_code, int32_t* max_hash_code) {
+  if (range.IsFull()) {
+    return;
+  }
+  if (*hash_code < range.first) {
+    *hash_code = range.first;
+  }
+  if (*max_hash_code < 0 || *max_hash_code > range.last) {
+    *max_hash_code = range.last;
+  }
+}
+
+} // namespace
+
+QLRocksDBStorage::QLRocksDBStorage(const DocDB& doc_db, DocKeyHashRange hash_range)
+    : doc_db_(doc_db), hash_range_(hash_range) {
 
 }
 
@@ -37,7 +54,7 @@ CHECKED_STATUS QLRocksDBStorage::GetIterator(
     std::unique_ptr<common::YQLRowwiseIteratorIf> *iter) const {
 
   std::unique_ptr<DocRowwiseIterator> doc_iter =
-    std::make_unique<DocRowwiseIterator>(projection, schema, txn_op_context, rocksdb_, read_time);
+    std::make_unique<DocRowwiseIterator>(projection, schema, txn_op_context, doc_db_, read_time);
   RETURN_NOT_OK(doc_iter->Init(spec));
   *iter = std::move(doc_iter);
   return Status::OK();
@@ -62,6 +79,9 @@ CHECKED_STATUS QLRocksDBStorage::BuildYQLScanSpec(const QLReadRequestPB& request
   RETURN_NOT_OK(QLKeyColumnValuesToPrimitiveValues(
       request.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
       &hashed_components));
+  if (hashed_components.empty()) {
+    LimitHashCodes(hash_range_, &hash_code, &max_hash_code);
+  }
 
   *req_read_time = read_time;
   SubDocKey start_sub_doc_key;
@@ -108,7 +128,7 @@ CHECKED_STATUS QLRocksDBStorage::GetIterator(
     common::YQLRowwiseIteratorIf::UniPtr* iter) const {
 
   std::unique_ptr<DocRowwiseIterator> doc_iter =
-    std::make_unique<DocRowwiseIterator>(projection, schema, txn_op_context, rocksdb_, read_time);
+    std::make_unique<DocRowwiseIterator>(projection, schema, txn_op_context, doc_db_, read_time);
   RETURN_NOT_OK(doc_iter->Init(spec));
 
   *iter = std::move(doc_iter);
@@ -130,6 +150,9 @@ CHECKED_STATUS QLRocksDBStorage::BuildYQLScanSpec(const PgsqlReadRequestPB& requ
                                              schema,
                                              0,
                                              &hashed_components));
+  if (hashed_components.empty()) {
+    LimitHashCodes(hash_range_, &hash_code, &max_hash_code);
+  }
 
   *req_read_time = read_time;
   SubDocKey start_sub_doc_key;
@@ -19,6 +19,8 @@
 #include "yb/rocksdb/db.h"
 #include "yb/common/ql_rowwise_iterator_interface.h"
 #include "yb/common/ql_storage_interface.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_types.h"
 
 namespace yb {
 namespace docdb {
@@ -26,7 +28,8 @@ namespace docdb {
 // Implementation of YQLStorageIf with rocksdb as a backend. This is what all of our QL tables use.
 class QLRocksDBStorage : public common::YQLStorageIf {
  public:
-  explicit QLRocksDBStorage(rocksdb::DB *rocksdb);
+  // Scans without hashed column values are limited to hash_range.
+  explicit QLRocksDBStorage(const DocDB& doc_db, DocKeyHashRange hash_range = DocKeyHashRange());
 
   //------------------------------------------------------------------------------------------------
   // CQL Support.
@@ -64,7 +67,8 @@ class QLRocksDBStorage : public common::YQLStorageIf {
                                           ReadHybridTime* req_read_time) const override;
 
  private:
-  rocksdb::DB *const rocksdb_;
+  const DocDB doc_db_;
+  const DocKeyHashRange hash_range_;
 };
 
 }  // namespace docdb
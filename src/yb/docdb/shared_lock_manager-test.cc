@@ -12,6 +12,7 @@
 //
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <random>
 #include <stack>
@@ -19,6 +20,7 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include "yb/util/format.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -383,5 +385,55 @@ TEST_F(SharedLockManagerTest, LockBatchReset) {
   EXPECT_TRUE(lb.empty());
 }
 
+////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////
+
+#ifdef NDEBUG
+// Measures lock/unlock throughput depending on the number of threads. Each thread repeatedly locks
+// a batch of its own keys together with a shared hot key, so the only contention is on the lock
+// table itself and on the hot key entry. Weak intents are used for the hot key, so they don't
+// conflict.
+TEST_F(SharedLockManagerTest, BenchmarkLockUnlock) {
+  constexpr size_t kKeysPerBatch = 4;
+  constexpr size_t kIterations = 200000;
+
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    std::vector<KeyToIntentTypeMap> batches(num_threads);
+    for (size_t i = 0; i != num_threads; ++i) {
+      batches[i].emplace("hot_key", IntentType::kWeakSerializableWrite);
+      for (size_t j = 0; j != kKeysPerBatch; ++j) {
+        batches[i].emplace(Format("key_$0_$1", i, j), IntentType::kStrongSnapshotWrite);
+      }
+    }
+
+    std::atomic<bool> start(false);
+    std::vector<thread> threads;
+    for (size_t i = 0; i != num_threads; ++i) {
+      threads.emplace_back([this, &start, &batch = batches[i]] {
+        while (!start.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        for (size_t j = 0; j != kIterations; ++j) {
+          lm_.Lock(batch);
+          lm_.Unlock(batch);
+        }
+      });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+      t.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - begin);
+    LOG(INFO) << "Threads: " << num_threads << ", batch size: " << kKeysPerBatch + 1
+              << ", lock/unlock batches per second: "
+              << num_threads * kIterations / elapsed.count();
+  }
+}
+#endif
+
 } // namespace docdb
 } // namespace yb
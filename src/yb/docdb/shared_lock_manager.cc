@@ -13,14 +13,19 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <condition_variable>
+#include <utility>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <glog/logging.h>
 
+#include "yb/gutil/hash/city.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
+#include "yb/util/slice.h"
 #include "yb/util/trace.h"
 #include "yb/util/tostring.h"
 
@@ -194,6 +199,113 @@ IntentType SharedLockManager::CombineIntents(const IntentType i1, const IntentTy
   FATAL_INVALID_ENUM_VALUE(IntentType, i1);
 }
 
+struct SharedLockManager::LockEntry {
+  // Taken only for short duration, with no blocking wait.
+  std::mutex mutex;
+
+  std::condition_variable cond_var;
+
+  // Refcounting for garbage collection. Can only be used while the shard mutex is held.
+  size_t num_using = 0;
+
+  // Number of holders for each type
+  std::array<size_t, kIntentTypeMapSize> num_holding;
+  LockState state;
+
+  // Key of this entry and its hash. Entries are reused, so the key buffer is allocated only when
+  // a longer key is assigned.
+  std::string key;
+  uint64_t key_hash = 0;
+
+  // Next entry in the same bucket of the shard, or in the free list of the shard.
+  LockEntry* next = nullptr;
+
+  void Lock(IntentType lock_type);
+
+  void Unlock(IntentType lock_type);
+
+  LockEntry() {
+    num_holding.fill(0);
+  }
+};
+
+// Part of the lock table that is protected by its own mutex. Entries are kept in a chained hash
+// table with a fixed number of buckets, and released entries are kept in the free list for reuse,
+// so in the steady state locking does not allocate memory.
+class SharedLockManager::LockShard {
+ public:
+  ~LockShard() {
+    for (auto& bucket : buckets_) {
+      DCHECK(bucket == nullptr) << "There are some unreleased locks";
+    }
+    while (free_list_) {
+      delete std::exchange(free_list_, free_list_->next);
+    }
+  }
+
+  // Make sure the entry for the key exists and return pointer to it, so it could be accessed
+  // without holding the shard mutex.
+  LockEntry* Reserve(const Slice& key, uint64_t hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LockEntry** slot = FindSlot(key, hash);
+    LockEntry* entry = *slot;
+    if (!entry) {
+      entry = free_list_;
+      if (entry) {
+        free_list_ = entry->next;
+      } else {
+        entry = new LockEntry;
+      }
+      entry->key.assign(key.cdata(), key.size());
+      entry->key_hash = hash;
+      entry->next = nullptr;
+      *slot = entry;
+    }
+    ++entry->num_using;
+    return entry;
+  }
+
+  // Unlocks the entry for the key and returns it to the free list when nobody uses it.
+  void Unlock(const Slice& key, uint64_t hash, IntentType intent_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LockEntry** slot = FindSlot(key, hash);
+    LockEntry* entry = *slot;
+    CHECK(entry) << "Unlocking key that is not locked: " << key.ToDebugHexString();
+    entry->Unlock(intent_type);
+    if (--entry->num_using == 0) {
+      *slot = entry->next;
+      entry->next = free_list_;
+      free_list_ = entry;
+    }
+  }
+
+ private:
+  static constexpr size_t kNumBuckets = 64;
+
+  // Returns pointer to the slot that points to the entry with the specified key. If there is no
+  // such entry, returns pointer to the trailing slot of the bucket chain.
+  LockEntry** FindSlot(const Slice& key, uint64_t hash) {
+    // Low bits of the hash are used to pick the shard.
+    LockEntry** slot = &buckets_[(hash / kNumShards) % kNumBuckets];
+    while (*slot && ((*slot)->key_hash != hash || Slice((*slot)->key) != key)) {
+      slot = &(*slot)->next;
+    }
+    return slot;
+  }
+
+  std::mutex mutex_;
+  std::array<LockEntry*, kNumBuckets> buckets_ = {};
+  LockEntry* free_list_ = nullptr;
+};
+
+namespace {
+
+uint64_t KeyHash(const std::string& key) {
+  return util_hash::CityHash64(key.c_str(), key.size());
+}
+
+} // namespace
+
 void SharedLockManager::LockEntry::Lock(IntentType lock_type) {
   // TODO(bojanserafimov): Implement CAS fast path. Only wait when CAS fails.
   int type_idx = static_cast<size_t>(lock_type);
@@ -226,44 +338,38 @@ void SharedLockManager::LockEntry::Unlock(IntentType lock_type) {
   }
 }
 
+SharedLockManager::SharedLockManager() : shards_(new LockShard[kNumShards]) {}
+
+SharedLockManager::~SharedLockManager() = default;
+
+SharedLockManager::LockShard& SharedLockManager::ShardFor(uint64_t hash) {
+  return shards_[hash % kNumShards];
+}
+
 void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type.size());
-  std::vector<SharedLockManager::LockEntry*> reserved = Reserve(key_to_intent_type);
-  size_t idx = 0;
+  // Keys are locked in the order of the map, so there are no deadlocks between batches. The shard
+  // mutex is released before waiting for the entry lock.
   for (const auto& key_and_intent_type : key_to_intent_type) {
+    const auto& key = key_and_intent_type.first;
     const auto intent_type = key_and_intent_type.second;
     VLOG(4) << "Locking " << docdb::ToString(intent_type) << ": "
-            << util::FormatBytesAsStr(key_and_intent_type.first);
-    reserved[idx]->Lock(intent_type);
-    idx++;
+            << util::FormatBytesAsStr(key);
+    const auto hash = KeyHash(key);
+    ShardFor(hash).Reserve(key, hash)->Lock(intent_type);
   }
   TRACE("Acquired a lock batch of $0 keys", key_to_intent_type.size());
 }
 
-std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
-    const KeyToIntentTypeMap& key_to_intent_type) {
-  std::vector<SharedLockManager::LockEntry*> reserved;
-  reserved.reserve(key_to_intent_type.size());
-  {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
-    }
-  }
-  return reserved;
-}
-
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
+    const auto& key = key_and_intent_type.first;
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
-            << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
+            << util::FormatBytesAsStr(key);
+    const auto hash = KeyHash(key);
+    ShardFor(hash).Unlock(key, hash, key_and_intent_type.second);
   }
-  Cleanup(key_to_intent_type);
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -274,15 +380,5 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
-    }
-  }
-}
-
 }  // namespace docdb
 }  // namespace yb
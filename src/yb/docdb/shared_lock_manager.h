@@ -15,6 +15,7 @@
 #define YB_DOCDB_SHARED_LOCK_MANAGER_H
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -22,8 +23,6 @@
 
 #include "yb/docdb/shared_lock_manager_fwd.h"
 #include "yb/docdb/lock_batch.h"
-#include "yb/gutil/spinlock.h"
-#include "yb/util/cross_thread_mutex.h"
 
 namespace yb {
 namespace docdb {
@@ -36,6 +35,8 @@ namespace docdb {
 // - Multiple kWeakSnapshotWrite, kWeakSerializableRead, and kWeakSerializableWrite
 class SharedLockManager {
  public:
+  SharedLockManager();
+  ~SharedLockManager();
 
   // Attempt to lock a batch of keys. The call may be blocked waiting for other locks to be
   // released. If the entries don't exist, they are created. The lock batch gets associated with
@@ -56,44 +57,16 @@ class SharedLockManager {
   static std::string ToString(const LockState& state);
 
  private:
+  struct LockEntry;
+  class LockShard;
 
-  struct LockEntry {
-    // Taken only for short duration, with no blocking wait.
-    std::mutex mutex;
+  // Number of independently locked shards of the lock table. Keys are distributed between shards
+  // by hash, so batches that lock unrelated keys rarely contend on the same shard mutex.
+  static constexpr size_t kNumShards = 16;
 
-    std::condition_variable cond_var;
+  LockShard& ShardFor(uint64_t hash);
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
-    size_t num_using = 0;
-
-    // Number of holders for each type
-    std::array<size_t, kIntentTypeMapSize> num_holding;
-    LockState state;
-
-    void Lock(IntentType lock_type);
-
-    void Unlock(IntentType lock_type);
-
-    LockEntry() {
-      num_holding.fill(0);
-    }
-  };
-
-  typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
-
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
-  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
-
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
-
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  std::unique_ptr<LockShard[]> shards_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
@@ -308,6 +308,9 @@ void RetryingTSRpcTask::UnregisterAsyncTask() {
     LOG_WITH_PREFIX(FATAL) << "Invalid task state " << s;
   }
   end_ts_ = MonoTime::Now();
+  Finished(s == MonitoredTaskState::kComplete
+               ? Status::OK()
+               : STATUS_FORMAT(Aborted, "Task $0 ended in state $1", description(), s));
   if (table_ != nullptr) {
     table_->RemoveTask(shared_from_this());
   }
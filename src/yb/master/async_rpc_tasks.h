@@ -136,6 +136,10 @@ class RetryingTSRpcTask : public MonitoredTask {
   // as the state is MonitoredTaskState::kRunning and deadline_ has not yet passed.
   virtual void HandleResponse(int attempt) = 0;
 
+  // Called once the task has reached a terminal state, right before it is unregistered.
+  // status is OK only if the task completed.
+  virtual void Finished(const Status& status) {}
+
   // Return the id of the tablet that is the subject of the async request.
   virtual TabletId tablet_id() const = 0;
 
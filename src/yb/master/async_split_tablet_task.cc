@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#include "yb/master/async_split_tablet_task.h"
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/master/master.h"
+#include "yb/master/ts_descriptor.h"
+#include "yb/master/catalog_manager.h"
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/tserver/tserver_admin.proxy.h"
+
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+
+namespace yb {
+namespace master {
+
+using std::string;
+using tserver::TabletServerErrorPB;
+
+////////////////////////////////////////////////////////////
+// AsyncSplitTablet
+////////////////////////////////////////////////////////////
+AsyncSplitTablet::AsyncSplitTablet(Master *master,
+                                   ThreadPool* callback_pool,
+                                   const TabletServerId& ts_uuid,
+                                   const scoped_refptr<TableInfo>& table,
+                                   const tserver::SplitTabletRequestPB& req)
+    : RetrySpecificTSRpcTask(master, callback_pool, ts_uuid, table),
+      req_(req) {
+  req_.set_dest_uuid(ts_uuid);
+}
+
+string AsyncSplitTablet::description() const {
+  return Format("$0 Split Tablet $1 RPC", permanent_uuid(), req_.tablet_id());
+}
+
+TabletServerId AsyncSplitTablet::permanent_uuid() const {
+  return permanent_uuid_;
+}
+
+void AsyncSplitTablet::HandleResponse(int attempt) {
+  server::UpdateClock(resp_, master_->clock());
+
+  if (resp_.has_error()) {
+    Status status = StatusFromPB(resp_.error().status());
+
+    // Do not retry on a fatal error.
+    switch (resp_.error().code()) {
+      case TabletServerErrorPB::TABLET_NOT_FOUND: FALLTHROUGH_INTENDED;
+      case TabletServerErrorPB::NOT_THE_LEADER: FALLTHROUGH_INTENDED;
+      case TabletServerErrorPB::INVALID_CONFIG: FALLTHROUGH_INTENDED;
+      case TabletServerErrorPB::TABLET_SPLIT:
+        LOG(WARNING) << "TS " << permanent_uuid() << ": split of tablet " << req_.tablet_id()
+                     << " failed. No further retry: " << status.ToString();
+        TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kFailed);
+        break;
+      default:
+        LOG(WARNING) << "TS " << permanent_uuid() << ": split of tablet " << req_.tablet_id()
+                     << " failed: " << status.ToString();
+    }
+  } else {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    VLOG(1) << "TS " << permanent_uuid() << ": split of tablet " << req_.tablet_id()
+            << " complete";
+  }
+}
+
+bool AsyncSplitTablet::SendRequest(int attempt) {
+  req_.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+
+  ts_admin_proxy_->SplitTabletAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send split tablet request to " << permanent_uuid_
+          << " (attempt " << attempt << "):\n"
+          << req_.DebugString();
+  return true;
+}
+
+void AsyncSplitTablet::Finished(const Status& status) {
+  master_->catalog_manager()->HandleTabletSplitDone(req_.tablet_id(), permanent_uuid_, status);
+}
+
+} // namespace master
+} // namespace yb
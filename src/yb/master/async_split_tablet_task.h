@@ -0,0 +1,53 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_MASTER_ASYNC_SPLIT_TABLET_TASK_H
+#define YB_MASTER_ASYNC_SPLIT_TABLET_TASK_H
+
+#include "yb/master/async_rpc_tasks.h"
+
+namespace yb {
+namespace master {
+
+// Send the "Split Tablet" request to the leader of the tablet being split.
+// Keeps retrying until we get an "ok" response or a fatal error, then reports the outcome to the
+// catalog manager.
+class AsyncSplitTablet : public RetrySpecificTSRpcTask {
+ public:
+  AsyncSplitTablet(Master* master,
+                   ThreadPool* callback_pool,
+                   const TabletServerId& ts_uuid,
+                   const scoped_refptr<TableInfo>& table,
+                   const tserver::SplitTabletRequestPB& req);
+
+  Type type() const override { return ASYNC_SPLIT_TABLET; }
+
+  std::string type_name() const override { return "Split Tablet"; }
+
+  std::string description() const override;
+
+ private:
+  TabletId tablet_id() const override { return req_.tablet_id(); }
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+  void Finished(const Status& status) override;
+
+  tserver::SplitTabletRequestPB req_;
+  tserver::SplitTabletResponsePB resp_;
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_ASYNC_SPLIT_TABLET_TASK_H
@@ -118,6 +118,9 @@ class TestLoadBalancerBase {
   }
 
   void TestAlgorithm() {
+    // Restores the flags changed by the test cases below.
+    google::FlagSaver flag_saver;
+
     // Assign them initially only to the first three TSs.
     std::shared_ptr<TSDescriptor> ts0 = SetupTS("0000", "a");
     std::shared_ptr<TSDescriptor> ts1 = SetupTS("1111", "b");
@@ -159,12 +162,19 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs_single_az);
     TestMissingPlacementSingleAz();
 
-    gflags::SetCommandLineOption("leader_balance_threshold", "2");
+    FLAGS_leader_balance_threshold = 2;
     PrepareTestState(ts_descs_multi_az);
     TestBalancingLeadersWithThreshold();
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingTabletLoad();
+
+    FLAGS_leader_balance_threshold = 0;
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeaderLoad();
   }
 
  protected:
@@ -760,6 +770,90 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(HandleAddReplicas(&placeholder, &placeholder, &placeholder));
   }
 
+  void TestBalancingTabletLoad() {
+    LOG(INFO) << "Testing balancing replicas by reported tablet load";
+    PlacementInfoPB* cluster_placement = replication_info_.mutable_live_replicas();
+    cluster_placement->set_num_replicas(kNumReplicas);
+    cb_->state_->options_->kUseTabletLoad = true;
+    cb_->state_->options_->kTabletSizeUnitBytes = 1000;
+
+    // Tablet 1 is much larger than the others, so it weighs 10 while the others weigh 1. Every
+    // server has a load of 13.
+    for (const auto& ts_desc : ts_descs_) {
+      SetTabletLoads(ts_desc.get(), {{tablets_[1]->tablet_id(), 9000, 0, 0}});
+    }
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    ResetState();
+    AnalyzeTablets();
+
+    // Counting replicas would move the first tablet, tablet 0, to the new server. The large tablet
+    // gets the servers closer to each other, so it is moved instead. ts2 is the leader of tablet 2
+    // and the last of the servers with equal load.
+    string placeholder;
+    TestAddLoad(tablets_[1]->tablet_id(), ts_descs_[2]->permanent_uuid(),
+                ts_descs_[3]->permanent_uuid());
+
+    // The load is now 13 13 3 10. Tablets of ts0 and ts1 are either on ts2 already or were just
+    // added, so the next move is a small tablet from ts1 to ts3.
+    TestAddLoad(placeholder, ts_descs_[1]->permanent_uuid(), ts_descs_[3]->permanent_uuid());
+
+    ClearTabletLoads();
+  }
+
+  void TestBalancingLeaderLoad() {
+    LOG(INFO) << "Testing balancing leaders by reported tablet load";
+    cb_->state_->options_->kUseTabletLoad = true;
+    cb_->state_->options_->kTabletOpsUnit = 100;
+
+    // ts0 leads tablets 0 and 3, the others one tablet each. Counting leaders this is balanced, but
+    // the two tablets led by ts0 are hot, so the leader load is 22 1 1.
+    SetTabletLoads(ts_descs_[0].get(), {{tablets_[0]->tablet_id(), 0, 1000, 0},
+                                        {tablets_[3]->tablet_id(), 0, 0, 1000}});
+    ResetState();
+    AnalyzeTablets();
+
+    // One of the hot leaders should move away from ts0. Moving the other one would just make a
+    // new hot server, so it stays.
+    string tablet_id, from_ts, to_ts, placeholder;
+    ASSERT_TRUE(HandleLeaderMoves(&tablet_id, &from_ts, &to_ts));
+    ASSERT_EQ(ts_descs_[0]->permanent_uuid(), from_ts);
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[3]->tablet_id());
+
+    // The server that got the hot leader gives its own leader to the remaining one, for a leader
+    // load of 11 11 2.
+    TestMoveLeader(&placeholder, to_ts, /* expected_to_ts */ "");
+    ASSERT_FALSE(HandleLeaderMoves(&placeholder, &placeholder, &placeholder));
+
+    ClearTabletLoads();
+  }
+
+  struct TestTabletLoad {
+    TabletId tablet_id;
+    int64_t sst_file_size;
+    double read_ops_per_sec;
+    double write_ops_per_sec;
+  };
+
+  void SetTabletLoads(TSDescriptor* ts_desc, const std::vector<TestTabletLoad>& loads) {
+    google::protobuf::RepeatedPtrField<TabletLoadPB> tablet_loads;
+    for (const auto& load : loads) {
+      auto* tablet_load = tablet_loads.Add();
+      tablet_load->set_tablet_id(load.tablet_id);
+      tablet_load->set_sst_file_size(load.sst_file_size);
+      tablet_load->set_read_ops_per_sec(load.read_ops_per_sec);
+      tablet_load->set_write_ops_per_sec(load.write_ops_per_sec);
+    }
+    ts_desc->set_tablet_loads(tablet_loads);
+  }
+
+  // Drops the reported load and goes back to counting replicas, for the tests that follow.
+  void ClearTabletLoads() {
+    for (const auto& ts_desc : ts_descs_) {
+      SetTabletLoads(ts_desc.get(), {});
+    }
+    cb_->state_->options_->kUseTabletLoad = false;
+  }
+
   // Methods to prepare the state of the current test.
   void PrepareTestState(const TSDescriptorVector& ts_descs) {
     // Clear old state.
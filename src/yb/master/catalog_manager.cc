@@ -89,6 +89,7 @@
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/async_rpc_tasks.h"
+#include "yb/master/async_split_tablet_task.h"
 #include "yb/master/yql_auth_roles_vtable.h"
 #include "yb/master/yql_auth_role_permissions_vtable.h"
 #include "yb/master/yql_auth_resource_role_permissions_index.h"
@@ -173,6 +174,12 @@ DEFINE_bool(catalog_manager_check_ts_count_for_create_table, true,
             "a table to be created.");
 TAG_FLAG(catalog_manager_check_ts_count_for_create_table, hidden);
 
+DEFINE_int64(tablet_split_size_threshold_bytes, 0,
+             "Tablets whose SST files reported by their leader are larger than this are split "
+             "in two. 0 disables automatic tablet splitting.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_split_size_threshold_bytes, experimental);
+
 METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_live,
                            "Number of live tservers in the cluster", yb::MetricUnit::kUnits,
                            "The number of tablet servers that have responded or done a heartbeat "
@@ -1874,8 +1881,9 @@ TableInfo *CatalogManager::CreateTableInfo(const CreateTableRequestPB& req,
 }
 
 TabletInfo* CatalogManager::CreateTabletInfo(TableInfo* table,
-                                             const PartitionPB& partition) {
-  TabletInfo* tablet = new TabletInfo(table, GenerateId());
+                                             const PartitionPB& partition,
+                                             const TabletId& tablet_id) {
+  TabletInfo* tablet = new TabletInfo(table, tablet_id.empty() ? GenerateId() : tablet_id);
   tablet->mutable_metadata()->StartMutation();
   SysTabletsEntryPB *metadata = &tablet->mutable_metadata()->mutable_dirty()->pb;
   metadata->set_state(SysTabletsEntryPB::PREPARING);
@@ -2915,13 +2923,28 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
   scoped_refptr<TabletInfo> tablet;
+  bool is_new_split_tablet = false;
   {
     boost::shared_lock<LockType> l(lock_);
     tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
+    if (!tablet) {
+      for (const auto& split : pending_tablet_splits_) {
+        const auto& ids = split.second.new_tablet_ids;
+        if (std::find(ids.begin(), ids.end(), report.tablet_id()) != ids.end()) {
+          is_new_split_tablet = true;
+          break;
+        }
+      }
+    }
   }
   RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
       Substitute("This master is no longer the leader, unable to handle report for tablet $0",
                  report.tablet_id()));
+  if (is_new_split_tablet) {
+    // The split that created this tablet is not applied to the catalog yet.
+    VLOG(1) << "Got report from tablet " << report.tablet_id() << " of a pending split";
+    return Status::OK();
+  }
   if (!tablet) {
     LOG(INFO) << "Got report from unknown tablet " << report.tablet_id()
               << ": Sending delete request for this orphan tablet";
@@ -2950,6 +2973,13 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   if (tablet_lock->data().is_deleted() ||
       table_lock->data().started_deleting()) {
     report_updates->set_state_msg(tablet_lock->data().pb.state_msg());
+    if (!table_lock->data().started_deleting() &&
+        tablet_lock->data().pb.split_tablet_ids_size() != 0) {
+      // Split tablet, its replicas are kept until the new tablets are fully replicated.
+      VLOG(1) << "Got report from split tablet " << tablet->ToString() << " on "
+              << ts_desc->permanent_uuid();
+      return Status::OK();
+    }
     const string msg = tablet_lock->data().pb.state_msg();
     LOG(INFO) << "Got report from deleted tablet " << tablet->ToString()
               << " (" << msg << "): Sending delete request for this tablet";
@@ -3122,6 +3152,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     }
   }
 
+  const TabletId split_parent_tablet_id = tablet_lock->data().pb.split_parent_tablet_id();
   table_lock->Unlock();
   // We update the tablets each time that someone reports it.
   // This shouldn't be very frequent and should only happen when something in fact changed.
@@ -3133,6 +3164,11 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
   tablet_lock->Commit();
 
+  if (!split_parent_tablet_id.empty() && report.state() == tablet::RUNNING) {
+    HandleSplitTabletRunning(tablet->tablet_id(), split_parent_tablet_id,
+                             ts_desc->permanent_uuid());
+  }
+
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
   // request needs to know who the most recent leader is.
@@ -5332,6 +5368,364 @@ Status CatalogManager::IsLoadBalanced(const IsLoadBalancedRequestPB* req,
   return Status::OK();
 }
 
+Status CatalogManager::SplitTablet(const SplitTabletRequestPB* req,
+                                   SplitTabletResponsePB* resp) {
+  scoped_refptr<TabletInfo> tablet;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    tablet = FindPtrOrNull(tablet_map_, req->tablet_id());
+  }
+  if (tablet == nullptr) {
+    Status s = STATUS_FORMAT(NotFound, "Unknown tablet $0", req->tablet_id());
+    return SetupError(resp->mutable_error(), MasterErrorPB::TABLET_NOT_RUNNING, s);
+  }
+
+  Status s = SendSplitTabletRequest(tablet);
+  if (s.IsInvalidArgument()) {
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+  }
+  if (!s.ok()) {
+    return SetupError(resp->mutable_error(), MasterErrorPB::TABLET_NOT_RUNNING, s);
+  }
+  return Status::OK();
+}
+
+Status CatalogManager::SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet) {
+  const scoped_refptr<TableInfo>& table = tablet->table();
+  if (table == nullptr) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 does not belong to a table", tablet->tablet_id());
+  }
+
+  PendingTabletSplit split;
+  PartitionPB partition;
+  TabletId parent_tablet_id;
+  {
+    auto table_lock = table->LockForRead();
+    auto tablet_lock = tablet->LockForRead();
+    if (!table_lock->data().is_running() || !tablet_lock->data().is_running()) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 is not running", tablet->tablet_id());
+    }
+    // The status tablet of a transaction is kept in its metadata, so the tablets of the
+    // transaction status table cannot be replaced.
+    if (table_lock->data().namespace_id() == kSystemNamespaceId) {
+      return STATUS_FORMAT(InvalidArgument, "Cannot split tablet $0 of system table $1",
+                           tablet->tablet_id(), table_lock->data().name());
+    }
+    partition = tablet_lock->data().pb.partition();
+    parent_tablet_id = tablet_lock->data().pb.split_parent_tablet_id();
+    split.config = tablet_lock->data().pb.committed_consensus_state().config();
+  }
+
+  TabletServerId leader_uuid;
+  if (!getLeaderUUID(tablet, &leader_uuid)) {
+    return STATUS_FORMAT(IllegalState, "No leader for tablet $0", tablet->tablet_id());
+  }
+  if (!IsRaftConfigVoter(leader_uuid, split.config)) {
+    return STATUS_FORMAT(IllegalState, "Leader $0 of tablet $1 is not a voter in its config",
+                         leader_uuid, tablet->tablet_id());
+  }
+  split.config.set_opid_index(consensus::kInvalidOpIdIndex);
+
+  // A tablet created by a split is not split again before the replicas of its parent are
+  // deleted, so that a tablet server never holds more than two generations of the same rows.
+  if (!parent_tablet_id.empty()) {
+    scoped_refptr<TabletInfo> parent;
+    {
+      boost::shared_lock<LockType> l(lock_);
+      parent = FindPtrOrNull(tablet_map_, parent_tablet_id);
+    }
+    if (parent != nullptr && parent->LockForRead()->data().pb.split_tablet_ids_size() != 0) {
+      return STATUS_FORMAT(IllegalState, "Replicas of tablet $0 split into $1 are not deleted yet",
+                           parent_tablet_id, tablet->tablet_id());
+    }
+  }
+
+  // Only hash partitions can be split, the split key is the middle of the hash range.
+  const auto& start_key = partition.partition_key_start();
+  const auto& end_key = partition.partition_key_end();
+  if ((!start_key.empty() && start_key.size() != PartitionSchema::kPartitionKeySize) ||
+      (!end_key.empty() && end_key.size() != PartitionSchema::kPartitionKeySize)) {
+    return STATUS_FORMAT(InvalidArgument, "Tablet $0 is not hash partitioned", tablet->tablet_id());
+  }
+  const uint32_t start_hash =
+      start_key.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(start_key);
+  const uint32_t end_hash = end_key.empty()
+      ? PartitionSchema::kMaxPartitionKey + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(end_key);
+  if (end_hash < start_hash + 2) {
+    return STATUS_FORMAT(InvalidArgument, "Tablet $0 covers a single hash code",
+                         tablet->tablet_id());
+  }
+  const string split_key = PartitionSchema::EncodeMultiColumnHashValue(
+      static_cast<uint16_t>(start_hash + (end_hash - start_hash) / 2));
+
+  tserver::SplitTabletRequestPB req;
+  req.set_tablet_id(tablet->tablet_id());
+  *req.mutable_config() = split.config;
+  for (int i = 0; i != 2; ++i) {
+    PartitionPB new_partition = partition;
+    if (i == 0) {
+      new_partition.set_partition_key_end(split_key);
+    } else {
+      new_partition.set_partition_key_start(split_key);
+    }
+    split.new_tablet_ids.push_back(GenerateId());
+    split.new_partitions.push_back(new_partition);
+    req.add_new_tablet_ids(split.new_tablet_ids.back());
+    *req.add_new_partitions() = new_partition;
+  }
+
+  {
+    std::lock_guard<LockType> l(lock_);
+    if (!pending_tablet_splits_.emplace(tablet->tablet_id(), std::move(split)).second) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 is already being split", tablet->tablet_id());
+    }
+  }
+
+  LOG(INFO) << "Splitting tablet " << tablet->ToString() << " at "
+            << Slice(split_key).ToDebugHexString() << " on " << leader_uuid;
+  auto call = std::make_shared<AsyncSplitTablet>(
+      master_, worker_pool_.get(), leader_uuid, table, req);
+  table->AddTask(call);
+  // On failure the task reports to HandleTabletSplitDone.
+  WARN_NOT_OK(call->Run(), "Failed to send split tablet request");
+  return Status::OK();
+}
+
+void CatalogManager::HandleTabletSplitDone(const TabletId& tablet_id,
+                                           const TabletServerId& ts_uuid,
+                                           const Status& status) {
+  scoped_refptr<TabletInfo> tablet;
+  PendingTabletSplit split;
+  {
+    std::lock_guard<LockType> l(lock_);
+    auto it = pending_tablet_splits_.find(tablet_id);
+    if (it == pending_tablet_splits_.end()) {
+      LOG(DFATAL) << "Split of unknown tablet " << tablet_id << " finished: " << status;
+      return;
+    }
+    split = it->second;
+    tablet = FindPtrOrNull(tablet_map_, tablet_id);
+    if (!status.ok() || tablet == nullptr) {
+      // The new tablets, if any were created, are deleted once they are reported.
+      pending_tablet_splits_.erase(it);
+    }
+  }
+
+  if (!status.ok()) {
+    LOG(WARNING) << "Split of tablet " << tablet_id << " on " << ts_uuid << " failed: " << status;
+    return;
+  }
+  if (tablet == nullptr) {
+    LOG(WARNING) << "Tablet " << tablet_id << " was removed while being split";
+    return;
+  }
+
+  Status s = ApplyTabletSplit(tablet, split);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to apply split of tablet " << tablet_id << ": " << s;
+    std::lock_guard<LockType> l(lock_);
+    pending_tablet_splits_.erase(tablet_id);
+  }
+}
+
+Status CatalogManager::ApplyTabletSplit(const scoped_refptr<TabletInfo>& tablet,
+                                        const PendingTabletSplit& split) {
+  const scoped_refptr<TableInfo>& table = tablet->table();
+  auto tablet_lock = tablet->LockForWrite();
+  if (tablet_lock->data().is_deleted()) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 was deleted", tablet->tablet_id());
+  }
+
+  // Each peer of the split tablet created the new tablets with the same config when it applied
+  // the split, their replicas are updated by the reports once a leader is elected.
+  TabletInfo::ReplicaMap replicas;
+  for (const auto& peer : split.config.peers()) {
+    TSDescSharedPtr ts_desc;
+    if (!master_->ts_manager()->LookupTSByUUID(peer.permanent_uuid(), &ts_desc)) {
+      continue;
+    }
+    TabletReplica replica;
+    replica.ts_desc = ts_desc.get();
+    replica.state = tablet::RUNNING;
+    replica.role = RaftPeerPB::FOLLOWER;
+    replica.member_type = peer.member_type();
+    replicas.emplace(peer.permanent_uuid(), replica);
+  }
+
+  vector<scoped_refptr<TabletInfo>> new_tablets;
+  vector<TabletInfo*> new_tablet_ptrs;
+  for (size_t i = 0; i != split.new_tablet_ids.size(); ++i) {
+    scoped_refptr<TabletInfo> new_tablet(CreateTabletInfo(
+        table.get(), split.new_partitions[i], split.new_tablet_ids[i]));
+    auto* metadata = new_tablet->mutable_metadata()->mutable_dirty();
+    metadata->set_state(SysTabletsEntryPB::RUNNING,
+                        Substitute("Split from tablet $0", tablet->tablet_id()));
+    *metadata->pb.mutable_table_ids() = tablet_lock->data().pb.table_ids();
+    metadata->pb.set_split_parent_tablet_id(tablet->tablet_id());
+    ConsensusStatePB* cstate = metadata->pb.mutable_committed_consensus_state();
+    cstate->set_current_term(kMinimumTerm);
+    *cstate->mutable_config() = split.config;
+    new_tablet->SetReplicaLocations(replicas);
+
+    new_tablet_ptrs.push_back(new_tablet.get());
+    new_tablets.push_back(std::move(new_tablet));
+  }
+
+  // The replicas of the split tablet are not deleted yet, the reports of the new tablets trigger
+  // their deletion.
+  const string msg = Substitute("Tablet split into $0", ToString(split.new_tablet_ids));
+  tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::DELETED, msg);
+  for (const auto& new_tablet_id : split.new_tablet_ids) {
+    tablet_lock->mutable_data()->pb.add_split_tablet_ids(new_tablet_id);
+  }
+
+  vector<TabletInfo*> updated_tablets = { tablet.get() };
+  Status s = sys_catalog_->AddAndUpdateItems(new_tablet_ptrs, updated_tablets);
+  if (!s.ok()) {
+    for (const auto& new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->AbortMutation();
+    }
+    return s.CloneAndPrepend("An error occurred while persisting the split tablets");
+  }
+
+  {
+    std::lock_guard<LockType> l(lock_);
+    for (const auto& new_tablet : new_tablets) {
+      tablet_map_[new_tablet->tablet_id()] = new_tablet;
+    }
+    // The first new tablet replaces the split tablet, since it has the same partition start.
+    table->AddTablets(new_tablet_ptrs);
+    pending_tablet_splits_.erase(tablet->tablet_id());
+  }
+  for (const auto& new_tablet : new_tablets) {
+    new_tablet->mutable_metadata()->CommitMutation();
+  }
+  tablet_lock->Commit();
+
+  LOG(INFO) << "Tablet " << tablet->ToString() << " split into "
+            << ToString(split.new_tablet_ids);
+  return Status::OK();
+}
+
+void CatalogManager::HandleSplitTabletRunning(const TabletId& tablet_id,
+                                              const TabletId& parent_tablet_id,
+                                              const TabletServerId& ts_uuid) {
+  scoped_refptr<TabletInfo> parent;
+  {
+    std::lock_guard<LockType> l(lock_);
+    parent = FindPtrOrNull(tablet_map_, parent_tablet_id);
+    if (parent == nullptr) {
+      split_tablet_running_replicas_.erase(tablet_id);
+      return;
+    }
+    if (!split_tablet_running_replicas_[tablet_id].insert(ts_uuid).second) {
+      return;
+    }
+  }
+
+  vector<TabletId> new_tablet_ids;
+  {
+    auto parent_lock = parent->LockForRead();
+    const auto& split_tablet_ids = parent_lock->data().pb.split_tablet_ids();
+    new_tablet_ids.assign(split_tablet_ids.begin(), split_tablet_ids.end());
+  }
+  if (new_tablet_ids.empty()) {
+    // The replicas of the split tablet were already deleted.
+    std::lock_guard<LockType> l(lock_);
+    split_tablet_running_replicas_.erase(tablet_id);
+    return;
+  }
+
+  vector<scoped_refptr<TabletInfo>> new_tablets;
+  vector<std::set<TabletServerId>> running_replicas;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const auto& new_tablet_id : new_tablet_ids) {
+      auto new_tablet = FindPtrOrNull(tablet_map_, new_tablet_id);
+      auto it = split_tablet_running_replicas_.find(new_tablet_id);
+      if (new_tablet == nullptr || it == split_tablet_running_replicas_.end()) {
+        return;
+      }
+      new_tablets.push_back(std::move(new_tablet));
+      running_replicas.push_back(it->second);
+    }
+  }
+  for (size_t i = 0; i != new_tablets.size(); ++i) {
+    auto new_tablet_lock = new_tablets[i]->LockForRead();
+    for (const auto& peer : new_tablet_lock->data().pb.committed_consensus_state().config()
+                                                       .peers()) {
+      if (peer.member_type() == RaftPeerPB::VOTER &&
+          running_replicas[i].count(peer.permanent_uuid()) == 0) {
+        return;
+      }
+    }
+  }
+
+  {
+    auto parent_lock = parent->LockForWrite();
+    if (parent_lock->data().pb.split_tablet_ids().empty()) {
+      // Concurrent report of another replica.
+      return;
+    }
+    parent_lock->mutable_data()->pb.clear_split_tablet_ids();
+    Status s = sys_catalog_->UpdateItem(parent.get());
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to persist the deletion of split tablet " << parent_tablet_id
+                   << ": " << s;
+      return;
+    }
+    parent_lock->Commit();
+  }
+
+  {
+    std::lock_guard<LockType> l(lock_);
+    for (const auto& new_tablet_id : new_tablet_ids) {
+      split_tablet_running_replicas_.erase(new_tablet_id);
+    }
+  }
+  LOG(INFO) << "Tablets " << ToString(new_tablet_ids) << " split from " << parent->ToString()
+            << " are running on all their voters, deleting the replicas of the split tablet";
+  DeleteTabletReplicas(parent.get(),
+                       Substitute("Tablet split into $0", ToString(new_tablet_ids)));
+}
+
+void CatalogManager::SplitTabletsAboveSizeThreshold(
+    const google::protobuf::RepeatedPtrField<TabletSizePB>& tablet_sizes) {
+  if (FLAGS_tablet_split_size_threshold_bytes <= 0) {
+    return;
+  }
+  for (const auto& tablet_size : tablet_sizes) {
+    if (tablet_size.sst_file_size() < FLAGS_tablet_split_size_threshold_bytes) {
+      continue;
+    }
+    scoped_refptr<TabletInfo> tablet;
+    {
+      boost::shared_lock<LockType> l(lock_);
+      if (ContainsKey(pending_tablet_splits_, tablet_size.tablet_id())) {
+        continue;
+      }
+      tablet = FindPtrOrNull(tablet_map_, tablet_size.tablet_id());
+    }
+    if (tablet == nullptr) {
+      continue;
+    }
+    // A split only starts if the tablet is fully replicated, so that the new tablets are not
+    // split again before they were re-replicated.
+    int num_replicas = 0;
+    TabletInfo::ReplicaMap replicas;
+    tablet->GetReplicaLocations(&replicas);
+    if (!GetReplicationFactor(&num_replicas).ok() ||
+        replicas.size() < static_cast<size_t>(num_replicas)) {
+      continue;
+    }
+    LOG(INFO) << "Tablet " << tablet->ToString() << " has " << tablet_size.sst_file_size()
+              << " bytes of SST files, splitting it";
+    WARN_NOT_OK(SendSplitTabletRequest(tablet),
+                Substitute("Failed to split tablet $0", tablet->tablet_id()));
+  }
+}
+
 void BlacklistState::Reset() {
   tservers_.clear();
   initial_load_ = 0;
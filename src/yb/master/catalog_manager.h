@@ -1025,6 +1025,20 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS IsLoadBalanced(const IsLoadBalancedRequestPB* req,
                                 IsLoadBalancedResponsePB* resp);
 
+  // Split the given tablet into two tablets at the middle of its hash partition. The split itself
+  // is done asynchronously by the leader of the tablet, the catalog is updated once it succeeds.
+  CHECKED_STATUS SplitTablet(const SplitTabletRequestPB* req, SplitTabletResponsePB* resp);
+
+  // Called by AsyncSplitTablet when the split of tablet_id on tablet server ts_uuid finished.
+  void HandleTabletSplitDone(const TabletId& tablet_id,
+                             const TabletServerId& ts_uuid,
+                             const Status& status);
+
+  // Split the tablets in the tablet server metrics whose SST files are larger than
+  // FLAGS_tablet_split_size_threshold_bytes.
+  void SplitTabletsAboveSizeThreshold(
+      const google::protobuf::RepeatedPtrField<TabletSizePB>& tablet_sizes);
+
   // Return the placement uuid of the primary cluster containing this master.
   string placement_uuid() const;
 
@@ -1166,8 +1180,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Helper for creating the initial TabletInfo state.
   // Leaves the tablet "write locked" with the new info in the
   // "dirty" state field.
+  // A new tablet id is generated unless one is provided.
   TabletInfo *CreateTabletInfo(TableInfo* table,
-                               const PartitionPB& partition);
+                               const PartitionPB& partition,
+                               const TabletId& tablet_id = TabletId());
 
   // Add index info to the indexed table.
   CHECKED_STATUS AddIndexInfoToTable(const TableId& indexed_table_id,
@@ -1301,6 +1317,30 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      DeleteTableResponsePB* resp,
                                      rpc::RpcContext* rpc);
 
+  // A split of a tablet that was sent to its leader.
+  struct PendingTabletSplit {
+    // The committed config of the split tablet, each of its peers creates the new tablets with it.
+    consensus::RaftConfigPB config;
+    std::vector<TabletId> new_tablet_ids;
+    std::vector<PartitionPB> new_partitions;
+  };
+
+  // Send the "split tablet request" to the leader of the tablet, the tablet is split at the
+  // middle of its hash partition.
+  CHECKED_STATUS SendSplitTabletRequest(const scoped_refptr<TabletInfo>& tablet);
+
+  // Replace the split tablet with the new tablets in the catalog, once its leader has split it.
+  // The replicas of the split tablet are kept until the new tablets are running on all their
+  // voters, see HandleSplitTabletRunning.
+  CHECKED_STATUS ApplyTabletSplit(const scoped_refptr<TabletInfo>& tablet,
+                                  const PendingTabletSplit& split);
+
+  // Called when ts_uuid reported a tablet created by a split as running. Deletes the replicas of
+  // the split tablet once all the tablets created from it are running on all their voters.
+  void HandleSplitTabletRunning(const TabletId& tablet_id,
+                                const TabletId& parent_tablet_id,
+                                const TabletServerId& ts_uuid);
+
   // Request tablet servers to delete all replicas of the tablet.
   void DeleteTabletReplicas(const TabletInfo* tablet, const std::string& msg);
 
@@ -1414,6 +1454,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Tablet maps: tablet-id -> TabletInfo
   TabletInfoMap tablet_map_;
 
+  // Splits sent to tablet servers but not yet applied to the catalog, keyed by the id of the
+  // tablet being split.
+  std::unordered_map<TabletId, PendingTabletSplit> pending_tablet_splits_;
+
+  // Tablet servers that reported a tablet created by a split as running, keyed by the id of the
+  // new tablet. Only kept while the replicas of the split tablet are not deleted.
+  std::unordered_map<TabletId, std::set<TabletServerId>> split_tablet_running_replicas_;
+
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   typedef std::unordered_map<NamespaceName, scoped_refptr<NamespaceInfo> > NamespaceInfoMap;
   NamespaceInfoMap namespace_ids_map_;
@@ -14,13 +14,17 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 
 #include <boost/thread/locks.hpp>
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_load_balancing,
             true,
@@ -60,6 +64,24 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_bool(load_balancer_use_tablet_load,
+            false,
+            "Balance the load reported by tablet servers for each replica, i.e. the SST size and "
+            "read and write ops rate, instead of just the number of replicas and leaders.");
+TAG_FLAG(load_balancer_use_tablet_load, advanced);
+
+DEFINE_int64(load_balancer_tablet_size_unit_bytes,
+             1_GB,
+             "When balancing tablet load, a replica weighs one more unit for each this many bytes "
+             "of SST files, on top of the one unit every replica weighs.");
+TAG_FLAG(load_balancer_tablet_size_unit_bytes, advanced);
+
+DEFINE_double(load_balancer_tablet_ops_unit,
+              100,
+              "When balancing tablet load, a replica weighs one more unit for each this many ops "
+              "per second, on top of the one unit every replica weighs.");
+TAG_FLAG(load_balancer_tablet_ops_unit, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -432,8 +454,11 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
-    out << uuid << ":" << load << " ";
+    out << uuid << ":" << state_->GetLoad(uuid);
+    if (state_->options_->kUseTabletLoad) {
+      out << "(" << state_->GetWeightedLoad(uuid) << ")";
+    }
+    out << " ";
   }
   VLOG(1) << out.str();
 }
@@ -469,7 +494,8 @@ bool ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance =
+          state_->GetWeightedLoad(high_load_uuid) - state_->GetWeightedLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
@@ -483,7 +509,7 @@ bool ClusterLoadBalancer::GetLoadToMove(
       }
 
       // If we don't find a tablet_id to move between these two TSs, advance the state.
-      if (GetTabletToMove(high_load_uuid, low_load_uuid, moving_tablet_id)) {
+      if (GetTabletToMove(high_load_uuid, low_load_uuid, load_variance, moving_tablet_id)) {
         // If we got this far, we have the candidate we want, so fill in the output params and
         // return. The tablet_id is filled in from GetTabletToMove.
         *from_ts = high_load_uuid;
@@ -522,7 +548,8 @@ bool ClusterLoadBalancer::SkipLeaderAsVictim(const TabletId& tablet_id) const {
 }
 
 bool ClusterLoadBalancer::GetTabletToMove(
-    const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id) {
+    const TabletServerId& from_ts, const TabletServerId& to_ts, double load_variance,
+    TabletId* moving_tablet_id) {
   const auto& from_ts_meta = state_->per_ts_meta_[from_ts];
   set<TabletId> non_over_replicated_tablets;
   set<TabletId> all_tablets;
@@ -546,6 +573,8 @@ bool ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  // Distance of the best candidate from the move that would even out the two tablet servers.
+  double best_distance = std::numeric_limits<double>::max();
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
@@ -563,13 +592,23 @@ bool ClusterLoadBalancer::GetTabletToMove(
       continue;
     }
     // If we got here, it means we either have no placement, in which case we can pick any TS, or
-    // we have placement and it's valid to move across these two tablet servers, so set the tablet
-    // and leave.
-    *moving_tablet_id = tablet_id;
-    return true;
+    // we have placement and it's valid to move across these two tablet servers.
+    //
+    // A replica only helps if it weighs less than the difference of load, otherwise the move would
+    // just swap the two servers. Out of those, pick the one that gets the two closest to each
+    // other. When counting replicas, all of them weigh 1, so this is the first candidate.
+    const double replica_load = state_->per_tablet_meta_[tablet_id].replica_load;
+    if (replica_load >= load_variance) {
+      continue;
+    }
+    const double distance = std::abs(load_variance - 2 * replica_load);
+    if (distance < best_distance) {
+      best_distance = distance;
+      *moving_tablet_id = tablet_id;
+    }
   }
   // If we couldn't select a tablet above, we have to return failure.
-  return false;
+  return best_distance != std::numeric_limits<double>::max();
 }
 
 bool ClusterLoadBalancer::GetLeaderToMove(
@@ -606,8 +645,8 @@ bool ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
-          state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
+      double load_variance = state_->GetWeightedLeaderLoad(high_load_uuid) -
+                             state_->GetWeightedLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < state_->options_->kMinLeaderLoadVarianceToBalance) {
@@ -628,31 +667,48 @@ bool ClusterLoadBalancer::GetLeaderToMove(
       const auto& itr = std::inserter(intersection, intersection.begin());
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
+      // As for replicas, only move a leader that weighs less than the difference of leader load,
+      // preferring the one that gets the two servers closest to each other.
+      double best_distance = std::numeric_limits<double>::max();
       for (const auto& tablet_id : intersection) {
-        *moving_tablet_id = tablet_id;
-        *from_ts = high_load_uuid;
-        *to_ts = low_load_uuid;
-
         const auto& per_tablet_meta = state_->per_tablet_meta_;
         const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
         if (PREDICT_TRUE(tablet_meta_iter != per_tablet_meta.end())) {
           const auto& tablet_meta = tablet_meta_iter->second;
+          if (tablet_meta.leader_load >= load_variance) {
+            continue;
+          }
+          const double distance = std::abs(load_variance - 2 * tablet_meta.leader_load);
+          if (distance >= best_distance) {
+            continue;
+          }
           const auto& stepdown_failures = tablet_meta.leader_stepdown_failures;
           const auto stepdown_failure_iter = stepdown_failures.find(low_load_uuid);
           if (stepdown_failure_iter != stepdown_failures.end()) {
             const auto time_since_failure = current_time - stepdown_failure_iter->second;
             if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
               LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
-                        << *from_ts << " to TS " << *to_ts << " yet: previous attempt with the same"
+                        << high_load_uuid << " to TS " << low_load_uuid
+                        << " yet: previous attempt with the same"
                         << " intended leader failed only " << ToString(time_since_failure)
                         << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
                         << "ms).";
             }
             continue;
           }
+          best_distance = distance;
         } else {
-          LOG(WARNING) << "Did not find load balancer metadata for tablet " << *moving_tablet_id;
+          LOG(WARNING) << "Did not find load balancer metadata for tablet " << tablet_id;
+          best_distance = 0;
         }
+        *moving_tablet_id = tablet_id;
+        *from_ts = high_load_uuid;
+        *to_ts = low_load_uuid;
+        if (best_distance == 0) {
+          break;
+        }
+      }
+      if (best_distance != std::numeric_limits<double>::max()) {
         return true;
       }
     }
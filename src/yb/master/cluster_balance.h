@@ -70,6 +70,11 @@ namespace master {
 //  leaders and moving some leaders to the servers with less to achieve an even distribution. If
 //  a threshold is set in the configuration, the balancer will just keep the numbers of leaders
 //  on each server below it instead of maintaining an even distribution.
+//
+//  By default the load of a tablet server is the number of replicas (or leaders) it hosts. With
+//  load_balancer_use_tablet_load, each replica is weighed by the SST size and ops rate reported for
+//  it in the heartbeats instead, so a few hot or large tablets are spread out even when the counts
+//  are already even.
 class ClusterLoadBalancer {
  public:
   explicit ClusterLoadBalancer(CatalogManager* cm);
@@ -204,8 +209,11 @@ class ClusterLoadBalancer {
   // Returns false otherwise.
   bool GetLoadToMove(TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Picks a tablet to move from from_ts to to_ts, whose replica weighs less than load_variance, the
+  // difference of load between the two servers.
   bool GetTabletToMove(
-      const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id);
+      const TabletServerId& from_ts, const TabletServerId& to_ts, double load_variance,
+      TabletId* moving_tablet_id);
 
   // Go through sorted_leader_load_ and figure out which leader to rebalance and from which TS
   // that is serving it to which other TS.
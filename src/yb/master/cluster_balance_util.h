@@ -48,6 +48,12 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_bool(load_balancer_use_tablet_load);
+
+DECLARE_int64(load_balancer_tablet_size_unit_bytes);
+
+DECLARE_double(load_balancer_tablet_ops_unit);
+
 namespace yb {
 namespace master {
 
@@ -116,6 +122,12 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Load that one replica of this tablet adds to a tablet server. Every replica weighs 1, unless
+  // we balance by reported tablet load, in which case its size and write rate are added.
+  double replica_load = 1;
+
+  // Same as replica_load, but for the leader of this tablet, which also serves the reads.
+  double leader_load = 1;
 };
 
 struct CBTabletServerMetadata {
@@ -130,6 +142,10 @@ struct CBTabletServerMetadata {
 
   // The set of tablet leader ids that this tablet server is currently running.
   std::set<TabletId> leaders;
+
+  // Sum of replica_load of the running and starting tablets, and of leader_load of the leaders.
+  double load = 0;
+  double leader_load = 0;
 };
 
 struct Options {
@@ -164,6 +180,13 @@ struct Options {
   // Max number of tablet leaders on tablet servers to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMoves = FLAGS_load_balancer_max_concurrent_moves;
 
+  // Whether to weigh replicas and leaders by the load reported for them, instead of counting them.
+  bool kUseTabletLoad = FLAGS_load_balancer_use_tablet_load;
+
+  // Number of SST bytes, and of ops per second, that weigh as much as a replica by itself.
+  double kTabletSizeUnitBytes = FLAGS_load_balancer_tablet_size_unit_bytes;
+  double kTabletOpsUnit = FLAGS_load_balancer_tablet_ops_unit;
+
   // TODO(bogdan): add state for leaders starting remote bootstraps, to limit on that end too.
 };
 
@@ -176,8 +199,8 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetWeightedLoad(a);
+    double load_b = GetWeightedLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -208,7 +231,7 @@ class ClusterLoadState {
   struct LeaderLoadComparator {
     explicit LeaderLoadComparator(ClusterLoadState* state) : state_(state) {}
     bool operator()(const TabletServerId& a, const TabletServerId& b) {
-      return state_->GetLeaderLoad(a) < state_->GetLeaderLoad(b);
+      return state_->GetWeightedLeaderLoad(a) < state_->GetWeightedLeaderLoad(b);
     }
     ClusterLoadState* state_;
   };
@@ -224,6 +247,53 @@ class ClusterLoadState {
     return per_ts_meta_.at(ts_uuid).leaders.size();
   }
 
+  // Get the load for a certain TS, with each replica weighed by its replica_load. Same as GetLoad
+  // when not balancing by tablet load.
+  double GetWeightedLoad(const TabletServerId& ts_uuid) const {
+    return per_ts_meta_.at(ts_uuid).load;
+  }
+
+  // Get the leader load for a certain TS, with each leader weighed by its leader_load.
+  double GetWeightedLeaderLoad(const TabletServerId& ts_uuid) const {
+    return per_ts_meta_.at(ts_uuid).leader_load;
+  }
+
+  // Computes replica_load and leader_load of the tablet from the load reported by the servers
+  // hosting it. The leader's report is preferred, as it is the one that serves reads and writes.
+  void UpdateTabletLoad(const TabletInfo::ReplicaMap& replica_map,
+                        const TabletId& tablet_id,
+                        CBTabletMetadata* tablet_meta) {
+    if (!options_ || !options_->kUseTabletLoad) {
+      return;
+    }
+    TSDescriptor::TabletLoad tablet_load;
+    bool found = false;
+    for (const auto& replica : replica_map) {
+      TSDescriptor::TabletLoad replica_load;
+      if (!replica.second.ts_desc->GetTabletLoad(tablet_id, &replica_load)) {
+        continue;
+      }
+      if (replica.second.role == consensus::RaftPeerPB::LEADER) {
+        tablet_load = replica_load;
+        found = true;
+        break;
+      }
+      if (!found || replica_load.sst_file_size > tablet_load.sst_file_size) {
+        tablet_load = replica_load;
+        found = true;
+      }
+    }
+    if (!found) {
+      return;
+    }
+    const double size_units = tablet_load.sst_file_size / options_->kTabletSizeUnitBytes;
+    const double write_units = tablet_load.write_ops_per_sec / options_->kTabletOpsUnit;
+    const double read_units = tablet_load.read_ops_per_sec / options_->kTabletOpsUnit;
+    // Every replica stores the data and applies the writes, while reads are served by the leader.
+    tablet_meta->replica_load = 1 + size_units + write_units;
+    tablet_meta->leader_load = 1 + write_units + read_units;
+  }
+
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
   // Update the per-tablet information for this tablet.
@@ -238,6 +308,7 @@ class ClusterLoadState {
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
+    UpdateTabletLoad(replica_map, tablet_id, &tablet_meta);
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -259,16 +330,19 @@ class ClusterLoadState {
       if (replica.second.role == consensus::RaftPeerPB::LEADER) {
         tablet_meta.leader_uuid = ts_uuid;
         ts_meta_it->second.leaders.insert(tablet_id);
+        ts_meta_it->second.leader_load += tablet_meta.leader_load;
       }
 
       const tablet::TabletStatePB& tablet_state = replica.second.state;
       if (tablet_state == tablet::RUNNING) {
         ts_meta_it->second.running_tablets.insert(tablet_id);
+        ts_meta_it->second.load += tablet_meta.replica_load;
         ++tablet_meta.running;
         ++total_running_;
       } else if (tablet_state == tablet::BOOTSTRAPPING || tablet_state == tablet::NOT_STARTED) {
         // Keep track of transitioning state (not running, but not in a stopped or failed state).
         ts_meta_it->second.starting_tablets.insert(tablet_id);
+        ts_meta_it->second.load += tablet_meta.replica_load;
         ++tablet_meta.starting;
         ++total_starting_;
       }
@@ -503,6 +577,7 @@ class ClusterLoadState {
 
   void AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
     per_ts_meta_[to_ts].starting_tablets.insert(tablet_id);
+    per_ts_meta_[to_ts].load += per_tablet_meta_[tablet_id].replica_load;
     ++per_tablet_meta_[tablet_id].starting;
     ++total_starting_;
     tablets_added_.insert(tablet_id);
@@ -512,11 +587,13 @@ class ClusterLoadState {
   void RemoveReplica(const TabletId& tablet_id, const TabletServerId& from_ts) {
     if (per_ts_meta_[from_ts].running_tablets.count(tablet_id)) {
       per_ts_meta_[from_ts].running_tablets.erase(tablet_id);
+      per_ts_meta_[from_ts].load -= per_tablet_meta_[tablet_id].replica_load;
       --per_tablet_meta_[tablet_id].running;
       --total_running_;
     }
     if (per_ts_meta_[from_ts].starting_tablets.count(tablet_id)) {
       per_ts_meta_[from_ts].starting_tablets.erase(tablet_id);
+      per_ts_meta_[from_ts].load -= per_tablet_meta_[tablet_id].replica_load;
       --per_tablet_meta_[tablet_id].starting;
       --total_starting_;
     }
@@ -542,10 +619,13 @@ class ClusterLoadState {
   void MoveLeader(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts = "") {
     DCHECK_EQ(per_tablet_meta_[tablet_id].leader_uuid, from_ts);
-    per_tablet_meta_[tablet_id].leader_uuid = to_ts;
+    auto& tablet_meta = per_tablet_meta_[tablet_id];
+    tablet_meta.leader_uuid = to_ts;
     per_ts_meta_[from_ts].leaders.erase(tablet_id);
+    per_ts_meta_[from_ts].leader_load -= tablet_meta.leader_load;
     if (!to_ts.empty()) {
       per_ts_meta_[to_ts].leaders.insert(tablet_id);
+      per_ts_meta_[to_ts].leader_load += tablet_meta.leader_load;
     }
     SortLeaderLoad();
   }
@@ -167,6 +167,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->set_total_sst_file_size(req->metrics().total_sst_file_size());
     ts_desc->set_write_ops_per_sec(req->metrics().write_ops_per_sec());
     ts_desc->set_read_ops_per_sec(req->metrics().read_ops_per_sec());
+    ts_desc->set_tablet_loads(req->metrics().tablet_loads());
   }
 
   if (req->has_tablet_report()) {
@@ -178,6 +179,11 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     }
   }
 
+  if (req->has_metrics()) {
+    server_->catalog_manager()->SplitTabletsAboveSizeThreshold(
+        req->metrics().leader_tablet_sizes());
+  }
+
   if (!ts_desc->has_tablet_report()) {
     resp->set_needs_full_tablet_report(true);
   }
@@ -555,5 +561,11 @@ void MasterServiceImpl::IsFlushTablesDone(const IsFlushTablesDoneRequestPB* req,
   HandleIn(req, resp, &rpc, &FlushManager::IsFlushTablesDone);
 }
 
+void MasterServiceImpl::SplitTablet(const SplitTabletRequestPB* req,
+                                    SplitTabletResponsePB* resp,
+                                    RpcContext rpc) {
+  HandleIn(req, resp, &rpc, &CatalogManager::SplitTablet);
+}
+
 } // namespace master
 } // namespace yb
@@ -185,6 +185,10 @@ class MasterServiceImpl : public MasterServiceIf,
       const IsFlushTablesDoneRequestPB* req, IsFlushTablesDoneResponsePB* resp,
       rpc::RpcContext rpc) override;
 
+  virtual void SplitTablet(
+      const SplitTabletRequestPB* req, SplitTabletResponsePB* resp,
+      rpc::RpcContext rpc) override;
+
  private:
 };
 
@@ -68,6 +68,12 @@ void MasterTabletServiceImpl::Write(const tserver::WriteRequestPB* req,
   HandleUnsupportedMethod("Write", resp, &context);
 }
 
+void MasterTabletServiceImpl::MultiWrite(const tserver::MultiWriteRequestPB* req,
+                                         tserver::MultiWriteResponsePB* resp,
+                                         rpc::RpcContext context)  {
+  HandleUnsupportedMethod("MultiWrite", resp, &context);
+}
+
 void MasterTabletServiceImpl::NoOp(const tserver::NoOpRequestPB* req,
                                    tserver::NoOpResponsePB* resp,
                                    rpc::RpcContext context)  {
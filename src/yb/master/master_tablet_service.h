@@ -36,6 +36,10 @@ class MasterTabletServiceImpl : public yb::tserver::TabletServiceImpl {
              tserver::WriteResponsePB* resp,
              rpc::RpcContext context) override;
 
+  void MultiWrite(const tserver::MultiWriteRequestPB* req,
+                  tserver::MultiWriteResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void NoOp(const tserver::NoOpRequestPB* req,
             tserver::NoOpResponsePB* resp,
             rpc::RpcContext context) override;
@@ -32,5 +32,9 @@ const scoped_refptr<MetricEntity>& MasterTabletServer::MetricEnt() const {
   return metric_entity_;
 }
 
+const std::shared_ptr<tserver::TabletServerServiceProxy>& MasterTabletServer::proxy() const {
+  return proxy_;
+}
+
 } // namespace master
 } // namespace yb
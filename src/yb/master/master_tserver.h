@@ -31,9 +31,12 @@ class MasterTabletServer : public tserver::TabletServerIf {
   server::Clock* Clock() override;
   const scoped_refptr<MetricEntity>& MetricEnt() const override;
 
+  const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy() const override;
+
  private:
   std::unique_ptr<MetricRegistry> metric_registry_;
   scoped_refptr<MetricEntity> metric_entity_;
+  std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
 };
 
 } // namespace master
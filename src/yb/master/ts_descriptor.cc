@@ -271,6 +271,30 @@ void TSDescriptor::ClearPendingTabletDelete(const std::string& tablet_id) {
   tablets_pending_delete_.erase(tablet_id);
 }
 
+void TSDescriptor::set_tablet_loads(
+    const google::protobuf::RepeatedPtrField<TabletLoadPB>& tablet_loads) {
+  std::unordered_map<std::string, TabletLoad> loads;
+  loads.reserve(tablet_loads.size());
+  for (const auto& tablet_load : tablet_loads) {
+    auto& load = loads[tablet_load.tablet_id()];
+    load.sst_file_size = tablet_load.sst_file_size();
+    load.read_ops_per_sec = tablet_load.read_ops_per_sec();
+    load.write_ops_per_sec = tablet_load.write_ops_per_sec();
+  }
+  std::lock_guard<simple_spinlock> l(lock_);
+  tsMetrics_.tablet_loads.swap(loads);
+}
+
+bool TSDescriptor::GetTabletLoad(const std::string& tablet_id, TabletLoad* load) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  auto it = tsMetrics_.tablet_loads.find(tablet_id);
+  if (it == tsMetrics_.tablet_loads.end()) {
+    return false;
+  }
+  *load = it->second;
+  return true;
+}
+
 std::string TSDescriptor::ToString() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return Format("{ permanent_uuid: $0 registration: $1 placement_id: $2 }",
@@ -35,6 +35,9 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+
+#include <google/protobuf/repeated_field.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/tserver/tserver_service.proxy.h"
@@ -60,6 +63,7 @@ namespace master {
 
 class TSRegistrationPB;
 class TSInformationPB;
+class TabletLoadPB;
 
 typedef util::SharedPtrTuple<tserver::TabletServerAdminServiceProxy,
                              tserver::TabletServerServiceProxy,
@@ -71,6 +75,13 @@ typedef util::SharedPtrTuple<tserver::TabletServerAdminServiceProxy,
 // This class is thread-safe.
 class TSDescriptor {
  public:
+  // Load of a single replica hosted by this server, as reported in the last heartbeat metrics.
+  struct TabletLoad {
+    uint64_t sst_file_size = 0;
+    double read_ops_per_sec = 0;
+    double write_ops_per_sec = 0;
+  };
+
   static CHECKED_STATUS RegisterNew(const NodeInstancePB& instance,
                                             const TSRegistrationPB& registration,
                                             gscoped_ptr<TSDescriptor>* desc);
@@ -189,7 +200,14 @@ class TSDescriptor {
     return tsMetrics_.write_ops_per_sec;
   }
 
+  // Replaces the per-replica load with the one from the latest heartbeat metrics.
+  void set_tablet_loads(const google::protobuf::RepeatedPtrField<TabletLoadPB>& tablet_loads);
+
+  // Returns false if this server did not report the load of the given tablet.
+  bool GetTabletLoad(const std::string& tablet_id, TabletLoad* load) const;
+
   void ClearMetrics() {
+    std::lock_guard<simple_spinlock> l(lock_);
     tsMetrics_.ClearMetrics();
   }
 
@@ -244,11 +262,15 @@ class TSDescriptor {
 
     double write_ops_per_sec = 0;
 
+    // Load of each replica hosted by the tserver, keyed by tablet id.
+    std::unordered_map<std::string, TabletLoad> tablet_loads;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
+      tablet_loads.clear();
     }
   };
 
@@ -38,6 +38,7 @@
 
 #include <stdint.h>
 #include <memory>
+#include <string>
 #include "yb/util/slice.h"
 #include "yb/rocksdb/status.h"
 #include "yb/util/cache_metrics.h"
@@ -66,6 +67,13 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with a fixed size capacity, backed by yb::Cache with the SAMPLED_LRU
+// eviction policy. Lookups only take a shared lock, so concurrent hits on the same shard do not
+// serialize. It has no single touch pool, the only query id it distinguishes is
+// kNoCacheQueryId. Its capacity cannot be changed and is never strictly enforced. Memory is
+// tracked by the "<id>-sharded_lru_cache" MemTracker.
+extern shared_ptr<Cache> NewSampledLRUCache(size_t capacity, const std::string& id);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
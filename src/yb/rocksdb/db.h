@@ -801,6 +801,12 @@ class DB {
     return Status::OK();
   }
 
+  // Sets the flushed frontier even if it is lower than the current one. Used when the data of
+  // this DB is reused by a new Raft group, e.g. for the tablets created by a tablet split.
+  virtual CHECKED_STATUS ForceFlushedFrontier(UserFrontierPtr values) {
+    return Status::OK();
+  }
+
   // Obtains the meta data of the specified column family of the DB.
   // STATUS(NotFound, "") will be returned if the current DB does not have
   // any column family match the specified name.
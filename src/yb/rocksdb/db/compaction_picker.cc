@@ -1148,7 +1148,57 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  return vstorage->CompactionScore(kLevel0) >= 1 || NumExpiredFiles(vstorage) != 0;
+}
+
+size_t UniversalCompactionPicker::NumExpiredFiles(const VersionStorageInfo* vstorage) const {
+  const int kLevel0 = 0;
+  if (ioptions_.expired_files_filter == nullptr) {
+    return 0;
+  }
+  // Files of other levels could contain older data that is hidden by the expired files.
+  for (int level = 1; level < vstorage->num_levels(); ++level) {
+    if (!vstorage->LevelFiles(level).empty()) {
+      return 0;
+    }
+  }
+  const auto& level_files = vstorage->LevelFiles(kLevel0);
+  const size_t num_expired = ioptions_.expired_files_filter->NumExpiredOldestFiles(level_files);
+  for (size_t i = level_files.size() - num_expired; i != level_files.size(); ++i) {
+    if (level_files[i]->being_compacted) {
+      return 0;
+    }
+  }
+  return num_expired;
+}
+
+Compaction* UniversalCompactionPicker::PickExpiredFilesCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  const size_t num_expired = NumExpiredFiles(vstorage);
+  if (num_expired == 0) {
+    return nullptr;
+  }
+
+  const auto& level_files = vstorage->LevelFiles(kLevel0);
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  for (size_t i = level_files.size() - num_expired; i != level_files.size(); ++i) {
+    auto* f = level_files[i];
+    inputs[0].files.push_back(f);
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking expired file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+  }
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), 0, 0, 0, 0,
+      kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(kLevel0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+  level0_compactions_in_progress_.insert(c);
+  return c;
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1353,6 +1403,13 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  // Dropping expired files is cheap and makes the following compactions smaller, so do it first.
+  Compaction* expired_files_compaction = PickExpiredFilesCompaction(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (expired_files_compaction != nullptr) {
+    return expired_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -259,6 +259,15 @@ class UniversalCompactionPicker : public CompactionPicker {
  private:
   struct SortedRun;
 
+  // Returns the number of the oldest level 0 files that could be deleted because their data has
+  // expired, according to ioptions_.expired_files_filter.
+  size_t NumExpiredFiles(const VersionStorageInfo* vstorage) const;
+
+  // Pick deletion compaction of the oldest files whose data has expired.
+  Compaction* PickExpiredFilesCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
   Compaction* DoPickCompaction(
       const std::string& cf_name,
       const MutableCFOptions& mutable_cf_options,
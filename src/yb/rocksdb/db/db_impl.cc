@@ -3103,7 +3103,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+               kCompactionStyleFIFO ||
+           c->compaction_reason() == CompactionReason::kUniversalExpiredFiles);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -5489,6 +5490,12 @@ Status DBImpl::SetFlushedFrontier(UserFrontierPtr frontier) {
   return ApplyVersionEdit(&edit);
 }
 
+Status DBImpl::ForceFlushedFrontier(UserFrontierPtr frontier) {
+  VersionEdit edit;
+  edit.ForceFlushedFrontier(std::move(frontier));
+  return ApplyVersionEdit(&edit);
+}
+
 void DBImpl::GetColumnFamilyMetaData(
     ColumnFamilyHandle* column_family,
     ColumnFamilyMetaData* cf_meta) {
@@ -159,6 +159,12 @@ class VersionEdit {
   void SetFlushedFrontier(UserFrontierPtr value) {
     flushed_frontier_ = std::move(value);
   }
+  // Same as SetFlushedFrontier, but the frontier is applied even if it is lower than the current
+  // flushed frontier.
+  void ForceFlushedFrontier(UserFrontierPtr value) {
+    flushed_frontier_ = std::move(value);
+    force_flushed_frontier_ = true;
+  }
   void SetMaxColumnFamily(uint32_t max_column_family) {
     max_column_family_ = max_column_family;
   }
@@ -263,6 +269,8 @@ class VersionEdit {
   boost::optional<uint32_t> max_column_family_;
   boost::optional<SequenceNumber> last_sequence_;
   UserFrontierPtr flushed_frontier_;
+  // Not persisted, recovery always takes the flushed frontier of the last edit.
+  bool force_flushed_frontier_ = false;
 
   DeletedFileSet deleted_files_;
   std::vector<std::pair<int, FileMetaData>> new_files_;
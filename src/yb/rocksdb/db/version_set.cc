@@ -2344,7 +2344,11 @@ Status VersionSet::LogAndApply(ColumnFamilyData* column_family_data,
     manifest_file_size_ = new_manifest_file_size;
     prev_log_number_ = edit->prev_log_number_.get_value_or(0);
     if (edit->flushed_frontier_) {
-      SetFlushedFrontier(edit->flushed_frontier_);
+      if (edit->force_flushed_frontier_) {
+        SetFlushedFrontierNoSanityChecking(edit->flushed_frontier_);
+      } else {
+        SetFlushedFrontier(edit->flushed_frontier_);
+      }
     }
   } else {
     RLOG(InfoLogLevel::ERROR_LEVEL, db_options_->info_log,
@@ -50,6 +50,8 @@ struct ImmutableCFOptions {
 
   CompactionFilterFactory* compaction_filter_factory;
 
+  const ExpiredFilesFilter* expired_files_filter;
+
   bool inplace_update_support;
 
   UpdateStatus (*inplace_callback)(char* existing_value,
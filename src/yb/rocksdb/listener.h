@@ -68,6 +68,8 @@ enum class CompactionReason {
   kUniversalSizeRatio,
   // [Universal] number of sorted runs > level0_file_num_compaction_trigger
   kUniversalSortedRunNum,
+  // [Universal] all data of the oldest files has expired
+  kUniversalExpiredFiles,
   // [FIFO] total size > max_table_files_size
   kFIFOMaxSize,
   // Manual compaction
@@ -66,6 +66,7 @@ class Statistics;
 class InternalKeyComparator;
 class WalFilter;
 class MemoryMonitor;
+class ExpiredFilesFilter;
 
 typedef std::shared_ptr<const InternalKeyComparator> InternalKeyComparatorPtr;
 
@@ -1315,6 +1316,10 @@ struct DBOptions {
 
   // Invoked after memtable switched.
   std::shared_ptr<std::function<MemTableFilter()>> mem_table_flush_filter_factory;
+
+  // Used by universal compaction to delete whole level 0 files whose data has fully expired,
+  // without reading them. Supported only when all files are in level 0.
+  std::shared_ptr<ExpiredFilesFilter> expired_files_filter;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1366,6 +1371,18 @@ class ReadFileFilter {
   virtual ~ReadFileFilter() {}
 };
 
+struct FileMetaData;
+class ExpiredFilesFilter {
+ public:
+  // Files are ordered from the newest to the oldest, as they are stored in level 0.
+  // Returns the number of the oldest files that could be deleted because all of their data has
+  // expired and does not hide any live data in the remaining files.
+  virtual size_t NumExpiredOldestFiles(const std::vector<FileMetaData*>& files) const = 0;
+
+ protected:
+  virtual ~ExpiredFilesFilter() {}
+};
+
 class TableReader;
 class TableAwareReadFileFilter {
  public:
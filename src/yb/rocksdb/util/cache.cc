@@ -24,8 +24,12 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+
+#include <atomic>
+
 #include <gflags/gflags.h>
 
+#include "yb/util/cache.h"
 #include "yb/util/metrics.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/statistics.h"
@@ -923,6 +927,165 @@ class ShardedLRUCache : public Cache {
   }
 };
 
+// Exposes a yb::Cache as a RocksDB block cache. Every value is wrapped together with its RocksDB
+// deleter, the wrapper is what yb::Cache stores.
+class YBCacheAdapter : public Cache, private yb::CacheDeleter {
+ public:
+  YBCacheAdapter(yb::Cache* cache, size_t capacity)
+      : cache_(cache), capacity_(capacity) {}
+
+  ~YBCacheAdapter() {
+    // Entries are deleted through this object, so destroy the cache while it is still alive.
+    cache_.reset();
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    auto* entry = new Entry(value, deleter, charge);
+    usage_.fetch_add(charge, std::memory_order_relaxed);
+    auto* yb_handle = cache_->Insert(key, entry, charge, this);
+    if (handle != nullptr) {
+      Pin(entry);
+      *handle = reinterpret_cast<Handle*>(yb_handle);
+    } else {
+      cache_->Release(yb_handle);
+    }
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+    }
+    return Status::OK();
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    auto* yb_handle = cache_->Lookup(key, yb::Cache::NO_EXPECT_IN_CACHE);
+    if (yb_handle == nullptr) {
+      if (statistics != nullptr) {
+        RecordTick(statistics, BLOCK_CACHE_MISS);
+      }
+      return nullptr;
+    }
+    auto* handle = reinterpret_cast<Handle*>(yb_handle);
+    auto* entry = GetEntry(handle);
+    Pin(entry);
+    const size_t charge = entry->charge;
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, charge);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, charge);
+    }
+    return handle;
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    auto* entry = GetEntry(handle);
+    if (entry->pins.fetch_sub(1, std::memory_order_relaxed) == 1) {
+      pinned_usage_.fetch_sub(entry->charge, std::memory_order_relaxed);
+    }
+    cache_->Release(reinterpret_cast<yb::Cache::Handle*>(handle));
+  }
+
+  void* Value(Handle* handle) override {
+    return GetEntry(handle)->value;
+  }
+
+  void Erase(const Slice& key) override {
+    cache_->Erase(key);
+  }
+
+  uint64_t NewId() override {
+    return cache_->NewId();
+  }
+
+  void SetCapacity(size_t capacity) override {
+    capacity_.store(capacity, std::memory_order_relaxed);
+    cache_->SetCapacity(capacity);
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    LOG_IF(DFATAL, strict_capacity_limit)
+        << "Strict capacity limit is not supported by a sampled LRU cache";
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return false;
+  }
+
+  size_t GetCapacity() const override {
+    return capacity_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetUsage() const override {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return GetEntry(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
+
+  // Shards are always locked while their entries are visited, regardless of thread_safe.
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    cache_->ApplyToAllCacheEntries([callback](void* value, size_t charge) {
+      auto* entry = static_cast<Entry*>(value);
+      callback(entry->value, entry->charge);
+    });
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    cache_->SetMetrics(entity);
+  }
+
+ private:
+  struct Entry {
+    Entry(void* value_, void (*deleter_)(const Slice& key, void* value), size_t charge_)
+        : value(value_), deleter(deleter_), charge(charge_) {}
+
+    void* value;
+    void (*deleter)(const Slice& key, void* value);
+    size_t charge;
+    // Number of outstanding handles to this entry.
+    std::atomic<size_t> pins{0};
+  };
+
+  void Pin(Entry* entry) {
+    if (entry->pins.fetch_add(1, std::memory_order_relaxed) == 0) {
+      pinned_usage_.fetch_add(entry->charge, std::memory_order_relaxed);
+    }
+  }
+
+  Entry* GetEntry(Handle* handle) const {
+    return static_cast<Entry*>(cache_->Value(reinterpret_cast<yb::Cache::Handle*>(handle)));
+  }
+
+  void Delete(const Slice& key, void* value) override {
+    std::unique_ptr<Entry> entry(static_cast<Entry*>(value));
+    usage_.fetch_sub(entry->charge, std::memory_order_relaxed);
+    entry->deleter(key, entry->value);
+  }
+
+  std::unique_ptr<yb::Cache> cache_;
+  std::atomic<size_t> capacity_;
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> pinned_usage_{0};
+};
+
 }  // end anonymous namespace
 
 shared_ptr<Cache> NewLRUCache(size_t capacity) {
@@ -942,4 +1105,9 @@ shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                            strict_capacity_limit);
 }
 
+shared_ptr<Cache> NewSampledLRUCache(size_t capacity, const std::string& id) {
+  return std::make_shared<YBCacheAdapter>(
+      yb::NewCache(yb::DRAM_CACHE, yb::SAMPLED_LRU, capacity, id), capacity);
+}
+
 }  // namespace rocksdb
@@ -660,6 +660,66 @@ void callback(void* entry, size_t charge) {
 }
 };
 
+TEST_F(CacheTest, SampledLRU) {
+  auto cache = NewSampledLRUCache(kCacheSize, "cache_test");
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_OK(Insert(cache, 200, 201));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(2U, cache->GetUsage());
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+
+  // Entries that are not cached by the query are neither inserted nor looked up.
+  ASSERT_OK(Insert(cache, 300, 301, 1, kNoCacheQueryId));
+  ASSERT_EQ(-1, Lookup(cache, 300));
+  ASSERT_EQ(-1, Lookup(cache, 100, kNoCacheQueryId));
+
+  // A replaced entry is deleted once its last handle is released.
+  Cache::Handle* handle = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(1U, cache->GetPinnedUsage());
+  ASSERT_OK(Insert(cache, 100, 102));
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(101, DecodeValue(cache->Value(handle)));
+  ASSERT_EQ(3U, cache->GetUsage());
+  ASSERT_EQ(0U, deleted_keys_.size());
+  cache->Release(handle);
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  ASSERT_EQ(2U, cache->GetUsage());
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 200);
+  ASSERT_EQ(-1, Lookup(cache, 200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(201, deleted_values_[1]);
+
+  // Overloading the cache evicts entries, but keeps the usage close to the capacity. The capacity
+  // is rounded up per shard.
+  for (int i = 0; i < kCacheSize * 2; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i));
+  }
+  ASSERT_LT(cache->GetUsage(), kCacheSize * 1.1);
+  ASSERT_GT(cache->GetUsage(), kCacheSize * 0.9);
+  ASSERT_EQ(3U + kCacheSize * 2 - cache->GetUsage(), deleted_keys_.size());
+
+  // Every cached entry is visited.
+  callback_state.clear();
+  cache->ApplyToAllCacheEntries(callback, true);
+  ASSERT_EQ(cache->GetUsage(), callback_state.size());
+
+  // Shrinking the cache evicts entries right away.
+  cache->SetCapacity(kCacheSize / 2);
+  ASSERT_EQ(static_cast<size_t>(kCacheSize / 2), cache->GetCapacity());
+  ASSERT_LT(cache->GetUsage(), kCacheSize * 0.55);
+  ASSERT_EQ(3U + kCacheSize * 2 - cache->GetUsage(), deleted_keys_.size());
+
+  // Destroying the cache deletes the remaining entries.
+  cache.reset();
+  ASSERT_EQ(3U + kCacheSize * 2, deleted_keys_.size());
+}
+
 TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   std::vector<std::pair<int, int>> inserted;
   callback_state.clear();
@@ -1924,6 +1924,7 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, wal_filter),
       BLACKLIST_ENTRY(DBOptions, boundary_extractor),
       BLACKLIST_ENTRY(DBOptions, mem_table_flush_filter_factory),
+      BLACKLIST_ENTRY(DBOptions, expired_files_filter),
   };
 
   TestAllFieldsSettable<DBOptions>(kDBOptionsBlacklist);
@@ -278,6 +278,10 @@ class StackableDB : public DB {
     return db_->SetFlushedFrontier(std::move(values));
   }
 
+  CHECKED_STATUS ForceFlushedFrontier(UserFrontierPtr values) override {
+    return db_->ForceFlushedFrontier(std::move(values));
+  }
+
   virtual void GetColumnFamilyMetaData(
       ColumnFamilyHandle *column_family,
       ColumnFamilyMetaData* cf_meta) override {
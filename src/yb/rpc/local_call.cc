@@ -90,5 +90,16 @@ Status LocalYBInboundCall::ParseParam(google::protobuf::Message* message) {
   LOG(FATAL) << "local call should not require parsing";
 }
 
+Status LocalYBInboundCall::GetRequestSidecar(int idx, Slice* sidecar) const {
+  // Request sidecars of a local call are taken directly from the controller of the caller.
+  const auto& sidecars = outbound_call()->controller()->request_sidecars();
+  if (idx < 0 || idx >= sidecars.size()) {
+    return STATUS_FORMAT(InvalidArgument, "Index $0 does not reference a valid request sidecar",
+                         idx);
+  }
+  *sidecar = Slice(sidecars[idx].udata(), sidecars[idx].size());
+  return Status::OK();
+}
+
 } // namespace rpc
 } // namespace yb
@@ -64,6 +64,8 @@ class LocalYBInboundCall : public YBInboundCall {
 
   CHECKED_STATUS ParseParam(google::protobuf::Message* message) override;
 
+  CHECKED_STATUS GetRequestSidecar(int idx, Slice* sidecar) const override;
+
   const google::protobuf::Message* request() const { return outbound_call()->req_; }
   google::protobuf::Message* response() const { return outbound_call()->response(); }
 
@@ -225,17 +225,33 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
 
 void OutboundCall::Serialize(std::deque<RefCntBuffer>* output) const {
   output->push_back(buffer_);
+  for (const auto& car : sidecars_) {
+    output->push_back(car);
+  }
 }
 
 Status OutboundCall::SetRequestParam(const Message& message) {
   using serialization::SerializeHeader;
   using serialization::SerializeMessage;
 
+  RequestHeader header;
+  InitHeader(&header);
+
+  // Sidecars are not copied into buffer_, they are sent from their own buffers right after it.
+  sidecars_ = controller_->request_sidecars();
+  uint32_t protobuf_msg_size = message.ByteSize();
+  uint32_t absolute_sidecar_offset = protobuf_msg_size;
+  for (const auto& car : sidecars_) {
+    header.add_sidecar_offsets(absolute_sidecar_offset);
+    absolute_sidecar_offset += car.size();
+  }
+  int additional_size = absolute_sidecar_offset - protobuf_msg_size;
+
   size_t message_size = 0;
   auto status = SerializeMessage(message,
                                  /* param_buf */ nullptr,
-                                 /* additional_size */ 0,
-                                 /* use_cached_size */ false,
+                                 additional_size,
+                                 /* use_cached_size */ true,
                                  /* offset */ 0,
                                  &message_size);
   if (!status.ok()) {
@@ -243,16 +259,15 @@ Status OutboundCall::SetRequestParam(const Message& message) {
   }
   size_t header_size = 0;
 
-  RequestHeader header;
-  InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  status = SerializeHeader(
+      header, message_size + additional_size, &buffer_, message_size, &header_size);
   remote_method_pool_->Release(header.release_remote_method());
   if (!status.ok()) {
     return status;
   }
   return SerializeMessage(message,
                           &buffer_,
-                          /* additional_size */ 0,
+                          additional_size,
                           /* use_cached_size */ true,
                           header_size);
 }
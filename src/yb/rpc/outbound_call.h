@@ -327,6 +327,9 @@ class OutboundCall : public RpcCall {
   // Buffers for storing segments of the wire-format request.
   RefCntBuffer buffer_;
 
+  // Request sidecars taken from the controller, sent right after buffer_.
+  std::vector<RefCntBuffer> sidecars_;
+
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
@@ -38,10 +38,16 @@
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
 
+DEFINE_uint64(rpc_bench_sidecar_size, 1024 * 1024,
+              "Size of the response sidecar used by the sidecars benchmark.");
+DEFINE_int32(rpc_bench_sidecar_threads, 4,
+             "Number of client threads used by the sidecars benchmark.");
+
 using std::string;
 using std::shared_ptr;
 
@@ -149,6 +155,50 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
 }
 
+// Measures the throughput of large read-like responses, that are sent as a sidecar of an already
+// prepared buffer.
+TEST_F(RpcBench, BenchmarkSidecars) {
+  StartTestServerWithGeneratedCode(&server_endpoint_);
+
+  MessengerOptions client_options = kDefaultClientMessengerOptions;
+  client_options.n_reactors = 2;
+  client_messenger_ = CreateMessenger("Client", client_options);
+
+  std::atomic<uint64_t> total_bytes{0};
+  std::vector<std::thread> threads;
+  Stopwatch sw(Stopwatch::ALL_THREADS);
+  sw.start();
+  for (int i = 0; i < FLAGS_rpc_bench_sidecar_threads; ++i) {
+    threads.emplace_back([this, &total_bytes] {
+      rpc_test::CalculatorServiceProxy p(client_messenger_, server_endpoint_);
+      rpc_test::SidecarsRequestPB req;
+      req.set_response_sidecar_size(FLAGS_rpc_bench_sidecar_size);
+      rpc_test::SidecarsResponsePB resp;
+      while (should_run_.load(std::memory_order_acquire)) {
+        RpcController controller;
+        controller.set_timeout(MonoDelta::FromSeconds(10));
+        CHECK_OK(p.Sidecars(req, &resp, &controller));
+        Slice sidecar;
+        CHECK_OK(controller.GetSidecar(resp.sidecars(0), &sidecar));
+        CHECK_EQ(FLAGS_rpc_bench_sidecar_size, sidecar.size());
+        total_bytes.fetch_add(sidecar.size(), std::memory_order_acq_rel);
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(10s);
+  should_run_.store(false, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sw.stop();
+
+  double total_gb = static_cast<double>(total_bytes.load(std::memory_order_acquire)) / 1_GB;
+  LOG(INFO) << "GB/sec:           " << total_gb / sw.elapsed().wall_seconds();
+  LOG(INFO) << "User CPU per GB:  " << sw.elapsed().user / 1e9 / total_gb << "s";
+  LOG(INFO) << "Sys CPU per GB:   " << sw.elapsed().system / 1e9 / total_gb << "s";
+}
+
 } // namespace rpc
 } // namespace yb
 
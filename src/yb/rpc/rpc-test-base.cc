@@ -15,6 +15,7 @@
 
 #include "yb/rpc/rpc-test-base.h"
 
+#include <mutex>
 #include <thread>
 
 #include "yb/util/random_util.h"
@@ -39,6 +40,8 @@ using yb::rpc_test::PanicRequestPB;
 using yb::rpc_test::PanicResponsePB;
 using yb::rpc_test::SendStringsRequestPB;
 using yb::rpc_test::SendStringsResponsePB;
+using yb::rpc_test::SidecarsRequestPB;
+using yb::rpc_test::SidecarsResponsePB;
 using yb::rpc_test::SleepRequestPB;
 using yb::rpc_test::SleepResponsePB;
 using yb::rpc_test::WhoAmIRequestPB;
@@ -284,14 +287,56 @@ class CalculatorService: public CalculatorServiceIf {
     }
   }
 
+  void Sidecars(
+      const SidecarsRequestPB* req, SidecarsResponsePB* resp, RpcContext context) override {
+    for (auto idx : req->echo_sidecars()) {
+      Slice sidecar;
+      int response_idx = 0;
+      auto status = context.GetRequestSidecar(idx, &sidecar);
+      if (status.ok()) {
+        status = context.AddRpcSidecar(RefCntBuffer(sidecar.data(), sidecar.size()),
+                                       &response_idx);
+      }
+      if (!status.ok()) {
+        context.RespondFailure(status);
+        return;
+      }
+      resp->add_sidecars(response_idx);
+    }
+    if (req->has_response_sidecar_size()) {
+      int response_idx = 0;
+      auto status = context.AddRpcSidecar(ResponseSidecar(req->response_sidecar_size()),
+                                          &response_idx);
+      if (!status.ok()) {
+        context.RespondFailure(status);
+        return;
+      }
+      resp->add_sidecars(response_idx);
+    }
+    context.RespondSuccess();
+  }
+
  private:
   void DoSleep(const SleepRequestPB* req, RpcContext context) {
     SleepFor(MonoDelta::FromMicroseconds(req->sleep_micros()));
     context.RespondSuccess();
   }
 
+  RefCntBuffer ResponseSidecar(size_t size) {
+    std::lock_guard<std::mutex> lock(response_sidecar_mutex_);
+    if (response_sidecar_.size() != size) {
+      response_sidecar_ = RefCntBuffer(size);
+      Random r(size);
+      RandomString(response_sidecar_.udata(), size, &r);
+    }
+    return response_sidecar_;
+  }
+
   std::string name_;
   std::weak_ptr<Messenger> messenger_;
+
+  std::mutex response_sidecar_mutex_;
+  RefCntBuffer response_sidecar_;
 };
 
 } // namespace
@@ -336,6 +336,46 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(p, sizes, Status::kRemoteError);
 }
 
+// Test that request sidecars reach the handler unchanged and can be sent back in the response.
+TEST_F(TestRpc, TestRequestSidecars) {
+  Endpoint server_endpoint;
+  StartTestServerWithGeneratedCode(&server_endpoint);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  rpc_test::CalculatorServiceProxy p(client_messenger, server_endpoint);
+
+  Random rng(GetRandomSeed32());
+  std::vector<std::string> cars;
+  for (int size : {0, 123, 3000 * 1024}) {
+    cars.push_back(RandomHumanReadableString(size, &rng));
+  }
+
+  RpcController controller;
+  rpc_test::SidecarsRequestPB req;
+  rpc_test::SidecarsResponsePB resp;
+  for (const auto& car : cars) {
+    req.add_echo_sidecars(controller.AddRequestSidecar(RefCntBuffer(car)));
+  }
+  req.set_response_sidecar_size(1024);
+  ASSERT_OK(p.Sidecars(req, &resp, &controller));
+
+  ASSERT_EQ(cars.size() + 1, static_cast<size_t>(resp.sidecars_size()));
+  for (size_t i = 0; i != cars.size(); ++i) {
+    Slice sidecar;
+    ASSERT_OK(controller.GetSidecar(resp.sidecars(i), &sidecar));
+    ASSERT_EQ(cars[i], sidecar.ToBuffer());
+  }
+  Slice sidecar;
+  ASSERT_OK(controller.GetSidecar(resp.sidecars(cars.size()), &sidecar));
+  ASSERT_EQ(1024U, sidecar.size());
+
+  // Request for a sidecar that was not sent should fail.
+  controller.Reset();
+  req.clear_echo_sidecars();
+  req.add_echo_sidecars(0);
+  ASSERT_NOK(p.Sidecars(req, &resp, &controller));
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   Endpoint server_addr;
@@ -175,6 +175,10 @@ void RpcContext::ResetRpcSidecars() {
   call_->ResetRpcSidecars();
 }
 
+Status RpcContext::GetRequestSidecar(int idx, Slice* sidecar) const {
+  return call_->GetRequestSidecar(idx, sidecar);
+}
+
 const Endpoint& RpcContext::remote_address() const {
   return call_->remote_address();
 }
@@ -49,6 +49,7 @@ class Message;
 
 namespace yb {
 
+class Slice;
 class Trace;
 
 namespace util {
@@ -176,6 +177,10 @@ class RpcContext {
   // Removes all RpcSidecars.
   void ResetRpcSidecars();
 
+  // Fills 'sidecar' with the slice pointing to the idx-th sidecar of the request, added by the
+  // caller with RpcController::AddRequestSidecar. The slice is valid while this context is alive.
+  CHECKED_STATUS GetRequestSidecar(int idx, Slice* sidecar) const;
+
   // Return the remote endpoint which sent the current RPC call.
   const Endpoint& remote_address() const;
   // Return the local endpoint which received the current RPC call.
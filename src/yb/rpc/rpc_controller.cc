@@ -69,6 +69,7 @@ void RpcController::Swap(RpcController* other) {
   std::swap(timeout_, other->timeout_);
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
+  request_sidecars_.swap(other->request_sidecars_);
 }
 
 void RpcController::Reset() {
@@ -77,6 +78,7 @@ void RpcController::Reset() {
     CHECK(finished());
   }
   call_.reset();
+  request_sidecars_.clear();
 }
 
 bool RpcController::finished() const {
@@ -104,6 +106,12 @@ Status RpcController::GetSidecar(int idx, Slice* sidecar) const {
   return call_->GetSidecar(idx, sidecar);
 }
 
+int RpcController::AddRequestSidecar(RefCntBuffer car) {
+  DCHECK(!call_) << "Request sidecars should be added before the call is sent";
+  request_sidecars_.push_back(std::move(car));
+  return static_cast<int>(request_sidecars_.size() - 1);
+}
+
 void RpcController::set_timeout(const MonoDelta& timeout) {
   std::lock_guard<simple_spinlock> l(lock_);
   DCHECK(!call_ || call_->state() == OutboundCall::READY);
@@ -33,6 +33,7 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -40,6 +41,7 @@
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -136,6 +138,16 @@ class RpcController {
   // May fail if index is invalid.
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // Adds a sidecar to the request of the next call made with this controller, and returns its
+  // index. The sidecar is written to the socket directly from 'car', so large payloads that are
+  // already serialized don't have to be copied into the request protobuf.
+  //
+  // Assumes no changes to the sidecar's data are made after insertion.
+  // Request sidecars are cleared by Reset().
+  int AddRequestSidecar(RefCntBuffer car);
+
+  const std::vector<RefCntBuffer>& request_sidecars() const { return request_sidecars_; }
+
  private:
   friend class OutboundCall;
   friend class Proxy;
@@ -148,6 +160,8 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
 
+  std::vector<RefCntBuffer> request_sidecars_;
+
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
 
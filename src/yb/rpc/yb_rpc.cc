@@ -206,7 +206,31 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
 
   request_data_.swap(*call_data);
   Slice source(request_data_.data(), request_data_.size());
-  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &serialized_request_));
+  Slice entire_message;
+  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
+
+  // Use information from header to extract the request sidecars.
+  const size_t sidecars = header_.sidecar_offsets_size();
+  if (sidecars > 0) {
+    serialized_request_ = Slice(entire_message.data(), header_.sidecar_offsets(0));
+    request_sidecars_.reserve(sidecars);
+    for (size_t i = 0; i < sidecars; ++i) {
+      size_t begin_offset = header_.sidecar_offsets(i);
+      size_t end_offset = i + 1 == sidecars ? entire_message.size()
+                                            : header_.sidecar_offsets(i + 1);
+      if (end_offset > entire_message.size() || end_offset < begin_offset) {
+        return STATUS_FORMAT(
+            Corruption,
+            "Invalid sidecar offsets; sidecar $0 apparently starts at $1, ends at $2, but the "
+            "entire message has length $3",
+            i, begin_offset, end_offset, entire_message.size());
+      }
+      request_sidecars_.emplace_back(entire_message.data() + begin_offset,
+                                     entire_message.data() + end_offset);
+    }
+  } else {
+    serialized_request_ = entire_message;
+  }
 
   // Adopt the service/method info from the header as soon as it's available.
   if (PREDICT_FALSE(!header_.has_remote_method())) {
@@ -240,6 +264,15 @@ void YBInboundCall::ResetRpcSidecars() {
   sidecars_.clear();
 }
 
+Status YBInboundCall::GetRequestSidecar(int idx, Slice* sidecar) const {
+  if (idx < 0 || idx >= request_sidecars_.size()) {
+    return STATUS_FORMAT(InvalidArgument, "Index $0 does not reference a valid request sidecar",
+                         idx);
+  }
+  *sidecar = request_sidecars_[idx];
+  return Status::OK();
+}
+
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                               bool is_success) {
   using serialization::SerializeMessage;
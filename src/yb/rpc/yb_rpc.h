@@ -90,6 +90,9 @@ class YBInboundCall : public InboundCall {
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
 
+  // See RpcContext::GetRequestSidecar()
+  virtual CHECKED_STATUS GetRequestSidecar(int idx, Slice* sidecar) const;
+
   // Serializes 'response' into the InboundCall's internal buffer, and marks
   // the call as a success. Enqueues the response back to the connection
   // that made the call.
@@ -156,6 +159,9 @@ class YBInboundCall : public InboundCall {
   // The header of the incoming call. Set by ParseFrom()
   RequestHeader header_;
 
+  // Sidecars of the incoming call, pointing into request_data_. Set by ParseFrom()
+  std::vector<Slice> request_sidecars_;
+
   // The buffers for serialized response. Set by SerializeResponseBuffer().
   RefCntBuffer response_buf_;
 
@@ -18,6 +18,8 @@
 #include "yb/common/schema.h"
 #include "yb/common/ql_storage_interface.h"
 
+#include "yb/docdb/doc_key.h"
+
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
@@ -47,6 +49,11 @@ class AbstractTablet {
 
   virtual const std::string& tablet_id() const = 0;
 
+  // Hash codes of the keys that belong to this tablet's partition.
+  virtual docdb::DocKeyHashRange PartitionHashRange() const {
+    return docdb::DocKeyHashRange();
+  }
+
   //------------------------------------------------------------------------------------------------
   // Redis support.
   virtual CHECKED_STATUS HandleRedisReadRequest(
@@ -43,6 +43,7 @@
 #include "yb/consensus/consensus.h"
 #include "yb/util/auto_release_pool.h"
 #include "yb/util/locks.h"
+#include "yb/util/monotime.h"
 #include "yb/util/status.h"
 #include "yb/util/memory/arena.h"
 
@@ -55,7 +56,7 @@ class OperationCompletionCallback;
 class OperationState;
 
 YB_DEFINE_ENUM(OperationType,
-               (kWrite)(kAlterSchema)(kUpdateTransaction)(kSnapshot)(kTruncate)(kEmpty));
+               (kWrite)(kAlterSchema)(kUpdateTransaction)(kSnapshot)(kTruncate)(kSplit)(kEmpty));
 
 // Base class for transactions.  There are different implementations for different types (Write,
 // AlterSchema, etc.) OperationDriver implementations use Operations along with Consensus to execute
@@ -119,6 +120,12 @@ class Operation {
   // know what was the final status of the transaction.
   virtual void Finish(OperationResult result) {}
 
+  // Invoked by the driver with the time the operation waited in the prepare queue, and, for
+  // leader-side operations, with the time it took to replicate it. Used by operations that keep
+  // per-stage latency metrics. Default implementation does nothing.
+  virtual void RecordPrepareQueueWait(MonoDelta wait_time) {}
+  virtual void RecordReplicationTime(MonoDelta replication_time) {}
+
   // Each implementation should have its own ToString() method.
   virtual std::string ToString() const = 0;
 
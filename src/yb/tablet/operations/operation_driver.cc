@@ -38,6 +38,7 @@
 #include "yb/consensus/consensus.h"
 #include "yb/gutil/strings/strcat.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/preparer.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
 #include "yb/util/debug-util.h"
@@ -85,8 +86,8 @@ OperationDriver::OperationDriver(OperationTracker *operation_tracker,
   }
 }
 
-Status OperationDriver::Init(std::unique_ptr<Operation> operation, DriverType type) {
-  operation_ = std::move(operation);
+Status OperationDriver::Init(std::unique_ptr<Operation>* operation, DriverType type) {
+  operation_ = std::move(*operation);
 
   if (type == consensus::REPLICA) {
     std::lock_guard<simple_spinlock> lock(opid_lock_);
@@ -108,9 +109,13 @@ Status OperationDriver::Init(std::unique_ptr<Operation> operation, DriverType ty
     }
   }
 
-  RETURN_NOT_OK(operation_tracker_->Add(this));
+  auto status = operation_tracker_->Add(this);
+  if (!status.ok()) {
+    // Give the operation back, so the caller could complete it with the failure.
+    *operation = std::move(operation_);
+  }
 
-  return Status::OK();
+  return status;
 }
 
 consensus::OpId OperationDriver::GetOpId() {
@@ -208,6 +213,7 @@ Status OperationDriver::PrepareAndStart() {
   // Actually prepare and start the operation.
   prepare_physical_hybrid_time_ = GetMonoTimeMicros();
   if (operation_) {
+    operation_->RecordPrepareQueueWait(MonoTime::Now() - start_time_);
     RETURN_NOT_OK(operation_->Prepare());
   }
 
@@ -323,6 +329,16 @@ void OperationDriver::HandleFailure(const Status& s) {
 }
 
 void OperationDriver::ReplicationFinished(const Status& status) {
+  if (status.ok() && replication_start_time_.Initialized()) {
+    const auto replication_time = MonoTime::Now() - replication_start_time_;
+    if (preparer_) {
+      preparer_->ReplicationFinished(replication_time);
+    }
+    if (operation_) {
+      operation_->RecordReplicationTime(replication_time);
+    }
+  }
+
   consensus::OpId op_id_local;
   {
     std::lock_guard<simple_spinlock> op_id_lock(opid_lock_);
@@ -124,8 +124,8 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
                   TableType table_type_);
 
   // Perform any non-constructor initialization. Sets the operation
-  // that will be executed.
-  CHECKED_STATUS Init(std::unique_ptr<Operation> operation, consensus::DriverType driver);
+  // that will be executed. On failure the operation is left in the operation argument.
+  CHECKED_STATUS Init(std::unique_ptr<Operation>* operation, consensus::DriverType driver);
 
   // Returns the OpId of the operation being executed or an uninitialized
   // OpId if none has been assigned. Returns a copy and thus should not
@@ -165,6 +165,12 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
   const MonoTime& start_time() const { return start_time_; }
 
+  // Set by the preparer right before a leader-side operation is submitted for replication, so that
+  // the replication time could be reported back to it.
+  void set_replication_start_time(MonoTime replication_start_time) {
+    replication_start_time_ = replication_start_time;
+  }
+
   Trace* trace() { return trace_.get(); }
 
   void HandleConsensusAppend() override;
@@ -290,6 +296,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
 
   const MonoTime start_time_;
 
+  // The time a leader-side operation was submitted for replication, see set_replication_start_time.
+  MonoTime replication_start_time_;
+
   ReplicationState replication_state_;
   PrepareState prepare_state_;
 
@@ -115,7 +115,8 @@ class OperationTrackerTest : public YBTest {
           nullptr,
           TableType::DEFAULT_TABLE_TYPE));
       auto tx = std::make_unique<NoOpOperation>(std::make_unique<NoOpOperationState>());
-      RETURN_NOT_OK(driver->Init(std::move(tx), consensus::LEADER));
+      std::unique_ptr<Operation> operation = std::move(tx);
+      RETURN_NOT_OK(driver->Init(&operation, consensus::LEADER));
       local_drivers.push_back(driver);
     }
 
@@ -80,6 +80,10 @@ METRIC_DEFINE_gauge_uint64(tablet, truncate_operations_inflight,
                            "Truncate Operations In Flight",
                            yb::MetricUnit::kOperations,
                            "Number of truncate operations currently in-flight");
+METRIC_DEFINE_gauge_uint64(tablet, split_operations_inflight,
+                           "Split Operations In Flight",
+                           yb::MetricUnit::kOperations,
+                           "Number of split operations currently in-flight");
 METRIC_DEFINE_gauge_uint64(tablet, empty_operations_inflight,
                            "Empty Operations In Flight",
                            yb::MetricUnit::kOperations,
@@ -112,8 +116,9 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
   INSTANTIATE(UpdateTransaction, update_transaction);
   INSTANTIATE(Snapshot, snapshot);
   INSTANTIATE(Truncate, truncate);
+  INSTANTIATE(Split, split);
   INSTANTIATE(Empty, empty);
-  static_assert(6 == kElementsInOperationType, "Init metrics for all operation types");
+  static_assert(7 == kElementsInOperationType, "Init metrics for all operation types");
 }
 #undef INSTANTIATE
 #undef GINIT
@@ -127,7 +132,7 @@ OperationTracker::OperationTracker() {
 }
 
 OperationTracker::~OperationTracker() {
-  std::lock_guard<simple_spinlock> l(lock_);
+  std::lock_guard<std::mutex> l(mutex_);
   CHECK_EQ(pending_operations_.size(), 0);
   if (mem_tracker_) {
     mem_tracker_->UnregisterFromParent();
@@ -161,7 +166,7 @@ Status OperationTracker::Add(OperationDriver* driver) {
   // again, as it may disappear between now and then.
   State st;
   st.memory_footprint = driver_mem_footprint;
-  std::lock_guard<simple_spinlock> l(lock_);
+  std::lock_guard<std::mutex> l(mutex_);
   CHECK(pending_operations_.emplace(driver, st).second);
   return Status::OK();
 }
@@ -194,12 +199,15 @@ void OperationTracker::Release(OperationDriver* driver) {
   {
     // Remove the operation from the map, retaining the state for use
     // below.
-    std::lock_guard<simple_spinlock> l(lock_);
+    std::lock_guard<std::mutex> l(mutex_);
     st = FindOrDie(pending_operations_, driver);
     if (PREDICT_FALSE(pending_operations_.erase(driver) != 1)) {
       LOG(FATAL) << "Could not remove pending operation from map: "
           << driver->ToStringUnlocked();
     }
+    if (pending_operations_.empty()) {
+      no_pending_operations_cond_.notify_all();
+    }
   }
 
   if (mem_tracker_) {
@@ -210,7 +218,7 @@ void OperationTracker::Release(OperationDriver* driver) {
 std::vector<scoped_refptr<OperationDriver>> OperationTracker::GetPendingOperations() const {
   std::vector<scoped_refptr<OperationDriver>> result;
   {
-    std::lock_guard<simple_spinlock> l(lock_);
+    std::lock_guard<std::mutex> l(mutex_);
     result.reserve(pending_operations_.size());
     for (const auto& e : pending_operations_) {
       result.push_back(e.first);
@@ -220,7 +228,7 @@ std::vector<scoped_refptr<OperationDriver>> OperationTracker::GetPendingOperatio
 }
 
 int OperationTracker::GetNumPendingForTests() const {
-  std::lock_guard<simple_spinlock> l(lock_);
+  std::lock_guard<std::mutex> l(mutex_);
   return pending_operations_.size();
 }
 
@@ -231,35 +239,42 @@ void OperationTracker::WaitForAllToFinish() const {
 
 Status OperationTracker::WaitForAllToFinish(const MonoDelta& timeout) const {
   const int complain_ms = 1000;
-  int wait_time = 250;
   int num_complaints = 0;
   MonoTime start_time = MonoTime::Now();
-  while (1) {
-    auto operations = GetPendingOperations();
-
-    if (operations.empty()) {
-      break;
-    }
-
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!pending_operations_.empty()) {
     MonoDelta diff = MonoTime::Now().GetDeltaSince(start_time);
     if (diff.MoreThan(timeout)) {
       return STATUS(TimedOut, Substitute("Timed out waiting for all operations to finish. "
                                          "$0 operations pending. Waited for $1",
-                                         operations.size(), diff.ToString()));
+                                         pending_operations_.size(), diff.ToString()));
     }
     int64_t waited_ms = diff.ToMilliseconds();
     if (waited_ms / complain_ms > num_complaints) {
+      num_complaints++;
+      std::vector<scoped_refptr<OperationDriver>> operations;
+      operations.reserve(pending_operations_.size());
+      for (const auto& e : pending_operations_) {
+        operations.push_back(e.first);
+      }
+      // Operations are released with their driver locked, so do not hold our lock while
+      // printing them.
+      lock.unlock();
       LOG(WARNING) << Substitute("OperationTracker waiting for $0 outstanding operations to"
                                  " complete now for $1 ms", operations.size(), waited_ms);
-      num_complaints++;
-    }
-    wait_time = std::min(wait_time * 5 / 4, 1000000);
-
-    LOG(INFO) << "Dumping currently running operations: ";
-    for (scoped_refptr<OperationDriver> driver : operations) {
-      LOG(INFO) << driver->ToString();
+      LOG(INFO) << "Dumping currently running operations: ";
+      for (const auto& driver : operations) {
+        LOG(INFO) << driver->ToString();
+      }
+      operations.clear();
+      lock.lock();
+      continue;
     }
-    SleepFor(MonoDelta::FromMicroseconds(wait_time));
+    // Wake up at least once per complaint interval, and when the timeout expires.
+    const int64_t wait_ms = std::min<int64_t>(
+        (num_complaints + 1) * complain_ms - waited_ms,
+        std::max<int64_t>(timeout.ToMilliseconds() - waited_ms, 1));
+    no_pending_operations_cond_.wait_for(lock, std::chrono::milliseconds(wait_ms));
   }
   return Status::OK();
 }
@@ -33,7 +33,9 @@
 #ifndef YB_TABLET_OPERATIONS_OPERATION_TRACKER_H
 #define YB_TABLET_OPERATIONS_OPERATION_TRACKER_H
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -78,6 +80,8 @@ class OperationTracker {
   // Returns number of pending operations.
   int GetNumPendingForTests() const;
 
+  // Waits until there are no pending operations. New operations could be added meanwhile, so the
+  // caller should stop submitting them beforehand.
   void WaitForAllToFinish() const;
   CHECKED_STATUS WaitForAllToFinish(const MonoDelta& timeout) const;
 
@@ -100,7 +104,10 @@ class OperationTracker {
   // Decrements relevant metric counters.
   void DecrementCounters(const OperationDriver& driver) const;
 
-  mutable simple_spinlock lock_;
+  mutable std::mutex mutex_;
+
+  // Notified when the last pending operation is released.
+  mutable std::condition_variable no_pending_operations_cond_;
 
   // Per-operation state that is tracked along with the operation itself.
   struct State {
@@ -110,7 +117,7 @@ class OperationTracker {
     int64_t memory_footprint;
   };
 
-  // Protected by 'lock_'.
+  // Protected by 'mutex_'.
   typedef std::unordered_map<
       scoped_refptr<OperationDriver>,
       State,
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/split_operation.h"
+
+#include <glog/logging.h>
+
+#include "yb/server/hybrid_clock.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tserver/tserver_admin.pb.h"
+#include "yb/util/trace.h"
+
+namespace yb {
+namespace tablet {
+
+using consensus::ReplicateMsg;
+using consensus::SPLIT_OP;
+using consensus::DriverType;
+using strings::Substitute;
+
+string SplitOperationState::ToString() const {
+  return Format("SplitOperationState [hybrid_time=$0, request=$1]",
+                hybrid_time_even_if_unset(),
+                request_ == nullptr ? "(none)" : request_->ShortDebugString());
+}
+
+SplitOperation::SplitOperation(std::unique_ptr<SplitOperationState> state, DriverType type)
+    : Operation(std::move(state), type, OperationType::kSplit) {
+}
+
+consensus::ReplicateMsgPtr SplitOperation::NewReplicateMsg() {
+  auto result = std::make_shared<ReplicateMsg>();
+  result->set_op_type(SPLIT_OP);
+  result->mutable_split_request()->CopyFrom(*state()->request());
+  return result;
+}
+
+void SplitOperation::DoStart() {
+  state()->TrySetHybridTimeFromClock();
+
+  TRACE("START SPLIT: hybrid time: $0",
+        server::HybridClock::GetPhysicalValueMicros(state()->hybrid_time()));
+}
+
+Status SplitOperation::Apply() {
+  TRACE("APPLY SPLIT: started");
+
+  // The split is committed at this point, so a failure to create the new tablets on this server
+  // does not fail the operation. The new tablets that are missing here are remote bootstrapped from
+  // their leaders once a majority of the peers created them.
+  auto* tablet_splitter = state()->tablet_splitter();
+  Status s = tablet_splitter ? tablet_splitter->ApplyTabletSplit(state())
+                             : STATUS(NotSupported, "Tablet peer cannot create new tablets");
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to create the new tablets of split tablet "
+                 << state()->tablet()->tablet_id() << ": " << s;
+    state()->completion_callback()->set_error(s);
+  }
+
+  TRACE("APPLY SPLIT: finished");
+  return Status::OK();
+}
+
+void SplitOperation::Finish(OperationResult result) {
+  if (result == Operation::ABORTED) {
+    LOG(INFO) << "Split of tablet " << state()->tablet()->tablet_id() << " aborted";
+    state()->tablet()->SetSplit(false);
+  }
+}
+
+string SplitOperation::ToString() const {
+  return Substitute("SplitOperation [state=$0]", state()->ToString());
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+#define YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
+
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+class SplitOperationState;
+
+// Creates the tablets that replace a split tablet on the local server. Implemented by the tablet
+// manager of the tablet server.
+class TabletSplitter {
+ public:
+  // Creates the new tablets described by the split request from the data of the split tablet.
+  // Called by each peer when the split is applied, and again when it is replayed during bootstrap,
+  // so new tablets that already exist are skipped.
+  virtual CHECKED_STATUS ApplyTabletSplit(SplitOperationState* state) = 0;
+
+  virtual ~TabletSplitter() {}
+};
+
+// Operation Context for the Split operation.
+// Keeps track of the Operation states (request, result, ...)
+class SplitOperationState : public OperationState {
+ public:
+  SplitOperationState(Tablet* tablet, TabletSplitter* tablet_splitter,
+                      const tserver::SplitTabletRequestPB* request = nullptr)
+      : OperationState(tablet), tablet_splitter_(tablet_splitter), request_(request) {}
+  ~SplitOperationState() {}
+
+  const tserver::SplitTabletRequestPB* request() const override { return request_; }
+
+  void UpdateRequestFromConsensusRound() override {
+    request_ = consensus_round()->replicate_msg()->mutable_split_request();
+  }
+
+  TabletSplitter* tablet_splitter() const { return tablet_splitter_; }
+
+  virtual std::string ToString() const override;
+
+ private:
+  TabletSplitter* const tablet_splitter_;
+
+  // The original RPC request.
+  const tserver::SplitTabletRequestPB* request_;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitOperationState);
+};
+
+// Executes the split of a tablet. The operation is the last one applied to the split tablet: the
+// leader stops accepting operations before submitting it, and followers stop as soon as it is
+// appended to their log, so every peer creates the new tablets from the same data.
+class SplitOperation : public Operation {
+ public:
+  SplitOperation(std::unique_ptr<SplitOperationState> operation_state,
+                 consensus::DriverType type);
+
+  SplitOperationState* state() override {
+    return down_cast<SplitOperationState*>(Operation::state());
+  }
+
+  const SplitOperationState* state() const override {
+    return down_cast<const SplitOperationState*>(Operation::state());
+  }
+
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+
+  CHECKED_STATUS Prepare() override { return Status::OK(); }
+
+  // Creates the new tablets on this server.
+  CHECKED_STATUS Apply() override;
+
+  // Lets the tablet accept operations again if the split was aborted.
+  void Finish(OperationResult result) override;
+
+  std::string ToString() const override;
+
+ private:
+  // Starts the SplitOperation by assigning it a timestamp.
+  void DoStart() override;
+
+  DISALLOW_COPY_AND_ASSIGN(SplitOperation);
+};
+
+}  // namespace tablet
+}  // namespace yb
+
+#endif  // YB_TABLET_OPERATIONS_SPLIT_OPERATION_H
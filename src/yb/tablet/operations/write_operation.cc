@@ -107,7 +107,9 @@ Status WriteOperation::Apply() {
 
   Tablet* tablet = state()->tablet();
 
+  const MonoTime apply_start = MonoTime::Now();
   tablet->ApplyRowOperations(state());
+  state()->stage_latencies()->apply = MonoTime::Now() - apply_start;
 
   return Status::OK();
 }
@@ -134,10 +136,24 @@ void WriteOperation::Finish(OperationResult result) {
   state()->Commit();
 
   TabletMetrics* metrics = tablet()->metrics();
-  if (metrics && type() == consensus::LEADER) {
+  if (!metrics) {
+    return;
+  }
+  if (type() == consensus::LEADER) {
     auto op_duration_usec = MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds();
     metrics->write_op_duration_client_propagated_consistency->Increment(op_duration_usec);
   }
+  // Stages that did not run for this operation, e.g. replication on a follower, are not set.
+  const auto& latencies = *state()->stage_latencies();
+  for (const auto& stage : {
+      std::make_pair(&latencies.conflict_resolution, &metrics->write_conflict_resolution_latency),
+      std::make_pair(&latencies.prepare_queue, &metrics->write_prepare_queue_latency),
+      std::make_pair(&latencies.replication, &metrics->write_replication_latency),
+      std::make_pair(&latencies.apply, &metrics->write_apply_latency)}) {
+    if (stage.first->Initialized()) {
+      (*stage.second)->Increment(stage.first->ToMicroseconds());
+    }
+  }
 }
 
 string WriteOperation::ToString() const {
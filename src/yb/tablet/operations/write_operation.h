@@ -147,6 +147,21 @@ class WriteOperationState : public OperationState {
   // Releases all the DocDB locks acquired by this transaction.
   void ReleaseDocDbLocks(Tablet* tablet);
 
+  // Time spent by this operation in the stages of the write path. Each stage is measured where it
+  // runs, and all of them are reported to the tablet metrics when the operation is committed.
+  // Key lock acquisition is reported by DocDB directly as write_lock_latency, and log append and
+  // sync are shared by all the operations of a log batch, so they are reported by the log.
+  struct StageLatencies {
+    MonoDelta conflict_resolution;
+    MonoDelta prepare_queue;
+    MonoDelta replication;
+    MonoDelta apply;
+  };
+
+  StageLatencies* stage_latencies() {
+    return &stage_latencies_;
+  }
+
   // Resets this OperationState, releasing all locks, destroying all prepared
   // writes, clearing the transaction result _and_ committing the current Mvcc
   // transaction.
@@ -179,6 +194,8 @@ class WriteOperationState : public OperationState {
   // or if an error happens.
   LockBatch docdb_locks_;
 
+  StageLatencies stage_latencies_;
+
   DISALLOW_COPY_AND_ASSIGN(WriteOperationState);
 };
 
@@ -230,6 +247,14 @@ class WriteOperation : public Operation {
   // the metrics, if result == ABORTED aborts the mvcc transaction.
   void Finish(OperationResult result) override;
 
+  void RecordPrepareQueueWait(MonoDelta wait_time) override {
+    state()->stage_latencies()->prepare_queue = wait_time;
+  }
+
+  void RecordReplicationTime(MonoDelta replication_time) override {
+    state()->stage_latencies()->replication = replication_time;
+  }
+
   std::string ToString() const override;
 
  private:
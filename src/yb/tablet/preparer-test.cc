@@ -0,0 +1,123 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/preparer.h"
+
+#include "yb/util/format.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace yb::size_literals;
+
+DECLARE_bool(enable_adaptive_group_replicate_batching);
+DECLARE_int32(max_adaptive_group_replicate_batch_size);
+DECLARE_int32(max_group_replicate_batch_bytes);
+
+namespace yb {
+namespace tablet {
+
+class PreparerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_max_group_replicate_batch_size = 16;
+    FLAGS_max_adaptive_group_replicate_batch_size = 512;
+    FLAGS_max_group_replicate_batch_bytes = 4_MB;
+  }
+};
+
+// Batch limit should grow with the replication latency, within the configured bounds.
+TEST_F(PreparerTest, BatchLimitFollowsReplicationLatency) {
+  constexpr int64_t kPrepareTimeUs = 10;
+
+  // No estimates yet.
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(0, 0, 1));
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(kPrepareTimeUs, 0, 1));
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(0, 1000, 1));
+
+  const std::vector<std::pair<int64_t, size_t>> replication_time_us_and_limit = {
+    { 50, 16 },
+    { 160, 16 },
+    { 1000, 100 },
+    { 2000, 200 },
+    { 5120, 512 },
+    { 100000, 512 },
+  };
+  for (const auto& entry : replication_time_us_and_limit) {
+    SCOPED_TRACE(Format("Replication time: $0us", entry.first));
+    ASSERT_EQ(entry.second, GroupReplicateBatchLimit(kPrepareTimeUs, entry.first, 1));
+  }
+
+  FLAGS_max_adaptive_group_replicate_batch_size = 64;
+  ASSERT_EQ(64U, GroupReplicateBatchLimit(kPrepareTimeUs, 100000, 1));
+
+  // Upper bound below the lower one is ignored.
+  FLAGS_max_adaptive_group_replicate_batch_size = 8;
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(kPrepareTimeUs, 100000, 1));
+
+  FLAGS_max_adaptive_group_replicate_batch_size = 512;
+  FLAGS_enable_adaptive_group_replicate_batching = false;
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(kPrepareTimeUs, 100000, 1));
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(kPrepareTimeUs, 100000, 1000));
+}
+
+// Pending operations should be split into batches of about the same size, that still respect the
+// configured bounds.
+TEST_F(PreparerTest, BatchLimitSplitsPendingOperations) {
+  // Replication is 100 times slower than prepare, so the limit is 100 operations.
+  constexpr int64_t kPrepareTimeUs = 10;
+  constexpr int64_t kReplicationTimeUs = 1000;
+
+  ASSERT_EQ(100U, GroupReplicateBatchLimit(kPrepareTimeUs, kReplicationTimeUs, 50));
+  ASSERT_EQ(100U, GroupReplicateBatchLimit(kPrepareTimeUs, kReplicationTimeUs, 100));
+  ASSERT_EQ(76U, GroupReplicateBatchLimit(kPrepareTimeUs, kReplicationTimeUs, 151));
+  ASSERT_EQ(67U, GroupReplicateBatchLimit(kPrepareTimeUs, kReplicationTimeUs, 201));
+
+  // Don't split into batches smaller than the lower bound.
+  ASSERT_EQ(16U, GroupReplicateBatchLimit(0, 0, 17));
+
+  for (int64_t replication_time_us = 1; replication_time_us <= 10000;
+       replication_time_us *= 3) {
+    for (size_t pending = 1; pending <= 2000; pending += 37) {
+      SCOPED_TRACE(Format("Replication time: $0us, pending: $1", replication_time_us, pending));
+      const auto limit = GroupReplicateBatchLimit(kPrepareTimeUs, replication_time_us, pending);
+      ASSERT_GE(limit, 16U);
+      ASSERT_LE(limit, 512U);
+      ASSERT_LE(limit, std::max<size_t>(replication_time_us / kPrepareTimeUs, 16));
+    }
+  }
+}
+
+TEST_F(PreparerTest, BatchHasRoom) {
+  constexpr size_t kLimit = 16;
+
+  ASSERT_TRUE(GroupReplicateBatchHasRoom(0, 0, kLimit, 1));
+  ASSERT_TRUE(GroupReplicateBatchHasRoom(kLimit - 1, kLimit - 1, kLimit, 1));
+  ASSERT_FALSE(GroupReplicateBatchHasRoom(kLimit, kLimit, kLimit, 1));
+
+  // Total size of the batch is limited by max_group_replicate_batch_bytes.
+  ASSERT_TRUE(GroupReplicateBatchHasRoom(1, 3_MB, kLimit, 1_MB));
+  ASSERT_FALSE(GroupReplicateBatchHasRoom(1, 3_MB, kLimit, 1_MB + 1));
+
+  // Operation larger than the limit gets a batch of its own.
+  ASSERT_TRUE(GroupReplicateBatchHasRoom(0, 0, kLimit, 5_MB));
+  ASSERT_FALSE(GroupReplicateBatchHasRoom(1, 5_MB, kLimit, 1));
+}
+
+} // namespace tablet
+} // namespace yb
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
@@ -24,11 +25,37 @@
 
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 
+using namespace yb::size_literals;
+
 DEFINE_int32(max_group_replicate_batch_size, 16,
-             "Maximum number of operations to submit to consensus for replication in a batch.");
+             "Maximum number of operations to submit to consensus for replication in a batch. "
+             "With adaptive batching enabled this is the lower bound of the batch size limit.");
+
+DEFINE_bool(enable_adaptive_group_replicate_batching, true,
+            "Size the batches of operations submitted to consensus for replication from the "
+            "prepare queue depth and the recent consensus round-trip time, instead of using "
+            "max_group_replicate_batch_size as is.");
+TAG_FLAG(enable_adaptive_group_replicate_batching, runtime);
+TAG_FLAG(enable_adaptive_group_replicate_batching, advanced);
+
+DEFINE_int32(max_adaptive_group_replicate_batch_size, 512,
+             "Upper bound of the adaptive limit on the number of operations to submit to "
+             "consensus for replication in a batch.");
+TAG_FLAG(max_adaptive_group_replicate_batch_size, runtime);
+TAG_FLAG(max_adaptive_group_replicate_batch_size, advanced);
+
+DEFINE_int32(max_group_replicate_batch_bytes, 4_MB,
+             "Maximum total size of the replicate messages submitted to consensus for replication "
+             "in a batch. A single operation larger than this is replicated in a batch of its "
+             "own.");
+TAG_FLAG(max_group_replicate_batch_bytes, runtime);
+TAG_FLAG(max_group_replicate_batch_bytes, advanced);
 
 // We have to make the queue length really long. Otherwise we risk crashes on followers when they
 // fail to append entries to the queue, as we try to cancel the operation in that case, and it
@@ -41,6 +68,19 @@ DEFINE_int32(max_group_replicate_batch_size, 16,
 DEFINE_int32(prepare_queue_max_size, 100000,
              "Maximum number of operations waiting in the per-tablet prepare queue.");
 
+METRIC_DEFINE_histogram(tablet, group_replicate_batch_size,
+  "Group Replicate Batch Size",
+  yb::MetricUnit::kOperations,
+  "Number of leader-side operations submitted to consensus for replication in one batch.",
+  10000, 2);
+
+METRIC_DEFINE_histogram(tablet, group_replicate_batching_delay,
+  "Group Replicate Batching Delay",
+  yb::MetricUnit::kMicroseconds,
+  "Time since the oldest operation of a batch was started till the batch was prepared for "
+  "replication.",
+  60000000LU, 2);
+
 using std::vector;
 
 namespace yb {
@@ -54,13 +94,16 @@ namespace tablet {
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
 
   CHECKED_STATUS Submit(OperationDriver* operation_driver);
 
+  void ReplicationFinished(MonoDelta replication_time);
+
  private:
   using OperationDrivers = std::vector<OperationDriver*>;
 
@@ -82,6 +125,9 @@ class PreparerImpl {
 
   boost::lockfree::queue<OperationDriver*> queue_;
 
+  // Number of operations in queue_, the lock-free queue does not track it.
+  std::atomic<int64_t> queue_size_{0};
+
   // This mutex/condition combination is used in Stop() in case multiple threads are calling that
   // function concurrently. One of them will ask the prepare thread to stop and wait for it, and
   // then will notify other threads that have called Stop().
@@ -90,6 +136,19 @@ class PreparerImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // Total replicate message size of leader_side_batch_ and the number of operations it is allowed
+  // to grow to, computed when the first operation is added to it.
+  size_t leader_side_batch_bytes_ = 0;
+  size_t leader_side_batch_limit_ = 0;
+
+  // Moving averages of the time to prepare a leader-side operation, maintained by the prepare task,
+  // and of the time to replicate one, reported from the replication callbacks.
+  int64_t prepare_time_us_ = 0;
+  std::atomic<int64_t> replication_time_us_{0};
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> batching_delay_histogram_;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -100,19 +159,24 @@ class PreparerImpl {
 
   void ProcessAndClearLeaderSideBatch();
 
-  // A wrapper around ProcessAndClearLeaderSideBatch that assumes we are currently holding the
-  // mutex.
+  // Returns the number of operations a new leader-side batch is allowed to grow to.
+  size_t LeaderSideBatchLimit() const;
 
   void ReplicateSubBatch(OperationDrivers::iterator begin,
                          OperationDrivers::iterator end);
 };
 
 PreparerImpl::PreparerImpl(consensus::Consensus* consensus,
-                                     ThreadPool* tablet_prepare_pool)
+                           ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
       queue_(FLAGS_prepare_queue_max_size),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_group_replicate_batch_size.Instantiate(metric_entity);
+    batching_delay_histogram_ = METRIC_group_replicate_batching_delay.Instantiate(metric_entity);
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -141,7 +205,9 @@ Status PreparerImpl::Submit(OperationDriver* operation_driver) {
   if (stop_requested_.load(std::memory_order_acquire)) {
     return STATUS(IllegalState, "Tablet is shutting down");
   }
+  queue_size_.fetch_add(1, std::memory_order_acq_rel);
   if (!queue_.bounded_push(operation_driver)) {
+    queue_size_.fetch_sub(1, std::memory_order_acq_rel);
     return STATUS_FORMAT(ServiceUnavailable,
                          "Prepare queue is full (max capacity $0)",
                          FLAGS_prepare_queue_max_size);
@@ -163,6 +229,7 @@ void PreparerImpl::Run() {
   for (;;) {
     OperationDriver *item = nullptr;
     while (queue_.pop(item)) {
+      queue_size_.fetch_sub(1, std::memory_order_acq_rel);
       ProcessItem(item);
     }
     if (queue_.empty()) {
@@ -198,16 +265,24 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     const bool apply_separately = operation_type == OperationType::kAlterSchema ||
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
+    const size_t item_bytes =
+        apply_separately ? 0 : item->consensus_round()->replicate_msg()->ByteSize();
 
-    // Don't add more than the max number of operations to a batch, and also don't add
+    // Don't add more than the max number of operations or bytes to a batch, and also don't add
     // operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
+    if (!GroupReplicateBatchHasRoom(
+            leader_side_batch_.size(), leader_side_batch_bytes_, leader_side_batch_limit_,
+            item_bytes) ||
         (!leader_side_batch_.empty() &&
-            bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
+         bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
       ProcessAndClearLeaderSideBatch();
     }
+    if (leader_side_batch_.empty()) {
+      leader_side_batch_limit_ = LeaderSideBatchLimit();
+    }
     leader_side_batch_.push_back(item);
+    leader_side_batch_bytes_ += item_bytes;
     if (apply_separately) {
       ProcessAndClearLeaderSideBatch();
     }
@@ -219,6 +294,22 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   }
 }
 
+size_t PreparerImpl::LeaderSideBatchLimit() const {
+  // The operation being added is not in the queue.
+  return GroupReplicateBatchLimit(
+      prepare_time_us_, replication_time_us_.load(std::memory_order_acquire),
+      std::max<int64_t>(queue_size_.load(std::memory_order_acquire), 0) + 1);
+}
+
+void PreparerImpl::ReplicationFinished(MonoDelta replication_time) {
+  // Exponential moving average with a weight of 1/8 for the new sample. Concurrent updates may
+  // lose a sample, which is fine for an estimate.
+  const int64_t sample = std::max<int64_t>(replication_time.ToMicroseconds(), 1);
+  const int64_t old_value = replication_time_us_.load(std::memory_order_acquire);
+  replication_time_us_.store(
+      old_value == 0 ? sample : old_value + (sample - old_value) / 8, std::memory_order_release);
+}
+
 void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   if (leader_side_batch_.empty()) {
     return;
@@ -226,6 +317,12 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
 
   VLOG(1) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
 
+  const MonoTime prepare_start = MonoTime::Now();
+  if (batching_delay_histogram_) {
+    batching_delay_histogram_->Increment(
+        (prepare_start - leader_side_batch_.front()->start_time()).ToMicroseconds());
+  }
+
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
   auto replication_subbatch_end = iter;
@@ -255,7 +352,15 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   // Replicate the remaining batch. No-op for an empty batch.
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
+  // Only this task updates the average prepare time, so there is no need for atomics here. The time
+  // to submit the batch to consensus is included, as it delays the next batch just the same.
+  const int64_t sample = std::max<int64_t>(
+      (MonoTime::Now() - prepare_start).ToMicroseconds() / leader_side_batch_.size(), 1);
+  prepare_time_us_ =
+      prepare_time_us_ == 0 ? sample : prepare_time_us_ + (sample - prepare_time_us_) / 8;
+
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
 }
 
 void PreparerImpl::ReplicateSubBatch(
@@ -273,11 +378,17 @@ void PreparerImpl::ReplicateSubBatch(
     }
   }
 
+  if (batch_size_histogram_) {
+    batch_size_histogram_->Increment(std::distance(batch_begin, batch_end));
+  }
+
   rounds_to_replicate_.clear();
   rounds_to_replicate_.reserve(std::distance(batch_begin, batch_end));
+  const MonoTime replication_start = MonoTime::Now();
   for (auto batch_iter = batch_begin; batch_iter != batch_end; ++batch_iter) {
     DCHECK_ONLY_NOTNULL(*batch_iter);
     DCHECK_ONLY_NOTNULL((*batch_iter)->consensus_round());
+    (*batch_iter)->set_replication_start_time(replication_start);
     rounds_to_replicate_.push_back((*batch_iter)->consensus_round());
   }
 
@@ -296,11 +407,48 @@ void PreparerImpl::ReplicateSubBatch(
   }
 }
 
+size_t GroupReplicateBatchLimit(
+    int64_t prepare_time_us, int64_t replication_time_us, size_t num_pending_operations) {
+  const size_t min_limit = std::max(FLAGS_max_group_replicate_batch_size, 1);
+  if (!FLAGS_enable_adaptive_group_replicate_batching) {
+    return min_limit;
+  }
+  const size_t max_limit = std::max<size_t>(
+      FLAGS_max_adaptive_group_replicate_batch_size, min_limit);
+
+  // Preparing more operations than it takes to replicate a batch delays the first operations of
+  // the batch for longer than a consensus round trip, while preparing fewer leaves consensus with
+  // more, smaller batches to replicate.
+  size_t limit = min_limit;
+  if (prepare_time_us > 0 && replication_time_us > 0) {
+    limit = std::min(std::max<size_t>(replication_time_us / prepare_time_us, min_limit),
+                     max_limit);
+  }
+
+  // Split the pending operations into batches of about the same size, rather than into full
+  // batches followed by a small one. But don't go below the configured minimum.
+  if (num_pending_operations > limit) {
+    const size_t num_batches = (num_pending_operations + limit - 1) / limit;
+    limit = std::max((num_pending_operations + num_batches - 1) / num_batches, min_limit);
+  }
+  return limit;
+}
+
+bool GroupReplicateBatchHasRoom(
+    size_t batch_size, size_t batch_bytes, size_t batch_limit, size_t operation_bytes) {
+  // A single operation larger than the byte limit is replicated in a batch of its own.
+  return batch_size == 0 ||
+         (batch_size < batch_limit &&
+          batch_bytes + operation_bytes <=
+              static_cast<size_t>(FLAGS_max_group_replicate_batch_bytes));
+}
+
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -320,5 +468,9 @@ Status Preparer::Submit(OperationDriver* operation_driver) {
   return impl_->Submit(operation_driver);
 }
 
+void Preparer::ReplicationFinished(MonoDelta replication_time) {
+  impl_->ReplicationFinished(replication_time);
+}
+
 }  // namespace tablet
 }  // namespace yb
@@ -16,6 +16,8 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/monotime.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 
@@ -23,6 +25,7 @@ DECLARE_int32(max_group_replicate_batch_size);
 DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
+class MetricEntity;
 class ThreadPool;
 
 namespace consensus {
@@ -39,9 +42,14 @@ class PreparerImpl;
 // leader-side transactions, submits them for replication to the consensus in batches. This is
 // useful because we have a "fat lock" in the consensus.
 // Preparer does not manage a thread but only submits to a token in a thread pool.
+//
+// The number of operations in a batch is adapted to the load: it grows with the ratio of the
+// consensus round-trip time to the time needed to prepare an operation, and the operations waiting
+// in the queue are split into batches of about equal size.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity = nullptr);
   ~Preparer();
 
   CHECKED_STATUS Start();
@@ -49,10 +57,26 @@ class Preparer {
 
   CHECKED_STATUS Submit(OperationDriver* txn_driver);
 
+  // Reports the time it took to replicate a leader-side operation submitted by this preparer.
+  void ReplicationFinished(MonoDelta replication_time);
+
  private:
   std::unique_ptr<PreparerImpl> impl_;
 };
 
+// Returns the number of leader-side operations a new group replicate batch is allowed to grow to,
+// given the average times to prepare and to replicate an operation, and the number of operations
+// waiting to be prepared, including the one that starts the batch.
+// The result is within [max_group_replicate_batch_size, max_adaptive_group_replicate_batch_size].
+size_t GroupReplicateBatchLimit(
+    int64_t prepare_time_us, int64_t replication_time_us, size_t num_pending_operations);
+
+// Returns true if an operation of operation_bytes could be added to a batch of batch_size
+// operations with batch_bytes total replicate message size, that is limited to batch_limit
+// operations.
+bool GroupReplicateBatchHasRoom(
+    size_t batch_size, size_t batch_bytes, size_t batch_limit, size_t operation_bytes);
+
 };  // namespace tablet
 }  // namespace yb
 #endif  // YB_TABLET_PREPARER_H
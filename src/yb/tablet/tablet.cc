@@ -33,6 +33,7 @@
 #include "yb/tablet/tablet.h"
 
 #include <algorithm>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -45,6 +46,7 @@
 #include <boost/scope_exit.hpp>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
@@ -186,6 +188,39 @@ using docdb::DocWriteBatch;
 using docdb::SubDocKey;
 using docdb::PrimitiveValue;
 
+namespace {
+
+yb::OpId MaxPersistentOpIdForDb(rocksdb::DB* db) {
+  auto frontier = db->GetFlushedFrontier();
+  if (!frontier) {
+    return yb::OpId();
+  }
+
+  return down_cast<docdb::ConsensusFrontier*>(frontier.get())->op_id();
+}
+
+} // namespace
+
+void IntentsFlushTrigger::SetIntentsDB(rocksdb::DB* intents_db) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  intents_db_ = intents_db;
+}
+
+void IntentsFlushTrigger::OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!intents_db_) {
+    return;
+  }
+  uint64_t immutable_entries = 0;
+  if (intents_db_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries) &&
+      immutable_entries != 0) {
+    rocksdb::FlushOptions options;
+    options.wait = false;
+    WARN_NOT_OK(intents_db_->Flush(options), "Failed to flush intents RocksDB");
+  }
+}
+
 ////////////////////////////////////////////////////////////
 // Tablet
 ////////////////////////////////////////////////////////////
@@ -274,11 +309,28 @@ CHECKED_STATUS EmitRocksDbMetricsAsPrometheus(
   return Status::OK();
 }
 
-// Struct to pass data to WriteOperation related functions.
+// State of the write operation while its key-value batch is prepared. Shared by callbacks of
+// conflict resolution, since preparation could wait for conflicting transactions.
 struct WriteOperationData {
+  WriteOperationData(WriteOperationState* operation_state_,
+                     DocWriteOperationCallback callback_,
+                     PendingOperationCounter* pending_op_counter)
+      : operation_state(operation_state_), callback(std::move(callback_)),
+        pending_operation(pending_op_counter) {}
+
   WriteOperationState* operation_state;
-  LockBatch *keys_locked;
-  HybridTime* restart_read_ht;
+  DocWriteOperationCallback callback;
+  // Keeps the tablet from shutting down while the batch is prepared.
+  ScopedPendingOperation pending_operation;
+  LockBatch keys_locked;
+  HybridTime restart_read_ht;
+  IsolationLevel isolation_level = IsolationLevel::NON_TRANSACTIONAL;
+  bool need_read_snapshot = false;
+  // Redis / QL / row operations separated from the write request, see SetupKeyValueBatch.
+  WriteRequestPB batch_request;
+  docdb::DocOperations doc_ops;
+  // Post-processes executed doc_ops. Not invoked when read should be restarted.
+  std::function<Status()> finish;
 
   tserver::WriteRequestPB* write_request() const {
     return operation_state->mutable_request();
@@ -290,6 +342,11 @@ struct WriteOperationData {
 };
 
 const char* Tablet::kDMSMemTrackerId = "DeltaMemStores";
+const char* Tablet::kIntentsSubdir = "intents";
+
+std::string DocDbOpIds::ToString() const {
+  return Format("{ regular: $0 intents: $1 }", regular, intents);
+}
 
 Tablet::Tablet(
     const scoped_refptr<TabletMetadata>& metadata,
@@ -340,7 +397,7 @@ Tablet::Tablet(
 
   if (transaction_participant_context) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
-        transaction_participant_context);
+        transaction_participant_context, metric_entity_);
     // Create transaction manager for secondary index update.
     if (!metadata_->index_map().empty()) {
       transaction_manager_.emplace(transaction_participant_context->client_future().get(),
@@ -358,6 +415,9 @@ Tablet::Tablet(
 
   flush_stats_ = make_shared<TabletFlushStats>();
   tablet_options_.listeners.emplace_back(flush_stats_);
+  if (transaction_participant_) {
+    intents_flush_trigger_ = make_shared<IntentsFlushTrigger>();
+  }
 }
 
 Tablet::~Tablet() {
@@ -403,12 +463,17 @@ Status Tablet::CreateTabletDirectories(const string& db_dir, FsManager* fs) {
 
 Status Tablet::OpenKeyValueTablet() {
   rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  docdb::InitRocksDBOptions(
+      &rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+      metadata_->schema().table_properties().num_range_components_in_bloom_filter());
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  auto retention_policy = make_shared<TabletRetentionPolicy>(this);
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy, PartitionHashRange());
+  rocksdb_options.expired_files_filter = make_shared<docdb::DocDBExpiredFilesFilter>(
+      retention_policy);
 
   auto mem_table_flush_filter_factory = [this] {
     if (mem_table_flush_filter_factory_) {
@@ -426,6 +491,10 @@ Status Tablet::OpenKeyValueTablet() {
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
 
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
+  if (intents_flush_trigger_) {
+    rocksdb_options.listeners.push_back(intents_flush_trigger_);
+  }
+
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
   if (!rocksdb_open_status.ok()) {
@@ -437,11 +506,45 @@ Status Tablet::OpenKeyValueTablet() {
     return STATUS(IllegalState, rocksdb_open_status.ToString());
   }
   rocksdb_.reset(db);
-  ql_storage_.reset(new docdb::QLRocksDBStorage(rocksdb_.get()));
+  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+
   if (transaction_participant_) {
-    transaction_participant_->SetDB(db);
+    // Intents RocksDB does not need the history cleanup nor the flush filter, and its flushes are
+    // tracked only by flush_stats_.
+    rocksdb::Options intents_rocksdb_options;
+    docdb::InitRocksDBOptions(
+        &intents_rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+    intents_rocksdb_options.listeners.assign({ flush_stats_ });
+
+    // Intents should not be flushed ahead of regular records. Otherwise intents removed by apply
+    // could be persisted while the corresponding regular records are not, so they would be lost
+    // after restart.
+    auto intents_mem_table_flush_filter_factory = [this] {
+      return [this](const rocksdb::MemTable& memtable) -> Result<bool> {
+        return CanFlushIntentsMemTable(memtable);
+      };
+    };
+    intents_rocksdb_options.mem_table_flush_filter_factory =
+        std::make_shared<MemTableFlushFilterFactoryType>(intents_mem_table_flush_filter_factory);
+
+    const string intents_dir = JoinPathSegments(db_dir, kIntentsSubdir);
+    LOG(INFO) << "Opening intents RocksDB at: " << intents_dir;
+    rocksdb::DB* intents_db = nullptr;
+    rocksdb_open_status = rocksdb::DB::Open(intents_rocksdb_options, intents_dir, &intents_db);
+    if (!rocksdb_open_status.ok()) {
+      LOG(ERROR) << "Failed to open intents RocksDB database in directory " << intents_dir << ": "
+                 << rocksdb_open_status.ToString();
+      delete intents_db;
+      return STATUS(IllegalState, rocksdb_open_status.ToString());
+    }
+    intents_db_.reset(intents_db);
+    intents_flush_trigger_->SetIntentsDB(intents_db);
+    transaction_participant_->SetDB(intents_db);
+    LOG(INFO) << "Successfully opened intents RocksDB database at " << intents_dir << ", obj: "
+              << intents_db;
   }
-  LOG(INFO) << "Successfully opened a RocksDB database at " << db_dir << ", obj: " << db;
+
+  ql_storage_.reset(new docdb::QLRocksDBStorage(doc_db(), PartitionHashRange()));
   return Status::OK();
 }
 
@@ -468,7 +571,11 @@ void Tablet::Shutdown() {
   }
 
   std::lock_guard<rw_spinlock> lock(component_lock_);
-  // Shutdown the RocksDB instance for this table, if present.
+  // Shutdown the RocksDB instances for this table, if present.
+  if (intents_flush_trigger_) {
+    intents_flush_trigger_->SetIntentsDB(nullptr);
+  }
+  intents_db_.reset();
   rocksdb_.reset();
   state_ = kShutdown;
 
@@ -500,7 +607,7 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   auto txn_op_ctx = CreateTransactionOperationContext(transaction_id);
   auto read_time = ReadHybridTime::SingleTime(HybridTime::kMax);
   auto result = std::make_unique<DocRowwiseIterator>(
-      std::move(mapped_projection), *schema(), txn_op_ctx, rocksdb_.get(), read_time,
+      std::move(mapped_projection), *schema(), txn_op_ctx, doc_db(), read_time,
       &pending_op_counter_);
   RETURN_NOT_OK(result->Init());
   return std::move(result);
@@ -539,7 +646,30 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
 
   std::lock_guard<std::mutex> lock(create_checkpoint_lock_);
 
-  rocksdb::Status status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
+  // Intents checkpoint is created before the regular one, so all intents removed by apply have
+  // corresponding regular records in the checkpoint. Regular RocksDB is flushed beforehand, so
+  // the intents memtable flush, that is done by checkpoint, is not postponed.
+  const string intents_dir = JoinPathSegments(dir, kIntentsSubdir);
+  rocksdb::Status status;
+  if (intents_db_) {
+    rocksdb::FlushOptions options;
+    status = rocksdb_->Flush(options);
+    if (status.ok()) {
+      // Checkpoint of the intents RocksDB is created in a temporary directory and moved to dir
+      // after the regular checkpoint, because CreateCheckpoint requires dir to not exist.
+      status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), dir + ".intents");
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Create intents checkpoint status: " << status.ToString();
+      return STATUS(IllegalState, Substitute("Unable to create intents checkpoint: $0",
+                                             status.ToString()));
+    }
+  }
+
+  status = rocksdb::checkpoint::CreateCheckpoint(rocksdb_.get(), dir);
+  if (status.ok() && intents_db_) {
+    status = rocksdb_->GetEnv()->RenameFile(dir + ".intents", intents_dir);
+  }
 
   if (!status.ok()) {
     LOG(WARNING) << "Create checkpoint status: " << status.ToString();
@@ -548,26 +678,100 @@ Status Tablet::CreateCheckpoint(const std::string& dir,
   LOG(INFO) << "Checkpoint created in " << dir;
 
   if (rocksdb_files != nullptr) {
-    vector<rocksdb::Env::FileAttributes> files_attrs;
-    status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+    RETURN_NOT_OK(AddCheckpointFiles(dir, "", rocksdb_files));
+    if (intents_db_) {
+      RETURN_NOT_OK(AddCheckpointFiles(intents_dir, kIntentsSubdir, rocksdb_files));
+    }
+  }
+
+  last_rocksdb_checkpoint_dir_ = dir;
+
+  return Status::OK();
+}
+
+Status Tablet::CheckNoPendingIntents() const {
+  if (intents_db_) {
+    // Intents refer to this tablet as a transaction participant, so they cannot be moved to the
+    // new tablets.
+    std::unique_ptr<rocksdb::Iterator> iter(intents_db_->NewIterator(rocksdb::ReadOptions()));
+    iter->SeekToFirst();
+    if (iter->Valid()) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 has pending transaction intents", tablet_id());
+    }
+  }
+  return Status::OK();
+}
+
+Status Tablet::CreateSplitCheckpoint(const std::string& dir) {
+  RETURN_NOT_OK(CheckNoPendingIntents());
+
+  RETURN_NOT_OK(metadata()->fs_manager()->CreateDirIfMissingAndSync(DirName(dir)));
+  RETURN_NOT_OK(CreateCheckpoint(dir));
+
+  // Regular DB includes the table's range components in its bloom filters, intents DB does not.
+  std::vector<std::pair<std::string, size_t>> db_dirs = {
+      { dir, metadata_->schema().table_properties().num_range_components_in_bloom_filter() } };
+  if (intents_db_) {
+    db_dirs.emplace_back(JoinPathSegments(dir, kIntentsSubdir), 0);
+  }
+  for (const auto& db_dir_and_range_components : db_dirs) {
+    const auto& db_dir = db_dir_and_range_components.first;
+    rocksdb::Options rocksdb_options;
+    docdb::InitRocksDBOptions(
+        &rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+        db_dir_and_range_components.second);
+    rocksdb::DB* db = nullptr;
+    rocksdb::Status status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
+    std::unique_ptr<rocksdb::DB> db_holder(db);
     if (!status.ok()) {
-      return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
-                                             status.ToString()));
+      return STATUS_FORMAT(IllegalState, "Unable to open split checkpoint $0: $1",
+                           db_dir, status.ToString());
     }
 
-    for (const auto& file_attrs : files_attrs) {
-      if (file_attrs.name == "." || file_attrs.name == "..") {
-        continue;
-      }
-      auto rocksdb_file_pb = rocksdb_files->Add();
-      rocksdb_file_pb->set_name(file_attrs.name);
-      rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
-      rocksdb_file_pb->set_inode(VERIFY_RESULT(
-          metadata_->fs_manager()->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+    // Keep the hybrid time of the checkpoint, so the new tablet does not read below it.
+    docdb::ConsensusFrontier frontier;
+    auto flushed_frontier = db->GetFlushedFrontier();
+    if (flushed_frontier) {
+      frontier.set_hybrid_time(
+          down_cast<docdb::ConsensusFrontier*>(flushed_frontier.get())->hybrid_time());
+    }
+    frontier.set_op_id(yb::OpId());
+    status = db->ForceFlushedFrontier(frontier.Clone());
+    if (!status.ok()) {
+      return STATUS_FORMAT(IllegalState, "Unable to reset flushed frontier of $0: $1",
+                           db_dir, status.ToString());
     }
   }
+  LOG(INFO) << "Split checkpoint created in " << dir;
 
-  last_rocksdb_checkpoint_dir_ = dir;
+  return Status::OK();
+}
+
+Status Tablet::AddCheckpointFiles(
+    const std::string& dir, const std::string& prefix,
+    google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files) {
+  vector<rocksdb::Env::FileAttributes> files_attrs;
+  auto status = rocksdb_->GetEnv()->GetChildrenFileAttributes(dir, &files_attrs);
+  if (!status.ok()) {
+    return STATUS(IllegalState, Substitute("Unable to get RocksDB files in dir $0: $1", dir,
+                                           status.ToString()));
+  }
+
+  for (const auto& file_attrs : files_attrs) {
+    if (file_attrs.name == "." || file_attrs.name == "..") {
+      continue;
+    }
+    // Intents subdirectory is listed separately.
+    if (prefix.empty() && file_attrs.name == kIntentsSubdir) {
+      continue;
+    }
+    auto rocksdb_file_pb = rocksdb_files->Add();
+    rocksdb_file_pb->set_name(
+        prefix.empty() ? file_attrs.name : JoinPathSegments(prefix, file_attrs.name));
+    rocksdb_file_pb->set_size_bytes(file_attrs.size_bytes);
+    rocksdb_file_pb->set_inode(VERIFY_RESULT(
+        metadata_->fs_manager()->env()->GetFileINode(JoinPathSegments(dir, file_attrs.name))));
+  }
 
   return Status::OK();
 }
@@ -594,38 +798,134 @@ void Tablet::PrepareTransactionWriteBatch(
 
 void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
                                         const rocksdb::UserFrontiers* frontiers,
-                                        const HybridTime hybrid_time,
-                                        rocksdb::WriteBatch* rocksdb_write_batch) {
-  // Write batch could be preallocated, here we handle opposite case.
-  if (rocksdb_write_batch == nullptr) {
-    WriteBatch write_batch;
-    ApplyKeyValueRowOperations(put_batch, frontiers, hybrid_time, &write_batch);
-    return;
-  }
+                                        const HybridTime hybrid_time) {
+  CatchUpIntentsFlushedFrontier();
 
-  if (put_batch.kv_pairs_size() == 0 && rocksdb_write_batch->Count() == 0) {
+  if (put_batch.kv_pairs_size() == 0) {
     return;
   }
 
-  rocksdb_write_batch->SetFrontiers(frontiers);
-
+  WriteBatch write_batch;
   if (put_batch.has_transaction()) {
-    PrepareTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    PrepareTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
+    WriteToRocksDB(frontiers, hybrid_time, &write_batch, docdb::StorageDbType::kIntents);
   } else {
-    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, rocksdb_write_batch);
+    PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
+    WriteToRocksDB(frontiers, hybrid_time, &write_batch, docdb::StorageDbType::kRegular);
+  }
+}
+
+void Tablet::ApplyReplayedWriteBatch(
+    const rocksdb::UserFrontiers& frontiers,
+    int64_t last_op_index,
+    HybridTime hybrid_time,
+    rocksdb::WriteBatch* write_batch) {
+  last_committed_write_index_.store(last_op_index, std::memory_order_release);
+  CatchUpIntentsFlushedFrontier();
+  WriteToRocksDB(&frontiers, hybrid_time, write_batch, docdb::StorageDbType::kRegular);
+}
+
+void Tablet::WriteToRocksDB(
+    const rocksdb::UserFrontiers* frontiers,
+    HybridTime hybrid_time,
+    rocksdb::WriteBatch* write_batch,
+    docdb::StorageDbType storage_db_type) {
+  if (write_batch->Count() == 0) {
+    return;
   }
 
+  write_batch->SetFrontiers(frontiers);
+
   // We are using Raft replication index for the RocksDB sequence number for
   // all members of this write batch.
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
 
   flush_stats_->AboutToWriteToDb(hybrid_time);
-  auto rocksdb_write_status = rocksdb_->Write(write_options, rocksdb_write_batch);
+  auto* dest_db = doc_db()[storage_db_type];
+  auto rocksdb_write_status = dest_db->Write(write_options, write_batch);
   if (!rocksdb_write_status.ok()) {
-    LOG(FATAL) << "Failed to write a batch with " << rocksdb_write_batch->Count() << " operations"
-               << " into RocksDB: " << rocksdb_write_status.ToString();
+    LOG(FATAL) << "Failed to write a batch with " << write_batch->Count() << " operations"
+               << " into " << ToString(storage_db_type) << " RocksDB: "
+               << rocksdb_write_status.ToString();
+  }
+}
+
+bool Tablet::CanFlushIntentsMemTable(const rocksdb::MemTable& memtable) {
+  auto frontiers = memtable.Frontiers();
+  if (!frontiers) {
+    return true;
+  }
+  const auto& intents_largest =
+      down_cast<const docdb::ConsensusFrontier&>(frontiers->Largest()).op_id();
+  if (MaxPersistentOpIdForDb(rocksdb_.get()).index >= intents_largest.index) {
+    return true;
   }
+
+  // When regular RocksDB does not have unflushed data, all regular records written before
+  // intents of this memtable are already persisted.
+  uint64_t active_entries = 0, immutable_entries = 0;
+  if (rocksdb_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries) &&
+      rocksdb_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries) &&
+      active_entries == 0 && immutable_entries == 0) {
+    return true;
+  }
+
+  // Intents memtable would be picked again after regular RocksDB is flushed, see
+  // IntentsFlushTrigger.
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  WARN_NOT_OK(rocksdb_->Flush(options), "Failed to flush regular RocksDB");
+  return false;
+}
+
+void Tablet::CatchUpIntentsFlushedFrontier() {
+  // During bootstrap intents could lag behind the regular flushed frontier, because they are not
+  // replayed yet.
+  if (!intents_db_ || state_ != kOpen) {
+    return;
+  }
+
+  auto num_flushes = flush_stats_->num_flushes();
+  if (num_flushes == last_seen_num_flushes_) {
+    return;
+  }
+  last_seen_num_flushes_ = num_flushes;
+
+  auto regular_frontier = rocksdb_->GetFlushedFrontier();
+  if (!regular_frontier) {
+    return;
+  }
+  const auto& regular_op_id =
+      down_cast<docdb::ConsensusFrontier*>(regular_frontier.get())->op_id();
+  if (regular_op_id <= MaxPersistentOpIdForDb(intents_db_.get())) {
+    return;
+  }
+
+  uint64_t active_entries = 0, immutable_entries = 0;
+  if (!intents_db_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries) ||
+      !intents_db_->GetIntProperty(
+          rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries)) {
+    LOG(DFATAL) << "Failed to get number of memtable entries of intents RocksDB";
+    return;
+  }
+
+  if (active_entries != 0 || immutable_entries != 0) {
+    // Also picks immutable memtables that were not allowed to be flushed before regular RocksDB.
+    rocksdb::FlushOptions options;
+    options.wait = false;
+    WARN_NOT_OK(intents_db_->Flush(options), "Failed to flush intents RocksDB");
+    return;
+  }
+
+  // All intents up to the regular flushed op id are already persisted, so it is safe to move
+  // intents flushed frontier forward.
+  VLOG(1) << "Advancing intents flushed frontier to " << regular_frontier->ToString();
+  WARN_NOT_OK(intents_db_->SetFlushedFrontier(std::move(regular_frontier)),
+              "Failed to advance intents flushed frontier");
 }
 
 namespace {
@@ -649,28 +949,25 @@ void SetupKeyValueBatch(WriteRequestPB* write_request, WriteRequestPB* batch_req
 
 //--------------------------------------------------------------------------------------------------
 // Redis Request Processing.
-Status Tablet::KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data) {
-  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
-  RETURN_NOT_OK(scoped_read_operation);
-  docdb::DocOperations doc_ops;
+Status Tablet::KeyValueBatchFromRedisWriteBatch(WriteOperationData* data) {
+  auto& doc_ops = data->doc_ops;
   // Since we take exclusive locks, it's okay to use Now as the read TS for writes.
-  WriteRequestPB batch_request;
-  SetupKeyValueBatch(data.write_request(), &batch_request);
-  auto* redis_write_batch = batch_request.mutable_redis_write_batch();
+  SetupKeyValueBatch(data->write_request(), &data->batch_request);
+  auto* redis_write_batch = data->batch_request.mutable_redis_write_batch();
 
   doc_ops.reserve(redis_write_batch->size());
   for (size_t i = 0; i < redis_write_batch->size(); i++) {
     doc_ops.emplace_back(new RedisWriteOperation(redis_write_batch->Mutable(i)));
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
-  if (data.restart_read_ht->is_valid()) {
+  data->finish = [data] {
+    auto& doc_ops = data->doc_ops;
+    auto* response = data->operation_state->response();
+    for (size_t i = 0; i < doc_ops.size(); i++) {
+      auto* redis_write_operation = down_cast<RedisWriteOperation*>(doc_ops[i].get());
+      response->add_redis_response_batch()->Swap(&redis_write_operation->response());
+    }
     return Status::OK();
-  }
-  auto* response = data.operation_state->response();
-  for (size_t i = 0; i < doc_ops.size(); i++) {
-    auto* redis_write_operation = down_cast<RedisWriteOperation*>(doc_ops[i].get());
-    response->add_redis_response_batch()->Swap(&redis_write_operation->response());
-  }
+  };
 
   return Status::OK();
 }
@@ -684,7 +981,8 @@ Status Tablet::HandleRedisReadRequest(const ReadHybridTime& read_time,
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
 
-  docdb::RedisReadOperation doc_op(redis_read_request, rocksdb_.get(), read_time);
+  docdb::RedisReadOperation doc_op(
+      redis_read_request, doc_db(), read_time, PartitionHashRange());
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
   return Status::OK();
@@ -756,23 +1054,19 @@ CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_r
   return Status::OK();
 }
 
-Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
-  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
-  RETURN_NOT_OK(scoped_read_operation);
-
-  docdb::DocOperations doc_ops;
-  WriteRequestPB batch_request;
-  SetupKeyValueBatch(data.write_request(), &batch_request);
-  auto* ql_write_batch = batch_request.mutable_ql_write_batch();
+Status Tablet::KeyValueBatchFromQLWriteBatch(WriteOperationData* data) {
+  auto& doc_ops = data->doc_ops;
+  SetupKeyValueBatch(data->write_request(), &data->batch_request);
+  auto* ql_write_batch = data->batch_request.mutable_ql_write_batch();
 
   doc_ops.reserve(ql_write_batch->size());
 
   Result<TransactionOperationContextOpt> txn_op_ctx =
-      CreateTransactionOperationContext(data.write_request()->write_batch().transaction());
+      CreateTransactionOperationContext(data->write_request()->write_batch().transaction());
   RETURN_NOT_OK(txn_op_ctx);
   for (size_t i = 0; i < ql_write_batch->size(); i++) {
     QLWriteRequestPB* req = ql_write_batch->Mutable(i);
-    QLResponsePB* resp = data.operation_state->response()->add_ql_response_batch();
+    QLResponsePB* resp = data->operation_state->response()->add_ql_response_batch();
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     } else {
@@ -783,22 +1077,22 @@ Status Tablet::KeyValueBatchFromQLWriteBatch(const WriteOperationData& data) {
       doc_ops.emplace_back(std::move(write_op));
     }
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
-  if (data.restart_read_ht->is_valid()) {
-    return Status::OK();
-  }
-
-  RETURN_NOT_OK(UpdateQLIndexes(&doc_ops));
-
-  for (size_t i = 0; i < doc_ops.size(); i++) {
-    QLWriteOperation* ql_write_op = down_cast<QLWriteOperation*>(doc_ops[i].get());
-    // If the QL write op returns a rowblock, move the op to the transaction state to return the
-    // rows data as a sidecar after the transaction completes.
-    if (ql_write_op->rowblock() != nullptr) {
-      doc_ops[i].release();
-      data.operation_state->ql_write_ops()->emplace_back(unique_ptr<QLWriteOperation>(ql_write_op));
+  data->finish = [this, data] {
+    auto& doc_ops = data->doc_ops;
+    RETURN_NOT_OK(UpdateQLIndexes(&doc_ops));
+
+    for (size_t i = 0; i < doc_ops.size(); i++) {
+      QLWriteOperation* ql_write_op = down_cast<QLWriteOperation*>(doc_ops[i].get());
+      // If the QL write op returns a rowblock, move the op to the transaction state to return the
+      // rows data as a sidecar after the transaction completes.
+      if (ql_write_op->rowblock() != nullptr) {
+        doc_ops[i].release();
+        data->operation_state->ql_write_ops()->emplace_back(
+            unique_ptr<QLWriteOperation>(ql_write_op));
+      }
     }
-  }
+    return Status::OK();
+  };
 
   return Status::OK();
 }
@@ -883,23 +1177,20 @@ CHECKED_STATUS Tablet::CreatePagingStateForRead(const PgsqlReadRequestPB& pgsql_
   return Status::OK();
 }
 
-Status Tablet::KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data) {
-  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
-  RETURN_NOT_OK(scoped_read_operation);
-  docdb::DocOperations doc_ops;
-  WriteRequestPB batch_request;
+Status Tablet::KeyValueBatchFromPgsqlWriteBatch(WriteOperationData* data) {
+  auto& doc_ops = data->doc_ops;
 
-  SetupKeyValueBatch(data.write_request(), &batch_request);
-  auto* pgsql_write_batch = batch_request.mutable_pgsql_write_batch();
+  SetupKeyValueBatch(data->write_request(), &data->batch_request);
+  auto* pgsql_write_batch = data->batch_request.mutable_pgsql_write_batch();
 
   doc_ops.reserve(pgsql_write_batch->size());
 
   Result<TransactionOperationContextOpt> txn_op_ctx =
-      CreateTransactionOperationContext(data.write_request()->write_batch().transaction());
+      CreateTransactionOperationContext(data->write_request()->write_batch().transaction());
   RETURN_NOT_OK(txn_op_ctx);
   for (size_t i = 0; i < pgsql_write_batch->size(); i++) {
     PgsqlWriteRequestPB* req = pgsql_write_batch->Mutable(i);
-    PgsqlResponsePB* resp = data.operation_state->response()->add_pgsql_response_batch();
+    PgsqlResponsePB* resp = data->operation_state->response()->add_pgsql_response_batch();
     if (metadata_->schema_version() != req->schema_version()) {
       resp->set_status(PgsqlResponsePB::PGSQL_STATUS_SCHEMA_VERSION_MISMATCH);
     } else {
@@ -909,74 +1200,71 @@ Status Tablet::KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data)
       doc_ops.emplace_back(std::move(write_op));
     }
   }
-  RETURN_NOT_OK(StartDocWriteOperation(doc_ops, data));
-  if (data.restart_read_ht->is_valid()) {
+  data->finish = [data] {
+    auto& doc_ops = data->doc_ops;
+    for (size_t i = 0; i < doc_ops.size(); i++) {
+      PgsqlWriteOperation* pgsql_write_op = down_cast<PgsqlWriteOperation*>(doc_ops[i].get());
+      // We'll need to return the number of updated, deleted, or inserted rows by each operations.
+      doc_ops[i].release();
+      data->operation_state->pgsql_write_ops()
+                           ->emplace_back(unique_ptr<PgsqlWriteOperation>(pgsql_write_op));
+    }
     return Status::OK();
-  }
-  for (size_t i = 0; i < doc_ops.size(); i++) {
-    PgsqlWriteOperation* pgsql_write_op = down_cast<PgsqlWriteOperation*>(doc_ops[i].get());
-    // We'll need to return the number of updated, deleted, or inserted rows by each operations.
-    doc_ops[i].release();
-    data.operation_state->pgsql_write_ops()
-                        ->emplace_back(unique_ptr<PgsqlWriteOperation>(pgsql_write_op));
-  }
+  };
 
   return Status::OK();
 }
 
 //--------------------------------------------------------------------------------------------------
 
-Status Tablet::AcquireLocksAndPerformDocOperations(
-    WriteOperationState *state, HybridTime* restart_read_ht) {
-  LockBatch locks_held;
-  WriteRequestPB* key_value_write_request = state->mutable_request();
-
-  bool invalid_table_type = true;
-  WriteOperationData data = {
-    state,
-    &locks_held,
-    restart_read_ht
-  };
-  switch (table_type_) {
-    case TableType::REDIS_TABLE_TYPE: {
-      RETURN_NOT_OK(KeyValueBatchFromRedisWriteBatch(data));
-      invalid_table_type = false;
-      break;
-    }
-    case TableType::YQL_TABLE_TYPE: {
-      CHECK_GT(key_value_write_request->ql_write_batch_size(), 0);
-      RETURN_NOT_OK(KeyValueBatchFromQLWriteBatch(data));
-      if (restart_read_ht->is_valid()) {
-        return Status::OK();
+void Tablet::AcquireLocksAndPerformDocOperations(
+    WriteOperationState *state, DocWriteOperationCallback callback) {
+  auto data = std::make_shared<WriteOperationData>(
+      state, std::move(callback), &pending_op_counter_);
+  Status status = MoveStatus(data->pending_operation);
+
+  if (status.ok()) {
+    bool invalid_table_type = true;
+    switch (table_type_) {
+      case TableType::REDIS_TABLE_TYPE: {
+        status = KeyValueBatchFromRedisWriteBatch(data.get());
+        invalid_table_type = false;
+        break;
       }
-      invalid_table_type = false;
-      break;
-    }
-    case TableType::PGSQL_TABLE_TYPE: {
-      RETURN_NOT_OK(KeyValueBatchFromPgsqlWriteBatch(data));
-      if (restart_read_ht->is_valid()) {
-        return Status::OK();
+      case TableType::YQL_TABLE_TYPE: {
+        CHECK_GT(state->mutable_request()->ql_write_batch_size(), 0);
+        status = KeyValueBatchFromQLWriteBatch(data.get());
+        invalid_table_type = false;
+        break;
       }
-      invalid_table_type = false;
-      break;
+      case TableType::PGSQL_TABLE_TYPE: {
+        status = KeyValueBatchFromPgsqlWriteBatch(data.get());
+        invalid_table_type = false;
+        break;
+      }
+    }
+    if (invalid_table_type) {
+      FATAL_INVALID_ENUM_VALUE(TableType, table_type_);
     }
   }
-  if (invalid_table_type) {
-    FATAL_INVALID_ENUM_VALUE(TableType, table_type_);
+  if (!status.ok()) {
+    data->callback(status, HybridTime::kInvalid);
+    return;
   }
-  // If there is a non-zero number of operations, we expect to be holding locks. The reverse is
-  // not always true, because we could decide to avoid writing based on results of reading.
-  DCHECK(!locks_held.empty() ||
-         key_value_write_request->write_batch().kv_pairs_size() == 0)
-      << "Expect to be holding locks for a non-zero number of write operations: "
-      << key_value_write_request->write_batch().DebugString();
-  state->ReplaceDocDBLocks(std::move(locks_held));
 
-  DCHECK_EQ(key_value_write_request->redis_write_batch_size(), 0)
-      << "Redis write batch not empty in key-value batch";
-  DCHECK_EQ(key_value_write_request->ql_write_batch_size(), 0)
-      << "QL write batch not empty in key-value batch";
-  return Status::OK();
+  StartDocWriteOperation(data);
+}
+
+Status Tablet::AcquireLocksAndPerformDocOperations(
+    WriteOperationState *state, HybridTime* restart_read_ht) {
+  auto promise = std::make_shared<std::promise<Status>>();
+  auto future = promise->get_future();
+  AcquireLocksAndPerformDocOperations(
+      state, [promise, restart_read_ht](const Status& status, HybridTime restart_ht) {
+        *restart_read_ht = restart_ht;
+        promise->set_value(status);
+      });
+  return future.get();
 }
 
 Status Tablet::Flush(FlushMode mode) {
@@ -984,13 +1272,21 @@ Status Tablet::Flush(FlushMode mode) {
 
   rocksdb::FlushOptions options;
   options.wait = mode == FlushMode::kSync;
+  // Regular RocksDB is flushed first, because intents could not be flushed ahead of it.
   rocksdb_->Flush(options);
+  if (intents_db_) {
+    intents_db_->Flush(options);
+  }
   return Status::OK();
 }
 
 Status Tablet::WaitForFlush() {
   TRACE_EVENT0("tablet", "Tablet::WaitForFlush");
-  return rocksdb_->WaitForFlush();
+  RETURN_NOT_OK(rocksdb_->WaitForFlush());
+  if (intents_db_) {
+    RETURN_NOT_OK(intents_db_->WaitForFlush());
+  }
+  return Status::OK();
 }
 
 Status Tablet::ImportData(const std::string& source_dir) {
@@ -1000,20 +1296,42 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+// Regular records are written before intents are removed, so concurrent readers always see either
+// the intent or the applied record.
 // TODO(dtxn) use separate thread for applying intents.
 // TODO(dtxn) use multiple batches when applying really big transaction.
 Status Tablet::ApplyIntents(const TransactionApplyData& data) {
-  WriteBatch rocksdb_write_batch;
+  CatchUpIntentsFlushedFrontier();
+
+  const yb::OpId op_id(data.op_id.term(), data.op_id.index());
+  bool apply_to_regular = true;
+  bool apply_to_intents = true;
+  if (state_ == kBootstrapping) {
+    // During bootstrap this operation could be already persisted in one of RocksDB instances.
+    // Writing to it again would move its flushed frontier backward.
+    auto flushed_op_ids = VERIFY_RESULT(MaxPersistentOpIds());
+    apply_to_regular = flushed_op_ids.regular < op_id;
+    apply_to_intents = flushed_op_ids.intents < op_id;
+  }
+
+  const bool separate_intents_db = intents_db_ != nullptr;
+  WriteBatch regular_write_batch;
+  WriteBatch intents_write_batch;
+  auto* intents_batch_ptr = separate_intents_db ? &intents_write_batch : &regular_write_batch;
   RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
-      data.transaction_id, data.commit_ht, rocksdb_.get(), &rocksdb_write_batch));
+      data.transaction_id, data.commit_ht, doc_db().intents,
+      apply_to_regular ? &regular_write_batch : nullptr,
+      apply_to_intents ? intents_batch_ptr : nullptr));
 
   // data.hybrid_time contains transaction commit time.
-  // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
-  set_op_id({data.op_id.term(), data.op_id.index()}, &frontiers);
+  set_op_id(op_id, &frontiers);
   set_hybrid_time(data.log_ht, &frontiers);
-  ApplyKeyValueRowOperations(
-      KeyValueWriteBatchPB(), &frontiers, data.commit_ht, &rocksdb_write_batch);
+  WriteToRocksDB(&frontiers, data.commit_ht, &regular_write_batch, docdb::StorageDbType::kRegular);
+  if (separate_intents_db) {
+    WriteToRocksDB(
+        &frontiers, data.commit_ht, &intents_write_batch, docdb::StorageDbType::kIntents);
+  }
   return Status::OK();
 }
 
@@ -1094,6 +1412,21 @@ Status Tablet::AlterSchema(AlterSchemaOperationState *operation_state) {
   return Status::OK();
 }
 
+docdb::DocKeyHashRange Tablet::PartitionHashRange() const {
+  docdb::DocKeyHashRange result;
+  const auto& partition = metadata_->partition();
+  // Only hash partitions are encoded as 2-byte hash codes.
+  const auto& start = partition.partition_key_start();
+  const auto& end = partition.partition_key_end();
+  if (start.size() == PartitionSchema::kPartitionKeySize) {
+    result.first = PartitionSchema::DecodeMultiColumnHashValue(start);
+  }
+  if (end.size() == PartitionSchema::kPartitionKeySize) {
+    result.last = PartitionSchema::DecodeMultiColumnHashValue(end) - 1;
+  }
+  return result;
+}
+
 ScopedPendingOperationPause Tablet::PauseReadWriteOperations() {
   LOG_SLOW_EXECUTION(WARNING, 1000,
                      Substitute("Tablet $0: Waiting for pending ops to complete", tablet_id())) {
@@ -1105,13 +1438,18 @@ ScopedPendingOperationPause Tablet::PauseReadWriteOperations() {
 }
 
 Status Tablet::SetFlushedFrontier(const docdb::ConsensusFrontier& frontier) {
-  const Status s = rocksdb_->SetFlushedFrontier(frontier.Clone());
-  if (PREDICT_FALSE(!s.ok())) {
-    auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
-    LOG(WARNING) << status;
-    return status;
+  for (auto* db : { intents_db_.get(), rocksdb_.get() }) {
+    if (!db) {
+      continue;
+    }
+    const Status s = db->SetFlushedFrontier(frontier.Clone());
+    if (PREDICT_FALSE(!s.ok())) {
+      auto status = STATUS(IllegalState, "Failed to set flushed frontier", s.ToString());
+      LOG(WARNING) << status;
+      return status;
+    }
+    DCHECK_EQ(frontier, *db->GetFlushedFrontier());
   }
-  DCHECK_EQ(frontier, *rocksdb_->GetFlushedFrontier());
   return Flush(FlushMode::kAsync);
 }
 
@@ -1127,9 +1465,21 @@ Status Tablet::Truncate(TruncateOperationState *state) {
   const rocksdb::SequenceNumber sequence_number = rocksdb_->GetLatestSequenceNumber();
   const string db_dir = rocksdb_->GetName();
 
-  rocksdb_ = nullptr;
   rocksdb::Options rocksdb_options;
   docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  // Intents RocksDB is destroyed first, so its directory is removed before the regular one.
+  if (intents_db_) {
+    const string intents_dir = intents_db_->GetName();
+    intents_flush_trigger_->SetIntentsDB(nullptr);
+    intents_db_ = nullptr;
+    Status s = rocksdb::DestroyDB(intents_dir, rocksdb_options);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG(WARNING) << "Failed to clean up intents db dir " << intents_dir << ": " << s;
+      return STATUS(IllegalState, "Failed to clean up intents db dir", s.ToString());
+    }
+  }
+
+  rocksdb_ = nullptr;
   Status s = rocksdb::DestroyDB(db_dir, rocksdb_options);
   if (PREDICT_FALSE(!s.ok())) {
     LOG(WARNING) << "Failed to clean up db dir " << db_dir << ": " << s;
@@ -1177,18 +1527,26 @@ Result<bool> Tablet::HasSSTables() const {
 
   std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
   rocksdb_->GetLiveFilesMetaData(&live_files_metadata);
+  if (live_files_metadata.empty() && intents_db_) {
+    intents_db_->GetLiveFilesMetaData(&live_files_metadata);
+  }
   return !live_files_metadata.empty();
 }
 
 Result<yb::OpId> Tablet::MaxPersistentOpId() const {
+  auto op_ids = VERIFY_RESULT(MaxPersistentOpIds());
+  op_ids.regular.MakeAtMost(op_ids.intents);
+  return op_ids.regular;
+}
+
+Result<DocDbOpIds> Tablet::MaxPersistentOpIds() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
-  auto temp = rocksdb_->GetFlushedFrontier();
-  if (!temp) {
-    return yb::OpId();
-  }
-  return down_cast<docdb::ConsensusFrontier*>(temp.get())->op_id();
+  DocDbOpIds result;
+  result.regular = MaxPersistentOpIdForDb(rocksdb_.get());
+  result.intents = intents_db_ ? MaxPersistentOpIdForDb(intents_db_.get()) : result.regular;
+  return result;
 }
 
 Status Tablet::DebugDump(vector<string> *lines) {
@@ -1206,6 +1564,11 @@ void Tablet::DocDBDebugDump(vector<string> *lines) {
   LOG_STRING(INFO, lines) << "Dumping tablet:";
   LOG_STRING(INFO, lines) << "---------------------------";
   yb::docdb::DocDBDebugDump(rocksdb_.get(), LOG_STRING(INFO, lines));
+  if (intents_db_) {
+    LOG_STRING(INFO, lines) << "Dumping intents:";
+    LOG_STRING(INFO, lines) << "---------------------------";
+    yb::docdb::DocDBDebugDump(intents_db_.get(), LOG_STRING(INFO, lines));
+  }
 }
 
 namespace {
@@ -1234,61 +1597,115 @@ Status Tablet::TEST_SwitchMemtable() {
   RETURN_NOT_OK(scoped_operation);
 
   rocksdb_->TEST_SwitchMemtable();
+  if (intents_db_) {
+    intents_db_->TEST_SwitchMemtable();
+  }
   return Status::OK();
 }
 
-Status Tablet::StartDocWriteOperation(const docdb::DocOperations &doc_ops,
-                                      const WriteOperationData& data) {
-  auto write_batch = data.write_request()->mutable_write_batch();
-  auto isolation_level = GetIsolationLevel(*write_batch, transaction_participant_.get());
-  RETURN_NOT_OK(isolation_level);
-  bool need_read_snapshot = false;
+void Tablet::StartDocWriteOperation(const WriteOperationDataPtr& data) {
+  auto isolation_level = GetIsolationLevel(
+      data->write_request()->write_batch(), transaction_participant_.get());
+  if (!isolation_level.ok()) {
+    CompleteDocWriteOperation(data, isolation_level.status());
+    return;
+  }
+  data->isolation_level = *isolation_level;
   docdb::PrepareDocWriteOperation(
-      doc_ops, metrics_->write_lock_latency, *isolation_level, &shared_lock_manager_,
-      data.keys_locked, &need_read_snapshot);
-
-  auto read_op = need_read_snapshot
-      ? ScopedReadOperation(this, RequireLease::kTrue, data.read_time())
-      : ScopedReadOperation();
-  auto real_read_time = need_read_snapshot ? read_op.read_time()
-                                           : ReadHybridTime::SingleTime(clock_->Now());
+      data->doc_ops, metrics_->write_lock_latency, data->isolation_level, &shared_lock_manager_,
+      &data->keys_locked, &data->need_read_snapshot);
 
-  if (*isolation_level == IsolationLevel::NON_TRANSACTIONAL &&
+  if (data->isolation_level == IsolationLevel::NON_TRANSACTIONAL &&
       metadata_->schema().table_properties().is_transactional()) {
     auto now = clock_->Now();
-    auto result = docdb::ResolveOperationConflicts(
-        doc_ops, now, rocksdb_.get(), transaction_participant_.get());
-    RETURN_NOT_OK(result);
-    if (now != *result) {
-      clock_->Update(*result);
-    }
+    const MonoTime resolution_start = MonoTime::Now();
+    docdb::ResolveOperationConflicts(
+        data->doc_ops, now, doc_db(), transaction_participant_.get(),
+        [this, data, now, resolution_start](const Result<HybridTime>& result) {
+          data->operation_state->stage_latencies()->conflict_resolution =
+              MonoTime::Now() - resolution_start;
+          if (!result.ok()) {
+            CompleteDocWriteOperation(data, result.status());
+            return;
+          }
+          if (now != *result) {
+            clock_->Update(*result);
+          }
+          ExecuteDocWriteOperation(data);
+        });
+    return;
   }
 
-  // We expect all read operations for this transaction to be done in ExecuteDocWriteOperation.
-  // Once read_txn goes out of scope, the read point is deregistered.
-  RETURN_NOT_OK(docdb::ExecuteDocWriteOperation(
-      doc_ops, real_read_time, rocksdb_.get(), write_batch,
-      table_type_ == TableType::REDIS_TABLE_TYPE ? InitMarkerBehavior::kRequired
-                                                 : InitMarkerBehavior::kOptional,
-      &monotonic_counter_,
-      data.restart_read_ht));
+  ExecuteDocWriteOperation(data);
+}
+
+void Tablet::ExecuteDocWriteOperation(const WriteOperationDataPtr& data) {
+  auto* write_batch = data->write_request()->mutable_write_batch();
+  {
+    auto read_op = data->need_read_snapshot
+        ? ScopedReadOperation(this, RequireLease::kTrue, data->read_time())
+        : ScopedReadOperation();
+    auto real_read_time = data->need_read_snapshot ? read_op.read_time()
+                                                   : ReadHybridTime::SingleTime(clock_->Now());
+
+    // We expect all read operations for this transaction to be done in ExecuteDocWriteOperation.
+    // Once read_op goes out of scope, the read point is deregistered.
+    auto status = docdb::ExecuteDocWriteOperation(
+        data->doc_ops, real_read_time, doc_db(), write_batch,
+        table_type_ == TableType::REDIS_TABLE_TYPE ? InitMarkerBehavior::kRequired
+                                                   : InitMarkerBehavior::kOptional,
+        &monotonic_counter_,
+        &data->restart_read_ht);
+    if (!status.ok()) {
+      CompleteDocWriteOperation(data, status);
+      return;
+    }
+  }
 
-  if (data.restart_read_ht->is_valid()) {
-    return Status::OK();
+  if (data->restart_read_ht.is_valid() ||
+      data->isolation_level == IsolationLevel::NON_TRANSACTIONAL) {
+    CompleteDocWriteOperation(data, Status::OK());
+    return;
   }
 
-  if (*isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
-    auto result = docdb::ResolveTransactionConflicts(*write_batch,
-                                                     clock_->Now(),
-                                                     rocksdb_.get(),
-                                                     transaction_participant_.get());
-    if (!result.ok()) {
-      *data.keys_locked = LockBatch();  // Unlock the keys.
-      return result;
-    }
+  const MonoTime resolution_start = MonoTime::Now();
+  docdb::ResolveTransactionConflicts(
+      *write_batch, clock_->Now(), doc_db(), transaction_participant_.get(),
+      [this, data, resolution_start](const Result<HybridTime>& result) {
+        data->operation_state->stage_latencies()->conflict_resolution =
+            MonoTime::Now() - resolution_start;
+        CompleteDocWriteOperation(data, result.ok() ? Status::OK() : result.status());
+      });
+}
+
+void Tablet::CompleteDocWriteOperation(const WriteOperationDataPtr& data, Status status) {
+  if (status.ok() && !data->restart_read_ht.is_valid() && data->finish) {
+    status = data->finish();
+  }
+  if (!status.ok()) {
+    data->keys_locked = LockBatch();  // Unlock the keys.
+    data->callback(status, HybridTime::kInvalid);
+    return;
+  }
+  if (data->restart_read_ht.is_valid()) {
+    data->callback(Status::OK(), data->restart_read_ht);
+    return;
   }
 
-  return Status::OK();
+  auto* key_value_write_request = data->write_request();
+  // If there is a non-zero number of operations, we expect to be holding locks. The reverse is
+  // not always true, because we could decide to avoid writing based on results of reading.
+  DCHECK(!data->keys_locked.empty() ||
+         key_value_write_request->write_batch().kv_pairs_size() == 0)
+      << "Expect to be holding locks for a non-zero number of write operations: "
+      << key_value_write_request->write_batch().DebugString();
+  data->operation_state->ReplaceDocDBLocks(std::move(data->keys_locked));
+
+  DCHECK_EQ(key_value_write_request->redis_write_batch_size(), 0)
+      << "Redis write batch not empty in key-value batch";
+  DCHECK_EQ(key_value_write_request->ql_write_batch_size(), 0)
+      << "QL write batch not empty in key-value batch";
+  data->callback(Status::OK(), HybridTime::kInvalid);
 }
 
 HybridTime Tablet::DoGetSafeTime(
@@ -1360,7 +1777,11 @@ void Tablet::ForceRocksDBCompactInTest() {
 }
 
 std::string Tablet::DocDBDumpStrInTest() {
-  return docdb::DocDBDebugDumpToStr(rocksdb_.get());
+  auto result = docdb::DocDBDebugDumpToStr(rocksdb_.get());
+  if (intents_db_) {
+    result += docdb::DocDBDebugDumpToStr(intents_db_.get());
+  }
+  return result;
 }
 
 void Tablet::LostLeadership() {
@@ -1378,7 +1799,7 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
   if (!pending_op_counter_.IsReady() || !rocksdb_) {
     return 0;
   }
-  return rocksdb_->GetTotalSSTFileSize();
+  return rocksdb_->GetTotalSSTFileSize() + (intents_db_ ? intents_db_->GetTotalSSTFileSize() : 0);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -55,6 +56,7 @@
 
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_types.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/shared_lock_manager.h"
@@ -72,6 +74,7 @@
 
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/opid.h"
 #include "yb/util/pending_op_counter.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/slice.h"
@@ -81,6 +84,7 @@
 
 namespace rocksdb {
 class DB;
+class MemTable;
 }
 
 namespace yb {
@@ -151,9 +155,39 @@ class TabletFlushStats : public rocksdb::EventListener {
   std::atomic<uint64_t> oldest_write_in_memstore_{std::numeric_limits<uint64_t>::max()};
 };
 
+// Flushes intents RocksDB after regular RocksDB flush completes. Flush of intents memtable could be
+// postponed until regular records written before it are flushed, see
+// Tablet::CanFlushIntentsMemTable, so it should be retried later.
+class IntentsFlushTrigger : public rocksdb::EventListener {
+ public:
+  // Should be reset to nullptr before intents RocksDB is destroyed.
+  void SetIntentsDB(rocksdb::DB* intents_db);
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+ private:
+  std::mutex mutex_;
+  rocksdb::DB* intents_db_ = nullptr;
+};
+
 YB_DEFINE_ENUM(FlushMode, (kSync)(kAsync));
 
+// Op ids persisted in the regular and intents RocksDB instances of a tablet.
+struct DocDbOpIds {
+  yb::OpId regular;
+  yb::OpId intents;
+
+  std::string ToString() const;
+};
+
 struct WriteOperationData;
+typedef std::shared_ptr<WriteOperationData> WriteOperationDataPtr;
+
+// Invoked once key-value batch of a write operation is prepared, or its preparation failed.
+// restart_read_ht is valid when the operation should not be performed, because read should be
+// restarted at this time.
+typedef std::function<void(const Status& status, HybridTime restart_read_ht)>
+    DocWriteOperationCallback;
 
 class Tablet : public AbstractTablet, public TransactionIntentApplier {
  public:
@@ -236,12 +270,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   void ApplyRowOperations(WriteOperationState* operation_state);
 
   // Apply a set of RocksDB row operations.
-  // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
+  // Transactional batches are written to the intents RocksDB, other batches to the regular one.
   void ApplyKeyValueRowOperations(
       const docdb::KeyValueWriteBatchPB& put_batch,
       const rocksdb::UserFrontiers* frontiers,
+      HybridTime hybrid_time);
+
+  // Applies non-transactional writes of several consecutive WRITE_OP entries accumulated during
+  // log replay into a single batch by docdb::PrepareNonTransactionWriteBatch.
+  // 'last_op_index' is the index of the last of those entries and 'hybrid_time' the latest hybrid
+  // time among them.
+  void ApplyReplayedWriteBatch(
+      const rocksdb::UserFrontiers& frontiers,
+      int64_t last_op_index,
       HybridTime hybrid_time,
-      rocksdb::WriteBatch* rocksdb_write_batch = nullptr);
+      rocksdb::WriteBatch* write_batch);
 
   //------------------------------------------------------------------------------------------------
   // Redis Request Processing.
@@ -249,11 +292,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Constructs a WriteRequestPB containing a serialized WriteBatch that will be
   // replicated by Raft. (Makes a copy, it is caller's responsibility to deallocate
   // write_request afterwards if it is no longer needed).
-  // The operation acquires the necessary locks required to correctly serialize concurrent write
-  // operations to same/conflicting part of the key/sub-key space. The locks acquired are returned
-  // via the 'keys_locked' vector, so that they may be unlocked later when the operation has been
-  // committed.
-  CHECKED_STATUS KeyValueBatchFromRedisWriteBatch(const WriteOperationData& data);
+  // Fills doc operations of data, that are executed by StartDocWriteOperation. It acquires the
+  // necessary locks required to correctly serialize concurrent write operations to
+  // same/conflicting part of the key/sub-key space. The locks acquired are kept in data, so that
+  // they may be unlocked later when the operation has been committed.
+  CHECKED_STATUS KeyValueBatchFromRedisWriteBatch(WriteOperationData* data);
 
   CHECKED_STATUS HandleRedisReadRequest(
       const ReadHybridTime& read_time,
@@ -273,7 +316,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       QLResponsePB* response) const override;
 
   // The QL equivalent of KeyValueBatchFromRedisWriteBatch, works similarly.
-  CHECKED_STATUS KeyValueBatchFromQLWriteBatch(const WriteOperationData& data);
+  CHECKED_STATUS KeyValueBatchFromQLWriteBatch(WriteOperationData* data);
 
   //------------------------------------------------------------------------------------------------
   // Postgres Request Processing.
@@ -287,7 +330,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const PgsqlReadRequestPB& pgsql_read_request, const size_t row_count,
       PgsqlResponsePB* response) const override;
 
-  CHECKED_STATUS KeyValueBatchFromPgsqlWriteBatch(const WriteOperationData& data);
+  CHECKED_STATUS KeyValueBatchFromPgsqlWriteBatch(WriteOperationData* data);
 
   //------------------------------------------------------------------------------------------------
   // Create a RocksDB checkpoint in the provided directory. Only used when table_type_ ==
@@ -295,6 +338,27 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   CHECKED_STATUS CreateCheckpoint(const std::string& dir,
       google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files = nullptr);
 
+  // Create a RocksDB checkpoint in the provided directory to be used as the data of a tablet
+  // created by splitting this one. The op ids of the checkpoint are reset, since the new tablet
+  // starts its own Raft log. Fails if there are pending transaction intents, so write operations
+  // should be stopped beforehand.
+  CHECKED_STATUS CreateSplitCheckpoint(const std::string& dir);
+
+  // Returns an error if the tablet has pending transaction intents, which cannot be moved to the
+  // tablets created by splitting it.
+  CHECKED_STATUS CheckNoPendingIntents() const;
+
+  // Whether this tablet is being split or was split. Set on the leader before the split operation
+  // is submitted, and on followers once it is appended to their log or replayed. A split tablet
+  // does not accept new operations.
+  bool IsSplit() const {
+    return split_.load(std::memory_order_acquire);
+  }
+
+  void SetSplit(bool split) {
+    split_.store(split, std::memory_order_release);
+  }
+
   // Create a new row iterator which yields the rows as of the current MVCC
   // state of this tablet.
   // The returned iterator is not initialized.
@@ -348,6 +412,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   const std::string& tablet_id() const override { return metadata_->tablet_id(); }
 
+  docdb::DocKeyHashRange PartitionHashRange() const override;
+
   // Return the metrics for this tablet.
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
@@ -363,19 +429,32 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
-  // Returns the maximum persistent op id from all SSTables in RocksDB.
+  // Returns the maximum op id that is persisted in all RocksDB instances of this tablet, i.e. the
+  // minimum of the regular and intents flushed op ids.
   Result<yb::OpId> MaxPersistentOpId() const;
 
+  // Returns the maximum persistent op ids of the regular and intents RocksDB separately.
+  Result<DocDbOpIds> MaxPersistentOpIds() const;
+
   // Returns the location of the last rocksdb checkpoint. Used for tests only.
   std::string GetLastRocksDBCheckpointDirForTest() { return last_rocksdb_checkpoint_dir_; }
 
   // For non-kudu table type fills key-value batch in transaction state request and updates
-  // request in state. Due to acquiring locks it can block the thread.
+  // request in state. Due to acquiring locks it can block the thread. It does not block while
+  // waiting for conflicting transactions, callback is invoked once they are resolved instead.
+  // The state should stay alive until callback is invoked.
+  void AcquireLocksAndPerformDocOperations(
+      WriteOperationState *state, DocWriteOperationCallback callback);
+
+  // Synchronous version of the above, blocks until the key-value batch is prepared.
   CHECKED_STATUS AcquireLocksAndPerformDocOperations(
       WriteOperationState *state, HybridTime* restart_read_ht);
 
   static const char* kDMSMemTrackerId;
 
+  // Name of the subdirectory of the tablet RocksDB directory where intents RocksDB is stored.
+  static const char* kIntentsSubdir;
+
   // Returns the timestamp corresponding to the oldest active reader. If none exists returns
   // the latest timestamp that is safe to read.
   // This is used to figure out what can be garbage collected during a compaction.
@@ -436,6 +515,16 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return rocksdb_.get();
   }
 
+  rocksdb::DB* TEST_intents_db() const {
+    return intents_db_.get();
+  }
+
+  // Returns DocDB of this tablet. When the tablet does not have a separate intents RocksDB,
+  // intents are stored in the regular one.
+  docdb::DocDB doc_db() const {
+    return { rocksdb_.get(), intents_db_ ? intents_db_.get() : rocksdb_.get() };
+  }
+
   CHECKED_STATUS TEST_SwitchMemtable();
 
  protected:
@@ -444,13 +533,41 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   friend class ScopedReadOperation;
   FRIEND_TEST(TestTablet, TestGetLogRetentionSizeForIndex);
 
-  CHECKED_STATUS StartDocWriteOperation(
-      const docdb::DocOperations &doc_ops,
-      const WriteOperationData& data);
+  // Acquires locks for doc operations of data and resolves their conflicts with transactions.
+  void StartDocWriteOperation(const WriteOperationDataPtr& data);
+
+  // Executes doc operations of data, once their conflicts with transactions are resolved.
+  void ExecuteDocWriteOperation(const WriteOperationDataPtr& data);
+
+  // Finishes preparation of data and invokes its callback.
+  void CompleteDocWriteOperation(const WriteOperationDataPtr& data, Status status);
 
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
+  // Writes prepared batch to the RocksDB of the specified type.
+  void WriteToRocksDB(
+      const rocksdb::UserFrontiers* frontiers,
+      HybridTime hybrid_time,
+      rocksdb::WriteBatch* write_batch,
+      docdb::StorageDbType storage_db_type);
+
+  // When the regular RocksDB gets flushed, makes sure that the intents RocksDB does not hold back
+  // the persistent op id of the tablet. I.e. flushes it if it has unflushed data, or advances its
+  // flushed frontier to the regular one otherwise.
+  // Should be called only from the apply path, so no intents are written concurrently.
+  void CatchUpIntentsFlushedFrontier();
+
+  // Intents memtable could be flushed only when all regular records written before its intents
+  // are flushed. Otherwise schedules flush of regular RocksDB and returns false.
+  bool CanFlushIntentsMemTable(const rocksdb::MemTable& memtable);
+
+  // Adds files of RocksDB checkpoint located in dir to rocksdb_files, prefix is prepended to
+  // their names.
+  CHECKED_STATUS AddCheckpointFiles(
+      const std::string& dir, const std::string& prefix,
+      google::protobuf::RepeatedPtrField<FilePB>* rocksdb_files);
+
   void DocDBDebugDump(std::vector<std::string> *lines);
 
   // Register/Unregister a read operation, with an associated timestamp, for the purpose of
@@ -567,6 +684,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // RocksDB database for key-value tables.
   std::unique_ptr<rocksdb::DB> rocksdb_;
 
+  // RocksDB database for transaction intents, it is opened only for tablets that have transaction
+  // participant. Stored in the kIntentsSubdir subdirectory of the regular RocksDB directory.
+  std::unique_ptr<rocksdb::DB> intents_db_;
+
+  // Number of flushes observed by the last CatchUpIntentsFlushedFrontier call.
+  size_t last_seen_num_flushes_ = 0;
+
+  std::shared_ptr<IntentsFlushTrigger> intents_flush_trigger_;
+
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -579,6 +705,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // prevent race conditions between destroying the RocksDB instance and read/write operations.
   std::atomic_bool shutdown_requested_{false};
 
+  // See IsSplit.
+  std::atomic<bool> split_{false};
+
   // This is a special atomic counter per tablet that increases monotonically.
   // It is like timestamp, but doesn't need locks to read or update.
   // This is raft replicated as well. Each replicate message contains the current number.
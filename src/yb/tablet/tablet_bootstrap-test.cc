@@ -43,9 +43,18 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
+DEFINE_int32(bootstrap_benchmark_num_ops, 2000,
+             "Number of write operations in the WAL replayed by BootstrapTest.ReplayBenchmark. "
+             "Use a few millions to get a multi-GB WAL.");
+DEFINE_int32(bootstrap_benchmark_rows_per_op, 10,
+             "Number of rows written by each operation in BootstrapTest.ReplayBenchmark.");
+DEFINE_int32(bootstrap_benchmark_value_size, 100,
+             "Size of the string value of each row written in BootstrapTest.ReplayBenchmark.");
+
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -75,6 +84,7 @@ using log::ReadableLogSegment;
 using server::Clock;
 using server::LogicalClock;
 using tserver::WriteRequestPB;
+using namespace yb::size_literals;
 
 class BootstrapTest : public LogTestBase {
  protected:
@@ -335,5 +345,52 @@ TEST_F(BootstrapTest, TestConsensusOnlyOperationOutOfOrderHybridTime) {
   ASSERT_EQ(1, results.size());
 }
 
+// Replays a synthetic WAL spanning several segments and reports the time it took for the tablet to
+// become ready.
+TEST_F(BootstrapTest, ReplayBenchmark) {
+  options_.segment_size_bytes = 1_MB;
+  BuildLog();
+
+  const std::string value(FLAGS_bootstrap_benchmark_value_size, 'x');
+  for (int i = 0; i != FLAGS_bootstrap_benchmark_num_ops; ++i) {
+    std::vector<TupleForAppend> writes;
+    for (int j = 0; j != FLAGS_bootstrap_benchmark_rows_per_op; ++j) {
+      writes.emplace_back(i * FLAGS_bootstrap_benchmark_rows_per_op + j, i, value);
+    }
+    const auto op_id = MakeOpId(1, current_index_++);
+    AppendReplicateBatch(op_id, op_id, std::move(writes), APPEND_ASYNC);
+  }
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  vector<string> files;
+  ASSERT_OK(env_->GetChildren(tablet_wal_path_, &files));
+  uint64_t wal_size = 0;
+  int num_segments = 0;
+  for (const auto& file : files) {
+    if (HasPrefixString(file, FsManager::kWalFileNamePrefix)) {
+      uint64_t file_size = 0;
+      ASSERT_OK(env_->GetFileSize(JoinPathSegments(tablet_wal_path_, file), &file_size));
+      wal_size += file_size;
+      ++num_segments;
+    }
+  }
+  ASSERT_GT(num_segments, 1);
+
+  shared_ptr<TabletClass> tablet;
+  ConsensusBootstrapInfo boot_info;
+  const auto start = MonoTime::Now();
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  const auto elapsed = MonoTime::Now() - start;
+  LOG(INFO) << Format("Replayed $0 operations, $1 bytes in $2 segments, ready in $3 seconds",
+                      FLAGS_bootstrap_benchmark_num_ops, wal_size, num_segments,
+                      elapsed.ToSeconds());
+
+  ASSERT_EQ(boot_info.orphaned_replicates.size(), 0);
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(FLAGS_bootstrap_benchmark_num_ops * FLAGS_bootstrap_benchmark_rows_per_op,
+            results.size());
+}
+
 } // namespace tablet
 } // namespace yb
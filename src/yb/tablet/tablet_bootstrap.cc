@@ -31,13 +31,17 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <algorithm>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/docdb/docdb.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -46,6 +50,7 @@
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/thread.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -55,6 +60,16 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_bool(tablet_bootstrap_prefetch_log_segments, true,
+            "Read and decode the next WAL segment on a separate thread while the current one is "
+            "being replayed during tablet bootstrap.");
+TAG_FLAG(tablet_bootstrap_prefetch_log_segments, advanced);
+
+DEFINE_int32(tablet_bootstrap_max_batched_writes, 64,
+             "Maximum number of consecutive non-transactional write operations combined into a "
+             "single RocksDB write batch during tablet bootstrap. 1 disables batching.");
+TAG_FLAG(tablet_bootstrap_max_batched_writes, advanced);
+
 DECLARE_uint64(max_clock_sync_error_usec);
 
 namespace yb {
@@ -100,6 +115,58 @@ static string DebugInfo(const string& tablet_id,
                     segment_path, debug_str);
 }
 
+// ============================================================================
+//  Class SegmentPrefetcher.
+// ============================================================================
+// Reads all entries of a log segment on a separate thread, so that reading and decoding of the next
+// segment overlaps with the replay of the current one. Only one segment is read ahead, which bounds
+// the memory used by replay to two decoded segments.
+class SegmentPrefetcher {
+ public:
+  explicit SegmentPrefetcher(std::string tablet_id) : tablet_id_(std::move(tablet_id)) {}
+
+  ~SegmentPrefetcher() {
+    Join();
+  }
+
+  CHECKED_STATUS Start(const scoped_refptr<ReadableLogSegment>& segment) {
+    DCHECK(!thread_);
+    segment_ = segment;
+    entries_.clear();
+    read_status_ = Status::OK();
+    return Thread::Create("tablet-bootstrap", Format("read-log-$0", tablet_id_),
+                          &SegmentPrefetcher::Read, this, &thread_);
+  }
+
+  // Waits for the read started by the last Start call and moves its result to 'entries'.
+  // Returns the status of the read, the entries read before an error are still returned.
+  Status Wait(log::LogEntries* entries) {
+    Join();
+    *entries = std::move(entries_);
+    entries_.clear();
+    segment_.reset();
+    return read_status_;
+  }
+
+ private:
+  void Read() {
+    read_status_ = segment_->ReadEntries(&entries_);
+  }
+
+  void Join() {
+    if (thread_) {
+      CHECK_OK(ThreadJoiner(thread_.get()).Join());
+      thread_.reset();
+    }
+  }
+
+  const std::string tablet_id_;
+  scoped_refptr<ReadableLogSegment> segment_;
+  log::LogEntries entries_;
+  Status read_status_;
+  scoped_refptr<Thread> thread_;
+};
+
 // ============================================================================
 //  Class ReplayState.
 // ============================================================================
@@ -256,7 +323,8 @@ TabletBootstrap::TabletBootstrap(const BootstrapTabletData& data)
       listener_(data.listener),
       log_anchor_registry_(data.log_anchor_registry),
       tablet_options_(data.tablet_options),
-      append_pool_(data.append_pool) {
+      append_pool_(data.append_pool),
+      log_group_committer_(data.log_group_committer) {
 }
 
 TabletBootstrap::~TabletBootstrap() {}
@@ -313,7 +381,21 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
   // If there were blocks, there must be segments to replay. This is required by Raft, since we
   // always need to know the term and index of the last logged op in order to vote, know how to
   // respond to AppendEntries(), etc.
+  // The only exception is a tablet created by a split: it starts with a copy of the split tablet's
+  // data, whose op ids were reset by Tablet::CreateSplitCheckpoint, and a new log.
   if (has_blocks && !needs_recovery) {
+    auto flushed_op_ids = VERIFY_RESULT(tablet_->MaxPersistentOpIds());
+    if (flushed_op_ids.regular.empty() && flushed_op_ids.intents.empty()) {
+      LOG_WITH_PREFIX(INFO) << "Found data of a split tablet and no log segments. "
+                            << "Creating new log.";
+      RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
+      RETURN_NOT_OK(FinishBootstrap("No bootstrap required, opened a new log",
+                                    rebuilt_log,
+                                    rebuilt_tablet));
+      consensus_info->last_id = MinimumOpId();
+      consensus_info->last_committed_id = MinimumOpId();
+      return Status::OK();
+    }
     return STATUS(IllegalState, Substitute("Tablet $0: Found rowsets but no log "
                                            "segments could be found.",
                                            tablet_id));
@@ -474,7 +556,9 @@ Status TabletBootstrap::OpenNewLog() {
   OpId init;
   init.set_term(0);
   init.set_index(0);
-  RETURN_NOT_OK(Log::Open(LogOptions(),
+  LogOptions log_options;
+  log_options.group_committer = log_group_committer_;
+  RETURN_NOT_OK(Log::Open(log_options,
                           tablet_->metadata()->fs_manager(),
                           tablet_->tablet_id(),
                           tablet_->metadata()->wal_dir(),
@@ -552,6 +636,13 @@ Status TabletBootstrap::HandleReplicateMessage(ReplayState* state,
     // safe time based on it in the end. We do require that we keep at least one committed entry
     // in the log, though.
     state->rocksdb_last_entry_hybrid_time = HybridTime(replicate.hybrid_time());
+  } else if (yb::OpId::FromPB(op_id) == regular_stored_op_id_ ||
+             yb::OpId::FromPB(op_id) == intents_stored_op_id_) {
+    // Regular and intents RocksDB could be flushed up to different op ids. Operation persisted in
+    // one of them is known to be committed, including its term, so it is safe to bump committed
+    // op id to it and to use its hybrid time for the MVCC safe time.
+    state->UpdateCommittedOpId(replicate.id());
+    state->rocksdb_last_entry_hybrid_time = HybridTime(replicate.hybrid_time());
   }
 
   // Append the replicate message to the log as is
@@ -599,6 +690,11 @@ Status TabletBootstrap::HandleReplicateMessage(ReplayState* state,
 
 Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
                                         ReplicateMsg* replicate) {
+  if (op_type != consensus::WRITE_OP) {
+    // Operations other than writes could depend on the preceding writes being applied.
+    FlushPendingWrites();
+  }
+
   switch (op_type) {
     case consensus::WRITE_OP:
       PlayWriteRequest(replicate);
@@ -613,6 +709,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::TRUNCATE_OP:
       return PlayTruncateRequest(replicate);
 
+    case consensus::SPLIT_OP:
+      return PlaySplitRequest(replicate);
+
     case consensus::NO_OP:
       return PlayNoOpRequest(replicate);
 
@@ -674,15 +773,19 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
 
 Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   auto persistent_op_id = MinimumOpId();
-  Result<yb::OpId> flushed_op_id = tablet_->MaxPersistentOpId();
-  RETURN_NOT_OK(flushed_op_id);
-
-  persistent_op_id.set_term(flushed_op_id.get_ptr()->term);
-  persistent_op_id.set_index(flushed_op_id.get_ptr()->index);
+  const auto flushed_op_ids = VERIFY_RESULT(tablet_->MaxPersistentOpIds());
+  regular_stored_op_id_ = flushed_op_ids.regular;
+  intents_stored_op_id_ = flushed_op_ids.intents;
+  auto flushed_op_id = flushed_op_ids.regular;
+  flushed_op_id.MakeAtMost(flushed_op_ids.intents);
+
+  persistent_op_id.set_term(flushed_op_id.term);
+  persistent_op_id.set_index(flushed_op_id.index);
   ReplayState state(persistent_op_id);
 
   LOG_WITH_PREFIX(INFO) << "Max persistent index in RocksDB's SSTables before bootstrap: "
-                        << state.last_stored_op_id.ShortDebugString();
+                        << state.last_stored_op_id.ShortDebugString() << ", per RocksDB: "
+                        << flushed_op_ids.ToString();
 
   log::SegmentSequence segments;
   RETURN_NOT_OK(log_reader_->GetSegmentsSnapshot(&segments));
@@ -691,11 +794,24 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  SegmentPrefetcher prefetcher(tablet_->tablet_id());
+  bool prefetching = false;
   int segment_count = 0;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
+  for (size_t segment_idx = 0; segment_idx != segments.size(); ++segment_idx) {
+    const scoped_refptr<ReadableLogSegment>& segment = segments[segment_idx];
     log::LogEntries entries;
     // TODO: Optimize this to not read the whole thing into memory?
-    Status read_status = segment->ReadEntries(&entries);
+    Status read_status = prefetching ? prefetcher.Wait(&entries) : segment->ReadEntries(&entries);
+    prefetching = false;
+    if (FLAGS_tablet_bootstrap_prefetch_log_segments && read_status.ok() &&
+        segment_idx + 1 != segments.size()) {
+      const auto prefetch_status = prefetcher.Start(segments[segment_idx + 1]);
+      if (prefetch_status.ok()) {
+        prefetching = true;
+      } else {
+        LOG_WITH_PREFIX(WARNING) << "Failed to start reading next log segment: " << prefetch_status;
+      }
+    }
     for (int entry_idx = 0; entry_idx < entries.size(); ++entry_idx) {
       Status s = HandleEntry(&state, &entries[entry_idx]);
       if (!s.ok()) {
@@ -732,6 +848,8 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     segment_count++;
   }
 
+  FlushPendingWrites();
+
   LOG(INFO) << "Dumping replay state to log at the end of " << __FUNCTION__;
   DumpReplayStateToLog(state);
 
@@ -764,10 +882,43 @@ void TabletBootstrap::PlayWriteRequest(ReplicateMsg* replicate_msg) {
 
   DCHECK(write->has_write_batch());
 
+  // Transactional writes go to the intents RocksDB and other writes to the regular one, so the
+  // write could be already persisted even though it is after the minimal persisted op id.
+  const auto& stored_op_id = write->write_batch().has_transaction() ? intents_stored_op_id_
+                                                                      : regular_stored_op_id_;
+  if (replicate_msg->id().index() <= stored_op_id.index) {
+    return;
+  }
+
   WriteOperationState operation_state(nullptr, write, nullptr);
   operation_state.mutable_op_id()->CopyFrom(replicate_msg->id());
   operation_state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
 
+  if (!write->write_batch().has_transaction() && FLAGS_tablet_bootstrap_max_batched_writes > 1) {
+    // Consecutive non-transactional writes are combined into one RocksDB write batch. Each of them
+    // is encoded with its own hybrid time, so the result is the same as applying them one by one.
+    tablet_->StartOperation(&operation_state);
+    const auto hybrid_time = operation_state.hybrid_time();
+    docdb::PrepareNonTransactionWriteBatch(
+        write->write_batch(), hybrid_time, &pending_writes_.batch);
+
+    const yb::OpId op_id(replicate_msg->id().term(), replicate_msg->id().index());
+    if (pending_writes_.hybrid_times.empty()) {
+      pending_writes_.frontiers.Smallest().set_op_id(op_id);
+    }
+    pending_writes_.frontiers.Largest().set_op_id(op_id);
+    pending_writes_.last_op_index = op_id.index;
+    pending_writes_.hybrid_times.push_back(hybrid_time);
+    if (pending_writes_.hybrid_times.size() >=
+            static_cast<size_t>(FLAGS_tablet_bootstrap_max_batched_writes)) {
+      FlushPendingWrites();
+    }
+    return;
+  }
+
+  // Transactional writes go to the intents RocksDB and should follow the preceding regular writes.
+  FlushPendingWrites();
+
   tablet_->StartOperation(&operation_state);
 
   // Use committed OpId for mem store anchoring.
@@ -778,6 +929,30 @@ void TabletBootstrap::PlayWriteRequest(ReplicateMsg* replicate_msg) {
   tablet_->mvcc_manager()->Replicated(operation_state.hybrid_time());
 }
 
+void TabletBootstrap::FlushPendingWrites() {
+  auto& hybrid_times = pending_writes_.hybrid_times;
+  if (hybrid_times.empty()) {
+    return;
+  }
+
+  // Hybrid times of entries in the log are not guaranteed to be monotonic, so frontiers are set
+  // to the min and max of them.
+  const auto minmax = std::minmax_element(hybrid_times.begin(), hybrid_times.end());
+  pending_writes_.frontiers.Smallest().set_hybrid_time(*minmax.first);
+  pending_writes_.frontiers.Largest().set_hybrid_time(*minmax.second);
+  tablet_->ApplyReplayedWriteBatch(
+      pending_writes_.frontiers, pending_writes_.last_op_index, *minmax.second,
+      &pending_writes_.batch);
+
+  // Operations were added to MVCC in log order, so they are marked as replicated in the same order.
+  for (const auto& hybrid_time : hybrid_times) {
+    tablet_->mvcc_manager()->Replicated(hybrid_time);
+  }
+
+  pending_writes_.batch.Clear();
+  hybrid_times.clear();
+}
+
 Status TabletBootstrap::PlayAlterSchemaRequest(ReplicateMsg* replicate_msg) {
   AlterSchemaRequestPB* alter_schema = replicate_msg->mutable_alter_schema_request();
 
@@ -841,6 +1016,21 @@ Status TabletBootstrap::PlayTruncateRequest(ReplicateMsg* replicate_msg) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlaySplitRequest(ReplicateMsg* replicate_msg) {
+  // The split is the last operation of the tablet, it does not accept operations after it.
+  tablet_->SetSplit(true);
+
+  if (data_.tablet_splitter == nullptr) {
+    return Status::OK();
+  }
+  // Usually the new tablets were created before the restart, in that case this is a no-op.
+  SplitOperationState operation_state(
+      tablet_.get(), data_.tablet_splitter, replicate_msg->mutable_split_request());
+  WARN_NOT_OK(data_.tablet_splitter->ApplyTabletSplit(&operation_state),
+              "Failed to create the new tablets of a split tablet");
+  return Status::OK();
+}
+
 Status TabletBootstrap::PlayUpdateTransactionRequest(ReplicateMsg* replicate_msg) {
   DCHECK(replicate_msg->has_hybrid_time());
 
@@ -32,10 +32,14 @@
 #ifndef YB_TABLET_TABLET_BOOTSTRAP_H
 #define YB_TABLET_TABLET_BOOTSTRAP_H
 
+#include "yb/rocksdb/write_batch.h"
+
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/util/opid.h"
 #include "yb/util/threadpool.h"
 
 namespace yb {
@@ -111,6 +115,10 @@ class TabletBootstrap {
 
   void PlayWriteRequest(consensus::ReplicateMsg* replicate_msg);
 
+  // Applies the non-transactional writes accumulated by PlayWriteRequest to RocksDB as a single
+  // write batch and marks them as replicated in MVCC.
+  void FlushPendingWrites();
+
   CHECKED_STATUS PlayUpdateTransactionRequest(consensus::ReplicateMsg* replicate_msg);
 
   CHECKED_STATUS PlayAlterSchemaRequest(consensus::ReplicateMsg* replicate_msg);
@@ -121,6 +129,8 @@ class TabletBootstrap {
 
   CHECKED_STATUS PlayTruncateRequest(consensus::ReplicateMsg* replicate_msg);
 
+  CHECKED_STATUS PlaySplitRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog(const ReplayState& state);
 
   // Handlers for each type of message seen in the log during replay.
@@ -157,6 +167,9 @@ class TabletBootstrap {
   // Thread pool for append task for bootstrap.
   ThreadPool* append_pool_;
 
+  // Tablet server wide group commit stage for the new log, null if disabled.
+  log::LogGroupCommitter* log_group_committer_;
+
   // Statistics on the replay of entries in the log.
   struct Stats {
     Stats()
@@ -183,6 +196,21 @@ class TabletBootstrap {
 
   HybridTime rocksdb_last_entry_hybrid_time_ = HybridTime::kMin;
 
+  // Op ids persisted in the regular and intents RocksDB before bootstrap. Log is replayed starting
+  // from the minimum of them, and writes already persisted in their RocksDB are skipped.
+  yb::OpId regular_stored_op_id_;
+  yb::OpId intents_stored_op_id_;
+
+  // Non-transactional writes of consecutive WRITE_OP entries that were started in MVCC, but not
+  // yet written to RocksDB. Flushed before any other operation is played, so the order of
+  // operations observed by RocksDB and MVCC is the same as in the log.
+  struct PendingWrites {
+    rocksdb::WriteBatch batch;
+    docdb::ConsensusFrontiers frontiers;
+    int64_t last_op_index = 0;
+    std::vector<HybridTime> hybrid_times;
+  } pending_writes_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(TabletBootstrap);
 };
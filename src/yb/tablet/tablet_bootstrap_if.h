@@ -61,6 +61,7 @@ class PartitionSchema;
 namespace log {
 class Log;
 class LogAnchorRegistry;
+class LogGroupCommitter;
 }
 
 namespace consensus {
@@ -121,6 +122,9 @@ struct BootstrapTabletData {
   TransactionParticipantContext* transaction_participant_context;
   TransactionCoordinatorContext* transaction_coordinator_context;
   ThreadPool* append_pool;
+  log::LogGroupCommitter* log_group_committer = nullptr;
+  // Creates the new tablets when a split operation is replayed.
+  TabletSplitter* tablet_splitter = nullptr;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
@@ -21,6 +21,7 @@ namespace tablet {
 class AbstractTablet;
 class TabletMetadata;
 class TabletPeer;
+class TabletSplitter;
 class TabletStatusPB;
 class TabletStatusListener;
 class WriteOperationState;
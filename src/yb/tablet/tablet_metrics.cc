@@ -74,6 +74,25 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, write_conflict_resolution_latency, "Write conflict resolution latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to resolve conflicts of a write operation with other transactions", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_prepare_queue_latency, "Write prepare queue latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time a write operation waited in the prepare queue before being prepared", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_replication_latency, "Write replication latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to replicate a write operation to a majority, including the local log append and "
+    "sync", 60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_apply_latency, "Write apply latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to apply a replicated write operation to RocksDB", 60000000LU, 2);
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -120,6 +139,10 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(write_conflict_resolution_latency),
+    MINIT(write_prepare_queue_latency),
+    MINIT(write_replication_latency),
+    MINIT(write_apply_latency),
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(leader_memory_pressure_rejections) {
 }
@@ -57,6 +57,11 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  // Write path stages, see WriteOperationState::StageLatencies.
+  scoped_refptr<Histogram> write_conflict_resolution_latency;
+  scoped_refptr<Histogram> write_prepare_queue_latency;
+  scoped_refptr<Histogram> write_replication_latency;
+  scoped_refptr<Histogram> write_apply_latency;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
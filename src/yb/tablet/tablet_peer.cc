@@ -38,6 +38,7 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
 #include <gflags/gflags.h>
 
 #include "yb/consensus/consensus.h"
@@ -68,6 +69,7 @@
 
 #include "yb/tablet/operations/alter_schema_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -132,15 +134,19 @@ TabletPeer::TabletPeer(
     const scoped_refptr<TabletMetadata>& meta,
     const consensus::RaftPeerPB& local_peer_pb,
     ThreadPool* apply_pool,
-    Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk)
+    Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
+    TabletSplitter* tablet_splitter,
+    ThreadPool* conflict_wait_pool)
   : meta_(meta),
     tablet_id_(meta->tablet_id()),
     local_peer_pb_(local_peer_pb),
     state_(TabletStatePB::NOT_STARTED),
     status_listener_(new TabletStatusListener(meta)),
     apply_pool_(apply_pool),
+    conflict_wait_pool_(conflict_wait_pool),
     log_anchor_registry_(new LogAnchorRegistry()),
-    mark_dirty_clbk_(std::move(mark_dirty_clbk)) {}
+    mark_dirty_clbk_(std::move(mark_dirty_clbk)),
+    tablet_splitter_(tablet_splitter) {}
 
 TabletPeer::~TabletPeer() {
   std::lock_guard<simple_spinlock> lock(lock_);
@@ -247,7 +253,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       }
     });
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetMetricEntity());
   }
 
   RETURN_NOT_OK(prepare_thread_->Start());
@@ -411,33 +418,154 @@ Status TabletPeer::WaitUntilConsensusRunning(const MonoDelta& timeout) {
   return Status::OK();
 }
 
+class TabletPeer::ScopedSubmittingOperation {
+ public:
+  explicit ScopedSubmittingOperation(TabletPeer* tablet_peer) : tablet_peer_(tablet_peer) {
+    ++tablet_peer_->num_submitting_operations_;
+  }
+
+  ~ScopedSubmittingOperation() {
+    // StartSplit sets the split flag before it checks the counter, so it is woken up by the last
+    // operation that finishes submitting after that.
+    if (--tablet_peer_->num_submitting_operations_ == 0 && tablet_peer_->tablet_->IsSplit()) {
+      std::lock_guard<std::mutex> lock(tablet_peer_->submitting_mutex_);
+      tablet_peer_->no_submitting_operations_cond_.notify_all();
+    }
+  }
+
+ private:
+  TabletPeer* tablet_peer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedSubmittingOperation);
+};
+
+Status TabletPeer::StartSplit(const MonoDelta& timeout) {
+  RETURN_NOT_OK(CheckRunning());
+  if (tablet_->IsSplit()) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is already being split", tablet_id_);
+  }
+  tablet_->SetSplit(true);
+
+  // The split flag is checked after the submitting counter is incremented, so once the counter
+  // drops to zero every operation is either rejected or registered in the operation tracker.
+  const MonoTime deadline = MonoTime::Now() + timeout;
+  {
+    std::unique_lock<std::mutex> lock(submitting_mutex_);
+    const bool submitted = no_submitting_operations_cond_.wait_until(
+        lock, deadline.ToSteadyTimePoint(), [this] {
+          return num_submitting_operations_.load() == 0;
+        });
+    if (!submitted) {
+      lock.unlock();
+      AbortSplit();
+      return STATUS_FORMAT(
+          TimedOut, "Timed out waiting for operations of tablet $0 to be submitted", tablet_id_);
+    }
+  }
+
+  Status status = operation_tracker_.WaitForAllToFinish(deadline - MonoTime::Now());
+  if (status.ok()) {
+    status = tablet_->CheckNoPendingIntents();
+  }
+  if (!status.ok()) {
+    AbortSplit();
+  }
+  return status;
+}
+
+void TabletPeer::AbortSplit() {
+  tablet_->SetSplit(false);
+}
+
+bool TabletPeer::IsSplit() const {
+  auto tablet = shared_tablet();
+  return tablet && tablet->IsSplit();
+}
+
 Status TabletPeer::SubmitWrite(std::unique_ptr<WriteOperationState> state) {
   auto operation = std::make_unique<WriteOperation>(std::move(state), consensus::LEADER);
   RETURN_NOT_OK(CheckRunning());
 
-  HybridTime restart_read_ht;
-  RETURN_NOT_OK(tablet_->AcquireLocksAndPerformDocOperations(operation->state(), &restart_read_ht));
-  // If a restart read is required, then we return this fact to caller and don't perform the write
-  // operation.
-  if (restart_read_ht.is_valid()) {
-    auto restart_time = operation->state()->response()->mutable_restart_read_time();
+  {
+    ScopedSubmittingOperation submitting(this);
+    if (tablet_->IsSplit()) {
+      return STATUS_FORMAT(IllegalState, "Tablet $0 was split", tablet_id_);
+    }
+  }
+
+  // Preparing the doc operations could wait for conflicting transactions, so the operation is
+  // owned by the callback until it is prepared.
+  auto* operation_state = operation->state();
+  auto holder = std::make_shared<std::unique_ptr<Operation>>(std::move(operation));
+  tablet_->AcquireLocksAndPerformDocOperations(
+      operation_state,
+      [peer = scoped_refptr<TabletPeer>(this), holder](
+          const Status& status, HybridTime restart_read_ht) {
+        peer->WriteOperationPrepared(std::move(*holder), status, restart_read_ht);
+      });
+  return Status::OK();
+}
+
+void TabletPeer::WriteOperationPrepared(
+    std::unique_ptr<Operation> operation, Status status, HybridTime restart_read_ht) {
+  if (status.ok() && restart_read_ht.is_valid()) {
+    // If a restart read is required, then we return this fact to caller and don't perform the
+    // write operation.
+    auto restart_time =
+        down_cast<WriteOperationState*>(operation->state())->response()
+            ->mutable_restart_read_time();
     restart_time->set_read_ht(restart_read_ht.ToUint64());
     restart_time->set_local_limit_ht(
         tablet_->SafeTime(RequireLease::kTrue).ToUint64());
     // Global limit is ignored by caller, so we don't set it.
     operation->state()->completion_callback()->OperationCompleted();
-    return Status::OK();
+    return;
+  }
+
+  // The split could be started while the operation was prepared.
+  boost::optional<ScopedSubmittingOperation> submitting;
+  if (status.ok()) {
+    status = CheckRunning();
+  }
+  if (status.ok()) {
+    submitting.emplace(this);
+    if (tablet_->IsSplit()) {
+      status = STATUS_FORMAT(IllegalState, "Tablet $0 was split", tablet_id_);
+    }
+  }
+  if (status.ok()) {
+    auto driver = NewLeaderOperationDriver(&operation);
+    if (driver.ok()) {
+      (**driver).ExecuteAsync();
+    } else {
+      status = driver.status();
+    }
+  }
+  if (!status.ok()) {
+    auto* completion_callback = operation->state()->completion_callback();
+    if (tablet_->IsSplit()) {
+      completion_callback->set_error(status, TabletServerErrorPB::TABLET_SPLIT);
+      completion_callback->OperationCompleted();
+    } else {
+      completion_callback->CompleteWithStatus(status);
+    }
   }
-  auto driver = VERIFY_RESULT(NewLeaderOperationDriver(std::move(operation)));
-  driver->ExecuteAsync();
-  return Status::OK();
 }
 
 void TabletPeer::Submit(std::unique_ptr<Operation> operation) {
   auto status = CheckRunning();
 
+  // The split operation itself is submitted after the tablet stopped accepting operations.
+  const bool is_split_operation = operation->operation_type() == OperationType::kSplit;
+  boost::optional<ScopedSubmittingOperation> submitting;
+  if (status.ok()) {
+    submitting.emplace(this);
+    if (tablet_->IsSplit() && !is_split_operation) {
+      status = STATUS_FORMAT(IllegalState, "Tablet $0 was split", tablet_id_);
+    }
+  }
   if (status.ok()) {
-    auto driver = NewLeaderOperationDriver(std::move(operation));
+    auto driver = NewLeaderOperationDriver(&operation);
     if (driver.ok()) {
       (**driver).ExecuteAsync();
     } else {
@@ -445,6 +573,9 @@ void TabletPeer::Submit(std::unique_ptr<Operation> operation) {
     }
   }
   if (!status.ok()) {
+    if (is_split_operation && tablet_) {
+      AbortSplit();
+    }
     operation->state()->completion_callback()->CompleteWithStatus(status);
   }
 }
@@ -461,6 +592,13 @@ void TabletPeer::UpdateClock(HybridTime hybrid_time) {
   clock_->Update(hybrid_time);
 }
 
+Status TabletPeer::SubmitConflictWaitContinuation(std::function<void()> func) {
+  if (!conflict_wait_pool_) {
+    return STATUS(NotSupported, "Conflict wait is not supported by this tablet");
+  }
+  return conflict_wait_pool_->SubmitFunc(std::move(func));
+}
+
 std::unique_ptr<UpdateTxnOperationState> TabletPeer::CreateUpdateTransactionState(
     tserver::TransactionStatePB* request) {
   auto result = std::make_unique<UpdateTxnOperationState>(tablet());
@@ -528,6 +666,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kTruncate:
       return consensus::TRUNCATE_OP;
 
+    case OperationType::kSplit:
+      return consensus::SPLIT_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -669,6 +810,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<TruncateOperation>(
           std::make_unique<TruncateOperationState>(tablet()), consensus::REPLICA);
 
+    case consensus::SPLIT_OP:
+      DCHECK(replicate_msg->has_split_request()) << "SPLIT_OP replica"
+          " operation must receive a SplitTabletRequestPB";
+      return std::make_unique<SplitOperation>(
+          std::make_unique<SplitOperationState>(tablet(), tablet_splitter_), consensus::REPLICA);
+
     case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
@@ -687,6 +834,11 @@ Status TabletPeer::StartReplicaOperation(
 
   consensus::ReplicateMsg* replicate_msg = round->replicate_msg().get();
   DCHECK(replicate_msg->has_hybrid_time());
+  if (replicate_msg->op_type() == consensus::SPLIT_OP) {
+    // Stop accepting operations before acknowledging the split, so that if this peer becomes the
+    // leader it does not accept writes that would be applied after the split.
+    tablet_->SetSplit(true);
+  }
   auto operation = CreateOperation(replicate_msg);
 
   // TODO(todd) Look at wiring the stuff below on the driver
@@ -701,7 +853,7 @@ Status TabletPeer::StartReplicaOperation(
   // This sets the monotonic counter to at least replicate_msg.monotonic_counter() atomically.
   tablet_->UpdateMonotonicCounter(replicate_msg->monotonic_counter());
 
-  OperationDriverPtr driver = VERIFY_RESULT(NewReplicaOperationDriver(std::move(operation)));
+  OperationDriverPtr driver = VERIFY_RESULT(NewReplicaOperationDriver(&operation));
 
   // Unretained is required to avoid a refcount cycle.
   state->consensus_round()->SetConsensusReplicatedCallback(
@@ -715,7 +867,8 @@ Status TabletPeer::StartReplicaOperation(
 }
 
 void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
-  auto driver = NewReplicaOperationDriver(nullptr);
+  std::unique_ptr<Operation> operation;
+  auto driver = NewReplicaOperationDriver(&operation);
   if (!driver.ok()) {
     LOG(ERROR) << "Failed to create operation driver to set propagated hybrid time";
     return;
@@ -752,19 +905,19 @@ shared_ptr<consensus::Consensus> TabletPeer::shared_consensus() const {
 }
 
 Result<OperationDriverPtr> TabletPeer::NewLeaderOperationDriver(
-    std::unique_ptr<Operation> operation) {
-  return NewOperationDriver(std::move(operation), consensus::LEADER);
+    std::unique_ptr<Operation>* operation) {
+  return NewOperationDriver(operation, consensus::LEADER);
 }
 
 Result<OperationDriverPtr> TabletPeer::NewReplicaOperationDriver(
-    std::unique_ptr<Operation> operation) {
-  return NewOperationDriver(std::move(operation), consensus::REPLICA);
+    std::unique_ptr<Operation>* operation) {
+  return NewOperationDriver(operation, consensus::REPLICA);
 }
 
-Result<OperationDriverPtr> TabletPeer::NewOperationDriver(std::unique_ptr<Operation> operation,
+Result<OperationDriverPtr> TabletPeer::NewOperationDriver(std::unique_ptr<Operation>* operation,
                                                           consensus::DriverType type) {
   auto operation_driver = CreateOperationDriver();
-  RETURN_NOT_OK(operation_driver->Init(std::move(operation), type));
+  RETURN_NOT_OK(operation_driver->Init(operation, type));
   return operation_driver;
 }
 
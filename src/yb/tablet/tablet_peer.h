@@ -34,6 +34,7 @@
 #define YB_TABLET_TABLET_PEER_H_
 
 #include <atomic>
+#include <condition_variable>
 #include <future>
 #include <map>
 #include <memory>
@@ -97,7 +98,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
 
   TabletPeer(const scoped_refptr<TabletMetadata>& meta,
              const consensus::RaftPeerPB& local_peer_pb, ThreadPool* apply_pool,
-             Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk);
+             Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
+             TabletSplitter* tablet_splitter = nullptr,
+             ThreadPool* conflict_wait_pool = nullptr);
 
   // Initializes the TabletPeer, namely creating the Log and initializing
   // Consensus.
@@ -134,14 +137,28 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // to the RPC WriteRequest, WriteResponse, RpcContext and to the tablet's
   // MvccManager.
   // The operation_state is deallocated after use by this function.
+  // Failures that happen after the key-value batch preparation has started are reported to the
+  // completion callback of the operation.
   CHECKED_STATUS SubmitWrite(std::unique_ptr<WriteOperationState> operation_state);
 
   void Submit(std::unique_ptr<Operation> operation);
 
+  // Stops accepting new operations and waits for the operations in flight to finish, so the split
+  // operation could be submitted as the last operation of the tablet. Operations submitted after
+  // that fail, and clients are expected to retry them on the new tablets.
+  CHECKED_STATUS StartSplit(const MonoDelta& timeout);
+
+  // Accepts operations again after a split that could not be submitted.
+  void AbortSplit();
+
+  bool IsSplit() const;
+
   HybridTime Now() override;
 
   void UpdateClock(HybridTime hybrid_time) override;
 
+  CHECKED_STATUS SubmitConflictWaitContinuation(std::function<void()> func) override;
+
   std::unique_ptr<UpdateTxnOperationState> CreateUpdateTransactionState(
       tserver::TransactionStatePB* request) override;
 
@@ -274,11 +291,12 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // Convenience method to return the permanent_uuid of this peer.
   const std::string& permanent_uuid() const;
 
-  Result<OperationDriverPtr> NewOperationDriver(std::unique_ptr<Operation> operation,
+  // On failure the operation is left in the operation argument, see OperationDriver::Init.
+  Result<OperationDriverPtr> NewOperationDriver(std::unique_ptr<Operation>* operation,
                                                 consensus::DriverType type);
 
-  Result<OperationDriverPtr> NewLeaderOperationDriver(std::unique_ptr<Operation> operation);
-  Result<OperationDriverPtr> NewReplicaOperationDriver(std::unique_ptr<Operation> operation);
+  Result<OperationDriverPtr> NewLeaderOperationDriver(std::unique_ptr<Operation>* operation);
+  Result<OperationDriverPtr> NewReplicaOperationDriver(std::unique_ptr<Operation>* operation);
 
   // Tells the tablet's log to garbage collect.
   CHECKED_STATUS RunLogGC();
@@ -339,6 +357,21 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   std::atomic<bool> has_consensus_ = {false};
 
   OperationTracker operation_tracker_;
+
+  class ScopedSubmittingOperation;
+
+  // Submits the write operation to Raft once its key-value batch is prepared, or completes it with
+  // the preparation failure.
+  void WriteOperationPrepared(
+      std::unique_ptr<Operation> operation, Status status, HybridTime restart_read_ht);
+
+  // Number of SubmitWrite/Submit calls in progress. An operation is registered in
+  // operation_tracker_ while the call is in progress, so StartSplit waits for this to drop to zero
+  // before waiting for the operation tracker.
+  std::atomic<int64_t> num_submitting_operations_{0};
+  std::mutex submitting_mutex_;
+  std::condition_variable no_submitting_operations_cond_;
+
   OperationOrderVerifier operation_order_verifier_;
   scoped_refptr<log::Log> log_;
   std::shared_ptr<TabletClass> tablet_;
@@ -366,6 +399,10 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // the Tablet server.
   ThreadPool* apply_pool_;
 
+  // Pool that continues conflict resolution of writes that waited for conflicting transactions.
+  // Null when the tablet does not have transactions, like the Master's system tablet.
+  ThreadPool* conflict_wait_pool_;
+
   scoped_refptr<server::Clock> clock_;
 
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
@@ -378,6 +415,9 @@ class TabletPeer : public RefCountedThreadSafe<TabletPeer>,
   // and defer any other heavy duty operations to a thread pool.
   Callback<void(std::shared_ptr<consensus::StateChangeContext> context)> mark_dirty_clbk_;
 
+  // Creates the new tablets when a split operation is applied.
+  TabletSplitter* const tablet_splitter_;
+
   // List of maintenance operations for the tablet that need information that only the peer
   // can provide.
   std::vector<MaintenanceOp*> maintenance_ops_;
@@ -15,7 +15,12 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -28,16 +33,20 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include "yb/client/client.h"
 #include "yb/client/transaction_rpc.h"
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
 
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 
 using namespace std::literals;
@@ -46,6 +55,47 @@ using namespace std::placeholders;
 DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
 
+DEFINE_bool(enable_transaction_status_batching, false,
+            "Whether status requests of running transactions with the same status tablet are "
+            "batched. When disabled, the status of every transaction is requested in a separate "
+            "RPC.");
+TAG_FLAG(enable_transaction_status_batching, runtime);
+TAG_FLAG(enable_transaction_status_batching, advanced);
+
+DEFINE_int32(transaction_status_max_batch_size, 500,
+             "Maximal number of transactions whose status is requested from the same status "
+             "tablet in a single RPC. Status requests issued while a request to the status tablet "
+             "is in flight are queued and sent together once it completes.");
+TAG_FLAG(transaction_status_max_batch_size, runtime);
+TAG_FLAG(transaction_status_max_batch_size, advanced);
+
+DECLARE_bool(enable_transaction_wait_queues);
+
+METRIC_DECLARE_entity(tablet);
+
+METRIC_DEFINE_histogram(
+    tablet, transaction_status_batch_size, "Transaction status batch size",
+    yb::MetricUnit::kTransactions,
+    "Number of transactions whose status is requested from a status tablet in one RPC",
+    10000, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, transaction_status_resolution_latency, "Transaction status resolution latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to resolve a batch of transaction statuses from a status tablet",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, transaction_conflict_wait_time, "Transaction conflict wait time",
+    yb::MetricUnit::kMicroseconds,
+    "Time spent by write operations waiting for completion of conflicting transactions",
+    60000000LU, 2);
+
+METRIC_DEFINE_counter(
+    tablet, transaction_deadlocks_detected, "Transaction deadlocks detected",
+    yb::MetricUnit::kTransactions,
+    "Number of waits for conflicting transactions rejected because they would form a deadlock");
+
 namespace yb {
 namespace tablet {
 
@@ -116,24 +166,128 @@ class Delayer {
   std::deque<std::pair<MonoTime, std::function<void()>>> queue_;
 };
 
+// Graph of transactions waiting for completion of other transactions.
+// It is shared by participants of all tablets of the process, so only cycles whose waits all happen
+// on tablets led by the same tablet server are detected. Other cycles are not detected, they are
+// broken by the wait deadline of conflict resolution.
+class WaitForGraph {
+ public:
+  static WaitForGraph& Instance() {
+    static WaitForGraph instance;
+    return instance;
+  }
+
+  // Adds edges from waiter to each of blockers, unless it would form a cycle.
+  // Returns false in the latter case.
+  bool AddWaiter(const TransactionId& waiter, const std::vector<TransactionId>& blockers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Reachable(blockers, waiter)) {
+      return false;
+    }
+    // The same transaction could wait in several tablets at once, so edges are counted.
+    auto& edges = edges_[waiter];
+    for (const auto& blocker : blockers) {
+      ++edges[blocker];
+    }
+    return true;
+  }
+
+  void RemoveWaiter(const TransactionId& waiter, const std::vector<TransactionId>& blockers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = edges_.find(waiter);
+    if (it == edges_.end()) {
+      LOG(DFATAL) << "Remove unknown waiter: " << waiter;
+      return;
+    }
+    for (const auto& blocker : blockers) {
+      auto edge = it->second.find(blocker);
+      if (edge != it->second.end() && --edge->second == 0) {
+        it->second.erase(edge);
+      }
+    }
+    if (it->second.empty()) {
+      edges_.erase(it);
+    }
+  }
+
+ private:
+  // Checks whether target is reachable from any of sources.
+  bool Reachable(const std::vector<TransactionId>& sources, const TransactionId& target) const {
+    std::unordered_set<TransactionId, TransactionIdHash> visited;
+    std::vector<TransactionId> queue(sources.begin(), sources.end());
+    while (!queue.empty()) {
+      auto current = queue.back();
+      queue.pop_back();
+      if (current == target) {
+        return true;
+      }
+      if (!visited.insert(current).second) {
+        continue;
+      }
+      auto it = edges_.find(current);
+      if (it != edges_.end()) {
+        for (const auto& edge : it->second) {
+          queue.push_back(edge.first);
+        }
+      }
+    }
+    return false;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<TransactionId,
+                     std::unordered_map<TransactionId, size_t, TransactionIdHash>,
+                     TransactionIdHash> edges_;
+};
+
+// Operation waiting for completion of conflicting transactions, see
+// TransactionStatusManager::WaitForTransactions.
+struct TransactionWaiter {
+  TransactionWaiter(const boost::optional<TransactionId>& id_,
+                    const std::vector<TransactionId>& blockers_,
+                    std::function<void(const Status&)> callback_)
+      : id(id_), blockers(blockers_), callback(std::move(callback_)) {}
+
+  const boost::optional<TransactionId> id;
+  const std::vector<TransactionId> blockers;
+  const MonoTime start = MonoTime::Now();
+  std::function<void(const Status&)> callback;
+  // Set once the waiter is notified, it is registered for each of blockers, and could also be
+  // notified by its deadline.
+  std::atomic<bool> notified{false};
+  // Task that notifies the waiter at its deadline.
+  std::atomic<rpc::ScheduledTaskId> timer_task_id{rpc::kUninitializedScheduledTaskId};
+};
+
+typedef std::shared_ptr<TransactionWaiter> TransactionWaiterPtr;
+
+// Sends status requests of running transactions to their status tablets. The response is
+// delivered to RunningTransaction::StatusReceived.
+class TransactionStatusRequester {
+ public:
+  virtual void RequestStatus(const TabletId& status_tablet, const TransactionId& id) = 0;
+
+ protected:
+  ~TransactionStatusRequester() {}
+};
+
 class RunningTransaction {
  public:
   RunningTransaction(TransactionMetadata metadata,
                      IntraTxnWriteId last_write_id,
                      rpc::Rpcs* rpcs,
                      TransactionParticipantContext* context,
-                     std::atomic<int64_t>* request_serial)
+                     TransactionStatusRequester* status_requester)
       : metadata_(std::move(metadata)),
         last_write_id_(last_write_id),
         rpcs_(*rpcs),
         context_(*context),
-        request_serial_(request_serial),
-        get_status_handle_(rpcs->InvalidHandle()),
+        status_requester_(*status_requester),
         abort_handle_(rpcs->InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -160,8 +314,7 @@ class RunningTransaction {
     local_commit_time_ = time;
   }
 
-  void RequestStatusAt(client::YBClient* client,
-                       const StatusRequest& request,
+  void RequestStatusAt(const StatusRequest& request,
                        std::unique_lock<std::mutex>* lock) const {
     if (last_known_status_hybrid_time_ > HybridTime::kMin) {
       auto transaction_status =
@@ -180,7 +333,7 @@ class RunningTransaction {
       return;
     }
     lock->unlock();
-    SendStatusRequest(client, lock->mutex());
+    SendStatusRequest();
   }
 
   void Abort(client::YBClient* client,
@@ -206,112 +359,49 @@ class RunningTransaction {
         &abort_handle_);
   }
 
- private:
-  static boost::optional<TransactionStatus> GetStatusAt(
-      HybridTime time,
-      HybridTime last_known_status_hybrid_time,
-      TransactionStatus last_known_status) {
-    switch (last_known_status) {
-      case TransactionStatus::ABORTED:
-        return TransactionStatus::ABORTED;
-      case TransactionStatus::COMMITTED:
-        return last_known_status_hybrid_time > time
-            ? TransactionStatus::PENDING
-            : TransactionStatus::COMMITTED;
-      case TransactionStatus::PENDING:
-        if (last_known_status_hybrid_time >= time) {
-          return TransactionStatus::PENDING;
-        }
-        return boost::none;
-      default:
-        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
-    }
-  }
-
-  void SendStatusRequest(client::YBClient* client, std::mutex* mutex) const {
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.Now().ToUint64());
-    int64_t serial_no = ++*request_serial_;
-    rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no, mutex)),
-        &get_status_handle_);
-  }
-
-  void StatusReceived(client::YBClient* client,
-                      const Status& status,
-                      const tserver::GetTransactionStatusResponsePB& response,
+  // Handles status of this transaction, received in response to a request sent with 'serial_no'.
+  // 'lock' should hold the participant mutex, it is released before notifying the waiters.
+  void StatusReceived(const Status& status,
+                      TransactionStatus response_status,
+                      HybridTime response_time,
                       int64_t serial_no,
-                      std::mutex* mutex) const {
-    auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
-    if (delay_usec > 0) {
-      delayer_.Delay(
-          MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
-          std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, mutex));
-    } else {
-      DoStatusReceived(client, status, response, serial_no, mutex);
-    }
-  }
-
-  void DoStatusReceived(client::YBClient* client,
-                        const Status& status,
-                        const tserver::GetTransactionStatusResponsePB& response,
-                        int64_t serial_no,
-                        std::mutex* mutex) const {
-    if (response.has_propagated_hybrid_time()) {
-      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    rpcs_.Unregister(&get_status_handle_);
+                      std::unique_lock<std::mutex>* lock) const {
     decltype(status_waiters_) status_waiters;
     HybridTime time;
     TransactionStatus transaction_status;
     const bool ok = status.ok();
-    bool send_new_request;
-    {
-      std::unique_lock<std::mutex> lock(*mutex);
-      if (ok) {
-        DCHECK(response.has_status_hybrid_time() ||
-               response.status() == TransactionStatus::ABORTED);
-        time = response.has_status_hybrid_time()
-            ? HybridTime(response.status_hybrid_time())
-            : HybridTime::kMax;
-        if (last_known_status_hybrid_time_ <= time) {
-          last_known_status_hybrid_time_ = time;
-          last_known_status_ = response.status();
-        }
-        time = last_known_status_hybrid_time_;
-        transaction_status = last_known_status_;
-
-        status_waiters.reserve(status_waiters_.size());
-        auto w = status_waiters_.begin();
-        for (auto it = status_waiters_.begin(); it != status_waiters_.end(); ++it) {
-          if (it->serial_no <= serial_no ||
-              GetStatusAt(it->global_limit_ht, time, transaction_status) ||
-              time < it->read_ht) {
-            status_waiters.push_back(std::move(*it));
-          } else {
-            if (w != it) {
-              *w = std::move(*it);
-            }
-            ++w;
+    if (ok) {
+      DCHECK(response_time.is_valid());
+      time = response_time;
+      if (last_known_status_hybrid_time_ <= time) {
+        last_known_status_hybrid_time_ = time;
+        last_known_status_ = response_status;
+      }
+      time = last_known_status_hybrid_time_;
+      transaction_status = last_known_status_;
+
+      status_waiters.reserve(status_waiters_.size());
+      auto w = status_waiters_.begin();
+      for (auto it = status_waiters_.begin(); it != status_waiters_.end(); ++it) {
+        if (it->serial_no <= serial_no ||
+            GetStatusAt(it->global_limit_ht, time, transaction_status) ||
+            time < it->read_ht) {
+          status_waiters.push_back(std::move(*it));
+        } else {
+          if (w != it) {
+            *w = std::move(*it);
           }
+          ++w;
         }
-        status_waiters_.erase(w, status_waiters_.end());
-      } else {
-        status_waiters_.swap(status_waiters);
       }
-      send_new_request = !status_waiters_.empty();
+      status_waiters_.erase(w, status_waiters_.end());
+    } else {
+      status_waiters_.swap(status_waiters);
     }
+    const bool send_new_request = !status_waiters_.empty();
+    lock->unlock();
     if (send_new_request) {
-      SendStatusRequest(client, mutex);
+      SendStatusRequest();
     }
     if (!ok) {
       for (const auto& waiter : status_waiters) {
@@ -343,6 +433,32 @@ class RunningTransaction {
     }
   }
 
+ private:
+  static boost::optional<TransactionStatus> GetStatusAt(
+      HybridTime time,
+      HybridTime last_known_status_hybrid_time,
+      TransactionStatus last_known_status) {
+    switch (last_known_status) {
+      case TransactionStatus::ABORTED:
+        return TransactionStatus::ABORTED;
+      case TransactionStatus::COMMITTED:
+        return last_known_status_hybrid_time > time
+            ? TransactionStatus::PENDING
+            : TransactionStatus::COMMITTED;
+      case TransactionStatus::PENDING:
+        if (last_known_status_hybrid_time >= time) {
+          return TransactionStatus::PENDING;
+        }
+        return boost::none;
+      default:
+        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
+    }
+  }
+
+  void SendStatusRequest() const {
+    status_requester_.RequestStatus(metadata_.status_tablet, metadata_.transaction_id);
+  }
+
   static Result<TransactionStatusResult> MakeAbortResult(
       const Status& status,
       const tserver::AbortTransactionResponsePB& response) {
@@ -379,30 +495,43 @@ class RunningTransaction {
   IntraTxnWriteId last_write_id_ = 0;
   rpc::Rpcs& rpcs_;
   TransactionParticipantContext& context_;
-  std::atomic<int64_t>* request_serial_;
+  TransactionStatusRequester& status_requester_;
   HybridTime local_commit_time_ = HybridTime::kInvalid;
 
   mutable TransactionStatus last_known_status_;
   mutable HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   mutable std::vector<StatusRequest> status_waiters_;
-  mutable rpc::Rpcs::Handle get_status_handle_;
   mutable rpc::Rpcs::Handle abort_handle_;
   mutable std::vector<TransactionStatusCallback> abort_waiters_;
-
-  // Used only in tests.
-  mutable Delayer delayer_;
 };
 
 } // namespace
 
-class TransactionParticipant::Impl {
+class TransactionParticipant::Impl : public TransactionStatusRequester {
  public:
-  explicit Impl(TransactionParticipantContext* context)
-      : context_(*context), log_prefix_(context->tablet_id() + ": ") {}
+  Impl(TransactionParticipantContext* context, const scoped_refptr<MetricEntity>& metric_entity)
+      : context_(*context), log_prefix_(context->tablet_id() + ": ") {
+    if (metric_entity) {
+      status_batch_size_ = METRIC_transaction_status_batch_size.Instantiate(metric_entity);
+      status_resolution_latency_ =
+          METRIC_transaction_status_resolution_latency.Instantiate(metric_entity);
+      conflict_wait_time_ = METRIC_transaction_conflict_wait_time.Instantiate(metric_entity);
+      deadlocks_detected_ = METRIC_transaction_deadlocks_detected.Instantiate(metric_entity);
+    }
+  }
 
   ~Impl() {
-    transactions_.clear();
+    // Status responses are dispatched to running transactions, so wait for them before removing
+    // transactions.
     rpcs_.Shutdown();
+    transactions_.clear();
+    // Waiting operations keep the tablet from shutting down, so they were all notified.
+    LOG_IF_WITH_PREFIX(DFATAL, !waiters_.empty())
+        << "Destroying participant with waiters for " << waiters_.size() << " transactions";
+    // Deadline timers of notified waiters are aborted, but still run their task asynchronously.
+    while (pending_wait_timers_.load(std::memory_order_acquire) != 0) {
+      SleepFor(MonoDelta::FromMilliseconds(1));
+    }
   }
 
   // Adds new running transaction.
@@ -417,7 +546,7 @@ class TransactionParticipant::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       auto it = transactions_.find(metadata->transaction_id);
       if (it == transactions_.end()) {
-        transactions_.emplace(*metadata, 0, &rpcs_, &context_, &request_serial_);
+        transactions_.emplace(*metadata, 0, &rpcs_, &context_, this);
         store = true;
       } else {
         DCHECK_EQ(it->metadata(), *metadata);
@@ -472,15 +601,13 @@ class TransactionParticipant::Impl {
   }
 
   void RequestStatusAt(const StatusRequest& request) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    auto it = FindOrLoad(*request.id);
-    if (it == transactions_.end()) {
-      lock.unlock();
-      request.callback(
-          STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
-      return;
+    if (GetAtomicFlag(&FLAGS_enable_transaction_wait_queues)) {
+      // Operations waiting for the transaction are notified when it is found to be aborted.
+      StatusRequest notifying_request = request;
+      notifying_request.callback = NotifyingAbortedCallback(*request.id, request.callback);
+      return DoRequestStatusAt(notifying_request);
     }
-    return it->RequestStatusAt(client(), request, &lock);
+    DoRequestStatusAt(request);
   }
 
   int64_t RegisterRequest() {
@@ -489,6 +616,9 @@ class TransactionParticipant::Impl {
 
   void Abort(const TransactionId& id,
              TransactionStatusCallback callback) {
+    if (GetAtomicFlag(&FLAGS_enable_transaction_wait_queues)) {
+      callback = NotifyingAbortedCallback(id, std::move(callback));
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     auto it = FindOrLoad(id);
     if (it == transactions_.end()) {
@@ -499,7 +629,67 @@ class TransactionParticipant::Impl {
     return it->Abort(client(), std::move(callback), &lock);
   }
 
+  void WaitForTransactions(const boost::optional<TransactionId>& waiter,
+                           const std::vector<TransactionId>& blockers,
+                           MonoTime deadline,
+                           std::function<void(const Status&)> callback) {
+    if (waiter && !WaitForGraph::Instance().AddWaiter(*waiter, blockers)) {
+      if (deadlocks_detected_) {
+        deadlocks_detected_->Increment();
+      }
+      callback(STATUS_FORMAT(TryAgain, "Deadlock detected: transaction $0 waits for $1",
+                             *waiter, blockers));
+      return;
+    }
+
+    auto transaction_waiter = std::make_shared<TransactionWaiter>(
+        waiter, blockers, std::move(callback));
+    bool applied = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& blocker : blockers) {
+        // A blocker that is not known here cannot be observed to complete, so it is only rechecked
+        // at the deadline.
+        auto it = FindOrLoad(blocker);
+        if (it != transactions_.end() && it->local_commit_time().is_valid()) {
+          applied = true;
+          break;
+        }
+      }
+      if (!applied) {
+        for (const auto& blocker : blockers) {
+          waiters_[blocker].push_back(transaction_waiter);
+        }
+      }
+    }
+    if (applied) {
+      NotifyWaiter(transaction_waiter);
+      return;
+    }
+
+    // The destructor waits for pending timers, since they refer to this participant.
+    pending_wait_timers_.fetch_add(1, std::memory_order_acq_rel);
+    auto& scheduler = client()->messenger()->scheduler();
+    transaction_waiter->timer_task_id.store(
+        scheduler.Schedule(
+            [this, transaction_waiter](const Status&) {
+              if (!transaction_waiter->notified.load(std::memory_order_acquire)) {
+                NotifyWaiter(transaction_waiter);
+              }
+              pending_wait_timers_.fetch_sub(1, std::memory_order_acq_rel);
+            },
+            deadline.ToSteadyTimePoint()),
+        std::memory_order_release);
+  }
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data) {
+    std::vector<TransactionWaiterPtr> waiters;
+    BOOST_SCOPE_EXIT(this_, &waiters) {
+      for (const auto& waiter : waiters) {
+        this_->NotifyWaiter(waiter);
+      }
+    } BOOST_SCOPE_EXIT_END;
+
     {
       std::lock_guard<std::mutex> lock(mutex_);
       // It is our last chance to load transaction metadata, if missing.
@@ -523,6 +713,7 @@ class TransactionParticipant::Impl {
           transaction.SetLocalCommitTime(data.commit_ht);
         });
         // TODO(dtxn) cleanup
+        TakeWaiters(data.transaction_id, &waiters);
       }
       if (data.mode == ProcessingMode::LEADER) {
         tserver::UpdateTransactionRequestPB req;
@@ -559,7 +750,184 @@ class TransactionParticipant::Impl {
     return &context_;
   }
 
+  // Queues the status request. When batching is enabled, it is sent right away if there is no
+  // request in flight to the status tablet, otherwise it is batched with the other requests
+  // queued meanwhile. When batching is disabled, it is always sent right away on its own.
+  void RequestStatus(const TabletId& status_tablet, const TransactionId& id) override {
+    std::vector<TransactionId> batch;
+    if (!FLAGS_enable_transaction_status_batching) {
+      {
+        std::lock_guard<std::mutex> lock(status_requests_mutex_);
+        ++status_requests_[status_tablet].in_flight;
+      }
+      batch.push_back(id);
+      SendStatusBatch(status_tablet, std::move(batch));
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(status_requests_mutex_);
+      auto& requests = status_requests_[status_tablet];
+      requests.queue.push_back(id);
+      if (requests.in_flight != 0 &&
+          requests.queue.size() < static_cast<size_t>(FLAGS_transaction_status_max_batch_size)) {
+        return;
+      }
+      TakeStatusBatch(&requests, &batch);
+    }
+    SendStatusBatch(status_tablet, std::move(batch));
+  }
+
  private:
+  struct StatusTabletRequests {
+    // Transactions whose status should be requested, but was not sent yet.
+    std::deque<TransactionId> queue;
+    size_t in_flight = 0;
+  };
+
+  // Moves up to transaction_status_max_batch_size transactions from the queue to batch.
+  // Requests that were queued before batching was disabled are sent one at a time.
+  void TakeStatusBatch(StatusTabletRequests* requests, std::vector<TransactionId>* batch) {
+    const int max_batch_size = FLAGS_enable_transaction_status_batching
+        ? std::max(FLAGS_transaction_status_max_batch_size, 1) : 1;
+    const size_t batch_size = std::min<size_t>(requests->queue.size(), max_batch_size);
+    batch->assign(requests->queue.begin(), requests->queue.begin() + batch_size);
+    requests->queue.erase(requests->queue.begin(), requests->queue.begin() + batch_size);
+    ++requests->in_flight;
+  }
+
+  void SendStatusBatch(const TabletId& status_tablet, std::vector<TransactionId> batch) {
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    for (const auto& id : batch) {
+      req.add_transaction_id(id.begin(), id.size());
+    }
+    req.set_propagated_hybrid_time(context_.Now().ToUint64());
+    // Every waiter registered before this point could be answered by the response.
+    const int64_t serial_no = ++request_serial_;
+    const MonoTime start = MonoTime::Now();
+
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      StatusBatchReceived(
+          status_tablet, batch, serial_no, start,
+          STATUS(Aborted, "Transaction participant is shutting down"),
+          tserver::GetTransactionStatusResponsePB());
+      return;
+    }
+    *handle = client::GetTransactionStatus(
+        TransactionRpcDeadline(),
+        nullptr /* tablet */,
+        client(),
+        &req,
+        [this, handle, status_tablet, batch = std::move(batch), serial_no, start](
+            const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+          auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
+          if (delay_usec > 0) {
+            delayer_.Delay(
+                MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
+                std::bind(&Impl::StatusBatchReceived, this, status_tablet, batch, serial_no,
+                          start, status, response));
+          } else {
+            StatusBatchReceived(status_tablet, batch, serial_no, start, status, response);
+          }
+          rpcs_.Unregister(handle);
+        });
+    (**handle).SendRpc();
+  }
+
+  // Returns status hybrid time of each transaction in the batch.
+  // A coordinator could omit the time of an aborted transaction, it is treated as
+  // HybridTime::kMax. Times of the other transactions keep their order.
+  static Result<std::vector<HybridTime>> StatusTimes(
+      size_t batch_size, const tserver::GetTransactionStatusResponsePB& response) {
+    const size_t num_statuses = response.status().size();
+    const size_t num_status_times = response.status_hybrid_time().size();
+    if (num_statuses != batch_size) {
+      return STATUS_FORMAT(
+          IllegalState, "Wrong number of statuses for $0 transactions: $1", batch_size,
+          response.ShortDebugString());
+    }
+    std::vector<HybridTime> result;
+    result.reserve(num_statuses);
+    if (num_status_times == num_statuses) {
+      for (auto time : response.status_hybrid_time()) {
+        result.emplace_back(time);
+      }
+      return result;
+    }
+    size_t time_idx = 0;
+    for (auto status : response.status()) {
+      if (status == TransactionStatus::ABORTED) {
+        result.push_back(HybridTime::kMax);
+      } else if (time_idx < num_status_times) {
+        result.emplace_back(response.status_hybrid_time(time_idx++));
+      } else {
+        break;
+      }
+    }
+    if (result.size() != num_statuses || time_idx != num_status_times) {
+      return STATUS_FORMAT(
+          IllegalState, "Wrong number of status times for $0 transactions: $1", batch_size,
+          response.ShortDebugString());
+    }
+    return result;
+  }
+
+  void StatusBatchReceived(const TabletId& status_tablet,
+                           const std::vector<TransactionId>& batch,
+                           int64_t serial_no,
+                           MonoTime start,
+                           Status status,
+                           const tserver::GetTransactionStatusResponsePB& response) {
+    if (response.has_propagated_hybrid_time()) {
+      context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+    }
+    std::vector<HybridTime> status_times;
+    if (status.ok()) {
+      auto times = StatusTimes(batch.size(), response);
+      if (times.ok()) {
+        status_times = std::move(*times);
+      } else {
+        status = times.status();
+      }
+    }
+    if (status_batch_size_) {
+      status_batch_size_->Increment(batch.size());
+      status_resolution_latency_->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+    }
+
+    // Send requests that were queued meanwhile before notifying waiters of this batch.
+    std::vector<TransactionId> next_batch;
+    {
+      std::lock_guard<std::mutex> lock(status_requests_mutex_);
+      auto it = status_requests_.find(status_tablet);
+      DCHECK(it != status_requests_.end());
+      --it->second.in_flight;
+      if (!it->second.queue.empty()) {
+        TakeStatusBatch(&it->second, &next_batch);
+      } else if (it->second.in_flight == 0) {
+        status_requests_.erase(it);
+      }
+    }
+    if (!next_batch.empty()) {
+      SendStatusBatch(status_tablet, std::move(next_batch));
+    }
+
+    for (size_t i = 0; i != batch.size(); ++i) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      auto it = transactions_.find(batch[i]);
+      if (it == transactions_.end()) {
+        continue;
+      }
+      if (status.ok()) {
+        it->StatusReceived(status, response.status(i), status_times[i], serial_no, &lock);
+      } else {
+        it->StatusReceived(
+            status, TransactionStatus::PENDING, HybridTime::kInvalid, serial_no, &lock);
+      }
+    }
+  }
+
   typedef boost::multi_index_container<RunningTransaction,
       boost::multi_index::indexed_by <
           boost::multi_index::hashed_unique <
@@ -633,11 +1001,96 @@ class TransactionParticipant::Impl {
     }
 
     it = transactions_.emplace(
-        std::move(*metadata), next_write_id, &rpcs_, &context_, &request_serial_).first;
+        std::move(*metadata), next_write_id, &rpcs_, &context_, this).first;
 
     return it;
   }
 
+  void DoRequestStatusAt(const StatusRequest& request) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = FindOrLoad(*request.id);
+    if (it == transactions_.end()) {
+      lock.unlock();
+      request.callback(
+          STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
+      return;
+    }
+    return it->RequestStatusAt(request, &lock);
+  }
+
+  // Wraps callback, so that operations waiting for transaction are notified when the callback
+  // receives its aborted status.
+  TransactionStatusCallback NotifyingAbortedCallback(const TransactionId& id,
+                                                     TransactionStatusCallback callback) {
+    return [this, id, callback = std::move(callback)](Result<TransactionStatusResult> result) {
+      if (result.ok() && result->status == TransactionStatus::ABORTED) {
+        std::vector<TransactionWaiterPtr> waiters;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          TakeWaiters(id, &waiters);
+        }
+        for (const auto& waiter : waiters) {
+          NotifyWaiter(waiter);
+        }
+      }
+      callback(std::move(result));
+    };
+  }
+
+  // Moves the waiters registered for transaction id to the waiters vector.
+  void TakeWaiters(const TransactionId& id, std::vector<TransactionWaiterPtr>* waiters) {
+    auto it = waiters_.find(id);
+    if (it == waiters_.end()) {
+      return;
+    }
+    waiters->insert(waiters->end(), it->second.begin(), it->second.end());
+    waiters_.erase(it);
+  }
+
+  // Notifies waiter, unless it was already notified. The callback of the waiter continues conflict
+  // resolution, so it is submitted to the conflict wait pool of the tablet server.
+  void NotifyWaiter(const TransactionWaiterPtr& waiter) {
+    if (waiter->notified.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& blocker : waiter->blockers) {
+        auto it = waiters_.find(blocker);
+        if (it == waiters_.end()) {
+          continue;
+        }
+        auto& blocker_waiters = it->second;
+        blocker_waiters.erase(
+            std::remove(blocker_waiters.begin(), blocker_waiters.end(), waiter),
+            blocker_waiters.end());
+        if (blocker_waiters.empty()) {
+          waiters_.erase(it);
+        }
+      }
+    }
+    auto timer_task_id = waiter->timer_task_id.load(std::memory_order_acquire);
+    if (timer_task_id != rpc::kUninitializedScheduledTaskId) {
+      client()->messenger()->scheduler().Abort(timer_task_id);
+    }
+    if (waiter->id) {
+      WaitForGraph::Instance().RemoveWaiter(*waiter->id, waiter->blockers);
+    }
+    if (conflict_wait_time_) {
+      conflict_wait_time_->Increment(
+          MonoTime::Now().GetDeltaSince(waiter->start).ToMicroseconds());
+    }
+
+    auto callback = std::move(waiter->callback);
+    auto status = context_.SubmitConflictWaitContinuation([callback] {
+      callback(Status::OK());
+    });
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to submit continuation of waiting operation: " << status;
+      callback(status);
+    }
+  }
+
   client::YBClient* client() const {
     return context_.client_future().get().get();
   }
@@ -653,11 +1106,28 @@ class TransactionParticipant::Impl {
   std::mutex mutex_;
   rpc::Rpcs rpcs_;
   Transactions transactions_;
+  // Operations waiting for completion of conflicting transactions, keyed by the transactions they
+  // wait for.
+  std::unordered_map<TransactionId, std::vector<TransactionWaiterPtr>, TransactionIdHash> waiters_;
+  // Number of scheduled deadline timers of waiters, that did not run yet.
+  std::atomic<int64_t> pending_wait_timers_{0};
   std::atomic<int64_t> request_serial_{0};
+
+  std::mutex status_requests_mutex_;
+  std::unordered_map<TabletId, StatusTabletRequests> status_requests_;
+
+  scoped_refptr<Histogram> status_batch_size_;
+  scoped_refptr<Histogram> status_resolution_latency_;
+  scoped_refptr<Histogram> conflict_wait_time_;
+  scoped_refptr<Counter> deadlocks_detected_;
+
+  // Used only in tests.
+  Delayer delayer_;
 };
 
-TransactionParticipant::TransactionParticipant(TransactionParticipantContext* context)
-    : impl_(new Impl(context)) {
+TransactionParticipant::TransactionParticipant(
+    TransactionParticipantContext* context, const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(new Impl(context, metric_entity)) {
 }
 
 TransactionParticipant::~TransactionParticipant() {
@@ -699,6 +1169,13 @@ void TransactionParticipant::Abort(const TransactionId& id,
   return impl_->Abort(id, std::move(callback));
 }
 
+void TransactionParticipant::WaitForTransactions(const boost::optional<TransactionId>& waiter,
+                                                const std::vector<TransactionId>& blockers,
+                                                MonoTime deadline,
+                                                std::function<void(const Status&)> callback) {
+  impl_->WaitForTransactions(waiter, blockers, deadline, std::move(callback));
+}
+
 CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData& data) {
   return impl_->ProcessApply(data);
 }
@@ -32,6 +32,8 @@
 
 #include "yb/consensus/opid_util.h"
 
+#include "yb/gutil/ref_counted.h"
+
 #include "yb/util/opid.pb.h"
 #include "yb/util/result.h"
 
@@ -45,6 +47,7 @@ class WriteBatch;
 namespace yb {
 
 class HybridTime;
+class MetricEntity;
 class TransactionMetadataPB;
 
 namespace tablet {
@@ -79,6 +82,11 @@ class TransactionParticipantContext {
   virtual HybridTime Now() = 0;
   virtual void UpdateClock(HybridTime hybrid_time) = 0;
 
+  // Runs func, that continues conflict resolution of a write after waiting for conflicting
+  // transactions. It blocks on status requests of transactions, so it is not run on the apply
+  // pool, whose threads should not wait for other tablets.
+  virtual CHECKED_STATUS SubmitConflictWaitContinuation(std::function<void()> func) = 0;
+
  protected:
   ~TransactionParticipantContext() {}
 };
@@ -88,7 +96,8 @@ class TransactionParticipantContext {
 // instance per tablet.
 class TransactionParticipant : public TransactionStatusManager {
  public:
-  explicit TransactionParticipant(TransactionParticipantContext* context);
+  TransactionParticipant(TransactionParticipantContext* context,
+                         const scoped_refptr<MetricEntity>& metric_entity);
   virtual ~TransactionParticipant();
 
   // Adds new running transaction.
@@ -109,6 +118,11 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void Abort(const TransactionId& id, TransactionStatusCallback callback) override;
 
+  void WaitForTransactions(const boost::optional<TransactionId>& waiter,
+                           const std::vector<TransactionId>& blockers,
+                           MonoTime deadline,
+                           std::function<void(const Status&)> callback) override;
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
   void SetDB(rocksdb::DB* db);
@@ -29,7 +29,8 @@ BulkLoadDocDBUtil::BulkLoadDocDBUtil(const std::string& tablet_id,
                                      const std::string& base_dir,
                                      const size_t memtable_size,
                                      int num_memtables,
-                                     int max_background_flushes)
+                                     int max_background_flushes,
+                                     size_t num_range_components_in_bloom_filter)
     : // Using optional init markers here because bulk load is only supported for CQL as of
       // 12/03/2017.
       DocDBRocksDBUtil(docdb::InitMarkerBehavior::kOptional),
@@ -37,7 +38,8 @@ BulkLoadDocDBUtil::BulkLoadDocDBUtil(const std::string& tablet_id,
       base_dir_(base_dir),
       memtable_size_(memtable_size),
       num_memtables_(num_memtables),
-      max_background_flushes_(max_background_flushes) {
+      max_background_flushes_(max_background_flushes),
+      num_range_components_in_bloom_filter_(num_range_components_in_bloom_filter) {
 }
 
 Status BulkLoadDocDBUtil::InitRocksDBDir() {
@@ -22,11 +22,15 @@ namespace tools {
 class BulkLoadDocDBUtil : public docdb::DocDBRocksDBUtil {
  public:
   BulkLoadDocDBUtil(const std::string& tablet_id, const std::string& base_dir,
-                    size_t memtable_size, int num_memtables, int max_background_flushes);
+                    size_t memtable_size, int num_memtables, int max_background_flushes,
+                    size_t num_range_components_in_bloom_filter);
   CHECKED_STATUS InitRocksDBDir() override;
   CHECKED_STATUS InitRocksDBOptions() override;
   std::string tablet_id() override;
   size_t block_cache_size() const override  { return 0; }
+  size_t num_range_components_in_bloom_filter() const override {
+    return num_range_components_in_bloom_filter_;
+  }
   const std::string& rocksdb_dir();
 
  private:
@@ -35,6 +39,7 @@ class BulkLoadDocDBUtil : public docdb::DocDBRocksDBUtil {
   const size_t memtable_size_;
   const int num_memtables_;
   const int max_background_flushes_;
+  const size_t num_range_components_in_bloom_filter_;
 };
 
 } // namespace tools
@@ -373,6 +373,10 @@ class YBBulkLoadTestWithoutRebalancing : public YBBulkLoadTest {
     FLAGS_enable_load_balancing = false;
     YBBulkLoadTest::SetUp();
   }
+
+ protected:
+  // Runs the partition and the bulk load tools and imports the generated files into the cluster.
+  void RunCLITool(const vector<string>& extra_bulk_load_args);
 };
 
 
@@ -405,7 +409,7 @@ TEST_F(YBBulkLoadTest, InvalidLines) {
   ASSERT_NOK(partition_generator_->LookupTabletId("123,123.2", &tablet_id, &partition_key));
 }
 
-TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
+void YBBulkLoadTestWithoutRebalancing::RunCLITool(const vector<string>& extra_bulk_load_args) {
   string exe_path = GetToolPath(kPartitionToolName);
   vector<string> argv = {kPartitionToolName, "-master_addresses", master_addresses_comma_separated_,
       "-table_name", kTableName, "-namespace_name", kNamespace};
@@ -478,6 +482,8 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
       "-bulk_load_num_files_per_tablet", std::to_string(kNumFilesPerTablet),
       "-flush_batch_for_tests"
   };
+  bulk_load_argv.insert(
+      bulk_load_argv.end(), extra_bulk_load_args.begin(), extra_bulk_load_args.end());
 
   std::unique_ptr<Subprocess> bulk_load_process;
   ASSERT_OK(StartProcessAndGetStreams(bulk_load_exec, bulk_load_argv, &out, &in,
@@ -600,5 +606,14 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
   }
 }
 
+TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
+  RunCLITool({});
+}
+
+TEST_F_EX(YBBulkLoadTest, TestCLIToolWithSstFiles, YBBulkLoadTestWithoutRebalancing) {
+  // Use a small sort buffer, so every tablet spills multiple runs that have to be merged.
+  RunCLITool({"-bulk_load_write_sst_files", "-bulk_load_sort_buffer_bytes", "4096"});
+}
+
 } // namespace tools
 } // namespace yb
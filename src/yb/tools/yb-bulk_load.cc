@@ -12,7 +12,11 @@
 //
 
 #include <sched.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <queue>
 #include <thread>
 #include <boost/algorithm/string.hpp>
 
@@ -21,6 +25,8 @@
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
+#include "yb/rocksdb/write_batch.h"
 #include "yb/client/client.h"
 #include "yb/common/entity_ids.h"
 #include "yb/common/hybrid_time.h"
@@ -35,15 +41,20 @@
 #include "yb/tools/bulk_load_utils.h"
 #include "yb/tools/yb-generate_partitions.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/coding.h"
 #include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/faststring.h"
 #include "yb/util/status.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/flags.h"
+#include "yb/util/format.h"
 #include "yb/util/logging.h"
 #include "yb/util/path_util.h"
+#include "yb/util/result.h"
 #include "yb/util/subprocess.h"
 
 using std::pair;
@@ -58,6 +69,7 @@ using yb::client::YBTableName;
 using yb::docdb::DocWriteBatch;
 using yb::docdb::InitMarkerBehavior;
 using yb::operator"" _GB;
+using yb::operator"" _MB;
 
 DEFINE_string(master_addresses, "", "Comma-separated list of YB Master server addresses");
 DEFINE_string(table_name, "", "Name of the table to generate partitions for");
@@ -82,16 +94,68 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_write_sst_files, false,
+            "Write the data of each tablet directly to a single SST file with SstFileWriter, "
+            "sorting it in memory bounded runs, instead of going through the rocksdb memtables, "
+            "flushes and compactions. Tablets are then finalized in parallel.");
+DEFINE_uint64(bulk_load_sort_buffer_bytes, 256_MB,
+              "Amount of encoded data a tablet buffers in memory before sorting it and spilling it "
+              "to a run file. Used with --bulk_load_write_sst_files");
+DEFINE_int32(bulk_load_num_parallel_tablets, 4,
+             "Number of tablets whose SST files are written and exported in parallel. Used with "
+             "--bulk_load_write_sst_files");
 
 namespace yb {
 namespace tools {
 
 namespace {
 
+typedef vector<pair<string, string>> KeyValues;
+
+// Collects the encoded DocDB records of a single tablet and writes them with SstFileWriter,
+// bypassing the memtables, flushes and compactions of the regular write path. Records are buffered
+// in memory up to --bulk_load_sort_buffer_bytes, after that the buffer is sorted and spilled to a
+// run file. Once the tablet is finished, the runs are merged into the final SST file, which is added
+// to the tablet's rocksdb, so the directory could be imported with ImportData as before.
+//
+// All records written by SstFileWriter have sequence number 0, while ImportData requires sequence
+// number ranges of the imported files to be disjoint, so a single file is produced per tablet.
+class TabletSstBuilder {
+ public:
+  explicit TabletSstBuilder(BulkLoadDocDBUtil* db_fixture);
+
+  // Adds a batch of records, could be invoked concurrently by multiple tasks.
+  CHECKED_STATUS Add(KeyValues entries);
+
+  // Writes the SST file and adds it to the tablet's rocksdb. Should be invoked after all records
+  // were added.
+  CHECKED_STATUS Finish();
+
+  uint64_t sst_file_size() const { return sst_file_size_; }
+
+ private:
+  class RunReader;
+
+  CHECKED_STATUS WriteRun(KeyValues entries, const string& path);
+  CHECKED_STATUS MergeRuns(rocksdb::SstFileWriter* writer);
+  string RunFilePath(size_t index) const;
+
+  BulkLoadDocDBUtil* const db_fixture_;
+  const string runs_dir_;
+
+  std::mutex mutex_;
+  KeyValues buffer_;
+  size_t buffer_bytes_ = 0;
+  vector<string> run_files_;
+
+  uint64_t sst_file_size_ = 0;
+};
+
 class BulkLoadTask : public Runnable {
  public:
   BulkLoadTask(vector<pair<TabletId, string>> rows, BulkLoadDocDBUtil *db_fixture,
-               const YBTable *table, YBPartitionGenerator *partition_generator);
+               TabletSstBuilder *sst_builder, const YBTable *table,
+               YBPartitionGenerator *partition_generator);
   void Run();
  private:
   CHECKED_STATUS PopulateColumnValue(const string &column,
@@ -105,6 +169,7 @@ class BulkLoadTask : public Runnable {
                            YBPartitionGenerator *const partition_generator);
   vector<pair<TabletId, string>> rows_;
   BulkLoadDocDBUtil *const db_fixture_;
+  TabletSstBuilder *const sst_builder_;
   const YBTable *const table_;
   YBPartitionGenerator *const partition_generator_;
 };
@@ -127,6 +192,10 @@ class BulkLoad {
   CHECKED_STATUS InitDBUtil(const TabletId &tablet_id);
   CHECKED_STATUS FinishTabletProcessing(const TabletId &tablet_id,
                                         vector<pair<TabletId, string>> rows);
+  // Submits writing the SST file of the tablet and its export to the finish thread pool, so that
+  // the rows of the next tablet are processed meanwhile.
+  CHECKED_STATUS SubmitSstFinish(const TabletId &tablet_id);
+  CHECKED_STATUS ExportFiles(const TabletId &tablet_id, BulkLoadDocDBUtil *db_fixture);
   CHECKED_STATUS RetryableSubmit(vector<pair<TabletId, string>> rows);
   CHECKED_STATUS CompactFiles();
 
@@ -134,7 +203,229 @@ class BulkLoad {
   shared_ptr<YBTable> table_;
   unique_ptr<YBPartitionGenerator> partition_generator_;
   gscoped_ptr<ThreadPool> thread_pool_;
+  // Used with --bulk_load_write_sst_files to finalize multiple tablets in parallel.
+  gscoped_ptr<ThreadPool> finish_thread_pool_;
   unique_ptr<BulkLoadDocDBUtil> db_fixture_;
+  unique_ptr<TabletSstBuilder> sst_builder_;
+
+  // Throughput stats.
+  int64_t num_rows_ = 0;
+  int64_t num_input_bytes_ = 0;
+  std::atomic<uint64_t> num_sst_bytes_{0};
+};
+
+// Sorts the records by key. Bulk load writes all records with the same hybrid time, so equal keys
+// come from rows with the same primary key. Only one of them is kept, like in the regular path
+// where the winner depends on the order in which concurrent batches are written.
+void SortAndDeduplicate(KeyValues* entries) {
+  std::stable_sort(entries->begin(), entries->end(),
+                   [](const pair<string, string>& lhs, const pair<string, string>& rhs) {
+    return lhs.first < rhs.first;
+  });
+  auto last = std::unique(entries->begin(), entries->end(),
+                          [](const pair<string, string>& lhs, const pair<string, string>& rhs) {
+    return lhs.first == rhs.first;
+  });
+  entries->erase(last, entries->end());
+}
+
+// Reads a run file, that is a sequence of records with fixed32 length prefixed key and value.
+class TabletSstBuilder::RunReader {
+ public:
+  RunReader(size_t index, gscoped_ptr<SequentialFile> file)
+      : index_(index), file_(std::move(file)) {
+  }
+
+  // Reads the next record, returns false when the run is exhausted.
+  Result<bool> Next() {
+    bool eof = false;
+    RETURN_NOT_OK(ReadString(&key_, &eof));
+    if (eof) {
+      return false;
+    }
+    RETURN_NOT_OK(ReadString(&value_, &eof));
+    if (eof) {
+      return STATUS_SUBSTITUTE(Corruption, "Truncated run file: $0", file_->filename());
+    }
+    return true;
+  }
+
+  size_t index() const { return index_; }
+  const string& key() const { return key_; }
+  const string& value() const { return value_; }
+
+ private:
+  CHECKED_STATUS ReadString(string* out, bool* eof) {
+    uint8_t length[sizeof(uint32_t)];
+    size_t read = 0;
+    RETURN_NOT_OK(ReadFully(length, sizeof(length), &read));
+    if (read == 0) {
+      *eof = true;
+      return Status::OK();
+    }
+    if (read == sizeof(length)) {
+      out->resize(DecodeFixed32(length));
+      RETURN_NOT_OK(ReadFully(reinterpret_cast<uint8_t*>(&(*out)[0]), out->size(), &read));
+      if (read == out->size()) {
+        return Status::OK();
+      }
+    }
+    return STATUS_SUBSTITUTE(Corruption, "Truncated run file: $0", file_->filename());
+  }
+
+  CHECKED_STATUS ReadFully(uint8_t* dest, size_t size, size_t* read) {
+    *read = 0;
+    while (*read < size) {
+      Slice result;
+      RETURN_NOT_OK(file_->Read(size - *read, &result, dest + *read));
+      if (result.empty()) {
+        break;
+      }
+      if (result.data() != dest + *read) {
+        memcpy(dest + *read, result.data(), result.size());
+      }
+      *read += result.size();
+    }
+    return Status::OK();
+  }
+
+  const size_t index_;
+  gscoped_ptr<SequentialFile> file_;
+  string key_;
+  string value_;
+};
+
+TabletSstBuilder::TabletSstBuilder(BulkLoadDocDBUtil* db_fixture)
+    : db_fixture_(db_fixture),
+      runs_dir_(JoinPathSegments(db_fixture->rocksdb_dir(), "bulk_load_runs")) {
+}
+
+string TabletSstBuilder::RunFilePath(size_t index) const {
+  return JoinPathSegments(runs_dir_, Format("run-$0", index));
+}
+
+Status TabletSstBuilder::Add(KeyValues entries) {
+  KeyValues run;
+  string run_path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries) {
+      buffer_bytes_ += entry.first.size() + entry.second.size();
+      buffer_.push_back(std::move(entry));
+    }
+    if (buffer_bytes_ < FLAGS_bulk_load_sort_buffer_bytes) {
+      return Status::OK();
+    }
+    if (run_files_.empty()) {
+      RETURN_NOT_OK(env_util::CreateDirIfMissing(Env::Default(), runs_dir_));
+    }
+    run.swap(buffer_);
+    buffer_bytes_ = 0;
+    run_path = RunFilePath(run_files_.size());
+    run_files_.push_back(run_path);
+  }
+
+  // Sort and write the run outside of the lock, so other tasks keep filling the buffer meanwhile.
+  return WriteRun(std::move(run), run_path);
+}
+
+Status TabletSstBuilder::WriteRun(KeyValues entries, const string& path) {
+  static constexpr size_t kWriteBufferSize = 1_MB;
+
+  SortAndDeduplicate(&entries);
+  gscoped_ptr<WritableFile> file;
+  RETURN_NOT_OK(Env::Default()->NewWritableFile(path, &file));
+  faststring buffer;
+  for (const auto& entry : entries) {
+    PutFixed32LengthPrefixedSlice(&buffer, entry.first);
+    PutFixed32LengthPrefixedSlice(&buffer, entry.second);
+    if (buffer.size() >= kWriteBufferSize) {
+      RETURN_NOT_OK(file->Append(Slice(buffer.data(), buffer.size())));
+      buffer.clear();
+    }
+  }
+  if (buffer.size() != 0) {
+    RETURN_NOT_OK(file->Append(Slice(buffer.data(), buffer.size())));
+  }
+  return file->Close();
+}
+
+Status TabletSstBuilder::MergeRuns(rocksdb::SstFileWriter* writer) {
+  auto greater = [](const RunReader* lhs, const RunReader* rhs) {
+    const int cmp = lhs->key().compare(rhs->key());
+    return cmp != 0 ? cmp > 0 : lhs->index() > rhs->index();
+  };
+  std::priority_queue<RunReader*, vector<RunReader*>, decltype(greater)> heap(greater);
+  vector<unique_ptr<RunReader>> readers;
+  readers.reserve(run_files_.size());
+  for (size_t i = 0; i != run_files_.size(); ++i) {
+    gscoped_ptr<SequentialFile> file;
+    RETURN_NOT_OK(Env::Default()->NewSequentialFile(run_files_[i], &file));
+    readers.emplace_back(new RunReader(i, std::move(file)));
+    if (VERIFY_RESULT(readers.back()->Next())) {
+      heap.push(readers.back().get());
+    }
+  }
+
+  // Each run is deduplicated already, the same key could still be present in several runs.
+  string last_key;
+  bool has_last_key = false;
+  while (!heap.empty()) {
+    RunReader* reader = heap.top();
+    heap.pop();
+    if (!has_last_key || reader->key() != last_key) {
+      RETURN_NOT_OK(writer->Add(reader->key(), reader->value()));
+      last_key = reader->key();
+      has_last_key = true;
+    }
+    if (VERIFY_RESULT(reader->Next())) {
+      heap.push(reader);
+    }
+  }
+  return Status::OK();
+}
+
+Status TabletSstBuilder::Finish() {
+  auto* env = Env::Default();
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, runs_dir_));
+
+  const rocksdb::Options& options = db_fixture_->options();
+  rocksdb::SstFileWriter writer(
+      rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options), options.comparator);
+  RETURN_NOT_OK(writer.Open(JoinPathSegments(runs_dir_, "tablet.sst")));
+  if (run_files_.empty()) {
+    SortAndDeduplicate(&buffer_);
+    for (const auto& entry : buffer_) {
+      RETURN_NOT_OK(writer.Add(entry.first, entry.second));
+    }
+  } else {
+    if (!buffer_.empty()) {
+      run_files_.push_back(RunFilePath(run_files_.size()));
+      RETURN_NOT_OK(WriteRun(std::move(buffer_), run_files_.back()));
+    }
+    RETURN_NOT_OK(MergeRuns(&writer));
+  }
+  KeyValues().swap(buffer_);
+  buffer_bytes_ = 0;
+
+  rocksdb::ExternalSstFileInfo file_info;
+  RETURN_NOT_OK(writer.Finish(&file_info));
+  sst_file_size_ = file_info.file_size;
+  RETURN_NOT_OK(db_fixture_->rocksdb()->AddFile(&file_info, /* move_file */ true));
+  return env->DeleteRecursively(runs_dir_);
+}
+
+// Collects the records of a rocksdb write batch.
+class KeyValuesCollector : public rocksdb::WriteBatch::Handler {
+ public:
+  explicit KeyValuesCollector(KeyValues* entries) : entries_(entries) {}
+
+  void Put(const Slice& key, const Slice& value) override {
+    entries_->emplace_back(key.ToBuffer(), value.ToBuffer());
+  }
+
+ private:
+  KeyValues* const entries_;
 };
 
 CompactionTask::CompactionTask(const vector<string>& sst_filenames, BulkLoadDocDBUtil* db_fixture)
@@ -155,16 +446,17 @@ void CompactionTask::Run() {
 }
 
 BulkLoadTask::BulkLoadTask(vector<pair<TabletId, string>> rows,
-                           BulkLoadDocDBUtil *db_fixture, const YBTable *table,
-                           YBPartitionGenerator *partition_generator)
+                           BulkLoadDocDBUtil *db_fixture, TabletSstBuilder *sst_builder,
+                           const YBTable *table, YBPartitionGenerator *partition_generator)
     : rows_(std::move(rows)),
       db_fixture_(db_fixture),
+      sst_builder_(sst_builder),
       table_(table),
       partition_generator_(partition_generator) {
 }
 
 void BulkLoadTask::Run() {
-  DocWriteBatch doc_write_batch(db_fixture_->rocksdb(), InitMarkerBehavior::kOptional);
+  DocWriteBatch doc_write_batch(db_fixture_->doc_db(), InitMarkerBehavior::kOptional);
 
   for (const auto &entry : rows_) {
     const string &row = entry.second;
@@ -174,6 +466,20 @@ void BulkLoadTask::Run() {
                        &doc_write_batch, partition_generator_));
   }
 
+  if (sst_builder_) {
+    // Encode the records the same way WriteToRocksDB does, but hand them to the SST builder.
+    rocksdb::WriteBatch rocksdb_write_batch;
+    CHECK_OK(db_fixture_->PopulateRocksDBWriteBatch(
+        doc_write_batch, &rocksdb_write_batch, HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
+        /* decode_dockey */ false, /* increment_write_id */ false));
+    KeyValues entries;
+    entries.reserve(rocksdb_write_batch.Count());
+    KeyValuesCollector collector(&entries);
+    CHECK_OK(rocksdb_write_batch.Iterate(&collector));
+    CHECK_OK(sst_builder_->Add(std::move(entries)));
+    return;
+  }
+
   // Flush the batch.
   CHECK_OK(db_fixture_->WriteToRocksDB(
       doc_write_batch, HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
@@ -297,7 +603,8 @@ Status BulkLoadTask::InsertRow(const string &row,
 
 Status BulkLoad::RetryableSubmit(vector<pair<TabletId, string>> rows) {
   auto runnable = std::make_shared<BulkLoadTask>(
-      std::move(rows), db_fixture_.get(), table_.get(), partition_generator_.get());
+      std::move(rows), db_fixture_.get(), sst_builder_.get(), table_.get(),
+      partition_generator_.get());
 
   Status s;
   do {
@@ -371,12 +678,42 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   // Wait for all tasks for the tablet to complete.
   thread_pool_->Wait();
 
+  if (sst_builder_) {
+    return SubmitSstFinish(tablet_id);
+  }
+
   // Now flush the DB.
   RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
 
   // Perform the necessary compactions.
   RETURN_NOT_OK(CompactFiles());
 
+  return ExportFiles(tablet_id, db_fixture_.get());
+}
+
+Status BulkLoad::SubmitSstFinish(const TabletId &tablet_id) {
+  // The task takes over the tablet's rocksdb, it is closed once the task is done.
+  shared_ptr<BulkLoadDocDBUtil> db_fixture(db_fixture_.release());
+  shared_ptr<TabletSstBuilder> sst_builder(sst_builder_.release());
+  auto task = [this, tablet_id, db_fixture, sst_builder] {
+    MonoTime start = MonoTime::Now();
+    CHECK_OK(sst_builder->Finish());
+    num_sst_bytes_ += sst_builder->sst_file_size();
+    LOG(INFO) << "Wrote SST file of " << sst_builder->sst_file_size() << " bytes for tablet "
+              << tablet_id << " in " << MonoTime::Now().GetDeltaSince(start).ToString();
+    CHECK_OK(ExportFiles(tablet_id, db_fixture.get()));
+  };
+
+  // The queue of the finish thread pool is bounded, so a full queue also limits the number of
+  // tablet buffers kept in memory.
+  Status s;
+  while ((s = finish_thread_pool_->SubmitFunc(task)).IsServiceUnavailable()) {
+    SleepFor(MonoDelta::FromMilliseconds(100));
+  }
+  return s;
+}
+
+Status BulkLoad::ExportFiles(const TabletId &tablet_id, BulkLoadDocDBUtil *db_fixture) {
   if (!FLAGS_export_files) {
     return Status::OK();
   }
@@ -397,7 +734,7 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
 
   // Invoke the bulk_load_helper script.
   vector<string> argv = {FLAGS_bulk_load_helper_script, "-t", tablet_id, "-r", csv_replicas, "-i",
-      FLAGS_ssh_key_file, "-d", db_fixture_->rocksdb_dir()};
+      FLAGS_ssh_key_file, "-d", db_fixture->rocksdb_dir()};
   string bulk_load_helper_stdout;
   RETURN_NOT_OK(Subprocess::Call(argv, &bulk_load_helper_stdout));
 
@@ -442,7 +779,7 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   }
 
   // Delete the data once the import is done.
-  return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+  return yb::Env::Default()->DeleteRecursively(db_fixture->rocksdb_dir());
 }
 
 
@@ -450,9 +787,14 @@ CHECKED_STATUS BulkLoad::InitDBUtil(const TabletId &tablet_id) {
   db_fixture_.reset(new BulkLoadDocDBUtil(tablet_id, FLAGS_base_dir,
                                           FLAGS_memtable_size_bytes,
                                           FLAGS_bulk_load_num_memtables,
-                                          FLAGS_bulk_load_max_background_flushes));
+                                          FLAGS_bulk_load_max_background_flushes,
+                                          table_->InternalSchema().table_properties()
+                                              .num_range_components_in_bloom_filter()));
   RETURN_NOT_OK(db_fixture_->InitRocksDBOptions());
   RETURN_NOT_OK(db_fixture_->DisableCompactions()); // This opens rocksdb.
+  if (FLAGS_bulk_load_write_sst_files) {
+    sst_builder_.reset(new TabletSstBuilder(db_fixture_.get()));
+  }
   return Status::OK();
 }
 
@@ -477,6 +819,14 @@ Status BulkLoad::InitYBBulkLoad() {
           .set_max_queue_size(FLAGS_bulk_load_threadpool_queue_size)
           .set_idle_timeout(MonoDelta::FromMilliseconds(5000))
           .Build(&thread_pool_));
+  if (FLAGS_bulk_load_write_sst_files) {
+    CHECK_OK(
+        ThreadPoolBuilder("bulk_load_finish")
+            .set_min_threads(FLAGS_bulk_load_num_parallel_tablets)
+            .set_max_threads(FLAGS_bulk_load_num_parallel_tablets)
+            .set_max_queue_size(FLAGS_bulk_load_num_parallel_tablets)
+            .Build(&finish_thread_pool_));
+  }
   return Status::OK();
 }
 
@@ -485,6 +835,7 @@ Status BulkLoad::RunBulkLoad() {
 
   RETURN_NOT_OK(InitYBBulkLoad());
 
+  const MonoTime start = MonoTime::Now();
   TabletId current_tablet_id;
 
   vector<pair<TabletId, string>> rows;
@@ -499,6 +850,8 @@ Status BulkLoad::RunBulkLoad() {
     }
     const TabletId tablet_id = line.substr(0, index);
     const string row = line.substr(index + 1, line.size() - (index + 1));
+    ++num_rows_;
+    num_input_bytes_ += row.size();
 
     // Reinitialize rocksdb if needed.
     if (current_tablet_id.empty() || current_tablet_id != tablet_id) {
@@ -517,6 +870,19 @@ Status BulkLoad::RunBulkLoad() {
 
   // Process last tablet.
   RETURN_NOT_OK(FinishTabletProcessing(current_tablet_id, std::move(rows)));
+  if (finish_thread_pool_) {
+    finish_thread_pool_->Wait();
+  }
+
+  const double elapsed_secs = std::max(MonoTime::Now().GetDeltaSince(start).ToSeconds(), 1e-3);
+  LOG(INFO) << "Bulk loaded " << num_rows_ << " rows (" << num_input_bytes_ << " bytes) in "
+            << elapsed_secs << " s: " << num_rows_ / elapsed_secs << " rows/sec, "
+            << num_input_bytes_ / elapsed_secs << " bytes/sec";
+  if (finish_thread_pool_) {
+    const uint64_t num_sst_bytes = num_sst_bytes_.load();
+    LOG(INFO) << "Wrote " << num_sst_bytes << " bytes of SST files: "
+              << num_sst_bytes / elapsed_secs << " bytes/sec";
+  }
   return Status::OK();
 }
 
@@ -547,6 +913,10 @@ int main(int argc, char** argv) {
     LOG(FATAL) << "--bulk_load_num_files_per_tablet needs to be greater than 0";
   }
 
+  if (FLAGS_bulk_load_write_sst_files && FLAGS_bulk_load_num_parallel_tablets <= 0) {
+    LOG(FATAL) << "--bulk_load_num_parallel_tablets needs to be greater than 0";
+  }
+
   yb::tools::BulkLoad bulk_load;
   yb::Status s = bulk_load.RunBulkLoad();
   if (!s.ok()) {
@@ -32,7 +32,9 @@
 
 #include "yb/tserver/heartbeater.h"
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -48,6 +50,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -197,6 +200,13 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Same as above, per tablet, for computing the iops of each replica.
+  struct TabletOps {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+  };
+  std::unordered_map<TabletId, TabletOps> prev_tablet_ops_;
+
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -401,18 +411,53 @@ Status Heartbeater::Thread::TryHeartbeat() {
     }
 #endif
 
-    // Get the Total SST file sizes and set it in the proto buf
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
+    // Get the Total SST file sizes and set it in the proto buf. Sizes of the tablets led by this
+    // server are also reported, so the master could split the largest ones. The size and iops of
+    // every replica are reported for the load balancer.
     std::vector<scoped_refptr<yb::tablet::TabletPeer> > tablet_peers;
+    std::unordered_map<TabletId, TabletOps> tablet_ops;
     uint64_t total_file_sizes = 0;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       scoped_refptr<yb::tablet::TabletPeer> tablet_peer = *it;
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        if (!tablet_class) {
+          continue;
+        }
+        const uint64_t file_sizes = tablet_class->GetTotalSSTFileSizes();
+        total_file_sizes += file_sizes;
+        auto consensus = tablet_peer->shared_consensus();
+        if (consensus && !tablet_class->IsSplit() &&
+            consensus->leader_status() == consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+          auto* tablet_size = req.mutable_metrics()->add_leader_tablet_sizes();
+          tablet_size->set_tablet_id(tablet_peer->tablet_id());
+          tablet_size->set_sst_file_size(file_sizes);
+        }
+
+        auto* metrics = tablet_class->metrics();
+        auto& ops = tablet_ops[tablet_peer->tablet_id()];
+        ops.reads = metrics->ql_read_latency->TotalCount() +
+                    metrics->redis_read_latency->TotalCount();
+        ops.writes = metrics->write_op_duration_client_propagated_consistency->TotalCount();
+        const auto& prev_ops = prev_tablet_ops_[tablet_peer->tablet_id()];
+        auto* tablet_load = req.mutable_metrics()->add_tablet_loads();
+        tablet_load->set_tablet_id(tablet_peer->tablet_id());
+        tablet_load->set_sst_file_size(file_sizes);
+        if (div > 0) {
+          tablet_load->set_read_ops_per_sec(
+              static_cast<double>(ops.reads - std::min(ops.reads, prev_ops.reads)) / div);
+          tablet_load->set_write_ops_per_sec(
+              static_cast<double>(ops.writes - std::min(ops.writes, prev_ops.writes)) / div);
+        }
       }
     }
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
+    // Tablets that are gone are dropped from the previous counters here.
+    prev_tablet_ops_.swap(tablet_ops);
 
     // Get the total number of read and write operations.
     scoped_refptr<Histogram> reads_hist = server_->GetMetricsHistogram
@@ -424,9 +469,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
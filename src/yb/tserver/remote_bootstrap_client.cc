@@ -32,6 +32,13 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+#include <boost/optional.hpp>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -41,9 +48,11 @@
 #include "yb/fs/block_id.h"
 #include "yb/fs/block_manager.h"
 #include "yb/fs/fs_manager.h"
+#include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tablet/tablet.pb.h"
@@ -60,6 +69,7 @@
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/size_literals.h"
 
@@ -98,6 +108,27 @@ DEFINE_test_flag(double, fault_crash_bootstrap_client_before_changing_role, 0.0,
 DEFINE_int32(remote_bootstrap_max_chunk_size, 1_MB,
              "Maximum chunk size to be transferred at a time during remote bootstrap.");
 
+DEFINE_int32(remote_bootstrap_max_outstanding_chunks, 4,
+             "Maximum number of chunk requests a remote bootstrap session keeps in flight for "
+             "a single file.");
+TAG_FLAG(remote_bootstrap_max_outstanding_chunks, advanced);
+
+DEFINE_int32(remote_bootstrap_max_concurrent_files, 4,
+             "Maximum number of files a remote bootstrap session downloads concurrently.");
+TAG_FLAG(remote_bootstrap_max_concurrent_files, advanced);
+
+DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 0,
+             "Maximum rate at which all remote bootstrap sessions of this server together fetch "
+             "data, i.e. the bandwidth budget shared by up to "
+             "load_balancer_max_concurrent_tablet_remote_bootstraps concurrent sessions. "
+             "0 means unlimited.");
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, advanced);
+TAG_FLAG(remote_bootstrap_rate_limit_bytes_per_sec, runtime);
+
+METRIC_DEFINE_counter(server, remote_bootstrap_bytes_fetched,
+                      "Remote Bootstrap Bytes Fetched", yb::MetricUnit::kBytes,
+                      "Number of bytes of tablet data fetched by remote bootstrap sessions.");
+
 // RETURN_NOT_OK_PREPEND() with a remote-error unwinding step.
 #define RETURN_NOT_OK_UNWIND_PREPEND(status, controller, msg) \
   RETURN_NOT_OK_PREPEND(UnwindRemoteError(status, controller), msg)
@@ -125,6 +156,276 @@ using tablet::TabletSuperBlockPB;
 
 constexpr int kBytesReservedForMessageHeaders = 16384;
 
+namespace {
+
+int32_t MaxChunkLength() {
+  return std::min(FLAGS_remote_bootstrap_max_chunk_size,
+                  FLAGS_rpc_max_message_size - kBytesReservedForMessageHeaders);
+}
+
+// Returns the rate limiter shared by all remote bootstrap sessions of the process, or null if the
+// fetch rate is not limited.
+rocksdb::RateLimiter* SharedRateLimiter() {
+  static std::mutex mutex;
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter;
+  static int64_t rate_bytes_per_sec = 0;
+
+  const int64_t rate = FLAGS_remote_bootstrap_rate_limit_bytes_per_sec;
+  if (rate <= 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!rate_limiter) {
+    rate_limiter.reset(rocksdb::NewGenericRateLimiter(rate));
+  } else if (rate != rate_bytes_per_sec) {
+    rate_limiter->SetBytesPerSecond(rate);
+  }
+  rate_bytes_per_sec = rate;
+  return rate_limiter.get();
+}
+
+// Blocks until 'bytes' more bytes may be fetched within the shared rate limit.
+void ThrottleFetch(int64_t bytes) {
+  auto* rate_limiter = SharedRateLimiter();
+  if (!rate_limiter) {
+    return;
+  }
+  while (bytes > 0) {
+    const auto burst = std::min(bytes, rate_limiter->GetSingleBurstBytes());
+    rate_limiter->Request(burst, rocksdb::Env::IO_HIGH);
+    bytes -= burst;
+  }
+}
+
+} // namespace
+
+// Downloads a set of files over the remote bootstrap session, several files at a time with several
+// chunk requests in flight for each of them.
+//
+// RPC callbacks only queue the completed fetches. Verification and all file I/O happen on the
+// thread that calls Run(), which appends the chunks of every file in offset order.
+class RemoteBootstrapClient::FileFetcher {
+ public:
+  FileFetcher(RemoteBootstrapClient* client, const std::vector<FileDownload>& files)
+      : client_(client), files_(files), states_(files.size()),
+        max_chunk_length_(MaxChunkLength()) {}
+
+  CHECKED_STATUS Run();
+
+ private:
+  struct Fetch {
+    size_t file_index;
+    FetchDataRequestPB req;
+    FetchDataResponsePB resp;
+    rpc::RpcController controller;
+  };
+
+  struct FileState {
+    std::unique_ptr<WritableFile> writer;
+    // Known once the first chunk of the file has been received.
+    boost::optional<uint64_t> total_length;
+    uint64_t next_fetch_offset = 0;
+    uint64_t next_write_offset = 0;
+    size_t outstanding = 0;
+    // Chunks received ahead of next_write_offset.
+    std::map<uint64_t, std::unique_ptr<Fetch>> received;
+  };
+
+  CHECKED_STATUS StartFile(size_t index);
+
+  // Sends chunk requests for the given file until it has enough of them in flight.
+  void FetchMore(size_t index);
+
+  // Requests the next chunk of the given file.
+  void SendFetch(size_t index);
+
+  // Requests up to length bytes of the given file starting at offset.
+  void SendFetch(size_t index, uint64_t offset, int64_t length);
+
+  CHECKED_STATUS HandleFetch(std::unique_ptr<Fetch> fetch);
+
+  CHECKED_STATUS FinishFile(size_t index);
+
+  std::unique_ptr<Fetch> WaitForFetch();
+
+  RemoteBootstrapClient* const client_;
+  const std::vector<FileDownload>& files_;
+  std::vector<FileState> states_;
+  const int64_t max_chunk_length_;
+
+  size_t next_file_ = 0;
+  size_t active_files_ = 0;
+  size_t outstanding_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::unique_ptr<Fetch>> completed_; // Protected by mutex_.
+};
+
+Status RemoteBootstrapClient::FileFetcher::Run() {
+  const size_t max_files = std::max(FLAGS_remote_bootstrap_max_concurrent_files, 1);
+  Status result;
+  for (;;) {
+    while (result.ok() && next_file_ < files_.size() && active_files_ < max_files) {
+      result = StartFile(next_file_++);
+    }
+    // On failure we still have to wait for the outstanding calls, they refer to this object.
+    if (outstanding_ == 0) {
+      break;
+    }
+    auto fetch = WaitForFetch();
+    if (!result.ok()) {
+      continue;
+    }
+    const auto& file = files_[fetch->file_index];
+    result = HandleFetch(std::move(fetch));
+    if (!result.ok()) {
+      result = result.CloneAndPrepend(Format("Unable to download $0 file $1",
+                                             DataIdPB::IdType_Name(file.data_id.type()),
+                                             file.path));
+    }
+  }
+  return result;
+}
+
+Status RemoteBootstrapClient::FileFetcher::StartFile(size_t index) {
+  const auto& file = files_[index];
+  client_->UpdateStatusMessage(Format("Downloading $0 ($1/$2)", file.path, index + 1,
+                                      files_.size()));
+  WritableFileOptions opts;
+  opts.sync_on_close = true;
+  gscoped_ptr<WritableFile> writer;
+  RETURN_NOT_OK_PREPEND(client_->fs_manager_->env()->NewWritableFile(opts, file.path, &writer),
+                        Format("Unable to open $0 for writing", file.path));
+  states_[index].writer.reset(writer.release());
+  ++active_files_;
+  // The file length is not known yet, so only fetch the first chunk.
+  SendFetch(index);
+  return Status::OK();
+}
+
+void RemoteBootstrapClient::FileFetcher::FetchMore(size_t index) {
+  auto& state = states_[index];
+  const size_t max_outstanding = std::max(FLAGS_remote_bootstrap_max_outstanding_chunks, 1);
+  while (state.outstanding < max_outstanding && state.next_fetch_offset < *state.total_length) {
+    SendFetch(index);
+  }
+}
+
+void RemoteBootstrapClient::FileFetcher::SendFetch(size_t index) {
+  auto& state = states_[index];
+  int64_t length = max_chunk_length_;
+  if (state.total_length) {
+    length = std::min<int64_t>(length, *state.total_length - state.next_fetch_offset);
+  }
+  const uint64_t offset = state.next_fetch_offset;
+  state.next_fetch_offset += length;
+  SendFetch(index, offset, length);
+}
+
+void RemoteBootstrapClient::FileFetcher::SendFetch(
+    size_t index, uint64_t offset, int64_t length) {
+  auto& state = states_[index];
+  ThrottleFetch(length);
+
+  auto* fetch = new Fetch;
+  fetch->file_index = index;
+  fetch->req.set_session_id(client_->session_id_);
+  fetch->req.mutable_data_id()->CopyFrom(files_[index].data_id);
+  fetch->req.set_offset(offset);
+  fetch->req.set_max_length(length);
+  fetch->controller.set_timeout(
+      MonoDelta::FromMilliseconds(client_->session_idle_timeout_millis_));
+
+  ++state.outstanding;
+  ++outstanding_;
+  client_->proxy_->FetchDataAsync(fetch->req, &fetch->resp, &fetch->controller, [this, fetch] {
+    // Notify under the lock, Run() may return and destroy this object as soon as it is released.
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.emplace_back(fetch);
+    cond_.notify_one();
+  });
+}
+
+std::unique_ptr<RemoteBootstrapClient::FileFetcher::Fetch>
+RemoteBootstrapClient::FileFetcher::WaitForFetch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return !completed_.empty(); });
+  auto result = std::move(completed_.front());
+  completed_.pop_front();
+  --outstanding_;
+  --states_[result->file_index].outstanding;
+  return result;
+}
+
+Status RemoteBootstrapClient::FileFetcher::HandleFetch(std::unique_ptr<Fetch> fetch) {
+  const size_t index = fetch->file_index;
+  auto& state = states_[index];
+  RETURN_NOT_OK_UNWIND_PREPEND(fetch->controller.status(), fetch->controller,
+                               "Unable to fetch data from remote");
+
+  const auto& chunk = fetch->resp.chunk();
+  const uint64_t offset = fetch->req.offset();
+  // Sanity-check for corruption.
+  RETURN_NOT_OK_PREPEND(client_->VerifyData(offset, chunk),
+                        Format("Error validating data item $0",
+                               files_[index].data_id.ShortDebugString()));
+  if (!state.total_length) {
+    state.total_length = chunk.total_data_length();
+  } else if (*state.total_length != chunk.total_data_length()) {
+    return STATUS_FORMAT(IllegalState, "File length changed from $0 to $1",
+                         *state.total_length, chunk.total_data_length());
+  }
+  // The remote may return less than requested, in which case the rest of the range is requested
+  // again. An empty chunk would never make progress and a longer one would overlap the next chunk.
+  const uint64_t requested_size = std::min<uint64_t>(
+      fetch->req.max_length(), *state.total_length - std::min(offset, *state.total_length));
+  const uint64_t received_size = chunk.data().size();
+  if (received_size > requested_size || (received_size == 0 && requested_size != 0)) {
+    return STATUS_FORMAT(Corruption, "Received $0 bytes at offset $1, requested $2",
+                         received_size, offset, requested_size);
+  }
+  if (received_size < requested_size) {
+    VLOG(3) << client_->LogPrefix() << "Short chunk of " << files_[index].path << ": received "
+            << received_size << " of " << requested_size << " bytes at offset " << offset;
+    SendFetch(index, offset + received_size, requested_size - received_size);
+  }
+
+  client_->bytes_fetched_ += chunk.data().size();
+  if (client_->bytes_fetched_counter_) {
+    client_->bytes_fetched_counter_->IncrementBy(chunk.data().size());
+  }
+
+  state.received.emplace(offset, std::move(fetch));
+  for (auto it = state.received.begin();
+       it != state.received.end() && it->first == state.next_write_offset;
+       it = state.received.erase(it)) {
+    const auto& data = it->second->resp.chunk().data();
+    RETURN_NOT_OK(state.writer->Append(data));
+    state.next_write_offset += data.size();
+  }
+
+  if (state.next_write_offset == *state.total_length) {
+    return FinishFile(index);
+  }
+  FetchMore(index);
+  return Status::OK();
+}
+
+Status RemoteBootstrapClient::FileFetcher::FinishFile(size_t index) {
+  const auto& file = files_[index];
+  auto& state = states_[index];
+  RETURN_NOT_OK_PREPEND(state.writer->Close(), Format("Unable to close $0", file.path));
+  state.writer.reset();
+  --active_files_;
+  VLOG(2) << client_->LogPrefix() << "Downloaded file " << file.path;
+
+  if (file.inode != 0) {
+    client_->inode2file_.emplace(file.inode, file.path);
+  }
+  return Status::OK();
+}
+
 RemoteBootstrapClient::RemoteBootstrapClient(std::string tablet_id,
                                              FsManager* fs_manager,
                                              shared_ptr<Messenger> messenger,
@@ -196,6 +497,10 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
                                     TSTabletManager* ts_manager) {
   CHECK(!started_);
   start_time_micros_ = GetCurrentTimeMicros();
+  if (ts_manager != nullptr && ts_manager->server() != nullptr) {
+    bytes_fetched_counter_ = METRIC_remote_bootstrap_bytes_fetched.Instantiate(
+        ts_manager->server()->metric_entity());
+  }
 
   Endpoint addr;
   RETURN_NOT_OK(EndpointFromHostPort(bootstrap_peer_addr, &addr));
@@ -357,8 +662,16 @@ Status RemoteBootstrapClient::FetchAll(TabletStatusListener* status_listener) {
   status_listener_ = CHECK_NOTNULL(status_listener);
 
   VLOG_WITH_PREFIX(2) << "Fetching table_type: " << TableType_Name(meta_->table_type());
+  const auto start = MonoTime::Now();
   RETURN_NOT_OK(DownloadRocksDBFiles());
   RETURN_NOT_OK(DownloadWALs());
+
+  const auto elapsed = MonoTime::Now() - start;
+  LOG_WITH_PREFIX(INFO) << "Fetched " << HumanReadableNumBytes::ToString(bytes_fetched_)
+                        << " in " << elapsed.ToString() << " ("
+                        << HumanReadableNumBytes::ToString(static_cast<int64_t>(
+                               bytes_fetched_ / std::max(elapsed.ToSeconds(), 1e-3)))
+                        << "/s)";
   return Status::OK();
 }
 
@@ -522,53 +835,50 @@ Status RemoteBootstrapClient::DownloadWALs() {
                         Substitute("Failed to sync WAL table directory $0", wal_table_top_dir));
 
   // Download the WAL segments.
-  int num_segments = wal_seqnos_.size();
-  LOG_WITH_PREFIX(INFO) << "Starting download of " << num_segments << " WAL segments...";
-  uint64_t counter = 0;
-  for (uint64_t seg_seqno : wal_seqnos_) {
-    UpdateStatusMessage(Substitute("Downloading WAL segment with seq. number $0 ($1/$2)",
-                                   seg_seqno, counter + 1, num_segments));
-    RETURN_NOT_OK(DownloadWAL(seg_seqno));
-    ++counter;
+  LOG_WITH_PREFIX(INFO) << "Starting download of " << wal_seqnos_.size() << " WAL segments...";
+  std::vector<FileDownload> files(wal_seqnos_.size());
+  for (size_t i = 0; i != wal_seqnos_.size(); ++i) {
+    files[i].data_id.set_type(DataIdPB::LOG_SEGMENT);
+    files[i].data_id.set_wal_segment_seqno(wal_seqnos_[i]);
+    files[i].path = fs_manager_->GetWalSegmentFileName(wal_dir, wal_seqnos_[i]);
   }
+  RETURN_NOT_OK(DownloadFiles(files));
 
   downloaded_wal_ = true;
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::DownloadFile(
-    const tablet::FilePB& file_pb, const std::string& dir, DataIdPB *data_id) {
-  auto file_path = JoinPathSegments(dir, file_pb.name());
-  if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
-      VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
-      if (link_status.ok()) {
-        return Status::OK();
-      }
-      // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
-                             << ": " << link_status;
+Status RemoteBootstrapClient::DownloadFiles(const std::vector<FileDownload>& files) {
+  // Only the first file of each inode is fetched, the others are linked to it once it is complete.
+  std::vector<FileDownload> to_fetch;
+  std::vector<const FileDownload*> to_link;
+  std::unordered_set<uint64_t> inodes;
+  for (const auto& file : files) {
+    if (file.inode != 0 &&
+        (inode2file_.count(file.inode) != 0 || !inodes.insert(file.inode).second)) {
+      to_link.push_back(&file);
+    } else {
+      to_fetch.push_back(file);
     }
   }
-
-  WritableFileOptions opts;
-  opts.sync_on_close = true;
-  gscoped_ptr<WritableFile> file;
-  RETURN_NOT_OK(fs_manager_->env()->NewWritableFile(opts, file_path, &file));
-
-  data_id->set_file_name(file_pb.name());
-  RETURN_NOT_OK_PREPEND(DownloadFile(*data_id, file.get()),
-                        Format("Unable to download $0 file $1",
-                               DataIdPB::IdType_Name(data_id->type()), file_path));
-  VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
-
-  if (file_pb.inode() != 0) {
-    inode2file_.emplace(file_pb.inode(), file_path);
+  RETURN_NOT_OK(FileFetcher(this, to_fetch).Run());
+
+  std::vector<FileDownload> unlinked;
+  for (const auto* file : to_link) {
+    const auto& target = inode2file_.at(file->inode);
+    VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file->path
+                        << " => " << target;
+    auto link_status = fs_manager_->env()->LinkFile(target, file->path);
+    if (!link_status.ok()) {
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file->path << " => " << target
+                             << ": " << link_status << ", downloading it instead";
+      unlinked.push_back(*file);
+      unlinked.back().inode = 0;
+    }
+  }
+  if (!unlinked.empty()) {
+    RETURN_NOT_OK(FileFetcher(this, unlinked).Run());
   }
-
   return Status::OK();
 }
 
@@ -593,34 +903,28 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  std::vector<FileDownload> files;
+  files.reserve(new_sb->rocksdb_files_size());
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
+    files.emplace_back();
+    auto& file = files.back();
+    file.data_id.set_type(DataIdPB::ROCKSDB_FILE);
+    file.data_id.set_file_name(file_pb.name());
+    file.path = JoinPathSegments(rocksdb_dir, file_pb.name());
+    file.inode = file_pb.inode();
+    // Files of intents RocksDB are stored in a subdirectory of rocksdb_dir.
+    const auto file_dir = DirName(file.path);
+    if (file_dir != rocksdb_dir) {
+      RETURN_NOT_OK_PREPEND(meta_->fs_manager()->CreateDirIfMissing(file_dir),
+                            Substitute("Failed to create RocksDB directory $0", file_dir));
+    }
   }
+  RETURN_NOT_OK(DownloadFiles(files));
   new_superblock_.swap(new_sb);
   downloaded_rocksdb_files_ = true;
   return Status::OK();
 }
 
-Status RemoteBootstrapClient::DownloadWAL(uint64_t wal_segment_seqno) {
-  VLOG_WITH_PREFIX(1) << "Downloading WAL segment with seqno " << wal_segment_seqno;
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::LOG_SEGMENT);
-  data_id.set_wal_segment_seqno(wal_segment_seqno);
-  const string dest_path = fs_manager_->GetWalSegmentFileName(meta_->wal_dir(), wal_segment_seqno);
-
-  WritableFileOptions opts;
-  opts.sync_on_close = true;
-  gscoped_ptr<WritableFile> writer;
-  RETURN_NOT_OK_PREPEND(fs_manager_->env()->NewWritableFile(opts, dest_path, &writer),
-                        "Unable to open file for writing");
-  RETURN_NOT_OK_PREPEND(DownloadFile(data_id, writer.get()),
-                        Substitute("Unable to download WAL segment with seq. number $0",
-                                   wal_segment_seqno));
-  return Status::OK();
-}
-
 Status RemoteBootstrapClient::WriteConsensusMetadata() {
   // If we didn't find a previous consensus meta file, create one.
   if (!cmeta_) {
@@ -671,8 +975,7 @@ template<class Appendable>
 Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
                                            Appendable* appendable) {
   uint64_t offset = 0;
-  int32_t max_length = std::min(FLAGS_remote_bootstrap_max_chunk_size,
-                                FLAGS_rpc_max_message_size - kBytesReservedForMessageHeaders);
+  int32_t max_length = MaxChunkLength();
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
@@ -51,6 +51,7 @@ namespace yb {
 
 class BlockId;
 class BlockIdPB;
+class Counter;
 class FsManager;
 class HostPort;
 
@@ -77,8 +78,9 @@ class TSTabletManager;
 // Client class for using remote bootstrap to copy a tablet from another host.
 // This class is not thread-safe.
 //
-// TODO:
-// * Parallelize download of blocks and WAL segments.
+// Files are fetched several at a time, with several chunk requests in flight for each of them, see
+// remote_bootstrap_max_concurrent_files and remote_bootstrap_max_outstanding_chunks. The fetch rate
+// of all sessions in the process is limited by remote_bootstrap_rate_limit_bytes_per_sec.
 //
 class RemoteBootstrapClient {
  public:
@@ -149,14 +151,9 @@ class RemoteBootstrapClient {
   // End the remote bootstrap session.
   CHECKED_STATUS EndRemoteSession();
 
-  // Download all WAL files sequentially.
+  // Download all WAL files.
   CHECKED_STATUS DownloadWALs();
 
-  // Download a single WAL file.
-  // Assumes the WAL directories have already been created.
-  // WAL file is opened with options so that it will fsync() on close.
-  CHECKED_STATUS DownloadWAL(uint64_t wal_segment_seqno);
-
   // Write out the Consensus Metadata file based on the ConsensusStatePB
   // downloaded as part of initiating the remote bootstrap session.
   CHECKED_STATUS WriteConsensusMetadata();
@@ -183,8 +180,18 @@ class RemoteBootstrapClient {
 
   CHECKED_STATUS VerifyData(uint64_t offset, const DataChunkPB& resp);
 
-  CHECKED_STATUS DownloadFile(
-      const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
+  // A remote file and the local path it should be downloaded to.
+  struct FileDownload {
+    DataIdPB data_id;
+    std::string path;
+    // Inode of the remote file, or 0 if unknown. Files sharing an inode are downloaded once and
+    // hard linked.
+    uint64_t inode = 0;
+  };
+
+  // Download the given files. Assumes their directories have already been created.
+  // Files are opened with options so that they will fsync() on close.
+  CHECKED_STATUS DownloadFiles(const std::vector<FileDownload>& files);
 
   // Return standard log prefix.
   std::string LogPrefix();
@@ -226,7 +233,14 @@ class RemoteBootstrapClient {
   // EndRemoteBootstrapSessionRequestPB request.
   bool succeeded_;
 
+  // Number of file bytes fetched by this session, and the server wide counter of them (null when
+  // the client is not running on a tablet server).
+  uint64_t bytes_fetched_ = 0;
+  scoped_refptr<Counter> bytes_fetched_counter_;
+
  private:
+  class FileFetcher;
+
   std::unordered_map<uint64_t, std::string> inode2file_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
@@ -15,6 +15,10 @@
 
 #include "yb/tserver/remote_bootstrap_client-test.h"
 
+DECLARE_int32(remote_bootstrap_max_chunk_size);
+DECLARE_int32(remote_bootstrap_max_outstanding_chunks);
+DECLARE_int32(remote_bootstrap_max_concurrent_files);
+DECLARE_int64(remote_bootstrap_max_fetch_data_length);
 
 using std::shared_ptr;
 
@@ -33,6 +37,10 @@ class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
   void SetUp() override {
     RemoteBootstrapClientTest::SetUp();
   }
+
+ protected:
+  // Verifies that the client has the same RocksDB files that the leader has.
+  void VerifyRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -46,6 +54,34 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
 TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->DownloadRocksDBFiles());
+  VerifyRocksDBFiles();
+}
+
+// Download with chunks much smaller than the files, so every file is fetched by many pipelined
+// chunk requests and several files are in flight at once.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesPipelined) {
+  FLAGS_remote_bootstrap_max_chunk_size = 1000;
+  FLAGS_remote_bootstrap_max_outstanding_chunks = 8;
+  FLAGS_remote_bootstrap_max_concurrent_files = 3;
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->FetchAll(&listener));
+  VerifyRocksDBFiles();
+  ASSERT_OK(client_->Finish());
+}
+
+// The source returns less than each request asks for, so the client has to request the rest of
+// every chunk.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesShortChunks) {
+  FLAGS_remote_bootstrap_max_chunk_size = 1000;
+  FLAGS_remote_bootstrap_max_outstanding_chunks = 4;
+  FLAGS_remote_bootstrap_max_fetch_data_length = 300;
+  TabletStatusListener listener(meta_);
+  ASSERT_OK(client_->FetchAll(&listener));
+  VerifyRocksDBFiles();
+  ASSERT_OK(client_->Finish());
+}
+
+void RemoteBootstrapRocksDBClientTest::VerifyRocksDBFiles() {
   auto tablet_peer_checkpoint_dir = tablet_peer_->tablet()->GetLastRocksDBCheckpointDirForTest();
 
   vector<std::string> rocksdb_files;
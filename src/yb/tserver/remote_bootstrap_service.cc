@@ -81,6 +81,10 @@ DEFINE_test_flag(double, fault_crash_on_handle_rb_fetch_data, 0.0,
                  "Fraction of the time when the tablet will crash while "
                  "servicing a RemoteBootstrapService FetchData() RPC call.");
 
+DEFINE_test_flag(int64, remote_bootstrap_max_fetch_data_length, 0,
+                 "When positive, FetchData() returns at most this many bytes per call, even if "
+                 "the client requested more.");
+
 DEFINE_test_flag(uint64, inject_latency_before_change_role_secs, 0,
                  "Number of seconds to sleep before we call ChangeRole.");
 
@@ -101,6 +105,10 @@ DEFINE_test_flag(double, fault_crash_leader_after_changing_role, 0.0,
 DEFINE_uint64(remote_bootstrap_change_role_timeout_ms, 15000,
               "Timeout for change role operation during remote bootstrap.");
 
+METRIC_DEFINE_counter(server, remote_bootstrap_bytes_sent,
+                      "Remote Bootstrap Bytes Sent", yb::MetricUnit::kBytes,
+                      "Number of bytes of tablet data sent to remote bootstrap clients.");
+
 namespace yb {
 namespace tserver {
 
@@ -129,7 +137,8 @@ RemoteBootstrapServiceImpl::RemoteBootstrapServiceImpl(
     : RemoteBootstrapServiceIf(metric_entity),
       fs_manager_(CHECK_NOTNULL(fs_manager)),
       tablet_peer_lookup_(CHECK_NOTNULL(tablet_peer_lookup)),
-      shutdown_latch_(1) {
+      shutdown_latch_(1),
+      bytes_sent_(METRIC_remote_bootstrap_bytes_sent.Instantiate(metric_entity)) {
   CHECK_OK(Thread::Create("remote-bootstrap", "rb-session-exp",
                           &RemoteBootstrapServiceImpl::EndExpiredSessions, this,
                           &session_expiration_thread_));
@@ -279,6 +288,10 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
 
   uint64_t offset = req->offset();
   int64_t client_maxlen = req->max_length();
+  if (PREDICT_FALSE(FLAGS_remote_bootstrap_max_fetch_data_length > 0) &&
+      (client_maxlen <= 0 || client_maxlen > FLAGS_remote_bootstrap_max_fetch_data_length)) {
+    client_maxlen = FLAGS_remote_bootstrap_max_fetch_data_length;
+  }
 
   const DataIdPB& data_id = req->data_id();
   RemoteBootstrapErrorPB::Code error_code = RemoteBootstrapErrorPB::UNKNOWN_ERROR;
@@ -299,6 +312,9 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
   uint32_t crc32 = Crc32c(data->data(), data->length());
   data_chunk->set_crc32(crc32);
 
+  session->AddBytesSent(data->size());
+  bytes_sent_->IncrementBy(data->size());
+
   context.RespondSuccess();
 }
 
@@ -448,7 +464,8 @@ Status RemoteBootstrapServiceImpl::DoEndRemoteBootstrapSessionUnlocked(
   // Remove the session from the map.
   // It will get destroyed once there are no outstanding refs.
   LOG(INFO) << "Ending remote bootstrap session " << session_id << " on tablet "
-            << session->tablet_id() << " with peer " << session->requestor_uuid();
+            << session->tablet_id() << " with peer " << session->requestor_uuid() << ", "
+            << session->TransferStatsToString();
   CHECK_EQ(1, sessions_.erase(session_id));
   CHECK_EQ(1, session_expirations_.erase(session_id));
 
@@ -131,6 +131,9 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
   // TODO: this is a hack, replace with some kind of timer impl. See KUDU-286.
   CountDownLatch shutdown_latch_;
   scoped_refptr<Thread> session_expiration_thread_;
+
+  // Total number of file bytes sent to remote bootstrap clients.
+  scoped_refptr<Counter> bytes_sent_;
 };
 
 } // namespace tserver
@@ -38,6 +38,7 @@
 #include "yb/consensus/log_reader.h"
 #include "yb/fs/block_manager.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/type_traits.h"
 #include "yb/server/metadata.h"
@@ -75,7 +76,8 @@ RemoteBootstrapSession::RemoteBootstrapSession(
       fs_manager_(fs_manager),
       blocks_deleter_(&blocks_),
       logs_deleter_(&logs_),
-      succeeded_(false) {}
+      succeeded_(false),
+      start_time_(MonoTime::Now()) {}
 
 RemoteBootstrapSession::~RemoteBootstrapSession() {
   // No lock taken in the destructor, should only be 1 thread with access now.
@@ -536,5 +538,15 @@ bool RemoteBootstrapSession::Succeeded() {
   return succeeded_;
 }
 
+std::string RemoteBootstrapSession::TransferStatsToString() const {
+  const auto bytes = bytes_sent();
+  const auto elapsed = MonoTime::Now() - start_time_;
+  const double seconds = std::max(elapsed.ToSeconds(), 1e-3);
+  return Substitute("sent $0 in $1 ($2/s)",
+                    HumanReadableNumBytes::ToString(bytes),
+                    elapsed.ToString(),
+                    HumanReadableNumBytes::ToString(static_cast<int64_t>(bytes / seconds)));
+}
+
 } // namespace tserver
 } // namespace yb
@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 #define YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -49,6 +50,7 @@
 #include "yb/tserver/remote_bootstrap.pb.h"
 #include "yb/util/env_util.h"
 #include "yb/util/locks.h"
+#include "yb/util/monotime.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -165,6 +167,16 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   bool Succeeded();
 
+  // Accounts 'bytes' of file data sent to the requestor, used for transfer throughput reporting.
+  void AddBytesSent(uint64_t bytes) {
+    bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  uint64_t bytes_sent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+
+  // Human readable summary of the data sent so far and the average transfer rate.
+  std::string TransferStatsToString() const;
+
   // Change the peer's role to VOTER.
   CHECKED_STATUS ChangeRole();
 
@@ -231,6 +243,9 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   // Directory where the checkpoint files are stored for this session (only for rocksdb).
   std::string checkpoint_dir_;
 
+  const MonoTime start_time_;
+  std::atomic<uint64_t> bytes_sent_{0};
+
  private:
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapSession);
 };
@@ -197,6 +197,12 @@ TEST_F(TabletServerTest, TestSetFlagsAndCheckWebPages) {
                        &buf));
   ASSERT_STR_CONTAINS(buf.ToString(), "<th>key</th>");
   ASSERT_STR_CONTAINS(buf.ToString(), "<td>string NULLABLE NOT A PARTITION KEY</td>");
+  ASSERT_STR_CONTAINS(buf.ToString(), "/tablet-latency?id=");
+
+  // Write latency breakdown page should render for the tablet.
+  ASSERT_OK(c.FetchURL(Substitute("http://$0/tablet-latency?id=$1", addr, kTabletId),
+                       &buf));
+  ASSERT_STR_CONTAINS(buf.ToString(), "<h1>Write Latency Breakdown</h1>");
 
   // Test fetching metrics.
   // Fetching metrics has the side effect of retiring metrics, but not in a single pass.
@@ -226,6 +232,7 @@ TEST_F(TabletServerTest, TestSetFlagsAndCheckWebPages) {
     ASSERT_STR_CONTAINS(buf.ToString(), "tcmalloc_max_total_thread_cache_bytes");
 #endif
     ASSERT_STR_CONTAINS(buf.ToString(), "glog_info_messages");
+    ASSERT_STR_CONTAINS(buf.ToString(), "write_replication_latency");
   }
 
   // Smoke-test the tracing infrastructure.
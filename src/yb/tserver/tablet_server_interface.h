@@ -14,6 +14,8 @@
 #ifndef YB_TSERVER_TABLET_SERVER_INTERFACE_H
 #define YB_TSERVER_TABLET_SERVER_INTERFACE_H
 
+#include <memory>
+
 #include "yb/server/clock.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/metrics.h"
@@ -21,6 +23,8 @@
 namespace yb {
 namespace tserver {
 
+class TabletServerServiceProxy;
+
 class TabletServerIf {
  public:
 
@@ -30,6 +34,9 @@ class TabletServerIf {
 
   virtual server::Clock* Clock() = 0;
   virtual const scoped_refptr<MetricEntity>& MetricEnt() const = 0;
+
+  // Returns the proxy to call this server locally, null if local calls are not supported.
+  virtual const std::shared_ptr<TabletServerServiceProxy>& proxy() const = 0;
 };
 
 } // namespace tserver
@@ -33,6 +33,7 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,6 +63,7 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/alter_schema_operation.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -75,6 +77,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
@@ -183,6 +186,20 @@ bool GetConsensusOrRespond(const TabletPeerPtr& tablet_peer,
   return true;
 }
 
+// Leader could send the operations to replicate as request sidecars, see
+// consensus_send_ops_as_sidecars. Parses them into the ops of the request.
+Status ParseOpsFromSidecars(const rpc::RpcContext& context, ConsensusRequestPB* req) {
+  for (auto idx : req->ops_sidecars()) {
+    Slice sidecar;
+    RETURN_NOT_OK(context.GetRequestSidecar(idx, &sidecar));
+    if (!req->add_ops()->ParseFromArray(sidecar.data(), sidecar.size())) {
+      return STATUS_FORMAT(Corruption, "Failed to parse operation from request sidecar $0", idx);
+    }
+  }
+  req->clear_ops_sidecars();
+  return Status::OK();
+}
+
 Status GetTabletRef(const TabletPeerPtr& tablet_peer,
                     shared_ptr<Tablet>* tablet,
                     TabletServerErrorPB::Code* error_code) {
@@ -191,9 +208,60 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
     *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
     return STATUS(IllegalState, "Tablet is not running");
   }
+  if (PREDICT_FALSE((*tablet)->IsSplit())) {
+    *error_code = TabletServerErrorPB::TABLET_SPLIT;
+    return STATUS_FORMAT(IllegalState, "Tablet $0 was split", tablet_peer->tablet_id());
+  }
+  return Status::OK();
+}
+
+// Operations are routed with the partitions of the table cached by the client, so after a tablet
+// split they could reach a tablet that does not own their hash code anymore.
+template <class Batch, class GetKey>
+CHECKED_STATUS CheckHashCodes(const tablet::AbstractTablet& tablet,
+                              const docdb::DocKeyHashRange& range,
+                              const Batch& batch,
+                              const GetKey& get_key) {
+  for (const auto& request : batch) {
+    const auto& key = get_key(request);
+    if (key.has_hash_code() && !range.Contains(key.hash_code())) {
+      return STATUS_FORMAT(IllegalState, "Hash code $0 is outside of the partition of tablet $1",
+                           key.hash_code(), tablet.tablet_id());
+    }
+  }
   return Status::OK();
 }
 
+CHECKED_STATUS CheckWriteHashCodes(const tablet::AbstractTablet& tablet,
+                                   const WriteRequestPB& req) {
+  const auto range = tablet.PartitionHashRange();
+  if (range.IsFull()) {
+    return Status::OK();
+  }
+  auto self = [](const auto& request) -> const auto& { return request; };
+  auto redis_key = [](const RedisWriteRequestPB& request) -> const RedisKeyValuePB& {
+    return request.key_value();
+  };
+  RETURN_NOT_OK(CheckHashCodes(tablet, range, req.ql_write_batch(), self));
+  RETURN_NOT_OK(CheckHashCodes(tablet, range, req.pgsql_write_batch(), self));
+  return CheckHashCodes(tablet, range, req.redis_write_batch(), redis_key);
+}
+
+CHECKED_STATUS CheckReadHashCodes(const tablet::AbstractTablet& tablet,
+                                  const ReadRequestPB& req) {
+  const auto range = tablet.PartitionHashRange();
+  if (range.IsFull()) {
+    return Status::OK();
+  }
+  auto self = [](const auto& request) -> const auto& { return request; };
+  auto redis_key = [](const RedisReadRequestPB& request) -> const RedisKeyValuePB& {
+    return request.key_value();
+  };
+  RETURN_NOT_OK(CheckHashCodes(tablet, range, req.ql_batch(), self));
+  RETURN_NOT_OK(CheckHashCodes(tablet, range, req.pgsql_batch(), self));
+  return CheckHashCodes(tablet, range, req.redis_batch(), redis_key);
+}
+
 } // namespace
 
 // Prepares modification operation, checks limits, fetches tablet_peer and tablet etc.
@@ -298,6 +366,13 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
         response_->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
       }
       response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+      // The write is already applied, so safe time for followers is not less than its hybrid time.
+      if (state_->tablet() != nullptr) {
+        auto safe_time = state_->tablet()->SafeTime(tablet::RequireLease::kFalse);
+        if (safe_time.is_valid()) {
+          response_->set_safe_time(safe_time.ToUint64());
+        }
+      }
       context_->RespondSuccess();
     }
   }
@@ -691,6 +766,60 @@ void TabletServiceAdminImpl::FlushTablets(const FlushTabletsRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceAdminImpl::SplitTablet(const SplitTabletRequestPB* req,
+                                         SplitTabletResponsePB* resp,
+                                         rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "SplitTablet", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "SplitTablet",
+               "tablet_id", req->tablet_id());
+
+  if (req->new_tablet_ids_size() < 2 || req->new_tablet_ids_size() != req->new_partitions_size() ||
+      !req->has_config()) {
+    const Status s = STATUS(InvalidArgument,
+                            "Expected at least two new tablets with partitions and a config");
+    SetupErrorAndRespond(
+        resp->mutable_error(), s, TabletServerErrorPB_Code_UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  server::UpdateClock(*req, server_->Clock());
+
+  LOG(INFO) << "Processing SplitTablet for tablet " << req->tablet_id() << " from "
+            << context.requestor_string();
+  VLOG(1) << "Full request: " << req->DebugString();
+
+  TabletPeerPtr tablet_peer;
+  if (!LookupTabletPeerOrRespond(
+      server_->tablet_manager(), req->tablet_id(), resp, &context, &tablet_peer)) {
+    return;
+  }
+
+  if (tablet_peer->IsSplit() && server_->tablet_manager()->HasSplitTablets(*req)) {
+    // The master retries the request when the response to a completed split was lost.
+    context.RespondSuccess();
+    return;
+  }
+
+  TabletServerErrorPB::Code error_code;
+  Status s = server_->tablet_manager()->StartTabletSplit(tablet_peer, *req, &error_code);
+  if (!s.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
+    return;
+  }
+
+  auto operation_state = std::make_unique<tablet::SplitOperationState>(
+      tablet_peer->tablet(), server_->tablet_manager(), req);
+  operation_state->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Submit the split operation. The RPC will be responded to asynchronously, once the new tablets
+  // were created on this server.
+  tablet_peer->Submit(
+      std::make_unique<tablet::SplitOperation>(std::move(operation_state), consensus::LEADER));
+}
+
 void TabletServiceImpl::Write(const WriteRequestPB* req,
                               WriteResponsePB* resp,
                               rpc::RpcContext context) {
@@ -726,6 +855,12 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  Status s = CheckWriteHashCodes(*tablet, *req);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, TabletServerErrorPB::TABLET_SPLIT, &context);
+    return;
+  }
+
   bool has_operations = (req->ql_write_batch_size() != 0 ||
                          req->redis_write_batch_size() != 0 ||
                          req->pgsql_write_batch_size());
@@ -747,6 +882,11 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   auto status = tablet_peer->SubmitWrite(std::move(operation_state));
 
   // Check that we could submit the write
+  if (PREDICT_FALSE(!status.ok() && tablet_peer->IsSplit())) {
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::TABLET_SPLIT,
+                         context_ptr.get());
+    return;
+  }
   RETURN_UNKNOWN_ERROR_IF_NOT_OK(status, resp, context_ptr.get());
 }
 
@@ -841,6 +981,106 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
   return true;
 }
 
+namespace {
+
+// State of a MultiWrite call shared by the callbacks of its per tablet writes.
+class MultiWriteContext {
+ public:
+  MultiWriteContext(const MultiWriteRequestPB* req, MultiWriteResponsePB* resp,
+                    rpc::RpcContext context)
+      : req_(req), resp_(resp), context_(std::move(context)),
+        controllers_(req->requests_size()), pending_(req->requests_size()) {
+    // No deadline is set on the local calls on purpose. They write directly to the responses of
+    // this call, so they should not finish before the writes themselves are done.
+  }
+
+  static void Start(const std::shared_ptr<MultiWriteContext>& self,
+                    TabletServerServiceProxy* proxy) {
+    for (int i = 0; i != self->req_->requests_size(); ++i) {
+      self->resp_->add_responses();
+    }
+    for (int i = 0; i != self->req_->requests_size(); ++i) {
+      proxy->WriteAsync(self->req_->requests(i), self->resp_->mutable_responses(i),
+                       &self->controllers_[i], [self] { self->WriteDone(); });
+    }
+  }
+
+ private:
+  void WriteDone() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    for (int i = 0; i != req_->requests_size(); ++i) {
+      auto* response = resp_->mutable_responses(i);
+      const auto& controller = controllers_[i];
+      auto status = controller.status();
+      if (!status.ok()) {
+        // The write was not even dispatched, e.g. the service queue is full, let the client retry.
+        status = STATUS_FORMAT(ServiceUnavailable, "Write was not dispatched: $0", status);
+      } else {
+        // Sidecars of the per tablet writes belong to their own calls, so move them to this call
+        // and renumber the references to them.
+        status = MoveSidecars(controller, response->mutable_ql_response_batch());
+        if (status.ok()) {
+          status = MoveSidecars(controller, response->mutable_pgsql_response_batch());
+        }
+      }
+      if (!status.ok()) {
+        response->Clear();
+        StatusToPB(status, response->mutable_error()->mutable_status());
+        response->mutable_error()->set_code(TabletServerErrorPB::UNKNOWN_ERROR);
+      }
+    }
+    context_.RespondSuccess();
+  }
+
+  template <class Responses>
+  CHECKED_STATUS MoveSidecars(const rpc::RpcController& controller, Responses* responses) {
+    for (auto& response : *responses) {
+      if (!response.has_rows_data_sidecar()) {
+        continue;
+      }
+      Slice sidecar;
+      RETURN_NOT_OK(controller.GetSidecar(response.rows_data_sidecar(), &sidecar));
+      int idx = 0;
+      RETURN_NOT_OK(context_.AddRpcSidecar(RefCntBuffer(sidecar.data(), sidecar.size()), &idx));
+      response.set_rows_data_sidecar(idx);
+    }
+    return Status::OK();
+  }
+
+  const MultiWriteRequestPB* const req_;
+  MultiWriteResponsePB* const resp_;
+  rpc::RpcContext context_;
+  std::vector<rpc::RpcController> controllers_;
+  std::atomic<int> pending_;
+};
+
+} // namespace
+
+void TabletServiceImpl::MultiWrite(const MultiWriteRequestPB* req,
+                                   MultiWriteResponsePB* resp,
+                                   rpc::RpcContext context) {
+  TRACE_EVENT1("tserver", "TabletServiceImpl::MultiWrite",
+               "num_requests", req->requests_size());
+  const auto& proxy = server_->proxy();
+  if (!proxy) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS(NotSupported, "MultiWrite requires local tablet server calls"),
+                         TabletServerErrorPB::OPERATION_NOT_SUPPORTED, &context);
+    return;
+  }
+  if (req->requests_size() == 0) {
+    context.RespondSuccess();
+    return;
+  }
+
+  // Each write is queued to the service pool of this server as a local call, so writes to
+  // different tablets proceed in parallel and go through exactly the same checks as a plain Write.
+  MultiWriteContext::Start(std::make_shared<MultiWriteContext>(req, resp, std::move(context)),
+                           proxy.get());
+}
+
 void TabletServiceImpl::Read(const ReadRequestPB* req,
                              ReadResponsePB* resp,
                              rpc::RpcContext context) {
@@ -858,6 +1098,25 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
 
+  {
+    auto status = CheckReadHashCodes(*tablet, *req);
+    if (PREDICT_FALSE(!status.ok())) {
+      SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::TABLET_SPLIT,
+                           &context);
+      return;
+    }
+  }
+
+  if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+      (req->has_max_staleness_ms() || req->has_min_safe_ht())) {
+    auto status = CheckFollowerReadStaleness(tablet.get(), req);
+    if (!status.ok()) {
+      SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::STALE_FOLLOWER,
+                           &context);
+      return;
+    }
+  }
+
   // safe_ht_to_read is used only for read restart, so if read_time is valid, then we would respond
   // with "restart required".
   HybridTime safe_ht_to_read;
@@ -936,6 +1195,26 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   TRACE("Done Read");
 }
 
+Status TabletServiceImpl::CheckFollowerReadStaleness(tablet::AbstractTablet* tablet,
+                                                     const ReadRequestPB* req) {
+  auto safe_time = tablet->SafeTime(tablet::RequireLease::kFalse);
+  if (req->has_min_safe_ht() && safe_time < HybridTime(req->min_safe_ht())) {
+    return STATUS_FORMAT(ServiceUnavailable,
+                         "Safe time $0 of tablet $1 is behind the last write $2 of the session",
+                         safe_time, req->tablet_id(), HybridTime(req->min_safe_ht()));
+  }
+  if (req->has_max_staleness_ms()) {
+    auto staleness_us = server_->Clock()->Now().PhysicalDiff(safe_time);
+    if (staleness_us > static_cast<int64_t>(req->max_staleness_ms()) * 1000) {
+      return STATUS_FORMAT(ServiceUnavailable,
+                           "Safe time $0 of tablet $1 is $2ms stale, max allowed: $3ms",
+                           safe_time, req->tablet_id(), staleness_us / 1000,
+                           req->max_staleness_ms());
+    }
+  }
+  return Status::OK();
+}
+
 void HandleRedisReadRequestAsync(
     tablet::AbstractTablet* tablet,
     const ReadHybridTime& read_time,
@@ -1085,7 +1364,11 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   // Unfortunately, we have to use const_cast here, because the protobuf-generated interface only
   // gives us a const request, but we need to be able to move messages out of the request for
   // efficiency.
-  Status s = consensus->Update(const_cast<ConsensusRequestPB*>(req), resp);
+  auto* mutable_req = const_cast<ConsensusRequestPB*>(req);
+  Status s = ParseOpsFromSidecars(context, mutable_req);
+  if (s.ok()) {
+    s = consensus->Update(mutable_req, resp);
+  }
   if (PREDICT_FALSE(!s.ok())) {
     // Clear the response first, since a partially-filled response could
     // result in confusing a caller, or in having missing required fields
@@ -67,6 +67,12 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   void Read(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context) override;
 
+  // Splits the request into its per tablet writes, runs them in parallel through the local proxy
+  // of this server and responds once all of them are done.
+  void MultiWrite(const MultiWriteRequestPB* req,
+                  MultiWriteResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void NoOp(const NoOpRequestPB* req, NoOpResponsePB* resp, rpc::RpcContext context) override;
 
   void ListTablets(const ListTabletsRequestPB* req,
@@ -139,6 +145,11 @@ class TabletServiceImpl : public TabletServerServiceIf {
                      tablet::TabletPeerPtr* tablet_peer,
                      tablet::TabletPtr* tablet);
 
+  // Checks that the safe time of this replica satisfies the staleness bound of a CONSISTENT_PREFIX
+  // read, i.e. that it is not older than max_staleness_ms and not lower than min_safe_ht.
+  CHECKED_STATUS CheckFollowerReadStaleness(tablet::AbstractTablet* tablet,
+                                            const ReadRequestPB* req);
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead(tablet::AbstractTablet* tablet,
@@ -178,6 +189,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                             FlushTabletsResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  virtual void SplitTablet(const SplitTabletRequestPB* req,
+                           SplitTabletResponsePB* resp,
+                           rpc::RpcContext context) override;
+
  private:
   TabletServer* server_;
 };
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -48,6 +49,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
+#include "yb/consensus/log_group_committer.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
@@ -60,6 +62,7 @@
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
 
 #include "yb/rpc/messenger.h"
@@ -104,10 +107,28 @@ DEFINE_int32(tablet_start_warn_threshold_ms, 500,
              "a warning with a trace.");
 TAG_FLAG(tablet_start_warn_threshold_ms, hidden);
 
+DEFINE_int32(tablet_split_wait_for_operations_timeout_ms, 10000,
+             "Time to wait for the pending operations of a tablet to finish before splitting it.");
+TAG_FLAG(tablet_split_wait_for_operations_timeout_ms, advanced);
+
+DEFINE_bool(log_group_commit_across_tablets, false,
+            "Hand the WAL syncs of all tablets over to a shared group commit stage with one thread "
+            "per WAL drive, so that concurrent appends of different tablets share sync passes "
+            "instead of each log syncing on its own append thread.");
+TAG_FLAG(log_group_commit_across_tablets, advanced);
+TAG_FLAG(log_group_commit_across_tablets, experimental);
+
 DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(block_cache_eviction_policy, "strict_lru",
+              "Eviction policy of the block cache shared by the tablets of this server: "
+              "strict_lru or sampled_lru. sampled_lru does not serialize concurrent hits on a "
+              "shard, but evicts less precisely, has no single touch pool and ignores "
+              "db_block_cache_num_shard_bits.");
+TAG_FLAG(block_cache_eviction_policy, advanced);
+
 DEFINE_test_flag(double, fault_crash_after_blocks_deleted, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after deleting the data blocks during tablet deletion.");
@@ -133,8 +154,32 @@ namespace {
 constexpr int kDbCacheSizeUsePercentage = -1;
 constexpr int kDbCacheSizeCacheDisabled = -2;
 
+const char* const kStrictLRUPolicy = "strict_lru";
+const char* const kSampledLRUPolicy = "sampled_lru";
+
+bool ValidateBlockCacheEvictionPolicy(const char* flagname, const std::string& value) {
+  if (value == kStrictLRUPolicy || value == kSampledLRUPolicy) {
+    return true;
+  }
+  LOG(ERROR) << flagname << " must be one of " << kStrictLRUPolicy << " or " << kSampledLRUPolicy
+             << ", value " << value << " is invalid";
+  return false;
+}
+
+// Creates the block cache shared by all tablets, with the eviction policy selected by
+// --block_cache_eviction_policy.
+std::shared_ptr<rocksdb::Cache> NewBlockCache(size_t capacity) {
+  if (FLAGS_block_cache_eviction_policy == kSampledLRUPolicy) {
+    return rocksdb::NewSampledLRUCache(capacity, "block_cache");
+  }
+  return rocksdb::NewLRUCache(capacity, FLAGS_db_block_cache_num_shard_bits);
+}
+
 } // namespace
 
+static bool block_cache_eviction_policy_dummy = google::RegisterFlagValidator(
+    &FLAGS_block_cache_eviction_policy, &ValidateBlockCacheEvictionPolicy);
+
 DEFINE_int32(flush_background_task_interval_msec, 0,
              "The tick interval time for the flush background task. "
              "This defaults to 0, which means disable the background task "
@@ -323,6 +368,12 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .unlimited_threads()
                .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
                .Build(&append_pool_));
+  // Continuations block waiting for statuses of conflicting transactions, so the number of
+  // threads is not limited, the same as for the pools above.
+  CHECK_OK(ThreadPoolBuilder("conflict-wait")
+               .unlimited_threads()
+               .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
+               .Build(&conflict_wait_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -348,8 +399,7 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    tablet_options_.block_cache = NewBlockCache(block_cache_size_bytes);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
 
@@ -399,6 +449,11 @@ Status TSTabletManager::Init() {
                 .set_max_threads(max_bootstrap_threads)
                 .Build(&open_tablet_pool_));
 
+  if (FLAGS_log_group_commit_across_tablets) {
+    log_group_committer_.reset(new log::LogGroupCommitter(fs_manager_->GetWalRootDirs()));
+    RETURN_NOT_OK(log_group_committer_->Start());
+  }
+
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
   RETURN_NOT_OK(fs_manager_->ListTabletIds(&tablet_ids));
@@ -482,7 +537,8 @@ Status TSTabletManager::CreateNewTablet(
     const Schema &schema,
     const PartitionSchema &partition_schema,
     RaftConfigPB config,
-    TabletPeerPtr *tablet_peer) {
+    TabletPeerPtr *tablet_peer,
+    tablet::Tablet* split_tablet) {
   CHECK_EQ(state(), MANAGER_RUNNING);
   CHECK(IsRaftConfigMember(server_->instance_pb().permanent_uuid(), config));
 
@@ -536,6 +592,17 @@ Status TSTabletManager::CreateNewTablet(
   RETURN_NOT_OK_PREPEND(create_status, "Couldn't create tablet metadata")
   LOG(INFO) << "Created tablet metadata for table: " << table_id << ", tablet: " << tablet_id;
 
+  if (split_tablet != nullptr) {
+    Status s = split_tablet->CreateSplitCheckpoint(meta->rocksdb_dir());
+    if (!s.ok()) {
+      WARN_NOT_OK(meta->DeleteTabletData(TABLET_DATA_DELETED, yb::OpId()),
+                  "Failed to delete data of tablet " + tablet_id);
+      WARN_NOT_OK(meta->DeleteSuperBlock(), "Failed to delete metadata of tablet " + tablet_id);
+      UnregisterDataWalDir(table_id, tablet_id, table_type, data_root_dir, wal_root_dir);
+      return s.CloneAndPrepend("Couldn't copy data of split tablet " + split_tablet->tablet_id());
+    }
+  }
+
   // We must persist the consensus metadata to disk before starting a new
   // tablet's TabletPeer and Consensus implementation.
   std::unique_ptr<ConsensusMetadata> cmeta;
@@ -554,6 +621,96 @@ Status TSTabletManager::CreateNewTablet(
   return Status::OK();
 }
 
+bool TSTabletManager::HasSplitTablets(const SplitTabletRequestPB& req) {
+  for (const auto& new_tablet_id : req.new_tablet_ids()) {
+    TabletPeerPtr new_peer;
+    if (!LookupTablet(new_tablet_id, &new_peer)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status TSTabletManager::StartTabletSplit(const TabletPeerPtr& tablet_peer,
+                                         const SplitTabletRequestPB& req,
+                                         TabletServerErrorPB::Code* error_code) {
+  *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  const auto consensus = tablet_peer->shared_consensus();
+  if (!tablet_peer->shared_tablet() || !consensus) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is not running", tablet_peer->tablet_id());
+  }
+  if (consensus->leader_status() != consensus::Consensus::LeaderStatus::LEADER_AND_READY) {
+    *error_code = TabletServerErrorPB::NOT_THE_LEADER;
+    return STATUS_FORMAT(IllegalState, "Not the leader of tablet $0", tablet_peer->tablet_id());
+  }
+
+  // Every voter of the split tablet creates the new tablets, so they must be the voters of the
+  // new tablets.
+  std::set<std::string> voters, new_voters;
+  for (const auto& peer : consensus->CommittedConfig().peers()) {
+    if (peer.member_type() == RaftPeerPB::VOTER) {
+      voters.insert(peer.permanent_uuid());
+    }
+  }
+  for (const auto& peer : req.config().peers()) {
+    if (peer.member_type() == RaftPeerPB::VOTER) {
+      new_voters.insert(peer.permanent_uuid());
+    }
+  }
+  if (voters != new_voters) {
+    *error_code = TabletServerErrorPB::INVALID_CONFIG;
+    return STATUS_FORMAT(InvalidArgument, "Voters of tablet $0 are $1, while the split expects $2",
+                         tablet_peer->tablet_id(), voters, new_voters);
+  }
+
+  LOG(INFO) << "Splitting tablet " << tablet_peer->tablet_id() << " into "
+            << yb::ToString(req.new_tablet_ids());
+  return tablet_peer->StartSplit(
+      MonoDelta::FromMilliseconds(FLAGS_tablet_split_wait_for_operations_timeout_ms));
+}
+
+Status TSTabletManager::ApplyTabletSplit(tablet::SplitOperationState* operation_state) {
+  const auto& req = *operation_state->request();
+  auto* tablet = operation_state->tablet();
+  if (req.new_tablet_ids_size() != req.new_partitions_size()) {
+    return STATUS_FORMAT(InvalidArgument, "Split of tablet $0 has $1 new tablets and $2 partitions",
+                         tablet->tablet_id(), req.new_tablet_ids_size(), req.new_partitions_size());
+  }
+  if (!IsRaftConfigMember(fs_manager_->uuid(), req.config())) {
+    LOG(INFO) << "Not a peer of the tablets split from " << tablet->tablet_id();
+    return Status::OK();
+  }
+  if (state() != MANAGER_RUNNING) {
+    return STATUS_FORMAT(IllegalState, "Tablet manager is not running: $0",
+                         TSTabletManagerStatePB_Name(state()));
+  }
+
+  const auto& meta = *tablet->metadata();
+  for (int i = 0; i != req.new_tablet_ids_size(); ++i) {
+    const auto& new_tablet_id = req.new_tablet_ids(i);
+    TabletPeerPtr new_peer;
+    if (LookupTablet(new_tablet_id, &new_peer)) {
+      // Created before a restart, or remote bootstrapped from the leader of the new tablet.
+      continue;
+    }
+    Partition partition;
+    Partition::FromPB(req.new_partitions(i), &partition);
+    Status s = CreateNewTablet(meta.table_id(), new_tablet_id, partition, meta.table_name(),
+                               meta.table_type(), meta.schema(), meta.partition_schema(),
+                               req.config(), nullptr, tablet);
+    if (s.IsAlreadyPresent()) {
+      // Is being remote bootstrapped.
+      continue;
+    }
+    RETURN_NOT_OK(s);
+  }
+
+  LOG(INFO) << "Tablet " << tablet->tablet_id() << " split into "
+            << yb::ToString(req.new_tablet_ids());
+  return Status::OK();
+}
+
 string LogPrefix(const string& tablet_id, const string& uuid) {
   return "T " + tablet_id + " P " + uuid + ": ";
 }
@@ -742,7 +899,9 @@ TabletPeerPtr TSTabletManager::CreateAndRegisterTabletPeer(
                           apply_pool_.get(),
                           Bind(&TSTabletManager::ApplyChange,
                                Unretained(this),
-                               meta->tablet_id())));
+                               meta->tablet_id()),
+                          this,
+                          conflict_wait_pool_.get()));
   RegisterTablet(meta->tablet_id(), tablet_peer, mode);
   return tablet_peer;
 }
@@ -922,7 +1081,9 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         tablet_options_,
         tablet_peer.get(),
         tablet_peer.get(),
-        append_pool()};
+        append_pool(),
+        log_group_committer_.get(),
+        this};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -1028,6 +1189,13 @@ void TSTabletManager::Shutdown() {
   if (append_pool_) {
     append_pool_->Shutdown();
   }
+  if (conflict_wait_pool_) {
+    conflict_wait_pool_->Shutdown();
+  }
+  // All logs are closed at this point, so the committer has no pending syncs left.
+  if (log_group_committer_) {
+    log_group_committer_->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(lock_);
@@ -51,6 +51,7 @@
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/tablet/tablet_fwd.h"
+#include "yb/tablet/operations/split_operation.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_admin.pb.h"
@@ -74,6 +75,10 @@ namespace consensus {
 class RaftConfigPB;
 } // namespace consensus
 
+namespace log {
+class LogGroupCommitter;
+} // namespace log
+
 namespace master {
 class ReportedTabletPB;
 class TabletReportPB;
@@ -119,7 +124,7 @@ class TransitionInProgressDeleter;
 // TODO: will also be responsible for keeping the local metadata about
 // which tablets are hosted on this server persistent on disk, as well
 // as re-opening all the tablets at startup, etc.
-class TSTabletManager : public tserver::TabletPeerLookupIf {
+class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::TabletSplitter {
  public:
   typedef std::vector<scoped_refptr<tablet::TabletPeer>> TabletPeers;
 
@@ -157,6 +162,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   //
   // If another tablet already exists with this ID, logs a DFATAL
   // and returns a bad Status.
+  //
+  // If split_tablet is non-NULL, the new tablet starts with a checkpoint of its data.
   CHECKED_STATUS CreateNewTablet(
     const string &table_id,
     const string &tablet_id,
@@ -166,7 +173,22 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
     const Schema &schema,
     const PartitionSchema &partition_schema,
     consensus::RaftConfigPB config,
-    scoped_refptr<tablet::TabletPeer> *tablet_peer);
+    scoped_refptr<tablet::TabletPeer> *tablet_peer,
+    tablet::Tablet* split_tablet = nullptr);
+
+  // Whether all the tablets created by the given split exist on this server.
+  bool HasSplitTablets(const SplitTabletRequestPB& req);
+
+  // Prepares the split of the given tablet, that must be led by this server: checks the request
+  // and stops accepting operations on the tablet. The caller then submits the split operation,
+  // which creates the new tablets on every peer when it is applied.
+  CHECKED_STATUS StartTabletSplit(const scoped_refptr<tablet::TabletPeer>& tablet_peer,
+                                  const SplitTabletRequestPB& req,
+                                  TabletServerErrorPB::Code* error_code);
+
+  // Creates the new tablets of a split on this server, each from a checkpoint of the data of the
+  // split tablet.
+  CHECKED_STATUS ApplyTabletSplit(tablet::SplitOperationState* operation_state) override;
 
   // Delete the specified tablet.
   // 'delete_type' must be one of TABLET_DATA_DELETED or TABLET_DATA_TOMBSTONED
@@ -439,6 +461,14 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for appender threads, shared between all tablets.
   std::unique_ptr<ThreadPool> append_pool_;
 
+  // Thread pool continuing conflict resolution of writes that waited for conflicting
+  // transactions, shared between all tablets.
+  std::unique_ptr<ThreadPool> conflict_wait_pool_;
+
+  // Group commit stage syncing the WALs of all tablets, one thread per WAL drive. Only created when
+  // log_group_commit_across_tablets is set.
+  std::unique_ptr<log::LogGroupCommitter> log_group_committer_;
+
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
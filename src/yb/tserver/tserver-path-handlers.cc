@@ -42,6 +42,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
@@ -55,8 +56,19 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/histogram.pb.h"
+#include "yb/util/metrics.h"
 #include "yb/util/url-coding.h"
 
+METRIC_DECLARE_histogram(write_lock_latency);
+METRIC_DECLARE_histogram(write_conflict_resolution_latency);
+METRIC_DECLARE_histogram(write_prepare_queue_latency);
+METRIC_DECLARE_histogram(write_replication_latency);
+METRIC_DECLARE_histogram(log_append_latency);
+METRIC_DECLARE_histogram(log_sync_latency);
+METRIC_DECLARE_histogram(write_apply_latency);
+METRIC_DECLARE_histogram(write_op_duration_client_propagated_consistency);
+
 namespace yb {
 namespace tserver {
 
@@ -104,6 +116,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   server->RegisterPathHandler(
       "/log-anchors", "", std::bind(&TabletServerPathHandlers::HandleLogAnchorsPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/tablet-latency", "",
+      std::bind(&TabletServerPathHandlers::HandleTabletLatencyPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/", "Dashboards",
       std::bind(&TabletServerPathHandlers::HandleDashboardsPage, this, _1, _2), true /* styled */,
@@ -349,6 +365,12 @@ void TabletServerPathHandlers::HandleTabletPage(const Webserver::WebRequest& req
                                   "Tablet Log Anchors")
           << "</li>" << endl;
 
+  // Write path latency breakdown page.
+  *output << "<li>" << Substitute("<a href=\"/tablet-latency?id=$0\">$1</a>",
+                                  UrlEncodeToString(tablet_id),
+                                  "Write Latency Breakdown")
+          << "</li>" << endl;
+
   // End list
   *output << "</ul>\n";
 }
@@ -381,6 +403,64 @@ void TabletServerPathHandlers::HandleLogAnchorsPage(const Webserver::WebRequest&
   *output << "<pre>" << EscapeForHtmlToString(dump) << "</pre>" << std::endl;
 }
 
+void TabletServerPathHandlers::HandleTabletLatencyPage(const Webserver::WebRequest& req,
+                                                       std::stringstream* output) {
+  // Stages of the write path in the order a write goes through them.
+  static const std::vector<std::pair<const char*, const HistogramPrototype*>> kStages = {
+    { "Lock acquisition", &METRIC_write_lock_latency },
+    { "Conflict resolution", &METRIC_write_conflict_resolution_latency },
+    { "Prepare queue wait", &METRIC_write_prepare_queue_latency },
+    { "Replication", &METRIC_write_replication_latency },
+    { "Log append", &METRIC_log_append_latency },
+    { "Log sync", &METRIC_log_sync_latency },
+    { "Apply", &METRIC_write_apply_latency },
+    { "Total (leader)", &METRIC_write_op_duration_client_propagated_consistency },
+  };
+
+  vector<scoped_refptr<TabletPeer>> peers;
+  if (ContainsKey(req.parsed_args, "id")) {
+    string tablet_id;
+    scoped_refptr<TabletPeer> peer;
+    if (!LoadTablet(tserver_, req, &tablet_id, &peer, output)) return;
+    peers.push_back(peer);
+  } else {
+    tserver_->tablet_manager()->GetTabletPeers(&peers);
+    std::sort(peers.begin(), peers.end(), &CompareByTabletId);
+  }
+
+  *output << "<h1>Write Latency Breakdown</h1>\n";
+  *output << "<p>Latencies are in microseconds. Log append and sync are per log batch, the other "
+             "stages are per write operation.</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Tablet ID</th><th>Stage</th><th>Count</th><th>Mean</th><th>p95</th>"
+             "<th>p99</th><th>p99.9</th><th>Max</th></tr>\n";
+  const MetricJsonOptions opts;
+  for (const scoped_refptr<TabletPeer>& peer : peers) {
+    shared_ptr<Tablet> tablet = peer->shared_tablet();
+    if (!tablet || !tablet->GetMetricEntity()) {
+      continue;
+    }
+    for (const auto& stage : kStages) {
+      auto metric = tablet->GetMetricEntity()->FindOrNull(*stage.second);
+      if (!metric) {
+        continue;
+      }
+      HistogramSnapshotPB snapshot;
+      if (!down_cast<Histogram*>(metric.get())->GetHistogramSnapshotPB(&snapshot, opts).ok() ||
+          snapshot.total_count() == 0) {
+        continue;
+      }
+      *output << Substitute(
+          "  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+          "<td>$7</td></tr>\n",
+          TabletLink(peer->tablet_id()), stage.first, snapshot.total_count(),
+          StringPrintf("%.1f", snapshot.mean()), snapshot.percentile_95(),
+          snapshot.percentile_99(), snapshot.percentile_99_9(), snapshot.max());
+    }
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleConsensusStatusPage(const Webserver::WebRequest& req,
                                                          std::stringstream* output) {
   string id;
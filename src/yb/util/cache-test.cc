@@ -33,7 +33,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #include <glog/logging.h>
@@ -44,6 +48,7 @@
 #include "yb/util/coding.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/test_util.h"
 
 #if defined(__linux__)
@@ -66,9 +71,12 @@ static void* EncodeValue(uintptr_t v) { return reinterpret_cast<void*>(v); }
 static int DecodeValue(void* v) { return reinterpret_cast<uintptr_t>(v); }
 
 class CacheTest : public YBTest,
-                  public ::testing::WithParamInterface<CacheType>,
+                  public ::testing::WithParamInterface<
+                      std::tuple<CacheType, CacheEvictionPolicy>>,
                   public CacheDeleter {
  public:
+  CacheType cache_type() const { return std::get<0>(GetParam()); }
+  CacheEvictionPolicy eviction_policy() const { return std::get<1>(GetParam()); }
 
   // Implementation of the CacheDeleter interface
   void Delete(const Slice& key, void* v) override {
@@ -92,12 +100,12 @@ class CacheTest : public YBTest,
     }
 #endif // defined(__linux__)
 
-    cache_.reset(NewLRUCache(GetParam(), kCacheSize, "cache_test"));
+    cache_.reset(NewCache(cache_type(), eviction_policy(), kCacheSize, "cache_test"));
 
     mem_tracker_ = MemTracker::FindTracker("cache_test-sharded_lru_cache");
     // Since nvm cache does not have memtracker due to the use of
     // tcmalloc for this we only check for it in the DRAM case.
-    if (GetParam() == DRAM_CACHE) {
+    if (cache_type() == DRAM_CACHE) {
       ASSERT_TRUE(mem_tracker_.get());
     }
 
@@ -126,9 +134,14 @@ class CacheTest : public YBTest,
 };
 
 #if defined(__linux__)
-INSTANTIATE_TEST_CASE_P(CacheTypes, CacheTest, ::testing::Values(DRAM_CACHE, NVM_CACHE));
+INSTANTIATE_TEST_CASE_P(CacheTypes, CacheTest, ::testing::Values(
+    std::make_tuple(DRAM_CACHE, STRICT_LRU),
+    std::make_tuple(DRAM_CACHE, SAMPLED_LRU),
+    std::make_tuple(NVM_CACHE, STRICT_LRU)));
 #else
-INSTANTIATE_TEST_CASE_P(CacheTypes, CacheTest, ::testing::Values(DRAM_CACHE));
+INSTANTIATE_TEST_CASE_P(CacheTypes, CacheTest, ::testing::Values(
+    std::make_tuple(DRAM_CACHE, STRICT_LRU),
+    std::make_tuple(DRAM_CACHE, SAMPLED_LRU)));
 #endif // defined(__linux__)
 
 TEST_P(CacheTest, TrackMemory) {
@@ -252,10 +265,172 @@ TEST_P(CacheTest, HeavyEntries) {
   ASSERT_LE(cached_weight, kCacheSize + kCacheSize/10);
 }
 
+TEST_P(CacheTest, SetCapacity) {
+  const int kNumElems = 1000;
+  const int kSizePerElem = kCacheSize / kNumElems;
+  for (int i = 0; i < kNumElems; i++) {
+    Insert(i, 1000 + i, kSizePerElem);
+  }
+  const size_t deleted_before = deleted_keys_.size();
+
+  // Shrinking the cache evicts entries right away.
+  cache_->SetCapacity(kCacheSize / 2);
+  int cached = 0;
+  for (int i = 0; i < kNumElems; i++) {
+    if (Lookup(i) != -1) {
+      ++cached;
+    }
+  }
+  ASSERT_LE(cached, kNumElems / 2);
+  ASSERT_GT(deleted_keys_.size(), deleted_before);
+  ASSERT_EQ(static_cast<size_t>(kNumElems - cached), deleted_keys_.size());
+
+  // Entries inserted after the shrink are evicted at the new capacity.
+  for (int i = kNumElems; i < 2 * kNumElems; i++) {
+    Insert(i, 1000 + i, kSizePerElem);
+  }
+  cached = 0;
+  for (int i = 0; i < 2 * kNumElems; i++) {
+    if (Lookup(i) != -1) {
+      ++cached;
+    }
+  }
+  ASSERT_LE(cached, kNumElems / 2);
+}
+
+TEST_P(CacheTest, ApplyToAllCacheEntries) {
+  std::vector<int> expected;
+  for (int i = 0; i < 10; i++) {
+    Insert(i, 1000 + i, i + 1);
+    expected.push_back(1000 + i);
+  }
+  Erase(5);
+  expected.erase(expected.begin() + 5);
+
+  std::vector<int> values;
+  size_t total_charge = 0;
+  cache_->ApplyToAllCacheEntries([&values, &total_charge](void* value, size_t charge) {
+    values.push_back(DecodeValue(value));
+    total_charge += charge;
+  });
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(expected, values);
+  if (cache_type() == DRAM_CACHE) {
+    ASSERT_EQ(55U - 6U, total_charge);
+  }
+}
+
 TEST_P(CacheTest, NewId) {
   uint64_t a = cache_->NewId();
   uint64_t b = cache_->NewId();
   ASSERT_NE(a, b);
 }
 
+// Readers look up hot keys while a writer keeps inserting and erasing, checking that lookups
+// always return the value that belongs to the key.
+TEST_P(CacheTest, ConcurrentLookups) {
+  // Entries could be deleted by reader threads, so do not use the test fixture as deleter.
+  class NoOpDeleter : public CacheDeleter {
+   public:
+    void Delete(const Slice& key, void* value) override {}
+  };
+  NoOpDeleter deleter;
+  auto insert = [this, &deleter](int key, int value) {
+    cache_->Release(cache_->Insert(EncodeKey(key), EncodeValue(value), 1, &deleter));
+  };
+
+  constexpr int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; i++) {
+    insert(i, 1000 + i);
+  }
+
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([this, &stop, &errors] {
+      int key = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        Cache::Handle* handle = cache_->Lookup(EncodeKey(key), Cache::EXPECT_IN_CACHE);
+        if (handle != nullptr) {
+          if (DecodeValue(cache_->Value(handle)) % 1000 != key) {
+            errors.fetch_add(1);
+          }
+          cache_->Release(handle);
+        }
+        key = (key + 1) % kNumKeys;
+      }
+    });
+  }
+
+  for (int i = 0; i < 10000; i++) {
+    const int key = i % kNumKeys;
+    if (i % 3 == 0) {
+      Erase(key);
+    } else {
+      insert(key, 1000 * (i % 7 + 1) + key);
+    }
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : readers) {
+    thread.join();
+  }
+  ASSERT_EQ(0, errors.load());
+  // Drop the entries before the deleter goes out of scope.
+  cache_.reset();
+}
+
+// Benchmarks
+
+#ifdef NDEBUG
+
+// Measures cache hit throughput of concurrent readers looking up a small hot key set, similar to
+// index and filter blocks of the block cache.
+TEST_P(CacheTest, BenchmarkConcurrentHits) {
+  if (cache_type() != DRAM_CACHE) {
+    return;
+  }
+
+  constexpr int kNumKeys = 1024;
+  const MonoDelta kDuration = MonoDelta::FromSeconds(2);
+  for (int i = 0; i < kNumKeys; i++) {
+    Insert(i, 1000 + i);
+  }
+  std::vector<std::string> keys;
+  for (int i = 0; i < kNumKeys; i++) {
+    keys.push_back(EncodeKey(i));
+  }
+
+  for (int num_threads : {1, 8, 32, 64, 128}) {
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> total_hits(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([this, t, &keys, &stop, &total_hits] {
+        uint64_t hits = 0;
+        size_t index = t * 7919;
+        while (!stop.load(std::memory_order_relaxed)) {
+          Cache::Handle* handle = cache_->Lookup(keys[index % keys.size()], Cache::EXPECT_IN_CACHE);
+          if (handle != nullptr) {
+            cache_->Release(handle);
+            ++hits;
+          }
+          index += 31;
+        }
+        total_hits.fetch_add(hits);
+      });
+    }
+    SleepFor(kDuration);
+    stop.store(true);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << (eviction_policy() == STRICT_LRU ? "STRICT_LRU" : "SAMPLED_LRU") << ", "
+              << num_threads << " threads: "
+              << total_hits.load() / kDuration.ToSeconds() << " hits/sec";
+  }
+}
+
+#endif // NDEBUG
+
 }  // namespace yb
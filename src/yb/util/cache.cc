@@ -34,6 +34,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <stdlib.h>
@@ -83,6 +84,8 @@ struct LRUHandle {
   size_t key_length;
   Atomic32 refs;
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
+  // Shard tick of the last access, maintained only by SampledLRUCache.
+  Atomic64 last_access;
   uint8_t key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -182,45 +185,40 @@ class HandleTable {
   }
 };
 
-// A single shard of sharded cache.
-class LRUCache {
+// Functionality shared by the shards of all eviction policies.
+class CacheShardBase {
  public:
-  explicit LRUCache(MemTracker* tracker);
-  ~LRUCache();
+  explicit CacheShardBase(MemTracker* tracker)
+      : usage_(0), mem_tracker_(tracker), metrics_(nullptr) {}
 
-  // Separate from constructor so caller can easily make an array of LRUCache
+  // Separate from constructor so caller can easily make an array of shards. Use Resize() to change
+  // the capacity of a shard in use.
   void SetCapacity(size_t capacity) { capacity_ = capacity; }
 
   void SetMetrics(CacheMetrics* metrics) { metrics_ = metrics; }
 
-  // Like Cache methods, but with an extra "hash" parameter.
-  Cache::Handle* Insert(const Slice& key, uint32_t hash,
-                        void* value, size_t charge,
-                        CacheDeleter* deleter);
-  Cache::Handle* Lookup(const Slice& key, uint32_t hash, bool caching);
   void Release(Cache::Handle* handle);
-  void Erase(const Slice& key, uint32_t hash);
 
- private:
-  void LRU_Remove(LRUHandle* e);
-  void LRU_Append(LRUHandle* e);
+ protected:
+  // Allocates an entry for the given key and value, with one reference for the cache and one for
+  // the returned handle.
+  LRUHandle* NewEntry(const Slice& key, uint32_t hash, void* value, size_t charge,
+                      CacheDeleter* deleter);
   // Just reduce the reference count by 1.
   // Return true if last reference
   bool Unref(LRUHandle* e);
   // Call deleter and free
   void FreeEntry(LRUHandle* e);
+  // Frees a list of entries linked through their "next" field.
+  void FreeEntries(LRUHandle* head);
+  void RecordLookup(bool was_hit, bool caching);
 
   // Initialized before use.
   size_t capacity_;
 
-  // mutex_ protects the following state.
-  MutexType mutex_;
+  // Protected by the mutex of the subclass.
   size_t usage_;
 
-  // Dummy head of LRU list.
-  // lru.prev is newest entry, lru.next is oldest entry.
-  LRUHandle lru_;
-
   HandleTable table_;
 
   MemTracker* mem_tracker_;
@@ -228,10 +226,111 @@ class LRUCache {
   CacheMetrics* metrics_;
 };
 
+bool CacheShardBase::Unref(LRUHandle* e) {
+  DCHECK_GT(ANNOTATE_UNPROTECTED_READ(e->refs), 0);
+  return !base::RefCountDec(&e->refs);
+}
+
+void CacheShardBase::FreeEntry(LRUHandle* e) {
+  DCHECK_EQ(ANNOTATE_UNPROTECTED_READ(e->refs), 0);
+  e->deleter->Delete(e->key(), e->value);
+  mem_tracker_->Release(e->charge);
+  if (PREDICT_TRUE(metrics_)) {
+    metrics_->cache_usage->DecrementBy(e->charge);
+    metrics_->evictions->Increment();
+  }
+  free(e);
+}
+
+void CacheShardBase::FreeEntries(LRUHandle* head) {
+  while (head != nullptr) {
+    LRUHandle* next = head->next;
+    FreeEntry(head);
+    head = next;
+  }
+}
+
+void CacheShardBase::Release(Cache::Handle* handle) {
+  LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+  bool last_reference = Unref(e);
+  if (last_reference) {
+    FreeEntry(e);
+  }
+}
+
+LRUHandle* CacheShardBase::NewEntry(
+    const Slice& key, uint32_t hash, void* value, size_t charge, CacheDeleter* deleter) {
+  LRUHandle* e = reinterpret_cast<LRUHandle*>(
+      malloc(sizeof(LRUHandle)-1 + key.size()));
+
+  e->value = value;
+  e->deleter = deleter;
+  e->charge = charge;
+  e->key_length = key.size();
+  e->hash = hash;
+  e->refs = 2;  // One from the cache, one for the returned handle
+  e->last_access = 0;
+  memcpy(e->key_data, key.data(), key.size());
+  mem_tracker_->Consume(charge);
+  if (PREDICT_TRUE(metrics_)) {
+    metrics_->cache_usage->IncrementBy(charge);
+    metrics_->inserts->Increment();
+  }
+  return e;
+}
+
+void CacheShardBase::RecordLookup(bool was_hit, bool caching) {
+  if (metrics_) {
+    metrics_->lookups->Increment();
+    if (was_hit) {
+      if (caching) {
+        metrics_->cache_hits_caching->Increment();
+      } else {
+        metrics_->cache_hits->Increment();
+      }
+    } else {
+      if (caching) {
+        metrics_->cache_misses_caching->Increment();
+      } else {
+        metrics_->cache_misses->Increment();
+      }
+    }
+  }
+}
+
+// A single shard of sharded cache.
+class LRUCache : public CacheShardBase {
+ public:
+  explicit LRUCache(MemTracker* tracker);
+  ~LRUCache();
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Cache::Handle* Insert(const Slice& key, uint32_t hash,
+                        void* value, size_t charge,
+                        CacheDeleter* deleter);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, bool caching);
+  void Erase(const Slice& key, uint32_t hash);
+  void Resize(size_t capacity);
+  void ApplyToAllEntries(const std::function<void(void* value, size_t charge)>& callback);
+
+ private:
+  void LRU_Remove(LRUHandle* e);
+  void LRU_Append(LRUHandle* e);
+
+  // Evicts the least recently used entries until the usage fits the capacity, linking the ones
+  // that should be freed through their "next" field.
+  void EvictIfNeeded(LRUHandle** to_remove_head);
+
+  // mutex_ protects the following state, as well as usage_ and table_.
+  MutexType mutex_;
+
+  // Dummy head of LRU list.
+  // lru.prev is newest entry, lru.next is oldest entry.
+  LRUHandle lru_;
+};
+
 LRUCache::LRUCache(MemTracker* tracker)
- : usage_(0),
-   mem_tracker_(tracker),
-   metrics_(nullptr) {
+    : CacheShardBase(tracker) {
   // Make empty circular linked list
   lru_.next = &lru_;
   lru_.prev = &lru_;
@@ -248,22 +347,6 @@ LRUCache::~LRUCache() {
   }
 }
 
-bool LRUCache::Unref(LRUHandle* e) {
-  DCHECK_GT(ANNOTATE_UNPROTECTED_READ(e->refs), 0);
-  return !base::RefCountDec(&e->refs);
-}
-
-void LRUCache::FreeEntry(LRUHandle* e) {
-  DCHECK_EQ(ANNOTATE_UNPROTECTED_READ(e->refs), 0);
-  e->deleter->Delete(e->key(), e->value);
-  mem_tracker_->Release(e->charge);
-  if (PREDICT_TRUE(metrics_)) {
-    metrics_->cache_usage->DecrementBy(e->charge);
-    metrics_->evictions->Increment();
-  }
-  free(e);
-}
-
 void LRUCache::LRU_Remove(LRUHandle* e) {
   e->next->prev = e->prev;
   e->prev->next = e->next;
@@ -292,56 +375,18 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, bool caching) {
   }
 
   // Do the metrics outside of the lock.
-  if (metrics_) {
-    metrics_->lookups->Increment();
-    bool was_hit = (e != nullptr);
-    if (was_hit) {
-      if (caching) {
-        metrics_->cache_hits_caching->Increment();
-      } else {
-        metrics_->cache_hits->Increment();
-      }
-    } else {
-      if (caching) {
-        metrics_->cache_misses_caching->Increment();
-      } else {
-        metrics_->cache_misses->Increment();
-      }
-    }
-  }
+  RecordLookup(e != nullptr, caching);
 
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
-void LRUCache::Release(Cache::Handle* handle) {
-  LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
-  bool last_reference = Unref(e);
-  if (last_reference) {
-    FreeEntry(e);
-  }
-}
-
 Cache::Handle* LRUCache::Insert(
     const Slice& key, uint32_t hash, void* value, size_t charge,
     CacheDeleter *deleter) {
 
-  LRUHandle* e = reinterpret_cast<LRUHandle*>(
-      malloc(sizeof(LRUHandle)-1 + key.size()));
+  LRUHandle* e = NewEntry(key, hash, value, charge, deleter);
   LRUHandle* to_remove_head = nullptr;
 
-  e->value = value;
-  e->deleter = deleter;
-  e->charge = charge;
-  e->key_length = key.size();
-  e->hash = hash;
-  e->refs = 2;  // One from LRUCache, one for the returned handle
-  memcpy(e->key_data, key.data(), key.size());
-  mem_tracker_->Consume(charge);
-  if (PREDICT_TRUE(metrics_)) {
-    metrics_->cache_usage->IncrementBy(charge);
-    metrics_->inserts->Increment();
-  }
-
   {
     std::lock_guard<MutexType> l(mutex_);
 
@@ -356,36 +401,266 @@ Cache::Handle* LRUCache::Insert(
       }
     }
 
-    while (usage_ > capacity_ && lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      LRU_Remove(old);
-      table_.Remove(old->key(), old->hash);
+    EvictIfNeeded(&to_remove_head);
+  }
+
+  // we free the entries here outside of mutex for
+  // performance reasons
+  FreeEntries(to_remove_head);
+
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void LRUCache::EvictIfNeeded(LRUHandle** to_remove_head) {
+  while (usage_ > capacity_ && lru_.next != &lru_) {
+    LRUHandle* old = lru_.next;
+    LRU_Remove(old);
+    table_.Remove(old->key(), old->hash);
+    if (Unref(old)) {
+      old->next = *to_remove_head;
+      *to_remove_head = old;
+    }
+  }
+}
+
+void LRUCache::Resize(size_t capacity) {
+  LRUHandle* to_remove_head = nullptr;
+  {
+    std::lock_guard<MutexType> l(mutex_);
+    capacity_ = capacity;
+    EvictIfNeeded(&to_remove_head);
+  }
+  FreeEntries(to_remove_head);
+}
+
+void LRUCache::ApplyToAllEntries(
+    const std::function<void(void* value, size_t charge)>& callback) {
+  std::lock_guard<MutexType> l(mutex_);
+  for (LRUHandle* e = lru_.next; e != &lru_; e = e->next) {
+    callback(e->value, e->charge);
+  }
+}
+
+void LRUCache::Erase(const Slice& key, uint32_t hash) {
+  LRUHandle* e;
+  bool last_reference = false;
+  {
+    std::lock_guard<MutexType> l(mutex_);
+    e = table_.Remove(key, hash);
+    if (e != nullptr) {
+      LRU_Remove(e);
+      last_reference = Unref(e);
+    }
+  }
+  // mutex not held here
+  // last_reference will only be true if e != NULL
+  if (last_reference) {
+    FreeEntry(e);
+  }
+}
+
+// A shard that approximates LRU without reordering entries on lookup. Lookups only take the
+// shared side of a per-CPU reader-writer lock and store a new shard tick in the entry, so
+// concurrent hits on the same shard do not serialize. Inserts, erases and evictions take the lock
+// exclusively. To evict, the shard samples a few entries following the eviction hand and evicts
+// the least recently accessed one among them, preferring entries that are not pinned by handles.
+class SampledLRUCache : public CacheShardBase {
+ public:
+  explicit SampledLRUCache(MemTracker* tracker);
+  ~SampledLRUCache();
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Cache::Handle* Insert(const Slice& key, uint32_t hash,
+                        void* value, size_t charge,
+                        CacheDeleter* deleter);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, bool caching);
+  void Erase(const Slice& key, uint32_t hash);
+  void Resize(size_t capacity);
+  void ApplyToAllEntries(const std::function<void(void* value, size_t charge)>& callback);
+
+ private:
+  static constexpr size_t kEvictionSampleSize = 8;
+
+  void Ring_Remove(LRUHandle* e);
+  void Ring_Insert(LRUHandle* e);
+
+  // Returns the entry that follows e in the ring, skipping the dummy head.
+  LRUHandle* Ring_Next(LRUHandle* e) {
+    e = e->next;
+    return e == &ring_ ? e->next : e;
+  }
+
+  // Evicts entries until the usage fits the capacity, linking the ones that should be freed
+  // through their "next" field.
+  void EvictIfNeeded(LRUHandle** to_remove_head);
+
+  // Readers take mutex_ in shared mode, writers in exclusive mode. It protects the following
+  // state, as well as usage_ and table_.
+  percpu_rwlock mutex_;
+
+  // Dummy head of the ring of all entries, in no particular order.
+  LRUHandle ring_;
+
+  // Next entry to consider for eviction, or ring_ when the ring is empty.
+  LRUHandle* hand_;
+
+  size_t num_entries_ = 0;
+
+  // Incremented on each insert, and by lookups of entries accessed before the last increment.
+  // Updated without the lock by lookups.
+  Atomic64 tick_ = 0;
+};
+
+SampledLRUCache::SampledLRUCache(MemTracker* tracker)
+    : CacheShardBase(tracker) {
+  ring_.next = &ring_;
+  ring_.prev = &ring_;
+  hand_ = &ring_;
+}
+
+SampledLRUCache::~SampledLRUCache() {
+  for (LRUHandle* e = ring_.next; e != &ring_; ) {
+    LRUHandle* next = e->next;
+    DCHECK_EQ(e->refs, 1);  // Error if caller has an unreleased handle
+    if (Unref(e)) {
+      FreeEntry(e);
+    }
+    e = next;
+  }
+}
+
+void SampledLRUCache::Ring_Remove(LRUHandle* e) {
+  if (hand_ == e) {
+    hand_ = e->next;
+  }
+  e->next->prev = e->prev;
+  e->prev->next = e->next;
+  usage_ -= e->charge;
+  --num_entries_;
+}
+
+void SampledLRUCache::Ring_Insert(LRUHandle* e) {
+  // Insert right behind the hand, so the new entry is sampled last.
+  e->next = hand_;
+  e->prev = hand_->prev;
+  e->prev->next = e;
+  e->next->prev = e;
+  usage_ += e->charge;
+  ++num_entries_;
+}
+
+Cache::Handle* SampledLRUCache::Lookup(const Slice& key, uint32_t hash, bool caching) {
+  LRUHandle* e;
+  {
+    shared_lock<rw_spinlock> l(mutex_.get_lock());
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      base::RefCountInc(&e->refs);
+      // Advance the tick, so that this access is ordered after the previous ones. It is skipped
+      // when the entry is already the most recently accessed one, hot entries are looked up by many
+      // threads at once.
+      if (base::subtle::NoBarrier_Load(&e->last_access) != base::subtle::NoBarrier_Load(&tick_)) {
+        base::subtle::NoBarrier_Store(
+            &e->last_access, base::subtle::NoBarrier_AtomicIncrement(&tick_, 1));
+      }
+    }
+  }
+
+  // Do the metrics outside of the lock.
+  RecordLookup(e != nullptr, caching);
+
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void SampledLRUCache::EvictIfNeeded(LRUHandle** to_remove_head) {
+  while (usage_ > capacity_ && num_entries_ != 0) {
+    if (hand_ == &ring_) {
+      hand_ = ring_.next;
+    }
+    // Pick the least recently accessed entry among the sampled ones. Entries pinned by handles
+    // are evicted only when all sampled entries are pinned.
+    LRUHandle* victim = nullptr;
+    bool victim_pinned = true;
+    LRUHandle* e = hand_;
+    const size_t sample_size = std::min(kEvictionSampleSize, num_entries_);
+    for (size_t i = 0; i != sample_size; ++i, e = Ring_Next(e)) {
+      const bool pinned = ANNOTATE_UNPROTECTED_READ(e->refs) > 1;
+      if (victim == nullptr || (victim_pinned && !pinned) ||
+          (victim_pinned == pinned && base::subtle::NoBarrier_Load(&e->last_access) <
+                                      base::subtle::NoBarrier_Load(&victim->last_access))) {
+        victim = e;
+        victim_pinned = pinned;
+      }
+    }
+    hand_ = e;
+
+    Ring_Remove(victim);
+    table_.Remove(victim->key(), victim->hash);
+    if (Unref(victim)) {
+      victim->next = *to_remove_head;
+      *to_remove_head = victim;
+    }
+  }
+}
+
+Cache::Handle* SampledLRUCache::Insert(
+    const Slice& key, uint32_t hash, void* value, size_t charge,
+    CacheDeleter *deleter) {
+
+  LRUHandle* e = NewEntry(key, hash, value, charge, deleter);
+  LRUHandle* to_remove_head = nullptr;
+
+  {
+    std::lock_guard<percpu_rwlock> l(mutex_);
+
+    e->last_access = base::subtle::NoBarrier_AtomicIncrement(&tick_, 1);
+    Ring_Insert(e);
+
+    LRUHandle* old = table_.Insert(e);
+    if (old != nullptr) {
+      Ring_Remove(old);
       if (Unref(old)) {
         old->next = to_remove_head;
         to_remove_head = old;
       }
     }
+
+    EvictIfNeeded(&to_remove_head);
   }
 
   // we free the entries here outside of mutex for
   // performance reasons
-  while (to_remove_head != nullptr) {
-    LRUHandle* next = to_remove_head->next;
-    FreeEntry(to_remove_head);
-    to_remove_head = next;
-  }
+  FreeEntries(to_remove_head);
 
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
-void LRUCache::Erase(const Slice& key, uint32_t hash) {
+void SampledLRUCache::Resize(size_t capacity) {
+  LRUHandle* to_remove_head = nullptr;
+  {
+    std::lock_guard<percpu_rwlock> l(mutex_);
+    capacity_ = capacity;
+    EvictIfNeeded(&to_remove_head);
+  }
+  FreeEntries(to_remove_head);
+}
+
+void SampledLRUCache::ApplyToAllEntries(
+    const std::function<void(void* value, size_t charge)>& callback) {
+  shared_lock<rw_spinlock> l(mutex_.get_lock());
+  for (LRUHandle* e = ring_.next; e != &ring_; e = e->next) {
+    callback(e->value, e->charge);
+  }
+}
+
+void SampledLRUCache::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
   {
-    std::lock_guard<MutexType> l(mutex_);
+    std::lock_guard<percpu_rwlock> l(mutex_);
     e = table_.Remove(key, hash);
     if (e != nullptr) {
-      LRU_Remove(e);
+      Ring_Remove(e);
       last_reference = Unref(e);
     }
   }
@@ -399,11 +674,12 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
 static const int kNumShardBits = 4;
 static const int kNumShards = 1 << kNumShardBits;
 
-class ShardedLRUCache : public Cache {
+template <class Shard>
+class ShardedCache : public Cache {
  private:
   shared_ptr<MemTracker> mem_tracker_;
   gscoped_ptr<CacheMetrics> metrics_;
-  vector<LRUCache*> shards_;
+  vector<Shard*> shards_;
   MutexType id_mutex_;
   uint64_t last_id_;
 
@@ -417,7 +693,7 @@ class ShardedLRUCache : public Cache {
   }
 
  public:
-  explicit ShardedLRUCache(size_t capacity, const string& id)
+  explicit ShardedCache(size_t capacity, const string& id)
       : last_id_(0) {
     // A cache is often a singleton, so:
     // 1. We reuse its MemTracker if one already exists, and
@@ -425,15 +701,19 @@ class ShardedLRUCache : public Cache {
     mem_tracker_ = MemTracker::FindOrCreateTracker(
         -1, strings::Substitute("$0-sharded_lru_cache", id));
 
-    const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
+    const size_t per_shard = PerShardCapacity(capacity);
     for (int s = 0; s < kNumShards; s++) {
-      gscoped_ptr<LRUCache> shard(new LRUCache(mem_tracker_.get()));
+      gscoped_ptr<Shard> shard(new Shard(mem_tracker_.get()));
       shard->SetCapacity(per_shard);
       shards_.push_back(shard.release());
     }
   }
 
-  virtual ~ShardedLRUCache() {
+  static size_t PerShardCapacity(size_t capacity) {
+    return (capacity + (kNumShards - 1)) / kNumShards;
+  }
+
+  virtual ~ShardedCache() {
     STLDeleteElements(&shards_);
   }
 
@@ -464,11 +744,25 @@ class ShardedLRUCache : public Cache {
 
   void SetMetrics(const scoped_refptr<MetricEntity>& entity) override {
     metrics_.reset(new CacheMetrics(entity));
-    for (LRUCache* cache : shards_) {
+    for (Shard* cache : shards_) {
       cache->SetMetrics(metrics_.get());
     }
   }
 
+  void SetCapacity(size_t capacity) override {
+    const size_t per_shard = PerShardCapacity(capacity);
+    for (Shard* cache : shards_) {
+      cache->Resize(per_shard);
+    }
+  }
+
+  void ApplyToAllCacheEntries(
+      const std::function<void(void* value, size_t charge)>& callback) override {
+    for (Shard* cache : shards_) {
+      cache->ApplyToAllEntries(callback);
+    }
+  }
+
   uint8_t* Allocate(int bytes) override {
     DCHECK_GE(bytes, 0);
     return new uint8_t[bytes];
@@ -488,11 +782,19 @@ class ShardedLRUCache : public Cache {
 }  // end anonymous namespace
 
 Cache* NewLRUCache(CacheType type, size_t capacity, const string& id) {
+  return NewCache(type, STRICT_LRU, capacity, id);
+}
+
+Cache* NewCache(CacheType type, CacheEvictionPolicy policy, size_t capacity, const string& id) {
   switch (type) {
     case DRAM_CACHE:
-      return new ShardedLRUCache(capacity, id);
+      if (policy == SAMPLED_LRU) {
+        return new ShardedCache<SampledLRUCache>(capacity, id);
+      }
+      return new ShardedCache<LRUCache>(capacity, id);
 #if !defined(__APPLE__)
     case NVM_CACHE:
+      LOG_IF(DFATAL, policy != STRICT_LRU) << "NVM cache only supports the strict LRU policy";
       return NewLRUNvmCache(capacity, id);
 #endif
     default:
@@ -33,6 +33,8 @@
 #define YB_UTIL_CACHE_H_
 
 #include <stdint.h>
+
+#include <functional>
 #include <string>
 
 #include "yb/gutil/macros.h"
@@ -50,10 +52,24 @@ enum CacheType {
   NVM_CACHE
 };
 
+enum CacheEvictionPolicy {
+  // Every lookup moves the entry to the head of the LRU list under the shard lock.
+  STRICT_LRU,
+  // Lookups only take a per-CPU shared lock and record the access time in the entry, eviction
+  // picks the least recently used entry among a small sample. Scales better when many threads
+  // hit the same shard, at the cost of less precise eviction.
+  SAMPLED_LRU
+};
+
 // Create a new cache with a fixed size capacity.  This implementation
 // of Cache uses a least-recently-used eviction policy.
 Cache* NewLRUCache(CacheType type, size_t capacity, const std::string& id);
 
+// Create a new cache with a fixed size capacity and the given eviction policy. NVM caches only
+// support STRICT_LRU.
+Cache* NewCache(CacheType type, CacheEvictionPolicy policy, size_t capacity,
+                const std::string& id);
+
 // Callback interface for deleting a value stored in the cache.
 // This is called when an inserted entry is no longer needed.
 class CacheDeleter {
@@ -135,6 +151,15 @@ class Cache {
   // Pass a metric entity in order to start recoding metrics.
   virtual void SetMetrics(const scoped_refptr<MetricEntity>& metric_entity) = 0;
 
+  // Sets the maximal total charge of the entries, evicting entries if the cache is over the new
+  // capacity. Entries pinned by handles are evicted from the cache, but freed only once released.
+  virtual void SetCapacity(size_t capacity) = 0;
+
+  // Invokes callback with the value and the charge of each entry of the cache. A shard of the cache
+  // is locked while its entries are visited, so the callback should not access the cache.
+  virtual void ApplyToAllCacheEntries(
+      const std::function<void(void* value, size_t charge)>& callback) = 0;
+
   // Allocate 'bytes' bytes from the cache's memory pool.
   //
   // It is possible that this will return NULL if the cache is above its capacity
@@ -34,6 +34,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -445,8 +446,7 @@ class PosixWritableFile : public WritableFile {
     TRACE_EVENT1("io", "PosixWritableFile::Sync", "path", filename_);
     ThreadRestrictions::AssertIOAllowed();
     LOG_SLOW_EXECUTION(WARNING, 1000, Substitute("sync call for $0", filename_)) {
-      if (pending_sync_) {
-        pending_sync_ = false;
+      if (pending_sync_.exchange(false, std::memory_order_acq_rel)) {
         RETURN_NOT_OK(DoSync(fd_, filename_));
       }
     }
@@ -465,7 +465,8 @@ class PosixWritableFile : public WritableFile {
     bool sync_on_close_;
     uint64_t filesize_;
     uint64_t pre_allocated_size_;
-    bool pending_sync_;
+    // Atomic, since the file could be synced concurrently with appends, see Log::Sync.
+    std::atomic<bool> pending_sync_;
 
  private:
 
@@ -232,6 +232,8 @@ class NvmLRUCache {
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
   void* AllocateAndRetry(size_t size);
+  void Resize(size_t capacity);
+  void ApplyToAllEntries(const std::function<void(void* value, size_t charge)>& callback);
 
  private:
   void NvmLRU_Remove(LRUHandle* e);
@@ -476,6 +478,26 @@ Cache::Handle* NvmLRUCache::Insert(const Slice& key, uint32_t hash,
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+void NvmLRUCache::Resize(size_t capacity) {
+  LRUHandle* to_remove_head = NULL;
+  {
+    std::lock_guard<MutexType> l(mutex_);
+    capacity_ = capacity;
+    while (usage_ > capacity_ && lru_.next != &lru_) {
+      EvictOldestUnlocked(&to_remove_head);
+    }
+  }
+  FreeLRUEntries(to_remove_head);
+}
+
+void NvmLRUCache::ApplyToAllEntries(
+    const std::function<void(void* value, size_t charge)>& callback) {
+  std::lock_guard<MutexType> l(mutex_);
+  for (LRUHandle* e = lru_.next; e != &lru_; e = e->next) {
+    callback(e->value, e->charge);
+  }
+}
+
 void NvmLRUCache::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
@@ -518,7 +540,7 @@ class ShardedLRUCache : public Cache {
         : last_id_(0),
           vmp_(vmp) {
 
-    const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
+    const size_t per_shard = PerShardCapacity(capacity);
     for (int s = 0; s < kNumShards; s++) {
       gscoped_ptr<NvmLRUCache> shard(new NvmLRUCache(vmp_));
       shard->SetCapacity(per_shard);
@@ -526,6 +548,10 @@ class ShardedLRUCache : public Cache {
     }
   }
 
+  static size_t PerShardCapacity(size_t capacity) {
+    return (capacity + (kNumShards - 1)) / kNumShards;
+  }
+
   virtual ~ShardedLRUCache() {
     STLDeleteElements(&shards_);
     // Per the note at the top of this file, our cache is entirely volatile.
@@ -564,6 +590,19 @@ class ShardedLRUCache : public Cache {
       cache->SetMetrics(metrics_.get());
     }
   }
+  // The size of the vmem pool does not change, so a larger capacity only takes effect up to it.
+  void SetCapacity(size_t capacity) override {
+    const size_t per_shard = PerShardCapacity(capacity);
+    for (NvmLRUCache* cache : shards_) {
+      cache->Resize(per_shard);
+    }
+  }
+  void ApplyToAllCacheEntries(
+      const std::function<void(void* value, size_t charge)>& callback) override {
+    for (NvmLRUCache* cache : shards_) {
+      cache->ApplyToAllEntries(callback);
+    }
+  }
   uint8_t* Allocate(int size) override {
     // Try allocating from each of the shards -- if vmem is tight,
     // this can cause eviction, so we might have better luck in different
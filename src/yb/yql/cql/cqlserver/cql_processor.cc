@@ -50,6 +50,16 @@ METRIC_DEFINE_histogram(
 METRIC_DEFINE_counter(
     server, yb_cqlserver_CQLServerService_ParsingErrors, "Errors encountered when parsing ",
     yb::MetricUnit::kRequests, "Errors encountered when parsing ");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheHits,
+    "Unprepared queries executed with a cached auto-parameterized statement",
+    yb::MetricUnit::kRequests,
+    "Unprepared queries executed with a cached auto-parameterized statement");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheMisses,
+    "Unprepared queries for which an auto-parameterized statement was prepared",
+    yb::MetricUnit::kRequests,
+    "Unprepared queries for which an auto-parameterized statement was prepared");
 METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_CQLServerService_Any,
     "yb.cqlserver.CQLServerService.AnyMethod RPC Time", yb::MetricUnit::kMicroseconds,
@@ -58,6 +68,13 @@ METRIC_DEFINE_histogram(
     "RPC requests",
     60000000LU, 2);
 
+DEFINE_bool(cql_auto_parameterize_unprepared_statements, false,
+            "Replace the literals of unprepared DML queries with bind markers "
+            "and execute them with the prepared statement cached for the resulting text, so that "
+            "queries differing only in their literal values are parsed and analyzed once.");
+TAG_FLAG(cql_auto_parameterize_unprepared_statements, runtime);
+TAG_FLAG(cql_auto_parameterize_unprepared_statements, advanced);
+
 DECLARE_bool(use_cassandra_authentication);
 
 namespace yb {
@@ -111,6 +128,12 @@ CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
       METRIC_handler_latency_yb_cqlserver_CQLServerService_Any.Instantiate(metric_entity);
   num_errors_parsing_cql_ =
       METRIC_yb_cqlserver_CQLServerService_ParsingErrors.Instantiate(metric_entity);
+  auto_parameterized_stmt_cache_hits_ =
+      METRIC_yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheHits.Instantiate(
+          metric_entity);
+  auto_parameterized_stmt_cache_misses_ =
+      METRIC_yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheMisses.Instantiate(
+          metric_entity);
 }
 
 //------------------------------------------------------------------------------------------------
@@ -189,6 +212,8 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  auto_parameterized_stmt_ = nullptr;
+  auto_parameterized_params_ = nullptr;
   SetCurrentCall(nullptr);
   Return();
 }
@@ -302,10 +327,76 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (FLAGS_cql_auto_parameterize_unprepared_statements && req.params().values.empty() &&
+      ExecuteAutoParameterized(req)) {
+    return nullptr;
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+bool CQLProcessor::ExecuteAutoParameterized(const QueryRequest& req) {
+  string normalized;
+  CQLLiterals literals;
+  if (!CQLStatement::AutoParameterize(req.query(), &normalized, &literals)) {
+    return false;
+  }
+
+  // The auto-parameterized statement is cached along with the prepared statements so it is shared
+  // by all clients, including those that prepare the same text themselves.
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(
+      ql_env_.CurrentKeyspace(), normalized);
+  shared_ptr<CQLStatement> stmt = service_impl_->AllocatePreparedStatement(
+      query_id, ql_env_.CurrentKeyspace(), normalized);
+  const bool cached = !stmt->unprepared();
+  // Falls back to running the query as is. The statement prepared here is dropped, so that
+  // queries that cannot be auto-parameterized do not fill the cache.
+  auto fallback = [this, &stmt, cached] {
+    if (!cached) {
+      service_impl_->DeletePreparedStatement(stmt);
+    }
+    return false;
+  };
+  PreparedResult::UniPtr result;
+  const Status s = stmt->Prepare(this, service_impl_->prepared_stmts_mem_tracker(), &result);
+  if (!s.ok() || result == nullptr) {
+    // A literal may be at a place where a bind marker is not allowed. Run the query as is then.
+    VLOG(1) << "Cannot auto-parameterize " << req.query() << ": " << s;
+    return fallback();
+  }
+
+  // Make sure every literal can be bound as the type the bind marker replacing it is analyzed to
+  // be, e.g. an integer literal for a bigint column but not for a double one.
+  const auto& bind_variable_schemas = result->bind_variable_schemas();
+  if (bind_variable_schemas.size() != literals.size()) {
+    return fallback();
+  }
+  unique_ptr<AutoParameterizedParams> params(
+      new AutoParameterizedParams(req.params(), std::move(literals)));
+  for (size_t i = 0; i < bind_variable_schemas.size(); i++) {
+    QLValue value;
+    if (!params->GetBindVariable(bind_variable_schemas[i].name(), i,
+                                 bind_variable_schemas[i].type(), &value).ok()) {
+      return fallback();
+    }
+  }
+
+  if (cached) {
+    cql_metrics_->auto_parameterized_stmt_cache_hits_->Increment();
+  } else {
+    cql_metrics_->auto_parameterized_stmt_cache_misses_->Increment();
+  }
+  stmt->clear_reparsed();
+  auto_parameterized_stmt_ = stmt;
+  auto_parameterized_params_ = std::move(params);
+  const Status exec_status = stmt->ExecuteAsync(
+      this, *auto_parameterized_params_, statement_executed_cb_);
+  if (PREDICT_FALSE(!exec_status.ok())) {
+    StatementExecuted(exec_status);
+  }
+  return true;
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
 
@@ -401,6 +492,11 @@ CQLResponse* CQLProcessor::ProcessResult(Status s, const ExecutedResult::SharedP
       ErrorCode ql_errcode = GetErrorCode(s);
       if (ql_errcode == ErrorCode::UNPREPARED_STATEMENT ||
           ql_errcode == ErrorCode::STALE_METADATA) {
+        // The auto-parameterized statement of a query is not known to the client, so it is never
+        // returned as unprepared. Drop it if stale so that the retry below prepares it again.
+        if (auto_parameterized_stmt_ != nullptr && auto_parameterized_stmt_->stale()) {
+          service_impl_->DeletePreparedStatement(auto_parameterized_stmt_);
+        }
         // Delete all stale prepared statements from our cache. Since CQL protocol allows only one
         // unprepared query id to be returned, we will return just the last unprepared / stale one
         // we found.
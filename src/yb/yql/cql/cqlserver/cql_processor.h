@@ -45,6 +45,8 @@ class CQLMetrics : public ql::QLMetrics {
 
   scoped_refptr<yb::Histogram> time_to_queue_cql_response_;
   scoped_refptr<yb::Counter> num_errors_parsing_cql_;
+  scoped_refptr<yb::Counter> auto_parameterized_stmt_cache_hits_;
+  scoped_refptr<yb::Counter> auto_parameterized_stmt_cache_misses_;
   // Rpc level metrics
   yb::rpc::RpcMethodMetrics rpc_method_metrics_;
 };
@@ -78,6 +80,10 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Execute an unprepared query through the prepared statement of its auto-parameterized text.
+  // Returns false if the query cannot be executed so and should be run as is.
+  bool ExecuteAutoParameterized(const QueryRequest& req);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
@@ -110,6 +116,10 @@ class CQLProcessor : public ql::QLProcessor {
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
+  // Auto-parameterized statement and its parameters for the unprepared query being executed.
+  std::shared_ptr<const CQLStatement> auto_parameterized_stmt_;
+  std::unique_ptr<AutoParameterizedParams> auto_parameterized_params_;
+
   // Current retry count.
   int retry_count_ = 0;
 
@@ -15,8 +15,18 @@
 
 #include "yb/yql/cql/cqlserver/cql_statement.h"
 
+#include <limits>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <openssl/md5.h>
 
+#include "yb/gutil/strings/escaping.h"
+#include "yb/gutil/strings/numbers.h"
+#include "yb/util/date_time.h"
+#include "yb/util/decimal.h"
+#include "yb/util/uuid.h"
+#include "yb/util/varint.h"
+
 namespace yb {
 namespace cqlserver {
 
@@ -39,5 +49,338 @@ CQLMessage::QueryId CQLStatement::GetQueryId(const string& keyspace, const strin
   return CQLMessage::QueryId(util::to_char_ptr(md5), sizeof(md5));
 }
 
+namespace {
+
+bool IsIdentifierChar(const char c) {
+  return isalnum(c) || c == '_' || c == '$';
+}
+
+// Only the statements whose analyzed parse tree can be executed with different bind variables are
+// auto-parameterized.
+bool IsDmlKeyword(const string& word) {
+  return boost::iequals(word, "SELECT") || boost::iequals(word, "INSERT") ||
+         boost::iequals(word, "UPDATE") || boost::iequals(word, "DELETE");
+}
+
+// Returns true if a '-' following the normalized text is the sign of a number, as in "h = -1" or
+// "(-1", rather than a subtraction, as in "c - 1".
+bool IsSignPosition(const string& normalized) {
+  const size_t pos = normalized.find_last_not_of(" \t\r\n");
+  if (pos == string::npos) {
+    return true;
+  }
+  const char c = normalized[pos];
+  return !IsIdentifierChar(c) && c != ')' && c != ']' && c != '}' && c != '?' && c != '\'' &&
+         c != '"';
+}
+
+// Returns the length of the uuid at pos of the statement, or 0 if there is none.
+size_t UuidLength(const string& ql_stmt, const size_t pos) {
+  static constexpr size_t kUuidLength = 36;
+  if (pos + kUuidLength > ql_stmt.size() ||
+      (pos + kUuidLength < ql_stmt.size() && IsIdentifierChar(ql_stmt[pos + kUuidLength]))) {
+    return 0;
+  }
+  for (size_t k = 0; k < kUuidLength; k++) {
+    const char c = ql_stmt[pos + k];
+    if ((k == 8 || k == 13 || k == 18 || k == 23) ? c != '-' : !isxdigit(c)) {
+      return 0;
+    }
+  }
+  return kUuidLength;
+}
+
+// Returns the end of the digits of a number starting at pos of the statement, with the fraction
+// and the exponent if any. Sets kind to kFloat if there is either of them, kInteger otherwise.
+size_t NumberEnd(const string& ql_stmt, size_t pos, CQLLiteral::Kind* kind) {
+  const size_t size = ql_stmt.size();
+  *kind = CQLLiteral::Kind::kInteger;
+  while (pos < size && isdigit(ql_stmt[pos])) {
+    pos++;
+  }
+  if (pos < size && ql_stmt[pos] == '.') {
+    *kind = CQLLiteral::Kind::kFloat;
+    for (pos++; pos < size && isdigit(ql_stmt[pos]); pos++) {}
+  }
+  if (pos < size && (ql_stmt[pos] == 'e' || ql_stmt[pos] == 'E')) {
+    size_t exponent = pos + 1;
+    if (exponent < size && (ql_stmt[exponent] == '+' || ql_stmt[exponent] == '-')) {
+      exponent++;
+    }
+    if (exponent < size && isdigit(ql_stmt[exponent])) {
+      *kind = CQLLiteral::Kind::kFloat;
+      for (pos = exponent; pos < size && isdigit(ql_stmt[pos]); pos++) {}
+    }
+  }
+  return pos;
+}
+
+template <class T>
+bool InRange(const int64_t value) {
+  return value >= std::numeric_limits<T>::min() && value <= std::numeric_limits<T>::max();
+}
+
+// Sets value to the literal converted to the given type. Returns false if it cannot be converted.
+bool BindLiteral(const CQLLiteral& literal, const DataType type, QLValue* value) {
+  switch (literal.kind) {
+    case CQLLiteral::Kind::kInteger: {
+      int64_t v = 0;
+      if (!safe_strto64(literal.value, &v)) {
+        // Too large for a bigint, may still be a varint or a decimal.
+        break;
+      }
+      switch (type) {
+        case DataType::INT8:
+          if (!InRange<int8_t>(v)) {
+            return false;
+          }
+          value->set_int8_value(v);
+          return true;
+        case DataType::INT16:
+          if (!InRange<int16_t>(v)) {
+            return false;
+          }
+          value->set_int16_value(v);
+          return true;
+        case DataType::INT32:
+          if (!InRange<int32_t>(v)) {
+            return false;
+          }
+          value->set_int32_value(v);
+          return true;
+        case DataType::INT64:
+          value->set_int64_value(v);
+          return true;
+        case DataType::TIMESTAMP:
+          value->set_timestamp_value(DateTime::TimestampFromInt(v));
+          return true;
+        default:
+          break;
+      }
+      break;
+    }
+    case CQLLiteral::Kind::kBoolean:
+      if (type != DataType::BOOL) {
+        return false;
+      }
+      value->set_bool_value(boost::iequals(literal.value, "true"));
+      return true;
+    case CQLLiteral::Kind::kUuid: {
+      Uuid uuid;
+      if (!uuid.FromString(literal.value).ok()) {
+        return false;
+      }
+      if (type == DataType::UUID) {
+        value->set_uuid_value(uuid);
+        return true;
+      }
+      if (type == DataType::TIMEUUID && uuid.IsTimeUuid().ok()) {
+        value->set_timeuuid_value(uuid);
+        return true;
+      }
+      return false;
+    }
+    case CQLLiteral::Kind::kBlob:
+      // The hex digits follow the 0x prefix.
+      if (type != DataType::BINARY || literal.value.size() % 2 != 0) {
+        return false;
+      }
+      value->set_binary_value(a2b_hex(literal.value.substr(2)));
+      return true;
+    case CQLLiteral::Kind::kString:
+      if (type == DataType::STRING) {
+        value->set_string_value(literal.value);
+        return true;
+      }
+      if (type == DataType::TIMESTAMP) {
+        auto timestamp = DateTime::TimestampFromString(literal.value);
+        if (!timestamp.ok()) {
+          return false;
+        }
+        value->set_timestamp_value(*timestamp);
+        return true;
+      }
+      return false;
+    case CQLLiteral::Kind::kFloat:
+      break;
+  }
+
+  // Numbers that are not bound as integers above.
+  switch (type) {
+    case DataType::FLOAT:
+    case DataType::DOUBLE: {
+      double v = 0;
+      if (!safe_strtod(literal.value, &v)) {
+        return false;
+      }
+      if (type == DataType::FLOAT) {
+        value->set_float_value(static_cast<float>(v));
+      } else {
+        value->set_double_value(v);
+      }
+      return true;
+    }
+    case DataType::DECIMAL: {
+      util::Decimal decimal;
+      if (!decimal.FromString(literal.value).ok()) {
+        return false;
+      }
+      value->set_decimal_value(decimal.EncodeToComparable());
+      return true;
+    }
+    case DataType::VARINT: {
+      util::VarInt varint;
+      if (literal.kind != CQLLiteral::Kind::kInteger || !varint.FromString(literal.value).ok()) {
+        return false;
+      }
+      value->set_varint_value(varint);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+bool CQLStatement::AutoParameterize(
+    const string& ql_stmt, string* normalized, CQLLiterals* literals) {
+  const size_t size = ql_stmt.size();
+  size_t i = 0;
+  while (i < size && isspace(ql_stmt[i])) {
+    i++;
+  }
+  size_t j = i;
+  while (j < size && IsIdentifierChar(ql_stmt[j])) {
+    j++;
+  }
+  if (!IsDmlKeyword(ql_stmt.substr(i, j - i))) {
+    return false;
+  }
+
+  normalized->assign(ql_stmt, 0, j);
+  literals->clear();
+  i = j;
+  while (i < size) {
+    const char c = ql_stmt[i];
+    const char next = (i + 1 < size) ? ql_stmt[i + 1] : '\0';
+    if (c == '\'') {
+      // String literal. A quote inside is escaped by doubling it.
+      string value;
+      for (j = i + 1; ; j++) {
+        if (j == size) {
+          return false;
+        }
+        if (ql_stmt[j] == '\'') {
+          if (j + 1 == size || ql_stmt[j + 1] != '\'') {
+            break;
+          }
+          j++;
+        }
+        value.push_back(ql_stmt[j]);
+      }
+      literals->push_back(CQLLiteral{CQLLiteral::Kind::kString, std::move(value)});
+      normalized->push_back('?');
+      i = j + 1;
+      continue;
+    }
+
+    if (c == '"') {
+      // Quoted identifier, kept as is.
+      for (j = i + 1; ; j++) {
+        if (j == size) {
+          return false;
+        }
+        if (ql_stmt[j] == '"') {
+          if (j + 1 == size || ql_stmt[j + 1] != '"') {
+            break;
+          }
+          j++;
+        }
+      }
+      j++;
+    } else if ((c == '-' && next == '-') || (c == '/' && next == '/')) {
+      // Single-line comment.
+      j = ql_stmt.find('\n', i);
+      j = (j == string::npos) ? size : j;
+    } else if (c == '/' && next == '*') {
+      j = ql_stmt.find("*/", i + 2);
+      if (j == string::npos) {
+        return false;
+      }
+      j += 2;
+    } else if (c == '?' || (c == ':' && (isalpha(next) || next == '_' || next == '"')) ||
+               (c == '$' && next == '$')) {
+      // Bind markers of the statement's own or a function body, leave the statement alone.
+      return false;
+    } else if (const size_t uuid_length = UuidLength(ql_stmt, i)) {
+      literals->push_back(CQLLiteral{CQLLiteral::Kind::kUuid, ql_stmt.substr(i, uuid_length)});
+      normalized->push_back('?');
+      i += uuid_length;
+      continue;
+    } else if (isalpha(c) || c == '_') {
+      for (j = i + 1; j < size && IsIdentifierChar(ql_stmt[j]); j++) {}
+      string word = ql_stmt.substr(i, j - i);
+      if (boost::iequals(word, "true") || boost::iequals(word, "false")) {
+        literals->push_back(CQLLiteral{CQLLiteral::Kind::kBoolean, std::move(word)});
+        normalized->push_back('?');
+        i = j;
+        continue;
+      }
+      if (boost::iequals(word, "NaN") || boost::iequals(word, "Infinity")) {
+        literals->push_back(CQLLiteral{CQLLiteral::Kind::kFloat, std::move(word)});
+        normalized->push_back('?');
+        i = j;
+        continue;
+      }
+    } else if (isdigit(c) || (c == '-' && isdigit(next) && IsSignPosition(*normalized))) {
+      CQLLiteral::Kind kind;
+      if (c == '0' && (next == 'x' || next == 'X')) {
+        kind = CQLLiteral::Kind::kBlob;
+        for (j = i + 2; j < size && isxdigit(ql_stmt[j]); j++) {}
+      } else {
+        j = NumberEnd(ql_stmt, c == '-' ? i + 1 : i, &kind);
+      }
+      if (j < size && (IsIdentifierChar(ql_stmt[j]) || ql_stmt[j] == '.')) {
+        // A literal of another kind, such as a duration, that is not replaced.
+        return false;
+      }
+      literals->push_back(CQLLiteral{kind, ql_stmt.substr(i, j - i)});
+      normalized->push_back('?');
+      i = j;
+      continue;
+    } else if (c == '.' && isdigit(next)) {
+      return false;
+    } else {
+      j = i + 1;
+    }
+    normalized->append(ql_stmt, i, j - i);
+    i = j;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------------------------
+AutoParameterizedParams::AutoParameterizedParams(
+    const ql::StatementParameters& params, CQLLiterals literals)
+    : ql::StatementParameters(params), literals_(std::move(literals)) {
+}
+
+Status AutoParameterizedParams::GetBindVariable(const string& name,
+                                                const int64_t pos,
+                                                const std::shared_ptr<QLType>& type,
+                                                QLValue* value) const {
+  if (pos < 0 || pos >= literals_.size()) {
+    // Return error with 1-based position.
+    return STATUS_SUBSTITUTE(RuntimeError, "Bind variable at position $0 not found", pos + 1);
+  }
+  const CQLLiteral& literal = literals_[pos];
+  if (!BindLiteral(literal, type->main(), value)) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Literal $0 at position $1 cannot be bound as $2",
+                             literal.value, pos + 1, type->ToString());
+  }
+  return Status::OK();
+}
+
 }  // namespace cqlserver
 }  // namespace yb
@@ -20,6 +20,7 @@
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
 #include <list>
+#include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/ql/statement.h"
@@ -29,6 +30,27 @@ namespace cqlserver {
 
 class CQLStatement;
 
+// A literal of an unprepared statement that was replaced with a bind marker by
+// CQLStatement::AutoParameterize().
+struct CQLLiteral {
+  enum class Kind {
+    kInteger,
+    kFloat,
+    kBoolean,
+    kUuid,
+    kBlob,
+    kString,
+  };
+
+  Kind kind;
+
+  // Text of the literal as written in the statement, including the sign of a number and the 0x
+  // prefix of a blob, except for a string literal whose value is unquoted and unescaped.
+  std::string value;
+};
+
+using CQLLiterals = std::vector<CQLLiteral>;
+
 // A map of CQL query id to the prepared statement for caching the prepared statments. Shared_ptr
 // is used so that a prepared statement can be aged out and removed from the cache without deleting
 // it when it is being executed by another client in another thread.
@@ -54,11 +76,35 @@ class CQLStatement : public ql::Statement {
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& ql_stmt);
 
+  // Replace the literals of an unprepared DML statement with bind markers so that statements
+  // differing only in their literal values share the same normalized text. The literals replaced
+  // are returned in the order of their bind markers. Returns false if the statement is not a DML
+  // or it cannot be normalized, e.g. it has bind markers of its own or a literal of a kind not
+  // listed in CQLLiteral::Kind, so that no normalized text keeps a literal value.
+  static bool AutoParameterize(
+      const std::string& ql_stmt, std::string* normalized, CQLLiterals* literals);
+
  private:
   // Position of the statement in the LRU.
   mutable CQLStatementListPos pos_;
 };
 
+// Parameters for executing an auto-parameterized statement. The literals taken out of the statement
+// text are returned as its bind variables while paging and consistency come from the original
+// query parameters.
+class AutoParameterizedParams : public ql::StatementParameters {
+ public:
+  AutoParameterizedParams(const ql::StatementParameters& params, CQLLiterals literals);
+
+  CHECKED_STATUS GetBindVariable(const std::string& name,
+                                 int64_t pos,
+                                 const std::shared_ptr<QLType>& type,
+                                 QLValue* value) const override;
+
+ private:
+  const CQLLiterals literals_;
+};
+
 }  // namespace cqlserver
 }  // namespace yb
 
@@ -20,12 +20,20 @@
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
+#include "yb/yql/cql/cqlserver/cql_statement.h"
 
 #include "yb/gutil/strings/join.h"
 #include "yb/util/cast.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/test_util.h"
 
+DECLARE_bool(cql_auto_parameterize_unprepared_statements);
+
+METRIC_DECLARE_counter(yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheHits);
+METRIC_DECLARE_counter(yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheMisses);
+
 namespace yb {
 namespace cqlserver {
 
@@ -45,6 +53,17 @@ class TestCQLService : public YBTableTestBase {
 
   void SendRequestAndExpectResponse(const string& cmd, const string& resp);
 
+  // Sends the request and reads the whole response, whatever it is.
+  void SendRequestAndSkipResponse(const string& cmd);
+
+  // Returns the memory used by the prepared statements cached by the server.
+  int64_t PreparedStatementsMemory() {
+    return server_->mem_tracker()->FindChild("CQL prepared statements' memory usage")
+        ->consumption();
+  }
+
+  const scoped_refptr<MetricEntity>& server_metric_entity() { return server_->metric_entity(); }
+
   int server_port() { return cql_server_port_; }
  private:
   Status SendRequestAndGetResponse(
@@ -132,6 +151,46 @@ void TestCQLService::SendRequestAndExpectResponse(const string& cmd, const strin
   CHECK_EQ(resp, string(reinterpret_cast<char*>(resp_), resp.length()));
 }
 
+void TestCQLService::SendRequestAndSkipResponse(const string& cmd) {
+  // The length of the response body is stored in the last 4 bytes of its 9 bytes header.
+  constexpr int kHeaderLength = 9;
+  ASSERT_OK(SendRequestAndGetResponse(cmd, kHeaderLength, 10000 /* timeout_in_millis */));
+  size_t body_length = 0;
+  for (int i = kHeaderLength - 4; i < kHeaderLength; i++) {
+    body_length = (body_length << 8) | resp_[i];
+  }
+
+  MonoTime deadline = MonoTime::Now() + MonoDelta::FromSeconds(10);
+  while (body_length > 0) {
+    size_t bytes_read = 0;
+    ASSERT_OK(client_sock_.BlockingRecv(
+        resp_, std::min(body_length, kBufLen), &bytes_read, deadline));
+    body_length -= bytes_read;
+  }
+}
+
+namespace {
+
+// Returns a version 4 QUERY request for the query, without bind values.
+string QueryRequestMessage(const string& query) {
+  auto append_int32 = [](int32_t value, string* out) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      out->push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+  };
+  string body;
+  append_int32(query.size(), &body);
+  body += query;
+  // Consistency ONE and no flags.
+  body += BINARY_STRING("\x00\x01" "\x00");
+
+  string request = BINARY_STRING("\x04\x00\x00\x00\x07");
+  append_int32(body.size(), &request);
+  return request + body;
+}
+
+} // namespace
+
 // The following test cases test the CQL protocol marshalling/unmarshalling with hand-coded
 // request messages and expected responses. They are good as basic and error-handling tests.
 // These are expected to be few.
@@ -233,6 +292,67 @@ TEST_F(TestCQLService, InvalidRequest) {
                     "\x00\x00\x00\x0a" "\x00\x17" "Request length too long"));
 }
 
+// An unprepared query that could not be executed with its auto-parameterized statement should not
+// leave that statement in the cache.
+TEST_F(TestCQLService, AutoParameterizeFallback) {
+  FLAGS_cql_auto_parameterize_unprepared_statements = true;
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x01" "\x00\x00\x00\x16"
+                    "\x00\x01" "\x00\x0b" "CQL_VERSION"
+                               "\x00\x05" "3.0.0"),
+      BINARY_STRING("\x84\x00\x00\x00\x02" "\x00\x00\x00\x00"));
+
+  ASSERT_EQ(0, PreparedStatementsMemory());
+
+  // The string literal is bound to the text column, so the normalized statement is cached.
+  SendRequestAndSkipResponse(
+      QueryRequestMessage("SELECT * FROM system.local WHERE key = 'local'"));
+  const int64_t cached_memory = PreparedStatementsMemory();
+  ASSERT_GT(cached_memory, 0);
+
+  // The integer literal cannot be bound to the text column, so the query falls back to the regular
+  // path.
+  SendRequestAndSkipResponse(QueryRequestMessage("SELECT * FROM system.local WHERE key = 1"));
+  ASSERT_EQ(cached_memory, PreparedStatementsMemory());
+}
+
+// Queries differing only in their literals, whatever their kinds, should share one cached
+// auto-parameterized statement.
+TEST_F(TestCQLService, AutoParameterizeLiteralKinds) {
+  FLAGS_cql_auto_parameterize_unprepared_statements = true;
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x01" "\x00\x00\x00\x16"
+                    "\x00\x01" "\x00\x0b" "CQL_VERSION"
+                               "\x00\x05" "3.0.0"),
+      BINARY_STRING("\x84\x00\x00\x00\x02" "\x00\x00\x00\x00"));
+  SendRequestAndSkipResponse(QueryRequestMessage("CREATE KEYSPACE test_literals"));
+  SendRequestAndSkipResponse(QueryRequestMessage(
+      "CREATE TABLE test_literals.t (h uuid, r int, v double, b boolean, PRIMARY KEY ((h), r))"));
+
+  auto hits = METRIC_yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheHits.Instantiate(
+      server_metric_entity());
+  auto misses =
+      METRIC_yb_cqlserver_CQLServerService_AutoParameterizedStatementCacheMisses.Instantiate(
+          server_metric_entity());
+  ASSERT_EQ(0, misses->value());
+
+  const vector<string> uuids = {
+      "123e4567-e89b-12d3-a456-426655440000",
+      "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11",
+      "00000000-0000-0000-0000-000000000000",
+  };
+  for (size_t i = 0; i < uuids.size(); i++) {
+    SendRequestAndSkipResponse(QueryRequestMessage(Substitute(
+        "INSERT INTO test_literals.t (h, r, v, b) VALUES ($0, -$1, -$1.5e-1, $2)",
+        uuids[i], i + 1, i % 2 == 0 ? "true" : "false")));
+    SendRequestAndSkipResponse(QueryRequestMessage(Substitute(
+        "SELECT * FROM test_literals.t WHERE h = $0 AND r = -$1", uuids[i], i + 1)));
+  }
+  // One entry for the insert and one for the select, that the following queries reuse.
+  ASSERT_EQ(2, misses->value());
+  ASSERT_EQ(4, hits->value());
+}
+
 TEST_F(TestCQLService, TestCQLServerEventConst) {
   std::unique_ptr<SchemaChangeEventResponse> response(
       new SchemaChangeEventResponse("", "", "", "", {}));
@@ -250,5 +370,74 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+TEST(TestCQLStatement, AutoParameterize) {
+  string normalized;
+  CQLLiterals literals;
+
+  ASSERT_TRUE(CQLStatement::AutoParameterize(
+      "SELECT * FROM t WHERE h = 10 AND r = 'it''s' LIMIT 5;", &normalized, &literals));
+  ASSERT_EQ("SELECT * FROM t WHERE h = ? AND r = ? LIMIT ?;", normalized);
+  ASSERT_EQ(3, literals.size());
+  ASSERT_EQ(CQLLiteral::Kind::kInteger, literals[0].kind);
+  ASSERT_EQ("10", literals[0].value);
+  ASSERT_EQ(CQLLiteral::Kind::kString, literals[1].kind);
+  ASSERT_EQ("it's", literals[1].value);
+  ASSERT_EQ("5", literals[2].value);
+
+  // Floats, negative numbers, blobs, uuids and booleans are replaced too, while quoted
+  // identifiers, comments and subtractions are kept as is.
+  ASSERT_TRUE(CQLStatement::AutoParameterize(
+      "insert into \"T1\" (a, b, c, d, e, f) values (1.5e-3, -3, 0xff, "
+      "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11, false, 7) -- 'comment' 8", &normalized, &literals));
+  ASSERT_EQ("insert into \"T1\" (a, b, c, d, e, f) values (?, ?, ?, ?, ?, ?) -- 'comment' 8",
+            normalized);
+  ASSERT_EQ(6, literals.size());
+  ASSERT_EQ(CQLLiteral::Kind::kFloat, literals[0].kind);
+  ASSERT_EQ("1.5e-3", literals[0].value);
+  ASSERT_EQ(CQLLiteral::Kind::kInteger, literals[1].kind);
+  ASSERT_EQ("-3", literals[1].value);
+  ASSERT_EQ(CQLLiteral::Kind::kBlob, literals[2].kind);
+  ASSERT_EQ(CQLLiteral::Kind::kUuid, literals[3].kind);
+  ASSERT_EQ("a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11", literals[3].value);
+  ASSERT_EQ(CQLLiteral::Kind::kBoolean, literals[4].kind);
+  ASSERT_EQ("7", literals[5].value);
+
+  ASSERT_TRUE(CQLStatement::AutoParameterize(
+      "UPDATE t SET c = c - 1 WHERE h IN (-1, 2)", &normalized, &literals));
+  ASSERT_EQ("UPDATE t SET c = c - ? WHERE h IN (?, ?)", normalized);
+  ASSERT_EQ("-1", literals[1].value);
+
+  // Literals of other kinds are not left in the normalized text.
+  ASSERT_FALSE(CQLStatement::AutoParameterize(
+      "UPDATE t SET d = 1h30m WHERE h = 1", &normalized, &literals));
+
+  // Statements with bind markers of their own, DDLs and malformed statements are not normalized.
+  ASSERT_FALSE(CQLStatement::AutoParameterize(
+      "SELECT * FROM t WHERE h = ?", &normalized, &literals));
+  ASSERT_FALSE(CQLStatement::AutoParameterize(
+      "UPDATE t SET v = 1 WHERE h = :h", &normalized, &literals));
+  ASSERT_FALSE(CQLStatement::AutoParameterize(
+      "CREATE TABLE t (h int PRIMARY KEY)", &normalized, &literals));
+  ASSERT_FALSE(CQLStatement::AutoParameterize(
+      "DELETE FROM t WHERE h = 'abc", &normalized, &literals));
+
+  // The literals are bound as the types of the bind markers replacing them.
+  ASSERT_TRUE(CQLStatement::AutoParameterize(
+      "SELECT * FROM t WHERE a = 7 AND b = -2.5 AND c = '2018-01-02 03:04:05'",
+      &normalized, &literals));
+  AutoParameterizedParams params(ql::StatementParameters(), literals);
+  QLValue value;
+  ASSERT_OK(params.GetBindVariable("a", 0, QLType::Create(DataType::INT16), &value));
+  ASSERT_EQ(7, value.int16_value());
+  ASSERT_OK(params.GetBindVariable("a", 0, QLType::Create(DataType::DOUBLE), &value));
+  ASSERT_EQ(7, value.double_value());
+  ASSERT_NOK(params.GetBindVariable("a", 0, QLType::Create(DataType::STRING), &value));
+  ASSERT_OK(params.GetBindVariable("b", 1, QLType::Create(DataType::FLOAT), &value));
+  ASSERT_EQ(-2.5, value.float_value());
+  ASSERT_NOK(params.GetBindVariable("b", 1, QLType::Create(DataType::INT32), &value));
+  ASSERT_OK(params.GetBindVariable("c", 2, QLType::Create(DataType::TIMESTAMP), &value));
+  ASSERT_NOK(params.GetBindVariable("c", 3, QLType::Create(DataType::INT16), &value));
+}
+
 }  // namespace cqlserver
 }  // namespace yb
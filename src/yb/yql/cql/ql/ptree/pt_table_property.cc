@@ -30,6 +30,7 @@ using client::YBColumnSchema;
 const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPropertyDataTypes
     = {
     {"bloom_filter_fp_chance", KVProperty::kBloomFilterFpChance},
+    {"bloom_filter_range_components", KVProperty::kBloomFilterRangeComponents},
     {"caching", KVProperty::kCaching},
     {"comment", KVProperty::kComment},
     {"compaction", KVProperty::kCompaction},
@@ -166,6 +167,25 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
             ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kBloomFilterRangeComponents: {
+      // The bloom filters of the existing SST files are built for the original number of
+      // components, so it could be set only when the table is created.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 cannot be altered", table_property_name).c_str(),
+                                  ErrorCode::INVALID_TABLE_PROPERTY);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
+      const int64_t num_range_columns =
+          sem_context->current_create_table_stmt()->primary_columns().size();
+      if (int_val < 0 || int_val > num_range_columns) {
+        return sem_context->Error(this,
+            Substitute("$0 must be between 0 and the number of clustering columns $1 (got $2)",
+                       table_property_name, num_range_columns, int_val).c_str(),
+            ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
+    }
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
     case KVProperty::kDclocalReadRepairChance: FALLTHROUGH_INTENDED;
     case KVProperty::kReadRepairChance:
@@ -367,6 +387,15 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kBloomFilterRangeComponents: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for bloom_filter_range_components"));
+      }
+      table_property->SetNumRangeComponentsInBloomFilter(val);
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
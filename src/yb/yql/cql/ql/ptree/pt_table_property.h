@@ -39,6 +39,7 @@ class PTTableProperty : public PTProperty {
  public:
   enum class KVProperty : int {
     kBloomFilterFpChance,
+    kBloomFilterRangeComponents,
     kCaching,
     kComment,
     kCompaction,
@@ -181,6 +181,46 @@ TEST_F(TestQLCreateTable, TestQLCreateTableWithTTL) {
   EXPECT_EQ(1000, properties_pb.default_time_to_live());
 }
 
+TEST_F(TestQLCreateTable, TestQLCreateTableWithBloomFilterRangeComponents) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get an available processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  EXEC_VALID_STMT("CREATE TABLE table_with_bloom (h int, r1 int, r2 int, v int, "
+                      "PRIMARY KEY((h), r1, r2)) WITH bloom_filter_range_components = 2;");
+
+  // Query the table schema.
+  master::Master *master = cluster_->mini_master()->master();
+  master::CatalogManager *catalog_manager = master->catalog_manager();
+  master::GetTableSchemaRequestPB request_pb;
+  master::GetTableSchemaResponsePB response_pb;
+  request_pb.mutable_table()->mutable_namespace_()->set_name(kDefaultKeyspaceName);
+  request_pb.mutable_table()->set_table_name("table_with_bloom");
+
+  // Verify the number of range components was stored in syscatalog table.
+  CHECK_OK(catalog_manager->GetTableSchema(&request_pb, &response_pb));
+  const TablePropertiesPB& properties_pb = response_pb.schema().table_properties();
+  EXPECT_TRUE(properties_pb.has_num_range_components_in_bloom_filter());
+  EXPECT_EQ(2, properties_pb.num_range_components_in_bloom_filter());
+
+  // Value could not exceed the number of clustering columns.
+  EXEC_INVALID_TABLE_CREATE_STMT(
+      "CREATE TABLE table_with_bloom_invalid (h int, r1 int, r2 int, v int, "
+          "PRIMARY KEY((h), r1, r2)) WITH bloom_filter_range_components = 3;",
+      "bloom_filter_range_components must be between 0 and the number of clustering columns 2");
+  EXEC_INVALID_TABLE_CREATE_STMT(
+      "CREATE TABLE table_with_bloom_invalid (h int, v int, PRIMARY KEY(h)) "
+          "WITH bloom_filter_range_components = 1;",
+      "bloom_filter_range_components must be between 0 and the number of clustering columns 0");
+
+  // Existing SST files have bloom filters built for the original value, so it cannot be altered.
+  EXEC_INVALID_TABLE_CREATE_STMT(
+      "ALTER TABLE table_with_bloom WITH bloom_filter_range_components = 1;",
+      "bloom_filter_range_components cannot be altered");
+}
+
 TEST_F(TestQLCreateTable, TestQLCreateTableWithClusteringOrderBy) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -24,8 +24,15 @@
 #include "yb/master/catalog_manager.h"
 #include "yb/rpc/messenger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(cql_follower_read_max_staleness_ms, 0,
+             "Reads at consistency level ONE may be served by followers. A follower whose safe "
+             "time lags more than this number of milliseconds rejects the read, which is then "
+             "retried on another replica. 0 means no bound.");
+TAG_FLAG(cql_follower_read_max_staleness_ms, evolving);
+
 namespace yb {
 namespace ql {
 
@@ -67,6 +74,10 @@ QLEnv::QLEnv(weak_ptr<rpc::Messenger> messenger, shared_ptr<YBClient> client,
       messenger_(messenger),
       cql_rpcserver_env_(cql_rpcserver_env) {
   CHECK_OK(session_->SetFlushMode(YBSession::MANUAL_FLUSH));
+  if (FLAGS_cql_follower_read_max_staleness_ms > 0) {
+    session_->SetFollowerReadMaxStaleness(
+        MonoDelta::FromMilliseconds(FLAGS_cql_follower_read_max_staleness_ms));
+  }
 }
 
 QLEnv::~QLEnv() {}
@@ -52,6 +52,10 @@ namespace redisserver {
     ((exists, Exists, 2, READ)) \
     ((getrange, GetRange, 4, READ)) \
     ((zcard, ZCard, 2, READ)) \
+    ((scan, Scan, -2, READ)) \
+    ((hscan, HScan, -3, READ)) \
+    ((sscan, SScan, -3, READ)) \
+    ((zscan, ZScan, -3, READ)) \
     ((set, Set, -3, WRITE)) \
     ((mset, MSet, -3, WRITE)) \
     ((hset, HSet, 4, WRITE)) \
@@ -51,6 +51,17 @@ constexpr size_t kMaxNumberLength = 25;
 constexpr char kPositiveInfinity[] = "+inf";
 constexpr char kNegativeInfinity[] = "-inf";
 
+// Scan cursors are opaque to clients, but a lot of clients handle them as numbers. So the position
+// to resume at is replied as "1" followed by 3 decimal digits per byte, and "0" is the cursor that
+// both starts and ends an iteration.
+constexpr char kScanCursorStart[] = "0";
+constexpr char kScanCursorPrefix = '1';
+constexpr size_t kScanCursorDigitsPerByte = 3;
+// SCAN position is the 2 byte hash code to resume at, optionally followed by this marker and the
+// key to resume after.
+constexpr size_t kScanHashCodeSize = 2;
+constexpr char kScanKeyMarker = 'k';
+
 string to_lower_case(Slice slice) {
   return boost::to_lower_copy(slice.ToBuffer());
 }
@@ -96,6 +107,82 @@ Result<int32_t> ParseInt32(const Slice& slice, const char* field) {
   return static_cast<int32_t>(*val);
 }
 
+string EncodeScanCursor(const string& position) {
+  string result(1, kScanCursorPrefix);
+  result.reserve(1 + position.size() * kScanCursorDigitsPerByte);
+  for (const uint8_t byte : position) {
+    result.push_back('0' + byte / 100);
+    result.push_back('0' + byte / 10 % 10);
+    result.push_back('0' + byte % 10);
+  }
+  return result;
+}
+
+// Returns none for the cursor that starts an iteration.
+Result<boost::optional<string>> DecodeScanCursor(const Slice& cursor) {
+  if (cursor == Slice(kScanCursorStart)) {
+    return boost::optional<string>();
+  }
+  if (cursor.empty() || cursor[0] != kScanCursorPrefix ||
+      (cursor.size() - 1) % kScanCursorDigitsPerByte != 0) {
+    return STATUS(InvalidArgument, "invalid cursor");
+  }
+  string result;
+  result.reserve((cursor.size() - 1) / kScanCursorDigitsPerByte);
+  for (size_t i = 1; i < cursor.size(); i += kScanCursorDigitsPerByte) {
+    int byte = 0;
+    for (size_t j = i; j != i + kScanCursorDigitsPerByte; ++j) {
+      if (!isdigit(cursor[j])) {
+        return STATUS(InvalidArgument, "invalid cursor");
+      }
+      byte = byte * 10 + cursor[j] - '0';
+    }
+    if (byte > std::numeric_limits<uint8_t>::max()) {
+      return STATUS(InvalidArgument, "invalid cursor");
+    }
+    result.push_back(static_cast<char>(byte));
+  }
+  return boost::optional<string>(std::move(result));
+}
+
+CHECKED_STATUS ParseScanOptions(const RedisClientCommand& args, size_t idx,
+                                RedisScanRequestPB* scan_request) {
+  for (; idx < args.size(); idx += 2) {
+    if (idx + 1 == args.size()) {
+      return STATUS(InvalidArgument, "syntax error");
+    }
+    const string option = to_lower_case(args[idx]);
+    if (option == "match") {
+      scan_request->set_pattern(args[idx + 1].cdata(), args[idx + 1].size());
+    } else if (option == "count") {
+      auto count = ParseInt32(args[idx + 1], "COUNT");
+      RETURN_NOT_OK(count);
+      if (*count < 1) {
+        return STATUS(InvalidArgument, "syntax error");
+      }
+      scan_request->set_count(*count);
+    } else {
+      return STATUS_SUBSTITUTE(InvalidArgument, "Unsupported scan option $0",
+                               args[idx].ToDebugString());
+    }
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS ParseCollectionScan(YBRedisReadOp* op, const RedisClientCommand& args,
+                                   RedisScanRequestPB_ScanRequestType request_type) {
+  auto* scan_request = op->mutable_request()->mutable_scan_request();
+  scan_request->set_request_type(request_type);
+  const auto& key = args[1];
+  op->mutable_request()->mutable_key_value()->set_key(key.cdata(), key.size());
+  auto cursor = DecodeScanCursor(args[2]);
+  RETURN_NOT_OK(cursor);
+  if (*cursor) {
+    scan_request->set_cursor(std::move(**cursor));
+  }
+  return ParseScanOptions(args, 3, scan_request);
+}
+
 } // namespace
 
 CHECKED_STATUS ParseSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
@@ -794,6 +881,69 @@ CHECKED_STATUS ParseGetRange(YBRedisReadOp* op, const RedisClientCommand& args)
   return Status::OK();
 }
 
+CHECKED_STATUS ParseScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  auto* scan_request = op->mutable_request()->mutable_scan_request();
+  scan_request->set_request_type(RedisScanRequestPB_ScanRequestType_SCAN);
+  auto cursor = DecodeScanCursor(args[1]);
+  RETURN_NOT_OK(cursor);
+  uint16_t hash_code = 0;
+  if (*cursor) {
+    const string& position = **cursor;
+    if (position.size() < kScanHashCodeSize ||
+        (position.size() > kScanHashCodeSize && position[kScanHashCodeSize] != kScanKeyMarker)) {
+      return STATUS(InvalidArgument, "invalid cursor");
+    }
+    hash_code = PartitionSchema::DecodeMultiColumnHashValue(position.substr(0, kScanHashCodeSize));
+    if (position.size() > kScanHashCodeSize) {
+      scan_request->set_cursor(position.substr(kScanHashCodeSize + 1));
+    }
+  }
+  // SCAN has no key, the hash code selects the tablet and the first key to scan.
+  op->mutable_request()->mutable_key_value()->set_hash_code(hash_code);
+  op->mutable_request()->mutable_key_value()->set_key("");
+  return ParseScanOptions(args, 2, scan_request);
+}
+
+CHECKED_STATUS ParseHScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseCollectionScan(op, args, RedisScanRequestPB_ScanRequestType_HSCAN);
+}
+
+CHECKED_STATUS ParseSScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseCollectionScan(op, args, RedisScanRequestPB_ScanRequestType_SSCAN);
+}
+
+CHECKED_STATUS ParseZScan(YBRedisReadOp* op, const RedisClientCommand& args) {
+  return ParseCollectionScan(op, args, RedisScanRequestPB_ScanRequestType_ZSCAN);
+}
+
+void CompleteScanResponse(const YBTable& table, const RedisReadRequestPB& request,
+                          RedisResponsePB* response) {
+  if (response->code() != RedisResponsePB_RedisStatusCode_OK) {
+    return;
+  }
+  if (request.scan_request().request_type() != RedisScanRequestPB_ScanRequestType_SCAN) {
+    response->set_scan_cursor(response->has_scan_cursor()
+        ? EncodeScanCursor(response->scan_cursor()) : kScanCursorStart);
+    return;
+  }
+
+  string position;
+  if (response->has_scan_cursor()) {
+    // The tablet replies the hash code and the key it stopped at.
+    position = response->scan_cursor();
+    position.insert(kScanHashCodeSize, 1, kScanKeyMarker);
+  } else if (response->has_scan_next_partition()) {
+    // The tablet has been scanned to the end, continue with the next one, if any. The tablet knows
+    // its partition, that is up to date even if the table partitions cached here are not.
+    position = response->scan_next_partition();
+  } else {
+    // Reply of a tablet server that does not report the next partition.
+    position = table.FindNextPartitionStart(
+        PartitionSchema::EncodeMultiColumnHashValue(request.key_value().hash_code()));
+  }
+  response->set_scan_cursor(position.empty() ? kScanCursorStart : EncodeScanCursor(position));
+}
+
 // Begin of input is going to be consumed, so we should adjust our pointers.
 // Since the beginning of input is being consumed by shifting the remaining bytes to the
 // beginning of the buffer.
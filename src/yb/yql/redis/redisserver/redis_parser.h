@@ -22,6 +22,8 @@
 #include "yb/client/callbacks.h"
 #include "yb/client/client_builder-internal.h"
 
+#include "yb/common/redis_protocol.pb.h"
+
 #include "yb/yql/redis/redisserver/redis_fwd.h"
 
 #include "yb/util/slice.h"
@@ -37,6 +39,12 @@ constexpr int64_t kNoneTtl = -1;
 CHECKED_STATUS ParseSet(client::YBRedisWriteOp *op, const RedisClientCommand& args);
 CHECKED_STATUS ParseGet(client::YBRedisReadOp* op, const RedisClientCommand& args);
 
+// Replaces the position a SCAN, HSCAN, SSCAN or ZSCAN request stopped at in the response with the
+// cursor to reply to the client. For SCAN, a tablet that has been scanned to the end continues at
+// the start of the next partition of the table.
+void CompleteScanResponse(const client::YBTable& table, const RedisReadRequestPB& request,
+                          RedisResponsePB* response);
+
 // TODO: make additional command support here
 
 // RedisParser is a finite state machine with memory.
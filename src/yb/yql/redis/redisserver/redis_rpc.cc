@@ -269,6 +269,12 @@ Out DoSerializeResponses(const Collection& responses, Out out) {
       out = SerializeBulkString(redis_response.string_response(), out);
     } else if (redis_response.has_int_response()) {
       out = SerializeInteger(redis_response.int_response(), out);
+    } else if (redis_response.has_scan_cursor()) {
+      // SCAN family replies are a two element array of the next cursor and the scanned elements.
+      static const std::string kScanReplyHeader = "*2\r\n";
+      out = SerializeEncoded(kScanReplyHeader, out);
+      out = SerializeBulkString(redis_response.scan_cursor(), out);
+      out = SerializeArray(redis_response.array_response().elements(), out);
     } else if (redis_response.has_array_response()) {
       if (redis_response.array_response().has_encoded() &&
           redis_response.array_response().encoded()) {
@@ -47,6 +47,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
 #include "yb/util/size_literals.h"
@@ -100,6 +101,11 @@ DEFINE_int32(redis_callbacks_threadpool_size, 64,
              "The maximum size for the threadpool which handles callbacks from the ybclient layer");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_int32(redis_follower_read_max_staleness_ms, 0,
+             "When reads are allowed from followers, a follower whose safe time lags more than "
+             "this number of milliseconds rejects the read, which is then retried on another "
+             "replica. 0 means no bound.");
+TAG_FLAG(redis_follower_read_max_staleness_ms, evolving);
 
 using yb::client::YBRedisOp;
 using yb::client::YBRedisReadOp;
@@ -252,6 +258,12 @@ class Operation {
     responded_.store(true, std::memory_order_release);
     if (status.ok()) {
       if (operation_) {
+        if (type_ == OperationType::kRead) {
+          const auto& request = down_cast<YBRedisReadOp*>(operation_.get())->request();
+          if (request.has_scan_request()) {
+            CompleteScanResponse(*operation_->table(), request, &response());
+          }
+        }
         call_->RespondSuccess(index_, metrics_, &response());
       } else {
         RedisResponsePB resp;
@@ -297,6 +309,10 @@ class SessionPool {
       session->SetTimeout(
           MonoDelta::FromMilliseconds(FLAGS_redis_service_yb_client_timeout_millis));
       CHECK_OK(session->SetFlushMode(YBSession::FlushMode::MANUAL_FLUSH));
+      if (FLAGS_redis_follower_read_max_staleness_ms > 0) {
+        session->SetFollowerReadMaxStaleness(
+            MonoDelta::FromMilliseconds(FLAGS_redis_follower_read_max_staleness_ms));
+      }
       sessions_.push_back(session);
       allocated_sessions_metric_->IncrementBy(1);
       return session;
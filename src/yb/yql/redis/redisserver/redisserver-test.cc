@@ -14,6 +14,7 @@
 #include <chrono>
 #include <memory>
 #include <random>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -2566,6 +2567,107 @@ TEST_F(TestRedisService, TestSRem) {
   VerifyCallbacks();
 }
 
+vector<string> ArrayReplyToStrings(const RedisReply& reply) {
+  vector<string> result;
+  for (const auto& element : reply.as_array()) {
+    result.push_back(element.as_string());
+  }
+  return result;
+}
+
+TEST_F(TestRedisService, TestScan) {
+  for (int i = 1; i <= 5; ++i) {
+    DoRedisTestOk(__LINE__, {"SET", Substitute("scan_key$0", i), "v"});
+  }
+  DoRedisTestOk(__LINE__, {"SET", "other_key", "v"});
+  DoRedisTestOk(__LINE__, {"SET", "scan_deleted", "v"});
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"DEL", "scan_deleted"}, 1);
+  SyncClient();
+
+  // Use a small count, so the scan has to resume both within a tablet and across tablets.
+  std::set<string> keys;
+  string cursor = "0";
+  int iterations = 0;
+  do {
+    DoRedisTest(__LINE__, {"SCAN", cursor, "MATCH", "scan_*", "COUNT", "2"},
+        RedisReplyType::kArray,
+        [&cursor, &keys](const RedisReply& reply) {
+          const auto& replies = reply.as_array();
+          ASSERT_EQ(2, replies.size());
+          cursor = replies[0].as_string();
+          for (const auto& key : replies[1].as_array()) {
+            ASSERT_TRUE(keys.insert(key.as_string()).second) << "Duplicate key: " << key.ToString();
+          }
+        }
+    );
+    SyncClient();
+    ASSERT_LT(++iterations, 1000);
+  } while (cursor != "0");
+  ASSERT_EQ(std::set<string>({"scan_key1", "scan_key2", "scan_key3", "scan_key4", "scan_key5"}),
+            keys);
+
+  DoRedisTestInt(__LINE__, {"HSET", "scan_hash", "f1", "v1"}, 1);
+  DoRedisTestInt(__LINE__, {"HSET", "scan_hash", "f2", "v2"}, 1);
+  DoRedisTestInt(__LINE__, {"HSET", "scan_hash", "f3", "v3"}, 1);
+  DoRedisTestInt(__LINE__, {"SADD", "scan_set", "a", "ab", "b", "c"}, 4);
+  DoRedisTestInt(__LINE__, {"ZADD", "scan_zset", "1", "m1", "2", "m2"}, 2);
+  SyncClient();
+
+  // The cursor of "f2" is "1" followed by the decimal codes of 'f' and '2'.
+  DoRedisTest(__LINE__, {"HSCAN", "scan_hash", "0", "COUNT", "2"}, RedisReplyType::kArray,
+      [](const RedisReply& reply) {
+        const auto& replies = reply.as_array();
+        ASSERT_EQ(2, replies.size());
+        ASSERT_EQ("1102050", replies[0].as_string());
+        ASSERT_EQ(vector<string>({"f1", "v1", "f2", "v2"}), ArrayReplyToStrings(replies[1]));
+      }
+  );
+  DoRedisTest(__LINE__, {"HSCAN", "scan_hash", "1102050", "COUNT", "2"}, RedisReplyType::kArray,
+      [](const RedisReply& reply) {
+        const auto& replies = reply.as_array();
+        ASSERT_EQ(2, replies.size());
+        ASSERT_EQ("0", replies[0].as_string());
+        ASSERT_EQ(vector<string>({"f3", "v3"}), ArrayReplyToStrings(replies[1]));
+      }
+  );
+  DoRedisTest(__LINE__, {"SSCAN", "scan_set", "0", "MATCH", "a*"}, RedisReplyType::kArray,
+      [](const RedisReply& reply) {
+        const auto& replies = reply.as_array();
+        ASSERT_EQ(2, replies.size());
+        ASSERT_EQ("0", replies[0].as_string());
+        ASSERT_EQ(vector<string>({"a", "ab"}), ArrayReplyToStrings(replies[1]));
+      }
+  );
+  DoRedisTest(__LINE__, {"ZSCAN", "scan_zset", "0"}, RedisReplyType::kArray,
+      [](const RedisReply& reply) {
+        const auto& replies = reply.as_array();
+        ASSERT_EQ(2, replies.size());
+        ASSERT_EQ("0", replies[0].as_string());
+        const auto& elements = replies[1].as_array();
+        ASSERT_EQ(4, elements.size());
+        ASSERT_EQ("m1", elements[0].as_string());
+        ASSERT_EQ(1.0, std::stod(elements[1].as_string()));
+        ASSERT_EQ("m2", elements[2].as_string());
+        ASSERT_EQ(2.0, std::stod(elements[3].as_string()));
+      }
+  );
+  DoRedisTest(__LINE__, {"SSCAN", "scan_missing", "0"}, RedisReplyType::kArray,
+      [](const RedisReply& reply) {
+        const auto& replies = reply.as_array();
+        ASSERT_EQ(2, replies.size());
+        ASSERT_EQ("0", replies[0].as_string());
+        ASSERT_EQ(0, replies[1].as_array().size());
+      }
+  );
+  DoRedisTestExpectError(__LINE__, {"HSCAN", "scan_set", "0"}, "WRONGTYPE");
+  DoRedisTestExpectError(__LINE__, {"HSCAN", "scan_hash", "12"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "COUNT", "0"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "MATCH"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestEmulateFlagFalse) {
   FLAGS_emulate_redis_responses = false;
 